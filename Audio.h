@@ -62,9 +62,12 @@
 #include "analyze_fft1024.h"
 #include "analyze_print.h"
 #include "analyze_tonedetect.h"
+#include "analyze_tonebank.h"
 #include "analyze_notefreq.h"
 #include "analyze_peak.h"
 #include "analyze_rms.h"
+#include "analyze_meter.h"
+#include "analyze_loudness.h"
 #include "async_input_spdif3.h"
 #include "control_sgtl5000.h"
 #include "control_wm8731.h"
@@ -83,15 +86,21 @@
 #include "effect_midside.h"
 #include "effect_reverb.h"
 #include "effect_freeverb.h"
+#include "effect_reverb_fdn.h"
 #include "effect_waveshaper.h"
+#include "effect_distortion.h"
+#include "effect_multiband.h"
+#include "effect_limiter.h"
 #include "effect_granular.h"
 #include "effect_combine.h"
 #include "effect_rectifier.h"
 #include "effect_wavefolder.h"
+#include "effect_vocoder.h"
 #include "filter_biquad.h"
 #include "filter_fir.h"
 #include "filter_variable.h"
 #include "filter_ladder.h"
+#include "filter_crossover.h"
 #include "input_adc.h"
 #include "input_adcs.h"
 #include "input_i2s.h"
@@ -105,6 +114,7 @@
 #include "input_pdm_i2s2.h"
 #include "input_spdif3.h"
 #include "mixer.h"
+#include "mixer_matrix.h"
 #include "output_dac.h"
 #include "output_dacs.h"
 #include "output_i2s.h"
@@ -130,6 +140,8 @@
 #include "record_queue.h"
 #include "synth_tonesweep.h"
 #include "synth_sine.h"
+#include "synth_additive.h"
+#include "synth_fm.h"
 #include "synth_waveform.h"
 #include "synth_dc.h"
 #include "synth_whitenoise.h"
@@ -65,67 +65,29 @@ void AudioAnalyzeFFT1024::update(void)
 	if (!block) return;
 
 #if defined(__ARM_ARCH_7EM__)
-	switch (state) {
-	case 0:
-		blocklist[0] = block;
-		state = 1;
-		break;
-	case 1:
-		blocklist[1] = block;
-		state = 2;
-		break;
-	case 2:
-		blocklist[2] = block;
-		state = 3;
-		break;
-	case 3:
-		blocklist[3] = block;
-		state = 4;
-		break;
-	case 4:
-		blocklist[4] = block;
-		state = 5;
-		break;
-	case 5:
-		blocklist[5] = block;
-		state = 6;
-		break;
-	case 6:
-		blocklist[6] = block;
-		state = 7;
-		break;
-	case 7:
-		blocklist[7] = block;
-		// TODO: perhaps distribute the work over multiple update() ??
-		//       github pull requsts welcome......
-		copy_to_fft_buffer(buffer+0x000, blocklist[0]->data);
-		copy_to_fft_buffer(buffer+0x100, blocklist[1]->data);
-		copy_to_fft_buffer(buffer+0x200, blocklist[2]->data);
-		copy_to_fft_buffer(buffer+0x300, blocklist[3]->data);
-		copy_to_fft_buffer(buffer+0x400, blocklist[4]->data);
-		copy_to_fft_buffer(buffer+0x500, blocklist[5]->data);
-		copy_to_fft_buffer(buffer+0x600, blocklist[6]->data);
-		copy_to_fft_buffer(buffer+0x700, blocklist[7]->data);
-		if (window) apply_window_to_fft_buffer(buffer, window);
-		arm_cfft_radix4_q15(&fft_inst, buffer);
-		// TODO: support averaging multiple copies
-		for (int i=0; i < 512; i++) {
-			uint32_t tmp = *((uint32_t *)buffer + i); // real & imag
-			uint32_t magsq = multiply_16tx16t_add_16bx16b(tmp, tmp);
-			output[i] = sqrt_uint32_approx(magsq);
-		}
-		outputflag = true;
-		release(blocklist[0]);
-		release(blocklist[1]);
-		release(blocklist[2]);
-		release(blocklist[3]);
-		blocklist[0] = blocklist[4];
-		blocklist[1] = blocklist[5];
-		blocklist[2] = blocklist[6];
-		blocklist[3] = blocklist[7];
-		state = 4;
-		break;
+	blocklist[state++] = block;
+	if (state < AUDIO_FFT1024_BLOCKS) return;
+
+	// TODO: perhaps distribute the work over multiple update() ??
+	//       github pull requsts welcome......
+	for (int i=0; i < AUDIO_FFT1024_BLOCKS; i++) {
+		copy_to_fft_buffer(buffer + i * AUDIO_BLOCK_SAMPLES * 2, blocklist[i]->data);
+	}
+	if (window) apply_window_to_fft_buffer(buffer, window);
+	arm_cfft_radix4_q15(&fft_inst, buffer);
+	// TODO: support averaging multiple copies
+	for (int i=0; i < 512; i++) {
+		uint32_t tmp = *((uint32_t *)buffer + i); // real & imag
+		uint32_t magsq = multiply_16tx16t_add_16bx16b(tmp, tmp);
+		output[i] = sqrt_uint32_approx(magsq);
+	}
+	outputflag = true;
+	// keep the newest half for 50% overlap with the next FFT
+	for (int i=0; i < AUDIO_FFT1024_BLOCKS / 2; i++) {
+		release(blocklist[i]);
+		blocklist[i] = blocklist[i + AUDIO_FFT1024_BLOCKS / 2];
 	}
+	state = AUDIO_FFT1024_BLOCKS / 2;
 #else
 	release(block);
 #endif
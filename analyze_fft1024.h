@@ -46,6 +46,12 @@ extern const int16_t AudioWindowCosine1024[];
 extern const int16_t AudioWindowTukey1024[];
 }
 
+// number of audio blocks which make up one 1024 point FFT
+#if AUDIO_BLOCK_SAMPLES < 16 || AUDIO_BLOCK_SAMPLES > 512
+#error "AudioAnalyzeFFT1024 requires AUDIO_BLOCK_SAMPLES from 16 to 512"
+#endif
+#define AUDIO_FFT1024_BLOCKS (1024 / AUDIO_BLOCK_SAMPLES)
+
 class AudioAnalyzeFFT1024 : public AudioStream
 {
 public:
@@ -89,7 +95,7 @@ public:
 private:
 	void init(void);
 	const int16_t *window;
-	audio_block_t *blocklist[8];
+	audio_block_t *blocklist[AUDIO_FFT1024_BLOCKS];
 	int16_t buffer[2048] __attribute__ ((aligned (4)));
 	//uint32_t sum[512];
 	//uint8_t count;
@@ -32,12 +32,12 @@
 
 // 140312 - PAH - slightly faster copy
 __attribute__((unused))
-static void copy_to_fft_buffer(void *destination, const void *source)
+static void copy_to_fft_buffer(void *destination, const void *source, int count)
 {
 	const uint16_t *src = (const uint16_t *)source;
 	uint32_t *dst = (uint32_t *)destination;
 
-	for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+	for (int i=0; i < count; i++) {
 		*dst++ = *src++;  // real sample plus a zero for imaginary
 	}
 }
@@ -62,13 +62,44 @@ void AudioAnalyzeFFT256::update(void)
 
 	block = receiveReadOnly();
 	if (!block) return;
-#if AUDIO_BLOCK_SAMPLES == 128 && defined (__ARM_ARCH_7EM__)
-	if (!prevblock) {
-		prevblock = block;
-		return;
+#if defined (__ARM_ARCH_7EM__)
+#if AUDIO_BLOCK_SAMPLES > 128
+	// each block is a whole FFT, so the second half of the previous
+	// block and the first half of this one make the overlapping FFT
+	if (state) {
+		copy_to_fft_buffer(buffer, blocklist[0]->data + 128, 128);
+		copy_to_fft_buffer(buffer + 256, block->data, 128);
+		release(blocklist[0]);
+		analyze();
 	}
-	copy_to_fft_buffer(buffer, prevblock->data);
-	copy_to_fft_buffer(buffer+256, block->data);
+	copy_to_fft_buffer(buffer, block->data, 256);
+	analyze();
+	blocklist[0] = block;
+	state = 1;
+#else
+	blocklist[state++] = block;
+	if (state < AUDIO_FFT256_BLOCKS) return;
+
+	for (int i=0; i < AUDIO_FFT256_BLOCKS; i++) {
+		copy_to_fft_buffer(buffer + i * AUDIO_BLOCK_SAMPLES * 2, blocklist[i]->data,
+			AUDIO_BLOCK_SAMPLES);
+	}
+	analyze();
+	// keep the newest half for 50% overlap with the next FFT
+	for (int i=0; i < AUDIO_FFT256_BLOCKS / 2; i++) {
+		release(blocklist[i]);
+		blocklist[i] = blocklist[i + AUDIO_FFT256_BLOCKS / 2];
+	}
+	state = AUDIO_FFT256_BLOCKS / 2;
+#endif
+#else
+	release(block);
+#endif
+}
+
+void AudioAnalyzeFFT256::analyze(void)
+{
+#if defined (__ARM_ARCH_7EM__)
 	//window = AudioWindowBlackmanNuttall256;
 	//window = NULL;
 	if (window) apply_window_to_fft_buffer(buffer, window);
@@ -95,38 +126,5 @@ void AudioAnalyzeFFT256::update(void)
 		}
 		outputflag = true;
 	}
-	release(prevblock);
-	prevblock = block;
-#elif AUDIO_BLOCK_SAMPLES == 64
-	if (prevblocks[2] == NULL) {
-		prevblocks[2] = prevblocks[1];
-		prevblocks[1] = prevblocks[0];
-		prevblocks[0] = block;
-		return;
-	}
-	if (count == 0) {
-		count = 1;
-		copy_to_fft_buffer(buffer, prevblocks[2]->data);
-		copy_to_fft_buffer(buffer+128, prevblocks[1]->data);
-		copy_to_fft_buffer(buffer+256, prevblocks[1]->data);
-		copy_to_fft_buffer(buffer+384, block->data);
-		if (window) apply_window_to_fft_buffer(buffer, window);
-		arm_cfft_radix4_q15(&fft_inst, buffer);
-	} else {
-		count = 2;
-		const uint32_t *p = (uint32_t *)buffer;
-		for (int i=0; i < 128; i++) {
-			uint32_t tmp = *p++;
-			int16_t v1 = tmp & 0xFFFF;
-			int16_t v2 = tmp >> 16;
-			output[i] = sqrt_uint32_approx(v1 * v1 + v2 * v2);
-		}
-	}
-	release(prevblocks[2]);
-	prevblocks[2] = prevblocks[1];
-	prevblocks[1] = prevblocks[0];
-	prevblocks[0] = block;
 #endif
 }
-
-
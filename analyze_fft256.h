@@ -46,20 +46,18 @@ extern const int16_t AudioWindowCosine256[];
 extern const int16_t AudioWindowTukey256[];
 }
 
+// number of audio blocks which make up one 256 point FFT
+#if AUDIO_BLOCK_SAMPLES < 16 || AUDIO_BLOCK_SAMPLES > 256
+#error "AudioAnalyzeFFT256 requires AUDIO_BLOCK_SAMPLES from 16 to 256"
+#endif
+#define AUDIO_FFT256_BLOCKS (256 / AUDIO_BLOCK_SAMPLES)
+
 class AudioAnalyzeFFT256 : public AudioStream
 {
 public:
 	AudioAnalyzeFFT256() : AudioStream(1, inputQueueArray),
-	  window(AudioWindowHanning256), count(0), outputflag(false) {
+	  window(AudioWindowHanning256), state(0), naverage(8), count(0), outputflag(false) {
 		arm_cfft_radix4_init_q15(&fft_inst, 256, 0, 1);
-#if AUDIO_BLOCK_SAMPLES == 128
-		prevblock = NULL;
-		naverage = 8;
-#elif AUDIO_BLOCK_SAMPLES == 64
-		prevblocks[0] = NULL;
-		prevblocks[1] = NULL;
-		prevblocks[2] = NULL;
-#endif
 	}
 	bool available() {
 		if (outputflag == true) {
@@ -87,10 +85,8 @@ public:
 		return (float)sum * (1.0f / 16384.0f);
 	}
 	void averageTogether(uint8_t n) {
-#if AUDIO_BLOCK_SAMPLES == 128
 		if (n == 0) n = 1;
 		naverage = n;
-#endif
 	}
 	void windowFunction(const int16_t *w) {
 		window = w;
@@ -98,17 +94,13 @@ public:
 	virtual void update(void);
 	uint16_t output[128] __attribute__ ((aligned (4)));
 private:
+	void analyze(void);
 	const int16_t *window;
-#if AUDIO_BLOCK_SAMPLES == 128
-	audio_block_t *prevblock;
-#elif AUDIO_BLOCK_SAMPLES == 64
-	audio_block_t *prevblocks[3];
-#endif
+	audio_block_t *blocklist[AUDIO_FFT256_BLOCKS];
 	int16_t buffer[512] __attribute__ ((aligned (4)));
-#if AUDIO_BLOCK_SAMPLES == 128
 	uint32_t sum[128];
+	uint8_t state;
 	uint8_t naverage;
-#endif
 	uint8_t count;
 	volatile bool outputflag;
 	audio_block_t *inputQueueArray[1];
@@ -0,0 +1,256 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+#include "analyze_loudness.h"
+#include "utility/dspinst.h"
+
+// K-weighting filter coefficients in the format of AudioFilterBiquad,
+// computed for any sample rate from the analog prototypes of the 48 kHz
+// filters in BS.1770.  The first stage is scaled by 0.5, so its +4 dB
+// high shelf can not clip the 16 bit data passed to the second stage.
+void AudioAnalyzeLoudness::kweighting(int32_t *coef)
+{
+	double K, Q, Vh, Vb, a0;
+
+	// high shelf, the acoustic effect of the head
+	K = tan(3.141592653589793 * 1681.974450955533 / AUDIO_SAMPLE_RATE_EXACT);
+	Q = 0.7071752369554196;
+	Vh = pow(10.0, 3.999843853973347 / 20.0);
+	Vb = pow(Vh, 0.4996667741545416);
+	a0 = 1.0 + K / Q + K * K;
+	/* b0 */ coef[0] = (Vh + Vb * K / Q + K * K) / a0 * 536870912.0;
+	/* b1 */ coef[1] = 2.0 * (K * K - Vh) / a0 * 536870912.0;
+	/* b2 */ coef[2] = (Vh - Vb * K / Q + K * K) / a0 * 536870912.0;
+	/* a1 */ coef[3] = -2.0 * (K * K - 1.0) / a0 * 1073741824.0;
+	/* a2 */ coef[4] = -(1.0 - K / Q + K * K) / a0 * 1073741824.0;
+
+	// RLB high pass
+	K = tan(3.141592653589793 * 38.13547087602444 / AUDIO_SAMPLE_RATE_EXACT);
+	Q = 0.5003270373238773;
+	a0 = 1.0 + K / Q + K * K;
+	/* b0 */ coef[5] = 1073741824;
+	/* b1 */ coef[6] = (int32_t)0x80000000;  // -2.0
+	/* b2 */ coef[7] = 1073741824;
+	/* a1 */ coef[8] = -2.0 * (K * K - 1.0) / a0 * 1073741824.0;
+	/* a2 */ coef[9] = -(1.0 - K / Q + K * K) / a0 * 1073741824.0;
+}
+
+float AudioAnalyzeLoudness::readIntegrated(void)
+{
+	const float step = 1.02329299f;  // 0.1 LU
+	uint32_t hist[LOUDNESS_HISTOGRAM_BINS];
+	uint32_t i, n, count;
+	float e, sum, threshold;
+
+	// both gates must see the same blocks, so copy the histogram
+	// before update() can add to it
+	__disable_irq();
+	memcpy(hist, histogram, sizeof(hist));
+	__enable_irq();
+
+	// each block is counted at the center of its histogram bin,
+	// within 0.05 LU of its measured loudness
+	e = powf(10.0f, (-70.0f + 0.05f + 0.691f) * 0.1f);
+	sum = 0.0f;
+	count = 0;
+	for (i=0; i < LOUDNESS_HISTOGRAM_BINS; i++) {
+		n = hist[i];
+		if (n) {
+			sum += (float)n * e;
+			count += n;
+		}
+		e *= step;
+	}
+	if (count == 0) return -INFINITY;
+
+	// relative gate, 10 LU below the absolute gated loudness
+	threshold = sum / (float)count * 0.1f;
+	e = powf(10.0f, (-70.0f + 0.05f + 0.691f) * 0.1f);
+	sum = 0.0f;
+	count = 0;
+	for (i=0; i < LOUDNESS_HISTOGRAM_BINS; i++) {
+		if (e > threshold) {
+			n = hist[i];
+			if (n) {
+				sum += (float)n * e;
+				count += n;
+			}
+		}
+		e *= step;
+	}
+	if (count == 0) return -INFINITY;
+	return -0.691f + 10.0f * log10f(sum / (float)count);
+}
+
+#if defined(__ARM_ARCH_7EM__)
+
+// one stage of AudioFilterBiquad's direct form 1 filter
+static void biquad(int16_t *block, const int32_t *coef,
+	uint32_t *bstate, uint32_t *astate, int32_t *sumstate)
+{
+	const int32_t b0 = coef[0], b1 = coef[1], b2 = coef[2];
+	const int32_t a1 = coef[3], a2 = coef[4];
+	uint32_t in2, out2, bprev, aprev;
+	uint32_t *data, *end;
+	int32_t sum;
+
+	data = (uint32_t *)block;
+	end = data + AUDIO_BLOCK_SAMPLES/2;
+	bprev = *bstate;
+	aprev = *astate;
+	sum = *sumstate;
+	do {
+		in2 = *data;
+		sum = signed_multiply_accumulate_32x16b(sum, b0, in2);
+		sum = signed_multiply_accumulate_32x16t(sum, b1, bprev);
+		sum = signed_multiply_accumulate_32x16b(sum, b2, bprev);
+		sum = signed_multiply_accumulate_32x16t(sum, a1, aprev);
+		sum = signed_multiply_accumulate_32x16b(sum, a2, aprev);
+		out2 = signed_saturate_rshift(sum, 16, 14);
+		sum &= 0x3FFF;
+		sum = signed_multiply_accumulate_32x16t(sum, b0, in2);
+		sum = signed_multiply_accumulate_32x16b(sum, b1, in2);
+		sum = signed_multiply_accumulate_32x16t(sum, b2, bprev);
+		sum = signed_multiply_accumulate_32x16b(sum, a1, out2);
+		sum = signed_multiply_accumulate_32x16t(sum, a2, aprev);
+		bprev = in2;
+		aprev = pack_16b_16b(signed_saturate_rshift(sum, 16, 14), out2);
+		sum &= 0x3FFF;
+		*data++ = aprev;
+	} while (data < end);
+	*bstate = bprev;
+	*astate = aprev;
+	*sumstate = sum;
+}
+
+static uint64_t sum_squares(const int16_t *p, uint32_t len)
+{
+	int64_t sum = 0;
+
+	if (len > 0 && ((uintptr_t)p & 2)) {
+		sum = p[0] * p[0];
+		p++;
+		len--;
+	}
+	while (len >= 2) {
+		uint32_t n = *(const uint32_t *)p;
+		sum = multiply_accumulate_16tx16t_add_16bx16b(sum, n, n);
+		p += 2;
+		len -= 2;
+	}
+	if (len > 0) sum += p[0] * p[0];
+	return sum;
+}
+
+void AudioAnalyzeLoudness::update(void)
+{
+	audio_block_t *block;
+	struct channel_state *ch;
+	uint32_t data[AUDIO_BLOCK_SAMPLES/2];
+	int16_t *samples = (int16_t *)data;
+	uint64_t rest[LOUDNESS_MAX_CHANNELS];
+	uint32_t i, split;
+	float sum, m, s;
+
+	// samples before split belong to the current 100 ms sub-block
+	split = subblock_remaining;
+	if (split > AUDIO_BLOCK_SAMPLES) split = AUDIO_BLOCK_SAMPLES;
+	for (i=0; i < LOUDNESS_MAX_CHANNELS; i++) {
+		ch = &state[i];
+		rest[i] = 0;
+		block = receiveReadOnly(i);
+		if (block) {
+			memcpy(data, block->data, sizeof(data));
+			release(block);
+		} else {
+			// once the filters settle to zero, no more work is needed
+			if ((ch->bprev[0] | ch->aprev[0] | ch->bprev[1] | ch->aprev[1]) == 0) continue;
+			memset(data, 0, sizeof(data));
+		}
+		biquad(samples, coefficients, &ch->bprev[0], &ch->aprev[0], &ch->sum[0]);
+		biquad(samples, coefficients + 5, &ch->bprev[1], &ch->aprev[1], &ch->sum[1]);
+		if (!block && sum_squares(samples, AUDIO_BLOCK_SAMPLES) <= AUDIO_BLOCK_SAMPLES * 4) {
+			// without input, rounding can leave the filters stuck a
+			// couple steps from zero, so stop them when no signal remains
+			memset(ch, 0, sizeof(struct channel_state));
+			continue;
+		}
+		sumsq[i] += sum_squares(samples, split);
+		if (split < AUDIO_BLOCK_SAMPLES) {
+			rest[i] = sum_squares(samples + split, AUDIO_BLOCK_SAMPLES - split);
+		}
+	}
+	subblock_remaining -= split;
+	if (subblock_remaining > 0) return;
+
+	// a sub-block is complete, add its weighted mean square to the
+	// history, undoing the first stage's 0.5 scaling
+	sum = 0.0f;
+	for (i=0; i < LOUDNESS_MAX_CHANNELS; i++) {
+		sum += weight[i] * (float)sumsq[i];
+		sumsq[i] = rest[i];
+	}
+	energy[energy_index] = sum * (4.0f / (32768.0f * 32768.0f)) / (float)subblock_length;
+	if (++energy_index >= 30) energy_index = 0;
+	if (energy_count < 30) energy_count++;
+	subblock_remaining = subblock_length - (AUDIO_BLOCK_SAMPLES - split);
+
+	// momentary is the last 4 sub-blocks, short-term is all 30
+	m = 0.0f;
+	s = 0.0f;
+	for (i=0; i < 30; i++) {
+		s += energy[i];
+		if (((energy_index + 30 - 1 - i) % 30) < 4) m += energy[i];
+	}
+	m = -0.691f + 10.0f * log10f(m * 0.25f);
+	s = -0.691f + 10.0f * log10f(s * (1.0f / 30.0f));
+	momentary = m;
+	shortterm = s;
+
+	// every momentary measurement is also a 400 ms gating block, which
+	// overlap by 75%, for the integrated loudness
+	if (energy_count >= 4 && m >= -70.0f) {
+		i = (m + 70.0f) * 10.0f;
+		if (i >= LOUDNESS_HISTOGRAM_BINS) i = LOUDNESS_HISTOGRAM_BINS - 1;
+		histogram[i]++;
+	}
+	sequence++;
+}
+
+#elif defined(KINETISL)
+
+void AudioAnalyzeLoudness::update(void)
+{
+	audio_block_t *block;
+
+	for (int i=0; i < LOUDNESS_MAX_CHANNELS; i++) {
+		block = receiveReadOnly(i);
+		if (block) release(block);
+	}
+}
+
+#endif
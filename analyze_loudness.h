@@ -0,0 +1,117 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef analyze_loudness_h_
+#define analyze_loudness_h_
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+// Loudness measurement according to ITU-R BS.1770-4 and EBU R128.
+// Each input is one channel, and unconnected inputs are silent.
+#define LOUDNESS_MAX_CHANNELS 8
+
+// Integrated loudness keeps a count of gating blocks in 0.1 LU steps
+// from -70 to +10 LUFS, so its memory does not grow with time.
+#define LOUDNESS_HISTOGRAM_BINS 800
+
+class AudioAnalyzeLoudness : public AudioStream
+{
+public:
+	AudioAnalyzeLoudness(void) : AudioStream(LOUDNESS_MAX_CHANNELS, inputQueueArray) {
+		memset(state, 0, sizeof(state));
+		memset(sumsq, 0, sizeof(sumsq));
+		memset(energy, 0, sizeof(energy));
+		memset(histogram, 0, sizeof(histogram));
+		for (int i=0; i < LOUDNESS_MAX_CHANNELS; i++) weight[i] = 1.0f;
+		kweighting(coefficients);
+		subblock_length = AUDIO_SAMPLE_RATE_EXACT / 10.0f + 0.5f;
+		subblock_remaining = subblock_length;
+		energy_index = 0;
+		energy_count = 0;
+		momentary = -INFINITY;
+		shortterm = -INFINITY;
+		sequence = 0;
+		sequence_read = 0;
+	}
+	// BS.1770 uses 1.0 for left, right & center, 1.41 for the
+	// surround channels, and 0 to exclude LFE
+	void channelWeight(unsigned int channel, float n) {
+		if (channel >= LOUDNESS_MAX_CHANNELS) return;
+		if (n < 0.0f) n = 0.0f;
+		weight[channel] = n;
+	}
+	// true once every 100 ms, when new loudness is computed
+	bool available(void) {
+		uint32_t n = sequence;
+		if (n == sequence_read) return false;
+		sequence_read = n;
+		return true;
+	}
+	// loudness of the last 400 ms, in LUFS
+	float readMomentary(void) {
+		return momentary;
+	}
+	// loudness of the last 3 seconds, in LUFS
+	float readShortTerm(void) {
+		return shortterm;
+	}
+	// gated loudness since the beginning or reset(), in LUFS
+	float readIntegrated(void);
+	// begin a new integrated measurement, from the gating blocks
+	// which begin after this
+	void reset(void) {
+		__disable_irq();
+		memset(histogram, 0, sizeof(histogram));
+		energy_count = 0;
+		__enable_irq();
+	}
+	virtual void update(void);
+private:
+	struct channel_state {
+		uint32_t bprev[2];  // previous input of each biquad stage
+		uint32_t aprev[2];  // previous output of each biquad stage
+		int32_t sum[2];     // rounding carried between samples
+	};
+	static void kweighting(int32_t *coef);
+	audio_block_t *inputQueueArray[LOUDNESS_MAX_CHANNELS];
+	struct channel_state state[LOUDNESS_MAX_CHANNELS];
+	uint64_t sumsq[LOUDNESS_MAX_CHANNELS];  // filtered sum of squares
+	float weight[LOUDNESS_MAX_CHANNELS];
+	int32_t coefficients[10];
+	float energy[30];  // mean square of the last 30 sub-blocks (3 sec)
+	uint32_t histogram[LOUDNESS_HISTOGRAM_BINS];
+	uint16_t subblock_length;
+	uint16_t subblock_remaining;
+	uint8_t energy_index;
+	uint8_t energy_count;
+	volatile float momentary;
+	volatile float shortterm;
+	volatile uint32_t sequence;
+	uint32_t sequence_read;
+};
+
+#endif
@@ -0,0 +1,201 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+#include "analyze_meter.h"
+#include "utility/dspinst.h"
+#include "utility/truepeak.h"
+
+// Returns the higher of limit and the largest oversampled output, in
+// sample units scaled by 8192.  When the filter can not possibly exceed
+// limit, only the history is updated.
+int32_t AudioAnalyzeMeter::oversampled_peak(int16_t *history, const int16_t *data,
+	uint32_t peak, int32_t limit)
+{
+	int16_t x[11 + AUDIO_BLOCK_SAMPLES];
+	uint32_t i, k;
+
+	for (i=0; i < 11; i++) {
+		int32_t n = abs(history[i]);
+		if ((uint32_t)n > peak) peak = n;
+	}
+	if ((int32_t)(peak * TRUEPEAK_GAIN_BOUND) <= limit) {
+		memcpy(history, data + AUDIO_BLOCK_SAMPLES - 11, sizeof(int16_t) * 11);
+		return limit;
+	}
+	memcpy(x, history, sizeof(int16_t) * 11);
+	memcpy(x + 11, data, sizeof(int16_t) * AUDIO_BLOCK_SAMPLES);
+	memcpy(history, data + AUDIO_BLOCK_SAMPLES - 11, sizeof(int16_t) * 11);
+
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		const int16_t *w = x + i;
+		int32_t y0 = 0, y1 = 0, y2 = 0, y3 = 0;
+		for (k=0; k < 12; k++) {
+			y0 += truepeak_phase0[k] * w[11 - k];
+			y1 += truepeak_phase1[k] * w[11 - k];
+			y2 += truepeak_phase1[k] * w[k];
+			y3 += truepeak_phase0[k] * w[k];
+		}
+		y0 = abs(y0);
+		y1 = abs(y1);
+		y2 = abs(y2);
+		y3 = abs(y3);
+		if (y1 > y0) y0 = y1;
+		if (y3 > y2) y2 = y3;
+		if (y2 > y0) y0 = y2;
+		if (y0 > limit) limit = y0;
+	}
+	return limit;
+}
+
+// Each block is measured in segments of at most one step.
+#if AUDIO_BLOCK_SAMPLES > METER_STEP
+#define METER_SEGMENT METER_STEP
+#else
+#define METER_SEGMENT AUDIO_BLOCK_SAMPLES
+#endif
+
+// Highest absolute sample and sum of squares of len samples, a multiple of 4.
+static uint32_t measure(const int16_t *p, uint32_t len, int64_t *sumsq)
+{
+	const int16_t *end = p + len;
+	int32_t min = 0, max = 0;
+	int64_t sum = 0;
+
+#if defined(__ARM_ARCH_7EM__)
+	do {
+		uint32_t n1 = *(uint32_t *)p;
+		uint32_t n2 = *(uint32_t *)(p + 2);
+		sum = multiply_accumulate_16tx16t_add_16bx16b(sum, n1, n1);
+		sum = multiply_accumulate_16tx16t_add_16bx16b(sum, n2, n2);
+		int32_t d0 = p[0], d1 = p[1], d2 = p[2], d3 = p[3];
+		if (d0 < min) min = d0;
+		if (d0 > max) max = d0;
+		if (d1 < min) min = d1;
+		if (d1 > max) max = d1;
+		if (d2 < min) min = d2;
+		if (d2 > max) max = d2;
+		if (d3 < min) min = d3;
+		if (d3 > max) max = d3;
+		p += 4;
+	} while (p < end);
+#else
+	do {
+		int32_t d = *p++;
+		sum += d * d;
+		if (d < min) min = d;
+		if (d > max) max = d;
+	} while (p < end);
+#endif
+	*sumsq = sum;
+	return (-min > max) ? -min : max;
+}
+
+// PPM and VU move once per step, on the step's peak and RMS
+void AudioAnalyzeMeter::ballistics(struct channel_state *ch)
+{
+	float level = (float)ch->step_peak * (1.0f / 32767.0f);
+	if (level > ch->ppm) {
+		ch->ppm += (level - ch->ppm) * ppm_attack;
+	} else {
+		ch->ppm *= ppm_fall;
+	}
+	float rms = sqrtf((float)ch->step_sumsq * (1.0f / METER_STEP)) * (1.0f / 32767.0f);
+	ch->vu += (rms - ch->vu) * vu_coef;
+	ch->step_peak = 0;
+	ch->step_sumsq = 0;
+}
+
+void AudioAnalyzeMeter::update(void)
+{
+	audio_block_t *block;
+	struct channel_state *ch;
+	uint32_t i, seg, peak, blockpeak;
+	int64_t sum;
+
+	// with small blocks, a step is only complete every few updates
+	const bool stepped = (step + METER_SEGMENT >= METER_STEP);
+	for (i=0; i < METER_MAX_CHANNELS; i++) {
+		ch = &state[i];
+		block = receiveReadOnly(i);
+		if (block) {
+			ch->active = 1;
+		} else if (!ch->active) {
+			continue;
+		}
+		blockpeak = 0;
+		for (seg=0; seg < AUDIO_BLOCK_SAMPLES; seg += METER_SEGMENT) {
+			if (block) {
+				peak = measure(block->data + seg, METER_SEGMENT, &sum);
+				if (peak > blockpeak) blockpeak = peak;
+				if (peak > ch->step_peak) ch->step_peak = peak;
+				ch->step_sumsq += sum;
+				if (peak > ch->peak) ch->peak = peak;
+				ch->sumsq += sum;
+			}
+			if (stepped) ballistics(ch);
+		}
+		if (block) {
+			if (truepeak_enable) {
+				ch->truepeak = oversampled_peak(ch->history, block->data,
+					blockpeak, ch->truepeak);
+			} else {
+				memcpy(ch->history, block->data + AUDIO_BLOCK_SAMPLES - 11, sizeof(ch->history));
+			}
+			release(block);
+		} else {
+			// silence: clear the filter history and let the meters fall
+			memset(ch->history, 0, sizeof(ch->history));
+			if (stepped && ch->ppm < 1.0e-6f && ch->vu < 1.0e-6f) {
+				ch->ppm = 0.0f;
+				ch->vu = 0.0f;
+				ch->active = 0;
+			}
+		}
+	}
+	step = stepped ? 0 : step + METER_SEGMENT;
+
+	if (++blocks < period_blocks) return;
+	// publish this period's levels, which readers copy without
+	// disabling interrupts (see read() in analyze_meter.h)
+	const float scale = 1.0f / (float)(blocks * AUDIO_BLOCK_SAMPLES);
+	for (i=0; i < METER_MAX_CHANNELS; i++) {
+		ch = &state[i];
+		levels[i].peak = (float)ch->peak * (1.0f / 32767.0f);
+		levels[i].rms = sqrtf((float)ch->sumsq * scale) * (1.0f / 32767.0f);
+		levels[i].truePeak = truepeak_enable ?
+			(float)ch->truepeak * (1.0f / (32767.0f * 8192.0f)) :
+			levels[i].peak;
+		levels[i].ppm = ch->ppm;
+		levels[i].vu = ch->vu;
+		ch->peak = 0;
+		ch->sumsq = 0;
+		ch->truepeak = 0;
+	}
+	blocks = 0;
+	asm volatile("" ::: "memory");
+	sequence = sequence + 1;
+}
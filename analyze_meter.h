@@ -0,0 +1,158 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef analyze_meter_h_
+#define analyze_meter_h_
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+// Measure up to 16 channels at once.  Each input is one channel, and
+// unconnected inputs cost almost nothing.
+#define METER_MAX_CHANNELS 16
+
+// PPM and VU ballistics run every 128 samples (2.9 ms), at any block size
+#define METER_STEP 128
+
+typedef struct audio_meter_levels_struct {
+	float peak;      // highest sample during the period
+	float rms;       // RMS level during the period
+	float truePeak;  // highest 4x oversampled level during the period
+	float ppm;       // peak programme meter reading
+	float vu;        // VU meter reading
+} audio_meter_levels_t;
+
+class AudioAnalyzeMeter : public AudioStream
+{
+public:
+	AudioAnalyzeMeter(void) : AudioStream(METER_MAX_CHANNELS, inputQueueArray) {
+		memset(state, 0, sizeof(state));
+		memset((void *)levels, 0, sizeof(levels));
+		sequence = 0;
+		sequence_read = 0;
+		blocks = 0;
+		step = 0;
+		truepeak_enable = true;
+		period(50.0f);
+		ppmBallistics(10.0f, 24.0f / 2.8f);  // IEC 60268-10 Type II
+		vuBallistics(300.0f);
+	}
+	// length of each measurement, levels are published when it ends
+	void period(float milliseconds) {
+		float n = milliseconds * (AUDIO_SAMPLE_RATE_EXACT / 1000.0f) / AUDIO_BLOCK_SAMPLES;
+		if (n < 1.0f) n = 1.0f;
+		if (n > 65535.0f) n = 65535.0f;
+		period_blocks = n + 0.5f;
+	}
+	// PPM rises with an integration time and falls at a steady rate
+	void ppmBallistics(float attackMilliseconds, float decibelsPerSecond) {
+		const float step_ms = METER_STEP * 1000.0f / AUDIO_SAMPLE_RATE_EXACT;
+		if (attackMilliseconds < step_ms) attackMilliseconds = step_ms;
+		if (decibelsPerSecond < 0.0f) decibelsPerSecond = 0.0f;
+		ppm_attack = 1.0f - expf(-step_ms / attackMilliseconds);
+		ppm_fall = powf(10.0f, decibelsPerSecond * step_ms * -0.00005f);
+	}
+	// VU reaches 99% of a steady level in this time
+	void vuBallistics(float milliseconds) {
+		const float step_ms = METER_STEP * 1000.0f / AUDIO_SAMPLE_RATE_EXACT;
+		if (milliseconds < step_ms) milliseconds = step_ms;
+		vu_coef = 1.0f - expf(-step_ms * 4.60517f / milliseconds);
+	}
+	void enableTruePeak(void) { truepeak_enable = true; }
+	void disableTruePeak(void) { truepeak_enable = false; }
+	// true once for each newly published set of levels
+	bool available(void) {
+		uint32_t n = sequence;
+		if (n == sequence_read) return false;
+		sequence_read = n;
+		return true;
+	}
+	// each reading is a single word, which interrupts can not split
+	float readPeak(unsigned int channel) {
+		if (channel >= METER_MAX_CHANNELS) return 0.0f;
+		return levels[channel].peak;
+	}
+	float readRMS(unsigned int channel) {
+		if (channel >= METER_MAX_CHANNELS) return 0.0f;
+		return levels[channel].rms;
+	}
+	float readTruePeak(unsigned int channel) {
+		if (channel >= METER_MAX_CHANNELS) return 0.0f;
+		return levels[channel].truePeak;
+	}
+	float readPPM(unsigned int channel) {
+		if (channel >= METER_MAX_CHANNELS) return 0.0f;
+		return levels[channel].ppm;
+	}
+	float readVU(unsigned int channel) {
+		if (channel >= METER_MAX_CHANNELS) return 0.0f;
+		return levels[channel].vu;
+	}
+	// copy all levels of one channel from the same period
+	bool read(unsigned int channel, audio_meter_levels_t *dest) {
+		if (channel >= METER_MAX_CHANNELS) return false;
+		uint32_t n;
+		do {
+			// update() can not be interrupted, so if the sequence
+			// has not changed, nothing was published while copying
+			n = sequence;
+			asm volatile("" ::: "memory");
+			*dest = *(const audio_meter_levels_t *)&levels[channel];
+			asm volatile("" ::: "memory");
+		} while (n != sequence);
+		return true;
+	}
+	virtual void update(void);
+private:
+	struct channel_state {
+		int16_t history[11];  // last samples, for the oversampling filter
+		uint8_t active;       // history or meters not yet at zero
+		uint16_t peak;        // highest absolute sample this period
+		int64_t sumsq;        // sum of squares this period
+		int32_t truepeak;     // highest oversampled output this period
+		uint16_t step_peak;   // highest absolute sample this step
+		int64_t step_sumsq;   // sum of squares this step
+		float ppm;
+		float vu;
+	};
+	static int32_t oversampled_peak(int16_t *history, const int16_t *data,
+		uint32_t peak, int32_t limit);
+	void ballistics(struct channel_state *ch);
+	audio_block_t *inputQueueArray[METER_MAX_CHANNELS];
+	struct channel_state state[METER_MAX_CHANNELS];
+	volatile audio_meter_levels_t levels[METER_MAX_CHANNELS];
+	volatile uint32_t sequence;
+	uint32_t sequence_read;
+	uint16_t blocks;
+	uint16_t period_blocks;
+	uint16_t step;        // samples of the current step already measured
+	bool truepeak_enable;
+	float ppm_attack;
+	float ppm_fall;
+	float vu_coef;
+};
+
+#endif
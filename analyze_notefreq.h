@@ -39,6 +39,13 @@
  ***********************************************************************/
 #define AUDIO_GUITARTUNER_BLOCKS  24
 /***********************************************************************/
+// AUDIO_GUITARTUNER_BLOCKS counts 128 sample blocks, so the detection
+// range stays the same when AUDIO_BLOCK_SAMPLES is changed.  This is how
+// many actual audio blocks are queued to fill the buffer.
+#if (AUDIO_GUITARTUNER_BLOCKS * 128) % AUDIO_BLOCK_SAMPLES != 0
+#error "AUDIO_GUITARTUNER_BLOCKS * 128 must be a multiple of AUDIO_BLOCK_SAMPLES"
+#endif
+#define AUDIO_GUITARTUNER_QUEUE  (AUDIO_GUITARTUNER_BLOCKS * 128 / AUDIO_BLOCK_SAMPLES)
 class AudioAnalyzeNoteFrequency : public AudioStream {
 public:
     /**
@@ -123,12 +130,13 @@ private:
     uint64_t  yin_buffer[5];
     uint64_t  rs_buffer[5];
     int16_t  AudioBuffer[AUDIO_GUITARTUNER_BLOCKS*128] __attribute__ ( ( aligned ( 4 ) ) );
-    uint8_t  yin_idx, state;
+    uint8_t  yin_idx;
+    uint16_t state;
     float    periodicity, yin_threshold, cpu_usage_max, data;
     bool     enabled, next_buffer, first_run;
     volatile bool new_output, process_buffer;
-    audio_block_t *blocklist1[AUDIO_GUITARTUNER_BLOCKS];
-    audio_block_t *blocklist2[AUDIO_GUITARTUNER_BLOCKS];
+    audio_block_t *blocklist1[AUDIO_GUITARTUNER_QUEUE];
+    audio_block_t *blocklist2[AUDIO_GUITARTUNER_QUEUE];
     audio_block_t *inputQueueArray[1];
 };
 #endif
@@ -0,0 +1,245 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+#include "analyze_tonebank.h"
+
+static inline int32_t multiply_32x32_rshift30(int32_t a, int32_t b) __attribute__((always_inline));
+static inline int32_t multiply_32x32_rshift30(int32_t a, int32_t b)
+{
+	return ((int64_t)a * (int64_t)b) >> 30;
+}
+
+static const int16_t zerodata[AUDIO_BLOCK_SAMPLES] = {0};
+
+static const float dtmf_freqs[8] = {
+	697.0f, 770.0f, 852.0f, 941.0f, 1209.0f, 1336.0f, 1477.0f, 1633.0f
+};
+static const char dtmf_keys[16] = {
+	'1', '2', '3', 'A',
+	'4', '5', '6', 'B',
+	'7', '8', '9', 'C',
+	'*', '0', '#', 'D'
+};
+
+void AudioAnalyzeToneBank::configure(unsigned int index)
+{
+	struct tone_state *t = &tone[index];
+	double w, bound;
+	int shift;
+
+	t->s1 = 0;
+	t->s2 = 0;
+	if (freqs[index] == 0.0f) {
+		// unused, but may run as one of a pair
+		t->coef = 0;
+		t->shift = 15;
+		t->scale = 0.0f;
+		return;
+	}
+	w = freqs[index] * (2.0 * 3.14159265358979323846 / AUDIO_SAMPLE_RATE_EXACT);
+	t->coef = cos(w) * 2147483647.999;
+	// The state can grow to len * 32768 / sin(w), so low frequencies
+	// with long lengths need the input reduced to avoid overflow.
+	bound = (double)len * 32768.0;
+	if (sin(w) > 1.0 / (double)len) bound /= sin(w);
+	else bound *= (double)len;
+	shift = 0;
+	while (bound > 536870912.0 && shift < 15) {
+		bound *= 0.5;
+		shift++;
+	}
+	t->shift = shift;
+	t->scale = (float)(4.0 * (double)(1 << (shift * 2))
+		/ ((double)len * (double)len * 32768.0 * 32768.0));
+}
+
+void AudioAnalyzeToneBank::length(float milliseconds)
+{
+	float n = milliseconds * (AUDIO_SAMPLE_RATE_EXACT / 1000.0f) + 0.5f;
+	if (n < 16.0f) n = 16.0f;
+	if (n > 65535.0f) n = 65535.0f;
+	__disable_irq();
+	len = n;
+	count = len;
+	for (unsigned int i=0; i < ntones; i++) {
+		configure(i);
+	}
+	__enable_irq();
+}
+
+void AudioAnalyzeToneBank::frequency(unsigned int index, float freq)
+{
+	if (index >= TONEBANK_MAX_TONES) return;
+	if (freq < 0.0f) freq = 0.0f;
+	if (freq > AUDIO_SAMPLE_RATE_EXACT / 2.0f) freq = AUDIO_SAMPLE_RATE_EXACT / 2.0f;
+	__disable_irq();
+	freqs[index] = freq;
+	configure(index);
+	if (freq > 0.0f) {
+		if (index >= ntones) ntones = index + 1;
+	} else {
+		while (ntones > 0 && freqs[ntones - 1] == 0.0f) ntones--;
+	}
+	__enable_irq();
+}
+
+void AudioAnalyzeToneBank::dtmf(void)
+{
+	for (int i=0; i < 8; i++) {
+		frequency(i, dtmf_freqs[i]);
+	}
+	__disable_irq();
+	dtmf_previous = 0;
+	dtmf_reported = 0;
+	dtmf_enable = true;
+	__enable_irq();
+}
+
+// Run 2 tones through the same samples, so each sample is read
+// only once for every pair of Goertzel filters.
+void AudioAnalyzeToneBank::goertzel_pair(struct tone_state *t0, struct tone_state *t1,
+	const int16_t *p, uint32_t n)
+{
+	const int32_t coef0 = t0->coef, shift0 = t0->shift;
+	const int32_t coef1 = t1->coef, shift1 = t1->shift;
+	int32_t a1 = t0->s1, a2 = t0->s2;
+	int32_t b1 = t1->s1, b2 = t1->s2;
+	int32_t a0, b0, x;
+
+	do {
+		x = *p++;
+		a0 = (x >> shift0) + multiply_32x32_rshift30(coef0, a1) - a2;
+		b0 = (x >> shift1) + multiply_32x32_rshift30(coef1, b1) - b2;
+		a2 = a1;
+		a1 = a0;
+		b2 = b1;
+		b1 = b0;
+	} while (--n > 0);
+	t0->s1 = a1;
+	t0->s2 = a2;
+	t1->s1 = b1;
+	t1->s2 = b2;
+}
+
+// Run the last tone alone, when the number of tones is odd.
+void AudioAnalyzeToneBank::goertzel(struct tone_state *t, const int16_t *p, uint32_t n)
+{
+	const int32_t coef = t->coef, shift = t->shift;
+	int32_t a1 = t->s1, a2 = t->s2;
+	int32_t a0;
+
+	do {
+		a0 = (*p++ >> shift) + multiply_32x32_rshift30(coef, a1) - a2;
+		a2 = a1;
+		a1 = a0;
+	} while (--n > 0);
+	t->s1 = a1;
+	t->s2 = a2;
+}
+
+void AudioAnalyzeToneBank::update(void)
+{
+	audio_block_t *block;
+	const int16_t *p, *end;
+	struct tone_state *t;
+	uint32_t i, n;
+
+	block = receiveReadOnly();
+	if (ntones == 0) {
+		if (block) release(block);
+		return;
+	}
+	p = block ? block->data : zerodata;
+	end = p + AUDIO_BLOCK_SAMPLES;
+	do {
+		n = end - p;
+		if (n > count) n = count;
+		for (i=0; i + 1 < ntones; i += 2) {
+			goertzel_pair(&tone[i], &tone[i + 1], p, n);
+		}
+		if (i < ntones) goertzel(&tone[i], p, n);
+		p += n;
+		count -= n;
+		if (count == 0) {
+			// the measurement is complete, compute each tone's power
+			for (i=0; i < ntones; i++) {
+				t = &tone[i];
+				int64_t power64 = (int64_t)t->s2 * (int64_t)t->s2;
+				power64 += (int64_t)t->s1 * (int64_t)t->s1;
+				power64 -= (int64_t)multiply_32x32_rshift30(t->coef, t->s1) * (int64_t)t->s2;
+				if (power64 < 0) power64 = 0;  // rounding, when no tone
+				power[i] = (float)power64 * t->scale;
+				t->s1 = 0;
+				t->s2 = 0;
+			}
+			if (dtmf_enable) decode_dtmf();
+			sequence++;
+			count = len;
+		}
+	} while (p < end);
+	if (block) release(block);
+}
+
+void AudioAnalyzeToneBank::decode_dtmf(void)
+{
+	uint32_t i, row, column;
+	float prow, pcol;
+	char key = 0;
+
+	row = 0;
+	for (i=1; i < 4; i++) {
+		if (power[i] > power[row]) row = i;
+	}
+	column = 4;
+	for (i=5; i < 8; i++) {
+		if (power[i] > power[column]) column = i;
+	}
+	prow = power[row];
+	pcol = power[column];
+	// both tones must be strong enough, the column tone may be up to
+	// 4 dB louder or 8 dB quieter, and all others must be 6 dB quieter
+	if (prow >= dtmf_threshold && pcol >= dtmf_threshold
+	  && pcol <= prow * 2.512f && pcol * 6.310f >= prow) {
+		key = dtmf_keys[row * 4 + column - 4];
+		for (i=0; i < 8; i++) {
+			if (i == row || i == column) continue;
+			if (power[i] * 3.981f > (i < 4 ? prow : pcol)) key = 0;
+		}
+	}
+	// report each key once, after it is seen in 2 measurements
+	if (key == 0) {
+		dtmf_reported = 0;
+	} else if (key == dtmf_previous && key != dtmf_reported) {
+		uint32_t h = (dtmf_head + 1) & 15;
+		if (h != dtmf_tail) {
+			dtmf_queue[dtmf_head] = key;
+			dtmf_head = h;
+		}
+		dtmf_reported = key;
+	}
+	dtmf_previous = key;
+}
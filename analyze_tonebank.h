@@ -0,0 +1,119 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef analyze_tonebank_h_
+#define analyze_tonebank_h_
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+// Detect up to 32 frequencies at once, using the Goertzel algorithm
+// like AudioAnalyzeToneDetect, but with all tones sharing the same
+// analysis length and a single pass over the incoming audio.
+#define TONEBANK_MAX_TONES 32
+
+class AudioAnalyzeToneBank : public AudioStream
+{
+public:
+	AudioAnalyzeToneBank(void) : AudioStream(1, inputQueueArray) {
+		memset(tone, 0, sizeof(tone));
+		memset(freqs, 0, sizeof(freqs));
+		memset((void *)power, 0, sizeof(power));
+		ntones = 0;
+		sequence = 0;
+		sequence_read = 0;
+		dtmf_enable = false;
+		dtmf_previous = 0;
+		dtmf_reported = 0;
+		dtmf_head = 0;
+		dtmf_tail = 0;
+		threshold(0.01f);
+		length(25.0f);
+	}
+	// number of milliseconds each measurement analyzes, for all tones
+	void length(float milliseconds);
+	// set the frequency detected by one tone, or 0 to remove it
+	void frequency(unsigned int index, float freq);
+	// configure tones 0 to 7 for DTMF, and begin decoding dial tones
+	void dtmf(void);
+	// minimum level of both DTMF tones, 0 to 1.0
+	void threshold(float level) {
+		if (level < 0.0f) level = 0.0f;
+		dtmf_threshold = level * level;
+	}
+	// true once each time all tones have new measurements
+	bool available(void) {
+		uint32_t n = sequence;
+		if (n == sequence_read) return false;
+		sequence_read = n;
+		return true;
+	}
+	// level of one tone, 0 to 1.0
+	float read(unsigned int index) {
+		if (index >= TONEBANK_MAX_TONES) return 0.0f;
+		return sqrtf(power[index]);
+	}
+	// next decoded dial tone key, or 0 if none
+	char readDTMF(void) {
+		uint32_t t = dtmf_tail;
+		if (t == dtmf_head) return 0;
+		char key = dtmf_queue[t];
+		dtmf_tail = (t + 1) & 15;
+		return key;
+	}
+	virtual void update(void);
+private:
+	struct tone_state {
+		int32_t coef;   // Goertzel algorithm coefficient, 2*cos(w)
+		int32_t s1;     // Goertzel algorithm state
+		int32_t s2;
+		int32_t shift;  // input headroom for low frequencies
+		float scale;    // converts state to level squared
+	};
+	void configure(unsigned int index);
+	void decode_dtmf(void);
+	static void goertzel_pair(struct tone_state *t0, struct tone_state *t1,
+		const int16_t *p, uint32_t n);
+	static void goertzel(struct tone_state *t, const int16_t *p, uint32_t n);
+	audio_block_t *inputQueueArray[1];
+	struct tone_state tone[TONEBANK_MAX_TONES];
+	float freqs[TONEBANK_MAX_TONES];
+	volatile float power[TONEBANK_MAX_TONES];
+	uint16_t len;
+	uint16_t count;
+	uint8_t ntones;
+	volatile uint32_t sequence;
+	uint32_t sequence_read;
+	bool dtmf_enable;
+	char dtmf_previous;
+	char dtmf_reported;
+	float dtmf_threshold;
+	char dtmf_queue[16];
+	volatile uint8_t dtmf_head;
+	volatile uint8_t dtmf_tail;
+};
+
+#endif
@@ -94,6 +94,8 @@ static const uint8_t default_config[] = {
 bool AudioControlCS42448::enable(void)
 {
 	Wire.begin();
+	shadow.clear();
+	deferred = false;
 	// TODO: wait for reset signal high??
 	if (!write(CS42448_Power_Control, 0xFF)) return false; // power down
 	if (!write(CS42448_Functional_Mode, default_config, sizeof(default_config))) return false;
@@ -148,26 +150,81 @@ bool AudioControlCS42448::invertADC(uint32_t data)
 	return write(CS42448_ADC_Channel_Invert, data); // these bits will invert the signal polarity of their respective ADC channels (1-6)
 }
 
+// The chip ID and status registers are never cached.  Writes to them
+// are sent in order, after any deferred writes.
+static bool cacheable(uint32_t address, uint32_t len)
+{
+	if (address < CS42448_Power_Control) return false;
+	if (address + len > CS42448_REGISTERS) return false;
+	if (address <= CS42448_Status && address + len > CS42448_Status) return false;
+	return true;
+}
+
 bool AudioControlCS42448::write(uint32_t address, uint32_t data)
 {
-	Wire.beginTransmission(i2c_addr);
-	Wire.write(address);
-	Wire.write(data);
-	if (Wire.endTransmission() == 0) return true;
-	return false;
+	uint8_t val = data;
+	return write(address, &val, 1);
 }
 
+// A block of registers is sent with auto increment, unless none of them
+// change.  Deferred, only the changed registers are queued.
 bool AudioControlCS42448::write(uint32_t address, const void *data, uint32_t len)
 {
-	Wire.beginTransmission(i2c_addr);
-	Wire.write(address | 0x80);
 	const uint8_t *p = (const uint8_t *)data;
-	const uint8_t *end = p + len;
-	while (p < end) {
-		Wire.write(*p++);
+	uint32_t i;
+
+	if (!cacheable(address, len)) {
+		if (shadow.pending() > 0) flush();
+		return i2c_write(address, p, len);
+	}
+	for (i=0; i < len; i++) {
+		if (!shadow.same(address + i, p[i])) break;
+	}
+	if (i >= len) return true;
+	if (deferred) {
+		for (i=0; i < len; i++) {
+			if (!shadow.same(address + i, p[i])) shadow.defer(address + i, p[i]);
+		}
+		return true;
+	}
+	if (!i2c_write(address, p, len)) {
+		for (i=0; i < len; i++) shadow.invalidate(address + i);
+		return false;
+	}
+	for (i=0; i < len; i++) shadow.set(address + i, p[i]);
+	return true;
+}
+
+void AudioControlCS42448::deferWrites(bool enable)
+{
+	if (!enable) flush();
+	deferred = enable;
+}
+
+unsigned int AudioControlCS42448::flush(unsigned int maxWrites)
+{
+	while (maxWrites > 0) {
+		int i = shadow.next();
+		if (i < 0) break;
+		uint8_t val = shadow.get(i);
+		if (!i2c_write(i, &val, 1)) {
+			shadow.retry(i); // try again next time
+			break;
+		}
+		maxWrites--;
+	}
+	return shadow.pending();
+}
+
+bool AudioControlCS42448::i2c_write(uint32_t address, const uint8_t *data, uint32_t len)
+{
+	Wire.beginTransmission(i2c_addr);
+	Wire.write((len > 1) ? (address | 0x80) : address);
+	const uint8_t *end = data + len;
+	while (data < end) {
+		Wire.write(*data++);
 	}
 	if (Wire.endTransmission() == 0) return true;
 	return false;
 }
 
-
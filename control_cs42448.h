@@ -28,12 +28,15 @@
 #define control_cs42448_h_
 
 #include "AudioControl.h"
+#include "utility/register_shadow.h"
 #include <math.h>
 
+#define CS42448_REGISTERS 0x1C // 0x00 to 0x1B
+
 class AudioControlCS42448 : public AudioControl
 {
 public:
-	AudioControlCS42448(void) : i2c_addr(0x48), muted(true) { }
+	AudioControlCS42448(void) : i2c_addr(0x48), muted(true), deferred(false) { }
 	void setAddress(uint8_t addr) {
 		i2c_addr = 0x48 | (addr & 3);
 	}
@@ -61,6 +64,12 @@ public:
 	bool filterFreeze(void);
 	bool invertDAC(uint32_t data);
 	bool invertADC(uint32_t data);
+	// Normally every change is sent to the chip before returning.  With
+	// deferred writes, changes are queued and sent by flush(), which can
+	// be called from loop() to send only a few at a time.
+	void deferWrites(bool enable);
+	unsigned int flush(unsigned int maxWrites = CS42448_REGISTERS);
+	unsigned int pendingWrites(void) { return shadow.pending(); }
 
 private:
 	bool volumeInteger(uint32_t n);
@@ -81,8 +90,11 @@ private:
 	}
 	bool write(uint32_t address, uint32_t data);
 	bool write(uint32_t address, const void *data, uint32_t len);
+	bool i2c_write(uint32_t address, const uint8_t *data, uint32_t len);
 	uint8_t i2c_addr;
 	bool muted;
+	RegisterShadow<CS42448_REGISTERS> shadow;
+	bool deferred;
 };
 
 #endif
@@ -507,6 +507,7 @@ void AudioControlSGTL5000::setAddress(uint8_t level)
 	} else {
 		i2c_addr = SGTL5000_I2C_ADDR_CS_HIGH;
 	}
+	shadow.clear();
 }
 
 bool AudioControlSGTL5000::enable(void) {
@@ -522,6 +523,8 @@ bool AudioControlSGTL5000::enable(const unsigned extMCLK, const uint32_t pllFreq
 
 	Wire.begin();
 	delay(5);
+	shadow.clear();
+	deferred = false;
 	
 	//Check if we are in Master Mode and if the Teensy had a reset:
 	unsigned int n = read(CHIP_I2S_CTRL);
@@ -592,22 +595,81 @@ bool AudioControlSGTL5000::enable(const unsigned extMCLK, const uint32_t pllFreq
 }
 
 
+// Registers which change by themselves, or act as commands, are never
+// cached.  Commands are sent in order, after any deferred writes.
+static bool cacheable(unsigned int reg)
+{
+	if (reg >= SGTL5000_REGISTERS * 2 || (reg & 1)) return false;
+	if (reg == CHIP_ANA_STATUS || reg == CHIP_ANA_TEST1 || reg == CHIP_ANA_TEST2) return false;
+	if (reg == DAP_FILTER_COEF_ACCESS) return false;
+	return true;
+}
+
 unsigned int AudioControlSGTL5000::read(unsigned int reg)
 {
 	unsigned int val;
-	Wire.beginTransmission(i2c_addr);
-	Wire.write(reg >> 8);
-	Wire.write(reg);
-	if (Wire.endTransmission(false) != 0) return 0;
-	if (Wire.requestFrom((int)i2c_addr, 2) < 2) return 0;
-	val = Wire.read() << 8;
-	val |= Wire.read();
+	bool cache = cacheable(reg);
+	if (cache && shadow.cached(reg >> 1)) return shadow.get(reg >> 1);
+	if (!i2c_read(reg, &val)) return 0;
+	if (cache) shadow.set(reg >> 1, val);
 	return val;
 }
 
 bool AudioControlSGTL5000::write(unsigned int reg, unsigned int val)
 {
 	if (reg == CHIP_ANA_CTRL) ana_ctrl = val;
+	if (!cacheable(reg)) {
+		if (shadow.pending() > 0) flush();
+		return i2c_write(reg, val);
+	}
+	unsigned int i = reg >> 1;
+	if (shadow.same(i, val)) return true;
+	if (deferred) {
+		shadow.defer(i, val);
+		return true;
+	}
+	if (!i2c_write(reg, val)) {
+		shadow.invalidate(i);
+		return false;
+	}
+	shadow.set(i, val);
+	return true;
+}
+
+void AudioControlSGTL5000::deferWrites(bool enable)
+{
+	if (!enable) flush();
+	deferred = enable;
+}
+
+unsigned int AudioControlSGTL5000::flush(unsigned int maxWrites)
+{
+	while (maxWrites > 0) {
+		int i = shadow.next();
+		if (i < 0) break;
+		if (!i2c_write(i << 1, shadow.get(i))) {
+			shadow.retry(i); // try again next time
+			break;
+		}
+		maxWrites--;
+	}
+	return shadow.pending();
+}
+
+bool AudioControlSGTL5000::i2c_read(unsigned int reg, unsigned int *val)
+{
+	Wire.beginTransmission(i2c_addr);
+	Wire.write(reg >> 8);
+	Wire.write(reg);
+	if (Wire.endTransmission(false) != 0) return false;
+	if (Wire.requestFrom((int)i2c_addr, 2) < 2) return false;
+	*val = Wire.read() << 8;
+	*val |= Wire.read();
+	return true;
+}
+
+bool AudioControlSGTL5000::i2c_write(unsigned int reg, unsigned int val)
+{
 	Wire.beginTransmission(i2c_addr);
 	Wire.write(reg >> 8);
 	Wire.write(reg);
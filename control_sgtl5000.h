@@ -29,15 +29,18 @@
 
 #include <AudioStream.h>
 #include "AudioControl.h"
+#include "utility/register_shadow.h"
 
 // SGTL5000-specific defines for headphones
 #define AUDIO_HEADPHONE_DAC 0
 #define AUDIO_HEADPHONE_LINEIN 1
 
+#define SGTL5000_REGISTERS 158 // 0x0000 to 0x013A, even addresses only
+
 class AudioControlSGTL5000 : public AudioControl
 {
 public:
-	AudioControlSGTL5000(void) : i2c_addr(0x0A) { }
+	AudioControlSGTL5000(void) : i2c_addr(0x0A), deferred(false) { }
 	void setAddress(uint8_t level);
 	bool enable(void);//For Teensy LC the SGTL acts as master, for all other Teensys as slave.
 	bool enable(const unsigned extMCLK, const uint32_t pllFreq = (4096.0l * AUDIO_SAMPLE_RATE_EXACT) ); //With extMCLK > 0, the SGTL acts as Master
@@ -106,6 +109,12 @@ public:
 	unsigned short surroundSoundDisable(void);
 	void killAutomation(void) { semi_automated=false; }
 	void setMasterMode(uint32_t freqMCLK_in);
+	// Normally every change is sent to the chip before returning.  With
+	// deferred writes, changes are queued and sent by flush(), which can
+	// be called from loop() to send only a few at a time.
+	void deferWrites(bool enable);
+	unsigned int flush(unsigned int maxWrites = SGTL5000_REGISTERS);
+	unsigned int pendingWrites(void) { return shadow.pending(); }
 
 protected:
 	bool muted;
@@ -116,6 +125,10 @@ protected:
 	unsigned int read(unsigned int reg);
 	bool write(unsigned int reg, unsigned int val);
 	unsigned int modify(unsigned int reg, unsigned int val, unsigned int iMask);
+	bool i2c_read(unsigned int reg, unsigned int *val);
+	bool i2c_write(unsigned int reg, unsigned int val);
+	RegisterShadow<SGTL5000_REGISTERS> shadow;
+	bool deferred;
 	unsigned short dap_audio_eq_band(uint8_t bandNum, float n);
 private:
 	bool semi_automated;
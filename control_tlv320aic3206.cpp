@@ -151,6 +151,9 @@ bool AudioControlTLV320AIC3206::enable(void)
   digitalWrite(RESET_PIN,HIGH);delay(50); //not reset
   digitalWrite(RESET_PIN,LOW);delay(50);  //reset
   digitalWrite(RESET_PIN,HIGH);delay(50);//not reset
+  shadow.clear();
+  curPage = -1;
+  deferred = false;
 	
   aic_reset(); delay(100);  //soft reset
   aic_init(); delay(100);
@@ -486,9 +489,25 @@ void AudioControlTLV320AIC3206::aic_init() {
   // aic_writePage(0, 28, 0); // 0x1C
 }
 
+// Pages 0 and 1 are cached, except the page select, the soft reset and the
+// registers which report status.  Other pages, such as the filter
+// coefficients, are sent in order after any deferred writes.
+static bool cacheable(uint8_t page, uint8_t reg)
+{
+  if (page > 1 || reg == 0 || reg >= 128) return false;
+  if (page == 0) {
+    if (reg == 1) return false;  //soft reset
+    if (reg >= 36 && reg <= 47) return false;  //flags, sticky flags, interrupt flags
+    if (reg == 67) return false;  //headset detect, the detected type is read only
+  }
+  return true;
+}
+
 unsigned int AudioControlTLV320AIC3206::aic_readPage(uint8_t page, uint8_t reg)
 {
   unsigned int val;
+  bool cache = cacheable(page, reg);
+  if (cache && shadow.cached(page * 128 + reg)) return shadow.get(page * 128 + reg);
   if (aic_goToPage(page)) {
     Wire.beginTransmission(AIC3206_I2C_ADDR);
     Wire.write(reg);
@@ -516,6 +535,7 @@ unsigned int AudioControlTLV320AIC3206::aic_readPage(uint8_t page, uint8_t reg)
 		Serial.print(".  Received: ");
 		Serial.println(val, HEX);
 	  }
+      if (cache) shadow.set(page * 128 + reg, val);
       return val;
     }
   } else {
@@ -542,6 +562,50 @@ bool AudioControlTLV320AIC3206::aic_writePage(uint8_t page, uint8_t reg, uint8_t
 	Serial.print(" Reg: ");Serial.print(reg);
 	Serial.print(" Val: ");Serial.println(val);
   }
+  if (!cacheable(page, reg)) {
+    if (shadow.pending() > 0) flush();
+    bool ok = i2c_write(page, reg, val);
+    if (reg == 0) curPage = -1;  //page select
+    if (page == 0 && reg == 1) {
+      //soft reset, every register and the page return to their defaults
+      shadow.clear();
+      curPage = -1;
+    }
+    return ok;
+  }
+  int i = page * 128 + reg;
+  if (shadow.same(i, val)) return true;
+  if (deferred) {
+    shadow.defer(i, val);
+    return true;
+  }
+  if (!i2c_write(page, reg, val)) {
+    shadow.invalidate(i);
+    return false;
+  }
+  shadow.set(i, val);
+  return true;
+}
+
+void AudioControlTLV320AIC3206::deferWrites(bool enable) {
+  if (!enable) flush();
+  deferred = enable;
+}
+
+unsigned int AudioControlTLV320AIC3206::flush(unsigned int maxWrites) {
+  while (maxWrites > 0) {
+    int i = shadow.next();
+    if (i < 0) break;
+    if (!i2c_write(i >> 7, i & 127, shadow.get(i))) {
+      shadow.retry(i); // try again next time
+      break;
+    }
+    maxWrites--;
+  }
+  return shadow.pending();
+}
+
+bool AudioControlTLV320AIC3206::i2c_write(uint8_t page, uint8_t reg, uint8_t val) {
   if (aic_goToPage(page)) {
     Wire.beginTransmission(AIC3206_I2C_ADDR);
     Wire.write(reg);delay(10);
@@ -557,6 +621,8 @@ bool AudioControlTLV320AIC3206::aic_writePage(uint8_t page, uint8_t reg, uint8_t
 }
 
 bool AudioControlTLV320AIC3206::aic_goToPage(byte page) {
+  if (page == curPage) return true;  //already there, no I2C needed
+  curPage = -1;
   Wire.beginTransmission(AIC3206_I2C_ADDR);
   Wire.write(0x00); delay(10);// page register  //was delay(10) from BPF
   Wire.write(page); delay(10);// go to page   //was delay(10) from BPF
@@ -573,6 +639,7 @@ bool AudioControlTLV320AIC3206::aic_goToPage(byte page) {
     }
     return false;
   }
+  curPage = page;
   return true;
 }
 
@@ -55,6 +55,7 @@
 #define control_tlv320aic3206_h_
 
 #include "AudioControl.h"
+#include "utility/register_shadow.h"
 #include <Arduino.h>
 
 //convenience names to use with inputSelect() to set whnch analog inputs to use
@@ -108,6 +109,12 @@ class AudioControlTLV320AIC3206: public AudioControl
 		float getSampleRate_Hz(void) { return sample_rate_Hz; }
 		void setIIRCoeffOnADC(int chan, uint32_t *coeff);  //for chan, use AIC3206_BOTH_CHAN or AIC3206_LEFT_CHAN or AIC3206_RIGHT_CHAN
 		bool enableAutoMuteDAC(bool, uint8_t);
+		// Normally every change is sent to the chip before returning.  With
+		// deferred writes, changes are queued and sent by flush(), which can
+		// be called from loop() to send only a few at a time.
+		void deferWrites(bool enable);
+		unsigned int flush(unsigned int maxWrites = 10);
+		unsigned int pendingWrites(void) { return shadow.pending(); }
 	private:
 	  void aic_reset(void);
 	  void aic_init(void);
@@ -116,6 +123,10 @@ class AudioControlTLV320AIC3206: public AudioControl
 
 	  bool aic_writeAddress(uint16_t address, uint8_t val);
 	  bool aic_goToPage(uint8_t page);
+	  bool i2c_write(uint8_t page, uint8_t reg, uint8_t val);
+	  RegisterShadow<256> shadow;  //pages 0 and 1
+	  bool deferred = false;
+	  int curPage = -1;  //the chip's page register, or -1 if not known
 	  int prevMicDetVal = -1;
 	  int resetPinAIC = 21;  //AIC reset pin, Tympan Rev C
 	  float HP_cutoff_Hz = 0.0f;
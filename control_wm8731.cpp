@@ -47,6 +47,8 @@ bool AudioControlWM8731::enable(void)
 {
 	Wire.begin();
 	delay(5);
+	shadow.clear();
+	deferred = false;
 #if 1
 	if (!write(WM8731_REG_RESET, 0)) {
 		return false; // no WM8731 chip responding
@@ -84,6 +86,72 @@ bool AudioControlWM8731::enable(void)
 //   https://forum.pjrc.com/threads/55334?p=201494&viewfull=1#post201494
 
 bool AudioControlWM8731::write(unsigned int reg, unsigned int val)
+{
+	if (reg > WM8731_REG_ACTIVE) {
+		// reset is a command, sent in order after deferred writes
+		if (shadow.pending() > 0) flush();
+		shadow.clear();
+		return i2c_write(reg, val);
+	}
+	if ((reg == WM8731_REG_LLINEIN || reg == WM8731_REG_LHEADOUT) && (val & 0x100)) {
+		// the chip also copies this setting to the right channel, which
+		// keeps its own both bit
+		unsigned int both = (shadow.get(reg + 1) & 0x100) | (val & 0xFF);
+		if (shadow.same(reg, val) && shadow.same(reg + 1, both)) return true;
+		if (deferred && shadow.cached(reg + 1)) {
+			// queue the right channel after this, so it is still right
+			// if this write is replaced by one without the both bit, or
+			// the right channel was already queued before this
+			shadow.defer(reg, val);
+			shadow.defer(reg + 1, both);
+			shadow.requeue(reg + 1);
+			return true;
+		}
+		// otherwise send it now, after anything already queued
+		if (shadow.pending() > 0 && flush() > 0) return false;
+		if (!i2c_write(reg, val)) {
+			shadow.invalidate(reg);
+			shadow.invalidate(reg + 1);
+			return false;
+		}
+		shadow.set(reg, val);
+		if (shadow.cached(reg + 1)) shadow.set(reg + 1, both);
+		return true;
+	}
+	if (shadow.same(reg, val)) return true;
+	if (deferred) {
+		shadow.defer(reg, val);
+		return true;
+	}
+	if (!i2c_write(reg, val)) {
+		shadow.invalidate(reg);
+		return false;
+	}
+	shadow.set(reg, val);
+	return true;
+}
+
+void AudioControlWM8731::deferWrites(bool enable)
+{
+	if (!enable) flush();
+	deferred = enable;
+}
+
+unsigned int AudioControlWM8731::flush(unsigned int maxWrites)
+{
+	while (maxWrites > 0) {
+		int i = shadow.next();
+		if (i < 0) break;
+		if (!i2c_write(i, shadow.get(i))) {
+			shadow.retry(i); // try again next time
+			break;
+		}
+		maxWrites--;
+	}
+	return shadow.pending();
+}
+
+bool AudioControlWM8731::i2c_write(unsigned int reg, unsigned int val)
 {
 	int attempt=0;
 	while (1) {
@@ -148,6 +216,8 @@ bool AudioControlWM8731master::enable(void)
 {
 	Wire.begin();
 	delay(5);
+	shadow.clear();
+	deferred = false;
 	//write(WM8731_REG_RESET, 0);
 
 	write(WM8731_REG_INTERFACE, 0x42); // I2S, 16 bit, MCLK master
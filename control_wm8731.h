@@ -28,6 +28,7 @@
 #define control_wm8731_h_
 
 #include "AudioControl.h"
+#include "utility/register_shadow.h"
 
 class AudioControlWM8731 : public AudioControl
 {
@@ -37,9 +38,18 @@ public:
 	bool volume(float n) { return volumeInteger(n * 80.0f + 47.499f); }
 	bool inputLevel(float n); // range: 0.0f to 1.0f
 	bool inputSelect(int n);
+	// Normally every change is sent to the chip before returning.  With
+	// deferred writes, changes are queued and sent by flush(), which can
+	// be called from loop() to send only a few at a time.
+	void deferWrites(bool enable);
+	unsigned int flush(unsigned int maxWrites = 10);
+	unsigned int pendingWrites(void) { return shadow.pending(); }
 protected:
 	bool write(unsigned int reg, unsigned int val);
+	bool i2c_write(unsigned int reg, unsigned int val);
 	bool volumeInteger(unsigned int n); // range: 0x2F to 0x7F
+	RegisterShadow<10> shadow;
+	bool deferred = false;
 };
 
 class AudioControlWM8731master : public AudioControlWM8731
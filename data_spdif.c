@@ -25,9 +25,9 @@
  */
  
 #include <stdint.h>
+#include "utility/spdif_encode.h"
 
-const __attribute__((aligned(32)))
-uint16_t spdif_bmclookup[256] = { //biphase mark encoded values (least significant bit first)
+const uint16_t spdif_bmclookup[256] __attribute__((aligned(32))) = { //biphase mark encoded values (least significant bit first)
 	0xcccc, 0x4ccc, 0x2ccc, 0xaccc, 0x34cc, 0xb4cc, 0xd4cc, 0x54cc,
 	0x32cc, 0xb2cc, 0xd2cc, 0x52cc, 0xcacc, 0x4acc, 0x2acc, 0xaacc,
 	0x334c, 0xb34c, 0xd34c, 0x534c, 0xcb4c, 0x4b4c, 0x2b4c, 0xab4c,
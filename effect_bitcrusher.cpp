@@ -58,36 +58,19 @@ void AudioEffectBitcrusher::update(void)
 			// fills with zeroes.
 		 	block->data[i] = sampleSquidge << (16-crushBits);
 		}
-	} else if (crushBits == 16) { //bitcrusher not being used, samplerate mods only.
-		i=0;
-		while (i < AUDIO_BLOCK_SAMPLES) {
-			// save the root sample. this will pick up a root
-			// sample every _sampleStep_ samples.
-			sampleSqueeze = block->data[i];
-			for (int j = 0; j < sampleStep && i < AUDIO_BLOCK_SAMPLES; j++) {
- 				// for each repeated sample, paste in the current
-				// root sample, then move onto the next step.
-				block->data[i] = sampleSqueeze;
-				i++;
-			}
-		}
-	} else {           //both being used. crush those bits and mash those samples.
-		i=0;
-		while (i < AUDIO_BLOCK_SAMPLES) {
-			// save the root sample. this will pick up a root sample
-			// every _sampleStep_ samples.
-			sampleSqueeze = block->data[i];
-			for (int j = 0; j < sampleStep && i < AUDIO_BLOCK_SAMPLES; j++) {
- 				// shift bits right to cut off fine detail sampleSquidge
-				// is a uint32 so sign extension will not occur, fills
-				// with zeroes.
+	} else {
+		// crush the bits (if used) of a root sample picked up every
+		// _sampleStep_ samples, and repeat it until the next one.  The
+		// count carries over to the next block, so the steps are the
+		// same at any block size.
+		for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			if (holdCount == 0) {
+				sampleSqueeze = block->data[i];
 				sampleSquidge = sampleSqueeze >> (16-crushBits);
- 				// shift bits left again to regain the volume level.
-				// fills with zeroes. paste into buffer sample +
-				// sampleStep offset.
-				block->data[i] = sampleSquidge << (16-crushBits);
-				i++;
+				holdSample = sampleSquidge << (16-crushBits);
 			}
+			block->data[i] = holdSample;
+			if (++holdCount >= sampleStep) holdCount = 0;
 		}
 	}
 	transmit(block);
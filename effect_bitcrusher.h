@@ -35,7 +35,7 @@ class AudioEffectBitcrusher : public AudioStream
 {
 public:
 	AudioEffectBitcrusher(void)
-	  : AudioStream(1, inputQueueArray) {}
+	  : AudioStream(1, inputQueueArray), holdCount(0), holdSample(0) {}
 	void bits(uint8_t b) {
 		if (b > 16) b = 16;
 		else if (b == 0) b = 1;
@@ -52,6 +52,8 @@ public:
 private:
 	uint8_t crushBits; // 16 = off
 	uint8_t sampleStep; // the number of samples to double up. This simple technique only allows a few stepped positions.
+	uint8_t holdCount; // samples of holdSample already output
+	int16_t holdSample;
 	audio_block_t *inputQueueArray[1];
 };
 
@@ -30,7 +30,7 @@
 void AudioEffectDelay::update(void)
 {
 	audio_block_t *output;
-	uint32_t head, tail, count, channel, index, prev, offset;
+	uint32_t head, tail, count, keep, channel, index, prev, offset;
 	const int16_t *src, *end;
 	int16_t *dst;
 
@@ -39,11 +39,16 @@ void AudioEffectDelay::update(void)
 	tail = tailindex;
 	if (++head >= DELAY_QUEUE_SIZE) head = 0;
 	if (head == tail) {
-		if (queue[tail] != NULL) release(queue[tail]);
+		if (queue[tail] != NULL) {
+			release(queue[tail]);
+			queue[tail] = NULL;
+			blockcount--;
+		}
 		if (++tail >= DELAY_QUEUE_SIZE) tail = 0;
 	}
 	queue[head] = receiveReadOnly();
 	headindex = head;
+	if (queue[head] != NULL) blockcount++;
 
 	// testing only.... don't allow null pointers into the queue
 	// instead, fill the empty times with blocks of zeros
@@ -62,23 +67,28 @@ void AudioEffectDelay::update(void)
 	//	}
 	//}
 
-	// discard unneeded blocks from the queue
+	// discard unneeded blocks from the queue, keeping only the
+	// maxblocks newest, tail through head (at least the head block)
 	if (head >= tail) {
 		count = head - tail;
 	} else {
 		count = DELAY_QUEUE_SIZE + head - tail;
 	}
-	if (count > maxblocks) {
-		count -= maxblocks;
+	keep = maxblocks ? maxblocks : 1;
+	if (count >= keep) {
+		count -= keep - 1;
 		do {
 			if (queue[tail] != NULL) {
 				release(queue[tail]);
 				queue[tail] = NULL;
+				blockcount--;
 			}
 			if (++tail >= DELAY_QUEUE_SIZE) tail = 0;
 		} while (--count > 0);
 	}
 	tailindex = tail;
+	// the most held from one update to the next
+	if (blockcount > blockcount_max) blockcount_max = blockcount;
 
 	// transmit the delayed outputs using queue data
 	for (channel = 0; channel < 8; channel++) {
@@ -98,7 +108,10 @@ void AudioEffectDelay::update(void)
 		} else {
 			// delay requires grabbing data from 2 blocks
 			output = allocate();
-			if (!output) continue;
+			if (!output) {
+				dropped++;
+				continue;
+			}
 			dst = output->data;
 			if (index > 0) {
 				prev = index - 1;
@@ -55,13 +55,17 @@ public:
 		headindex = 0;
 		tailindex = 0;
 		maxblocks = 0;
+		queuelimit = DELAY_QUEUE_SIZE;
+		blockcount = 0;
+		blockcount_max = 0;
+		dropped = 0;
 		memset(queue, 0, sizeof(queue));
 	}
 	void delay(uint8_t channel, float milliseconds) {
 		if (channel >= 8) return;
 		if (milliseconds < 0.0f) milliseconds = 0.0f;
 		uint32_t n = (milliseconds*(AUDIO_SAMPLE_RATE_EXACT/1000.0f))+0.5f;
-		uint32_t nmax = AUDIO_BLOCK_SAMPLES * (DELAY_QUEUE_SIZE-1);
+		uint32_t nmax = AUDIO_BLOCK_SAMPLES * (queuelimit-1);
 		if (n > nmax) n = nmax;
 		uint32_t blks = (n + (AUDIO_BLOCK_SAMPLES-1)) / AUDIO_BLOCK_SAMPLES + 1;
 		if (!(activemask & (1<<channel))) {
@@ -88,6 +92,24 @@ public:
 		// recompute maxblocks for remaining enabled channels
 		recompute_maxblocks();
 	}
+	// limit the number of audio blocks this delay may hold, which
+	// also limits the longest delay to (blocks - 1) blocks of samples
+	void setMaxBlocks(uint32_t blocks) {
+		if (blocks < 2) blocks = 2;
+		if (blocks > DELAY_QUEUE_SIZE) blocks = DELAY_QUEUE_SIZE;
+		__disable_irq();
+		queuelimit = blocks;
+		uint32_t nmax = AUDIO_BLOCK_SAMPLES * (blocks-1);
+		for (int i=0; i < 8; i++) {
+			if (position[i] > nmax) position[i] = nmax;
+		}
+		recompute_maxblocks();
+		__enable_irq();
+	}
+	uint32_t memoryUsage(void) { return blockcount; }
+	uint32_t memoryUsageMax(void) { return blockcount_max; }
+	void memoryUsageMaxReset(void) { blockcount_max = blockcount; }
+	uint32_t droppedBlocks(void) { return dropped; }
 	virtual void update(void);
 private:
 	void recompute_maxblocks(void) {
@@ -106,6 +128,10 @@ private:
 	uint16_t headindex;    // head index (incoming) data in quueu
 	uint16_t tailindex;    // tail index (outgoing) data from queue
 	uint16_t maxblocks;    // number of blocks needed in queue
+	uint16_t queuelimit;   // most blocks the queue may use
+	uint16_t blockcount;   // audio blocks currently held in queue
+	uint16_t blockcount_max;
+	uint32_t dropped;      // outputs not sent because allocate() failed
 #if DELAY_QUEUE_SIZE * AUDIO_BLOCK_SAMPLES < 65535
 	uint16_t position[8]; // # of sample delay for each channel
 #else
@@ -0,0 +1,304 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+#include "effect_distortion.h"
+
+// Polyphase lowpass filters for each oversampling factor, with 24 taps
+// per phase.  Kaiser windowed sinc, flat to 0.4 and at least 71 dB
+// down above 0.6 of the original sample rate.
+static const float oversample2_coeffs[48] = {
+	-5.681231060e-05, -1.371956603e-04, 2.635207930e-04, 4.501852644e-04,
+	-7.139367573e-04, -1.074002010e-03, 1.552261106e-03, 2.173519552e-03,
+	-2.965958156e-03, -3.961882982e-03, 5.198965540e-03, 6.722277581e-03,
+	-8.587625910e-03, -1.086706413e-02, 1.365818010e-02, 1.710024391e-02,
+	-2.140357085e-02, -2.690625372e-02, 3.419298613e-02, 4.437240821e-02,
+	-5.982980806e-02, -8.678587969e-02, 1.480893355e-01, 4.495161066e-01,
+	4.495161066e-01, 1.480893355e-01, -8.678587969e-02, -5.982980806e-02,
+	4.437240821e-02, 3.419298613e-02, -2.690625372e-02, -2.140357085e-02,
+	1.710024391e-02, 1.365818010e-02, -1.086706413e-02, -8.587625910e-03,
+	6.722277581e-03, 5.198965540e-03, -3.961882982e-03, -2.965958156e-03,
+	2.173519552e-03, 1.552261106e-03, -1.074002010e-03, -7.139367573e-04,
+	4.501852644e-04, 2.635207930e-04, -1.371956603e-04, -5.681231060e-05,
+};
+static const float oversample4_coeffs[96] = {
+	-1.521173813e-05, -5.924572256e-05, -8.799887531e-05, -5.135279816e-05,
+	6.969483460e-05, 2.220115911e-04, 2.864955580e-04, 1.503852312e-04,
+	-1.877044748e-04, -5.583315080e-04, -6.802285683e-04, -3.399053915e-04,
+	4.064779353e-04, 1.164374555e-03, 1.371867171e-03, 6.652497806e-04,
+	-7.743083296e-04, -2.164320845e-03, -2.493761532e-03, -1.184932319e-03,
+	1.353798527e-03, 3.720405603e-03, 4.220816336e-03, 1.977480793e-03,
+	-2.230619418e-03, -6.059982599e-03, -6.805111078e-03, -3.159784331e-03,
+	3.537011365e-03, 9.548367164e-03, 1.066975711e-02, 4.937437382e-03,
+	-5.517406179e-03, -1.489704410e-02, -1.668529456e-02, -7.758567818e-03,
+	8.738101920e-03, 2.386545575e-02, 2.716238255e-02, 1.290952363e-02,
+	-1.497535268e-02, -4.257147023e-02, -5.119261648e-02, -2.629355485e-02,
+	3.419782915e-02, 1.165870935e-01, 1.954319182e-01, 2.435501708e-01,
+	2.435501708e-01, 1.954319182e-01, 1.165870935e-01, 3.419782915e-02,
+	-2.629355485e-02, -5.119261648e-02, -4.257147023e-02, -1.497535268e-02,
+	1.290952363e-02, 2.716238255e-02, 2.386545575e-02, 8.738101920e-03,
+	-7.758567818e-03, -1.668529456e-02, -1.489704410e-02, -5.517406179e-03,
+	4.937437382e-03, 1.066975711e-02, 9.548367164e-03, 3.537011365e-03,
+	-3.159784331e-03, -6.805111078e-03, -6.059982599e-03, -2.230619418e-03,
+	1.977480793e-03, 4.220816336e-03, 3.720405603e-03, 1.353798527e-03,
+	-1.184932319e-03, -2.493761532e-03, -2.164320845e-03, -7.743083296e-04,
+	6.652497806e-04, 1.371867171e-03, 1.164374555e-03, 4.064779353e-04,
+	-3.399053915e-04, -6.802285683e-04, -5.583315080e-04, -1.877044748e-04,
+	1.503852312e-04, 2.864955580e-04, 2.220115911e-04, 6.969483460e-05,
+	-5.135279816e-05, -8.799887531e-05, -5.924572256e-05, -1.521173813e-05,
+};
+static const float oversample8_coeffs[192] = {
+	-3.857175796e-06, -1.411936274e-05, -2.646087697e-05, -3.831231509e-05,
+	-4.628767340e-05, -4.680023043e-05, -3.689421503e-05, -1.514532538e-05,
+	1.756506717e-05, 5.761047978e-05, 9.869193304e-05, 1.325229993e-04,
+	1.501135414e-04, 1.435051562e-04, 1.076842780e-04, 4.230628950e-05,
+	-4.716847005e-05, -1.492808973e-04, -2.475491016e-04, -3.226459226e-04,
+	-3.555729490e-04, -3.313894553e-04, -2.428659937e-04, -9.333700145e-05,
+	1.019415214e-04, 3.164506731e-04, 5.153035759e-04, 6.602048818e-04,
+	7.158834206e-04, 6.570349805e-04, 4.745667129e-04, 1.798799975e-04,
+	-1.938977287e-04, -5.944201633e-04, -9.564702906e-04, -1.211564395e-03,
+	-1.299552037e-03, -1.180415124e-03, -8.441863554e-04, -3.169629050e-04,
+	3.385817244e-04, 1.029016364e-03, 1.642116162e-03, 2.063678444e-03,
+	2.196880451e-03, 1.981135401e-03, 1.407115684e-03, 5.248728446e-04,
+	-5.571893028e-04, -1.683419785e-03, -2.671410873e-03, -3.339491577e-03,
+	-3.537372101e-03, -3.175113060e-03, -2.245334754e-03, -8.341586394e-04,
+	8.822256118e-04, 2.656400382e-03, 4.202535539e-03, 5.239264680e-03,
+	5.536621719e-03, 4.959733635e-03, 3.501735822e-03, 1.299362761e-03,
+	-1.373178087e-03, -4.133359650e-03, -6.540233784e-03, -8.159223805e-03,
+	-8.632990588e-03, -7.747710593e-03, -5.483782006e-03, -2.041352903e-03,
+	2.165931182e-03, 6.551269476e-03, 1.042642677e-02, 1.309709198e-02,
+	1.396986480e-02, 1.265605984e-02, 9.056713587e-03, 3.414632884e-03,
+	-3.677029947e-03, -1.131475036e-02, -1.837168285e-02, -2.362356209e-02,
+	-2.589922469e-02, -2.423718557e-02, -1.802773634e-02, -7.120829799e-03,
+	8.116416676e-03, 2.680281461e-02, 4.760942224e-02, 6.888349050e-02,
+	8.881670495e-02, 1.056382239e-01, 1.178093001e-01, 1.241955730e-01,
+	1.241955730e-01, 1.178093001e-01, 1.056382239e-01, 8.881670495e-02,
+	6.888349050e-02, 4.760942224e-02, 2.680281461e-02, 8.116416676e-03,
+	-7.120829799e-03, -1.802773634e-02, -2.423718557e-02, -2.589922469e-02,
+	-2.362356209e-02, -1.837168285e-02, -1.131475036e-02, -3.677029947e-03,
+	3.414632884e-03, 9.056713587e-03, 1.265605984e-02, 1.396986480e-02,
+	1.309709198e-02, 1.042642677e-02, 6.551269476e-03, 2.165931182e-03,
+	-2.041352903e-03, -5.483782006e-03, -7.747710593e-03, -8.632990588e-03,
+	-8.159223805e-03, -6.540233784e-03, -4.133359650e-03, -1.373178087e-03,
+	1.299362761e-03, 3.501735822e-03, 4.959733635e-03, 5.536621719e-03,
+	5.239264680e-03, 4.202535539e-03, 2.656400382e-03, 8.822256118e-04,
+	-8.341586394e-04, -2.245334754e-03, -3.175113060e-03, -3.537372101e-03,
+	-3.339491577e-03, -2.671410873e-03, -1.683419785e-03, -5.571893028e-04,
+	5.248728446e-04, 1.407115684e-03, 1.981135401e-03, 2.196880451e-03,
+	2.063678444e-03, 1.642116162e-03, 1.029016364e-03, 3.385817244e-04,
+	-3.169629050e-04, -8.441863554e-04, -1.180415124e-03, -1.299552037e-03,
+	-1.211564395e-03, -9.564702906e-04, -5.944201633e-04, -1.938977287e-04,
+	1.798799975e-04, 4.745667129e-04, 6.570349805e-04, 7.158834206e-04,
+	6.602048818e-04, 5.153035759e-04, 3.164506731e-04, 1.019415214e-04,
+	-9.333700145e-05, -2.428659937e-04, -3.313894553e-04, -3.555729490e-04,
+	-3.226459226e-04, -2.475491016e-04, -1.492808973e-04, -4.716847005e-05,
+	4.230628950e-05, 1.076842780e-04, 1.435051562e-04, 1.501135414e-04,
+	1.325229993e-04, 9.869193304e-05, 5.761047978e-05, 1.756506717e-05,
+	-1.514532538e-05, -3.689421503e-05, -4.680023043e-05, -4.628767340e-05,
+	-3.831231509e-05, -2.646087697e-05, -1.411936274e-05, -3.857175796e-06,
+};
+
+// below this input change, ADAA uses the curve's midpoint instead,
+// avoiding float precision loss when dividing tiny differences
+#define ADAA_MIN_DIFFERENCE  (1.0f / 1024.0f)
+
+AudioEffectDistortion::~AudioEffectDistortion()
+{
+	if (table) delete [] table;
+}
+
+void AudioEffectDistortion::settable(float *newtable, int length)
+{
+	float *oldtable;
+	float *newintegral = newtable + length;
+	uint32_t n = length - 1;
+	float h = 2.0f / (float)n;
+
+	// integrate the piecewise linear curve outward from x = 0
+	newintegral[n/2] = 0.0f;
+	for (uint32_t i = n/2; i < n; i++) {
+		newintegral[i + 1] = newintegral[i] + (newtable[i] + newtable[i + 1]) * 0.5f * h;
+	}
+	for (uint32_t i = n/2; i > 0; i--) {
+		newintegral[i - 1] = newintegral[i] - (newtable[i] + newtable[i - 1]) * 0.5f * h;
+	}
+	__disable_irq();
+	oldtable = table;
+	table = newtable;
+	integral = newintegral;
+	segments = n;
+	xprev = 0.0f;
+	Fprev = 0.0f;
+	__enable_irq();
+	if (oldtable) delete [] oldtable;
+}
+
+void AudioEffectDistortion::shape(const float *waveshape, int length)
+{
+	// length must be bigger than 2 and equal to a power of two + 1
+	if (!waveshape || length < 3 || length > 4097 || ((length - 1) & (length - 2))) return;
+	float *newtable = new float[length * 2];
+	if (!newtable) return;
+	for (int i = 0; i < length; i++) {
+		newtable[i] = waveshape[i];
+	}
+	settable(newtable, length);
+}
+
+void AudioEffectDistortion::polynomial(const float *coefficients, int count)
+{
+	if (!coefficients || count < 1) return;
+	const int length = 1025;
+	float *newtable = new float[length * 2];
+	if (!newtable) return;
+	for (int i = 0; i < length; i++) {
+		float x = (float)i * (2.0f / (float)(length - 1)) - 1.0f;
+		float y = 0.0f;
+		for (int k = count - 1; k >= 0; k--) {
+			y = y * x + coefficients[k];
+		}
+		newtable[i] = y;
+	}
+	settable(newtable, length);
+}
+
+void AudioEffectDistortion::oversample(int n)
+{
+	__disable_irq();
+	setfactor(n);
+	__enable_irq();
+}
+
+void AudioEffectDistortion::setfactor(int n)
+{
+	const float *coeffs;
+	int taps;
+
+	if (n >= 8) {
+		n = 8;
+		coeffs = oversample8_coeffs;
+		taps = 192;
+	} else if (n >= 4) {
+		n = 4;
+		coeffs = oversample4_coeffs;
+		taps = 96;
+	} else if (n >= 2) {
+		n = 2;
+		coeffs = oversample2_coeffs;
+		taps = 48;
+	} else {
+		factor = 1;
+		return;
+	}
+	arm_fir_interpolate_init_f32(&interpolation, n, taps,
+		(float32_t *)coeffs, interpolation_state, DISTORTION_CHUNK);
+	arm_fir_decimate_init_f32(&decimation, taps, n,
+		(float32_t *)coeffs, decimation_state, DISTORTION_CHUNK * n);
+	factor = n;
+}
+
+// the curve, with linear interpolation between table points
+inline float AudioEffectDistortion::lookup(float x)
+{
+	float pos = (x + 1.0f) * (float)segments * 0.5f;
+	if (pos <= 0.0f) return table[0];
+	if (pos >= (float)segments) return table[segments];
+	uint32_t i = pos;
+	float frac = pos - (float)i;
+	return table[i] + (table[i + 1] - table[i]) * frac;
+}
+
+// integral of the curve, which continues at its end values beyond +/-1.0
+inline float AudioEffectDistortion::antiderivative(float x)
+{
+	float pos = (x + 1.0f) * (float)segments * 0.5f;
+	float h = 2.0f / (float)segments;
+	if (pos <= 0.0f) return integral[0] + table[0] * (x + 1.0f);
+	if (pos >= (float)segments) return integral[segments] + table[segments] * (x - 1.0f);
+	uint32_t i = pos;
+	float t = pos - (float)i;
+	return integral[i] + h * t * (table[i] + (table[i + 1] - table[i]) * t * 0.5f);
+}
+
+// first order ADAA: the average of the curve between the previous and
+// current input, which suppresses the aliasing of sharp corners
+inline float AudioEffectDistortion::shaper(float x)
+{
+	if (!adaa_enable) return lookup(x);
+	float F = antiderivative(x);
+	float diff = x - xprev;
+	float y;
+	if (fabsf(diff) > ADAA_MIN_DIFFERENCE) {
+		y = (F - Fprev) / diff;
+	} else {
+		y = lookup((x + xprev) * 0.5f);
+	}
+	xprev = x;
+	Fprev = F;
+	return y;
+}
+
+void AudioEffectDistortion::update(void)
+{
+	audio_block_t *block;
+	float in[DISTORTION_CHUNK];
+	float os[DISTORTION_CHUNK * DISTORTION_MAX_OVERSAMPLE];
+	float out[DISTORTION_CHUNK];
+	int i, j, n;
+
+	if (!table) return;
+	block = receiveWritable();
+	if (!block) return;
+
+	n = factor;
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i += DISTORTION_CHUNK) {
+		int16_t *data = block->data + i;
+		if (n == 1) {
+			for (j=0; j < DISTORTION_CHUNK; j++) {
+				out[j] = shaper(data[j] * gain * (1.0f / 32768.0f));
+			}
+		} else {
+			// the interpolator inserts zeros, so gain by the factor
+			float scale = gain * (float)n / 32768.0f;
+			for (j=0; j < DISTORTION_CHUNK; j++) {
+				in[j] = data[j] * scale;
+			}
+			arm_fir_interpolate_f32(&interpolation, in, os, DISTORTION_CHUNK);
+			for (j=0; j < DISTORTION_CHUNK * n; j++) {
+				os[j] = shaper(os[j]);
+			}
+			arm_fir_decimate_f32(&decimation, os, out, DISTORTION_CHUNK * n);
+		}
+		for (j=0; j < DISTORTION_CHUNK; j++) {
+			float y = out[j] * 32768.0f;
+			if (y > 32767.0f) y = 32767.0f;
+			if (y < -32768.0f) y = -32768.0f;
+			data[j] = y;
+		}
+	}
+	transmit(block);
+	release(block);
+}
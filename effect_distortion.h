@@ -0,0 +1,101 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef effect_distortion_h_
+#define effect_distortion_h_
+
+#include "Arduino.h"
+#include "AudioStream.h"
+#include "arm_math.h"
+
+// Waveshaping distortion with 2x, 4x or 8x oversampling, and optional
+// antiderivative anti-aliasing (ADAA), so hard curves do not alias.
+// Oversampling uses the same CMSIS polyphase FIR interpolation and
+// decimation as AudioFilterLadder.
+#if AUDIO_BLOCK_SAMPLES < 32
+#define DISTORTION_CHUNK AUDIO_BLOCK_SAMPLES  // input samples per FIR call
+#else
+#define DISTORTION_CHUNK 32
+#endif
+#define DISTORTION_MAX_OVERSAMPLE 8
+#define DISTORTION_MAX_TAPS 192
+
+class AudioEffectDistortion : public AudioStream
+{
+public:
+	AudioEffectDistortion(void) : AudioStream(1, inputQueueArray) {
+		table = NULL;
+		integral = NULL;
+		segments = 0;
+		gain = 1.0f;
+		adaa_enable = false;
+		xprev = 0.0f;
+		Fprev = 0.0f;
+		setfactor(2);
+	}
+	~AudioEffectDistortion();
+	// Use a curve from -1.0 to +1.0, like AudioEffectWaveshaper.
+	// length must be a power of two + 1, from 3 to 4097.
+	void shape(const float *waveshape, int length);
+	// Use a polynomial, y = c[0] + c[1]*x + c[2]*x^2 ..., which is
+	// computed into a table of 1025 points
+	void polynomial(const float *coefficients, int count);
+	// Oversampling factor: 1 (none), 2, 4 or 8
+	void oversample(int factor);
+	// Antiderivative anti-aliasing, useful with less oversampling
+	void adaa(bool enable) {
+		__disable_irq();
+		adaa_enable = enable;
+		__enable_irq();
+	}
+	// Gain before the curve, to drive the signal harder
+	void drive(float n) {
+		if (n < 0.0f) n = 0.0f;
+		gain = n;
+	}
+	virtual void update(void);
+private:
+	void setfactor(int n);
+	void settable(float *newtable, int length);
+	float lookup(float x);
+	float antiderivative(float x);
+	float shaper(float x);
+	float *table;     // curve, from x = -1.0 to +1.0
+	float *integral;  // antiderivative of curve, 0 at x = 0
+	uint32_t segments;
+	float gain;
+	bool adaa_enable;
+	float xprev;
+	float Fprev;
+	int factor;
+	arm_fir_interpolate_instance_f32 interpolation;
+	arm_fir_decimate_instance_f32 decimation;
+	float interpolation_state[DISTORTION_CHUNK - 1 + DISTORTION_MAX_TAPS / DISTORTION_MAX_OVERSAMPLE];
+	float decimation_state[DISTORTION_CHUNK * DISTORTION_MAX_OVERSAMPLE - 1 + DISTORTION_MAX_TAPS];
+	audio_block_t *inputQueueArray[1];
+};
+
+#endif
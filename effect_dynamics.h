@@ -43,6 +43,9 @@
 #define RATIO_OFF		1.0f
 #define RATIO_INFINITY	60.0f
 
+// Fast log2, also used by AudioEffectMultibandCompressor
+float log2f_approx(float X);
+
 class AudioEffectDynamics : public AudioStream
 {
 public:
@@ -187,11 +190,13 @@ private:
 		}
 	}
 	
-	//Computes smoothing time constants for a 10% to 90% change
+	//Computes smoothing time constants for a 10% to 90% change,
+	//applied once per sample by update()
 	float timeToAlpha(float time) {
-		return expf(-0.9542f / (((float)AUDIO_SAMPLE_RATE_EXACT / (float)AUDIO_BLOCK_SAMPLES) * time));
+		return expf(-0.9542f / ((float)AUDIO_SAMPLE_RATE_EXACT * time));
 	}
-	
+
+protected:
 	virtual void update(void);
 };
 #endif
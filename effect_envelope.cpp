@@ -84,9 +84,13 @@ void AudioEffectEnvelope::update(void)
 		}
 		p = (uint32_t *)(block->data);
 	}
-	else
+	else {
+		// without input, idle and sustain have no state to advance,
+		// so there is nothing to compute until noteOn or noteOff
+		if (state == STATE_IDLE || state == STATE_SUSTAIN) return;
 		p = NULL;
-	
+	}
+
 	end = p + AUDIO_BLOCK_SAMPLES/2;
 
 	// need to run the envelope process even with silent data, or
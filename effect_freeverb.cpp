@@ -95,37 +95,8 @@ static int16_t sat16(int32_t n, int rshift) {
 }
 
 // TODO: move this to one of the data files, use in output_adat.cpp, output_tdm.cpp, etc
-static const audio_block_t zeroblock = {
-0, 0, 0, {
-0, 0, 0, 0,
-#if AUDIO_BLOCK_SAMPLES > 4
-0, 0, 0, 0,
-#endif
-#if AUDIO_BLOCK_SAMPLES > 8
-0, 0, 0, 0, 0, 0, 0, 0,
-#endif
-#if AUDIO_BLOCK_SAMPLES > 16
-0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-#endif
-#if AUDIO_BLOCK_SAMPLES > 32
-0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-#endif
-#if AUDIO_BLOCK_SAMPLES > 48
-0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-#endif
-#if AUDIO_BLOCK_SAMPLES > 64
-0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-#endif
-#if AUDIO_BLOCK_SAMPLES > 80
-0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-#endif
-#if AUDIO_BLOCK_SAMPLES > 96
-0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-#endif
-#if AUDIO_BLOCK_SAMPLES > 112
-0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-#endif
-} };
+// (the data array is zero filled for any AUDIO_BLOCK_SAMPLES)
+static const audio_block_t zeroblock = { 0, 0, 0, { 0 } };
 
 void AudioEffectFreeverb::update()
 {
@@ -236,84 +207,139 @@ void AudioEffectFreeverb::update()
 
 AudioEffectFreeverbStereo::AudioEffectFreeverbStereo() : AudioStream(1, inputQueueArray)
 {
-	memset(comb1bufL, 0, sizeof(comb1bufL));
-	memset(comb2bufL, 0, sizeof(comb2bufL));
-	memset(comb3bufL, 0, sizeof(comb3bufL));
-	memset(comb4bufL, 0, sizeof(comb4bufL));
-	memset(comb5bufL, 0, sizeof(comb5bufL));
-	memset(comb6bufL, 0, sizeof(comb6bufL));
-	memset(comb7bufL, 0, sizeof(comb7bufL));
-	memset(comb8bufL, 0, sizeof(comb8bufL));
-	comb1indexL = 0;
-	comb2indexL = 0;
-	comb3indexL = 0;
-	comb4indexL = 0;
-	comb5indexL = 0;
-	comb6indexL = 0;
-	comb7indexL = 0;
-	comb8indexL = 0;
-	comb1filterL = 0;
-	comb2filterL = 0;
-	comb3filterL = 0;
-	comb4filterL = 0;
-	comb5filterL = 0;
-	comb6filterL = 0;
-	comb7filterL = 0;
-	comb8filterL = 0;
-	memset(comb1bufR, 0, sizeof(comb1bufR));
-	memset(comb2bufR, 0, sizeof(comb2bufR));
-	memset(comb3bufR, 0, sizeof(comb3bufR));
-	memset(comb4bufR, 0, sizeof(comb4bufR));
-	memset(comb5bufR, 0, sizeof(comb5bufR));
-	memset(comb6bufR, 0, sizeof(comb6bufR));
-	memset(comb7bufR, 0, sizeof(comb7bufR));
-	memset(comb8bufR, 0, sizeof(comb8bufR));
-	comb1indexR = 0;
-	comb2indexR = 0;
-	comb3indexR = 0;
-	comb4indexR = 0;
-	comb5indexR = 0;
-	comb6indexR = 0;
-	comb7indexR = 0;
-	comb8indexR = 0;
-	comb1filterR = 0;
-	comb2filterR = 0;
-	comb3filterR = 0;
-	comb4filterR = 0;
-	comb5filterR = 0;
-	comb6filterR = 0;
-	comb7filterR = 0;
-	comb8filterR = 0;
+	memset(comb1buf, 0, sizeof(comb1buf));
+	memset(comb2buf, 0, sizeof(comb2buf));
+	memset(comb3buf, 0, sizeof(comb3buf));
+	memset(comb4buf, 0, sizeof(comb4buf));
+	memset(comb5buf, 0, sizeof(comb5buf));
+	memset(comb6buf, 0, sizeof(comb6buf));
+	memset(comb7buf, 0, sizeof(comb7buf));
+	memset(comb8buf, 0, sizeof(comb8buf));
+	comb1index = 0;
+	comb2index = 0;
+	comb3index = 0;
+	comb4index = 0;
+	comb5index = 0;
+	comb6index = 0;
+	comb7index = 0;
+	comb8index = 0;
+	comb1filter = 0;
+	comb2filter = 0;
+	comb3filter = 0;
+	comb4filter = 0;
+	comb5filter = 0;
+	comb6filter = 0;
+	comb7filter = 0;
+	comb8filter = 0;
 	combdamp1 = 6553;
 	combdamp2 = 26215;
 	combfeeback = 27524;
-	memset(allpass1bufL, 0, sizeof(allpass1bufL));
-	memset(allpass2bufL, 0, sizeof(allpass2bufL));
-	memset(allpass3bufL, 0, sizeof(allpass3bufL));
-	memset(allpass4bufL, 0, sizeof(allpass4bufL));
-	allpass1indexL = 0;
-	allpass2indexL = 0;
-	allpass3indexL = 0;
-	allpass4indexL = 0;
-	memset(allpass1bufR, 0, sizeof(allpass1bufR));
-	memset(allpass2bufR, 0, sizeof(allpass2bufR));
-	memset(allpass3bufR, 0, sizeof(allpass3bufR));
-	memset(allpass4bufR, 0, sizeof(allpass4bufR));
-	allpass1indexR = 0;
-	allpass2indexR = 0;
-	allpass3indexR = 0;
-	allpass4indexR = 0;
+	memset(allpass1buf, 0, sizeof(allpass1buf));
+	memset(allpass2buf, 0, sizeof(allpass2buf));
+	memset(allpass3buf, 0, sizeof(allpass3buf));
+	memset(allpass4buf, 0, sizeof(allpass4buf));
+	allpass1index = 0;
+	allpass2index = 0;
+	allpass3index = 0;
+	allpass4index = 0;
 }
 
-void AudioEffectFreeverbStereo::update()
+#if !defined(KINETISL)
+
+// left channel buffers are this many samples shorter than right
+#define STEREO_SPREAD 23
+
+// Run one comb filter over a whole block, for both channels at once.
+// Each buffer word holds left (low half) and right (high half).  Right
+// reads the oldest word, left reads the word STEREO_SPREAD newer.
+static void comb_stereo(uint32_t *buf, uint32_t len, uint16_t *indexptr,
+	uint32_t *filterptr, const uint32_t *input, int32_t *sumL, int32_t *sumR,
+	uint32_t damp, int32_t feedback)
+{
+	uint32_t index = *indexptr;
+	uint32_t indexL = index + STEREO_SPREAD;
+	uint32_t filter = *filterptr;
+	if (indexL >= len) indexL -= len;
+
+	for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		uint32_t bufR = buf[index];
+		uint32_t bufL = buf[indexL];
+		sumL[i] += (int16_t)bufL;
+		sumR[i] += (int32_t)bufR >> 16;
+		// filter = bufout * damp2 + filter * damp1, as 2 dual multiplies
+#if defined(__ARM_ARCH_7EM__)
+		int32_t filterL = sat16(multiply_16tx16t_add_16bx16b(
+			pack_16b_16b(filter, bufL), damp), 15);
+		int32_t filterR = sat16(multiply_16tx16t_add_16bx16b(
+			pack_16t_16t(filter, bufR), damp), 15);
+		filter = pack_16b_16b(filterR, filterL);
+		buf[index] = signed_add_16_and_16(pack_16b_16b(
+			sat16(filterR * feedback, 15),
+			sat16(filterL * feedback, 15)), input[i]);
+#else
+		int32_t damp1 = (int32_t)damp >> 16;
+		int32_t damp2 = (int16_t)damp;
+		int32_t filterL = sat16((int16_t)bufL * damp2 + (int16_t)filter * damp1, 15);
+		int32_t filterR = sat16(((int32_t)bufR >> 16) * damp2 + ((int32_t)filter >> 16) * damp1, 15);
+		filter = ((uint32_t)filterR << 16) | (filterL & 0xFFFF);
+		int32_t in = (int16_t)input[i];
+		int32_t outL = sat16(in + sat16(filterL * feedback, 15), 0);
+		int32_t outR = sat16(in + sat16(filterR * feedback, 15), 0);
+		buf[index] = ((uint32_t)outR << 16) | (outL & 0xFFFF);
+#endif
+		if (++index >= len) index = 0;
+		if (++indexL >= len) indexL = 0;
+	}
+	*indexptr = index;
+	*filterptr = filter;
+}
+
+// Run one allpass filter over a whole block, for both channels at once.
+static void allpass_stereo(uint32_t *buf, uint32_t len, uint16_t *indexptr,
+	int16_t *outL, int16_t *outR)
 {
+	uint32_t index = *indexptr;
+	uint32_t indexL = index + STEREO_SPREAD;
+	if (indexL >= len) indexL -= len;
+
+	for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		int32_t bufoutL = (int16_t)buf[indexL];
+		int32_t bufoutR = (int32_t)buf[index] >> 16;
+		int32_t outputL = outL[i];
+		int32_t outputR = outR[i];
 #if defined(__ARM_ARCH_7EM__)
+		buf[index] = pack_16b_16b(outputR + (bufoutR >> 1), outputL + (bufoutL >> 1));
+#else
+		buf[index] = ((uint32_t)(outputR + (bufoutR >> 1)) << 16)
+			| ((outputL + (bufoutL >> 1)) & 0xFFFF);
+#endif
+		outL[i] = sat16(bufoutL - outputL, 1);
+		outR[i] = sat16(bufoutR - outputR, 1);
+		if (++index >= len) index = 0;
+		if (++indexL >= len) indexL = 0;
+	}
+	*indexptr = index;
+}
+
+#define COMB_STEREO(n) comb_stereo(comb##n##buf, sizeof(comb##n##buf)/sizeof(uint32_t), \
+	&comb##n##index, &comb##n##filter, input, sumL, sumR, damp, feedback)
+#define ALLPASS_STEREO(n) allpass_stereo(allpass##n##buf, sizeof(allpass##n##buf)/sizeof(uint32_t), \
+	&allpass##n##index, outL, outR)
+
+#endif
+
+void AudioEffectFreeverbStereo::update()
+{
+#if !defined(KINETISL)
 	const audio_block_t *block;
 	audio_block_t *outblockL;
 	audio_block_t *outblockR;
+	uint32_t input[AUDIO_BLOCK_SAMPLES];
+	int32_t sumL[AUDIO_BLOCK_SAMPLES];
+	int32_t sumR[AUDIO_BLOCK_SAMPLES];
+	int16_t outL[AUDIO_BLOCK_SAMPLES];
+	int16_t outR[AUDIO_BLOCK_SAMPLES];
 	int i;
-	int16_t input, bufout, outputL, outputR;
-	int32_t sum;
 
 	block = receiveReadOnly(0);
 	outblockL = allocate();
@@ -326,168 +352,52 @@ void AudioEffectFreeverbStereo::update()
 	}
 	if (!block) block = &zeroblock;
 
+	__disable_irq();
+	const uint32_t damp = ((uint32_t)combdamp1 << 16) | (uint16_t)combdamp2;
+	const int32_t feedback = combfeeback;
+	__enable_irq();
+
 	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
 		// TODO: scale numerical range depending on roomsize & damping
-		input = sat16(block->data[i] * 8738, 17); // for numerical headroom
-		sum = 0;
-
-		bufout = comb1bufL[comb1indexL];
-		sum += bufout;
-		comb1filterL = sat16(bufout * combdamp2 + comb1filterL * combdamp1, 15);
-		comb1bufL[comb1indexL] = sat16(input + sat16(comb1filterL * combfeeback, 15), 0);
-		if (++comb1indexL >= sizeof(comb1bufL)/sizeof(int16_t)) comb1indexL = 0;
-
-		bufout = comb2bufL[comb2indexL];
-		sum += bufout;
-		comb2filterL = sat16(bufout * combdamp2 + comb2filterL * combdamp1, 15);
-		comb2bufL[comb2indexL] = sat16(input + sat16(comb2filterL * combfeeback, 15), 0);
-		if (++comb2indexL >= sizeof(comb2bufL)/sizeof(int16_t)) comb2indexL = 0;
-
-		bufout = comb3bufL[comb3indexL];
-		sum += bufout;
-		comb3filterL = sat16(bufout * combdamp2 + comb3filterL * combdamp1, 15);
-		comb3bufL[comb3indexL] = sat16(input + sat16(comb3filterL * combfeeback, 15), 0);
-		if (++comb3indexL >= sizeof(comb3bufL)/sizeof(int16_t)) comb3indexL = 0;
-
-		bufout = comb4bufL[comb4indexL];
-		sum += bufout;
-		comb4filterL = sat16(bufout * combdamp2 + comb4filterL * combdamp1, 15);
-		comb4bufL[comb4indexL] = sat16(input + sat16(comb4filterL * combfeeback, 15), 0);
-		if (++comb4indexL >= sizeof(comb4bufL)/sizeof(int16_t)) comb4indexL = 0;
-
-		bufout = comb5bufL[comb5indexL];
-		sum += bufout;
-		comb5filterL = sat16(bufout * combdamp2 + comb5filterL * combdamp1, 15);
-		comb5bufL[comb5indexL] = sat16(input + sat16(comb5filterL * combfeeback, 15), 0);
-		if (++comb5indexL >= sizeof(comb5bufL)/sizeof(int16_t)) comb5indexL = 0;
-
-		bufout = comb6bufL[comb6indexL];
-		sum += bufout;
-		comb6filterL = sat16(bufout * combdamp2 + comb6filterL * combdamp1, 15);
-		comb6bufL[comb6indexL] = sat16(input + sat16(comb6filterL * combfeeback, 15), 0);
-		if (++comb6indexL >= sizeof(comb6bufL)/sizeof(int16_t)) comb6indexL = 0;
-
-		bufout = comb7bufL[comb7indexL];
-		sum += bufout;
-		comb7filterL = sat16(bufout * combdamp2 + comb7filterL * combdamp1, 15);
-		comb7bufL[comb7indexL] = sat16(input + sat16(comb7filterL * combfeeback, 15), 0);
-		if (++comb7indexL >= sizeof(comb7bufL)/sizeof(int16_t)) comb7indexL = 0;
-
-		bufout = comb8bufL[comb8indexL];
-		sum += bufout;
-		comb8filterL = sat16(bufout * combdamp2 + comb8filterL * combdamp1, 15);
-		comb8bufL[comb8indexL] = sat16(input + sat16(comb8filterL * combfeeback, 15), 0);
-		if (++comb8indexL >= sizeof(comb8bufL)/sizeof(int16_t)) comb8indexL = 0;
-
-		outputL = sat16(sum * 31457, 17);
-		sum = 0;
-
-		bufout = comb1bufR[comb1indexR];
-		sum += bufout;
-		comb1filterR = sat16(bufout * combdamp2 + comb1filterR * combdamp1, 15);
-		comb1bufR[comb1indexR] = sat16(input + sat16(comb1filterR * combfeeback, 15), 0);
-		if (++comb1indexR >= sizeof(comb1bufR)/sizeof(int16_t)) comb1indexR = 0;
-
-		bufout = comb2bufR[comb2indexR];
-		sum += bufout;
-		comb2filterR = sat16(bufout * combdamp2 + comb2filterR * combdamp1, 15);
-		comb2bufR[comb2indexR] = sat16(input + sat16(comb2filterR * combfeeback, 15), 0);
-		if (++comb2indexR >= sizeof(comb2bufR)/sizeof(int16_t)) comb2indexR = 0;
-
-		bufout = comb3bufR[comb3indexR];
-		sum += bufout;
-		comb3filterR = sat16(bufout * combdamp2 + comb3filterR * combdamp1, 15);
-		comb3bufR[comb3indexR] = sat16(input + sat16(comb3filterR * combfeeback, 15), 0);
-		if (++comb3indexR >= sizeof(comb3bufR)/sizeof(int16_t)) comb3indexR = 0;
-
-		bufout = comb4bufR[comb4indexR];
-		sum += bufout;
-		comb4filterR = sat16(bufout * combdamp2 + comb4filterR * combdamp1, 15);
-		comb4bufR[comb4indexR] = sat16(input + sat16(comb4filterR * combfeeback, 15), 0);
-		if (++comb4indexR >= sizeof(comb4bufR)/sizeof(int16_t)) comb4indexR = 0;
+		int32_t in = sat16(block->data[i] * 8738, 17); // for numerical headroom
+		input[i] = ((uint32_t)in << 16) | (in & 0xFFFF);
+		sumL[i] = 0;
+		sumR[i] = 0;
+	}
+	if (block != &zeroblock) release((audio_block_t *)block);
 
-		bufout = comb5bufR[comb5indexR];
-		sum += bufout;
-		comb5filterR = sat16(bufout * combdamp2 + comb5filterR * combdamp1, 15);
-		comb5bufR[comb5indexR] = sat16(input + sat16(comb5filterR * combfeeback, 15), 0);
-		if (++comb5indexR >= sizeof(comb5bufR)/sizeof(int16_t)) comb5indexR = 0;
+	COMB_STEREO(1);
+	COMB_STEREO(2);
+	COMB_STEREO(3);
+	COMB_STEREO(4);
+	COMB_STEREO(5);
+	COMB_STEREO(6);
+	COMB_STEREO(7);
+	COMB_STEREO(8);
 
-		bufout = comb6bufR[comb6indexR];
-		sum += bufout;
-		comb6filterR = sat16(bufout * combdamp2 + comb6filterR * combdamp1, 15);
-		comb6bufR[comb6indexR] = sat16(input + sat16(comb6filterR * combfeeback, 15), 0);
-		if (++comb6indexR >= sizeof(comb6bufR)/sizeof(int16_t)) comb6indexR = 0;
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		outL[i] = sat16(sumL[i] * 31457, 17);
+		outR[i] = sat16(sumR[i] * 31457, 17);
+	}
 
-		bufout = comb7bufR[comb7indexR];
-		sum += bufout;
-		comb7filterR = sat16(bufout * combdamp2 + comb7filterR * combdamp1, 15);
-		comb7bufR[comb7indexR] = sat16(input + sat16(comb7filterR * combfeeback, 15), 0);
-		if (++comb7indexR >= sizeof(comb7bufR)/sizeof(int16_t)) comb7indexR = 0;
+	ALLPASS_STEREO(1);
+	ALLPASS_STEREO(2);
+	ALLPASS_STEREO(3);
+	ALLPASS_STEREO(4);
 
-		bufout = comb8bufR[comb8indexR];
-		sum += bufout;
-		comb8filterR = sat16(bufout * combdamp2 + comb8filterR * combdamp1, 15);
-		comb8bufR[comb8indexR] = sat16(input + sat16(comb8filterR * combfeeback, 15), 0);
-		if (++comb8indexR >= sizeof(comb8bufR)/sizeof(int16_t)) comb8indexR = 0;
-
-		outputR = sat16(sum * 31457, 17);
-
-		bufout = allpass1bufL[allpass1indexL];
-		allpass1bufL[allpass1indexL] = outputL + (bufout >> 1);
-		outputL = sat16(bufout - outputL, 1);
-		if (++allpass1indexL >= sizeof(allpass1bufL)/sizeof(int16_t)) allpass1indexL = 0;
-
-		bufout = allpass2bufL[allpass2indexL];
-		allpass2bufL[allpass2indexL] = outputL + (bufout >> 1);
-		outputL = sat16(bufout - outputL, 1);
-		if (++allpass2indexL >= sizeof(allpass2bufL)/sizeof(int16_t)) allpass2indexL = 0;
-
-		bufout = allpass3bufL[allpass3indexL];
-		allpass3bufL[allpass3indexL] = outputL + (bufout >> 1);
-		outputL = sat16(bufout - outputL, 1);
-		if (++allpass3indexL >= sizeof(allpass3bufL)/sizeof(int16_t)) allpass3indexL = 0;
-
-		bufout = allpass4bufL[allpass4indexL];
-		allpass4bufL[allpass4indexL] = outputL + (bufout >> 1);
-		outputL = sat16(bufout - outputL, 1);
-		if (++allpass4indexL >= sizeof(allpass4bufL)/sizeof(int16_t)) allpass4indexL = 0;
-
-		outblockL->data[i] = sat16(outputL * 30, 0);
-
-		bufout = allpass1bufR[allpass1indexR];
-		allpass1bufR[allpass1indexR] = outputR + (bufout >> 1);
-		outputR = sat16(bufout - outputR, 1);
-		if (++allpass1indexR >= sizeof(allpass1bufR)/sizeof(int16_t)) allpass1indexR = 0;
-
-		bufout = allpass2bufR[allpass2indexR];
-		allpass2bufR[allpass2indexR] = outputR + (bufout >> 1);
-		outputR = sat16(bufout - outputR, 1);
-		if (++allpass2indexR >= sizeof(allpass2bufR)/sizeof(int16_t)) allpass2indexR = 0;
-
-		bufout = allpass3bufR[allpass3indexR];
-		allpass3bufR[allpass3indexR] = outputR + (bufout >> 1);
-		outputR = sat16(bufout - outputR, 1);
-		if (++allpass3indexR >= sizeof(allpass3bufR)/sizeof(int16_t)) allpass3indexR = 0;
-
-		bufout = allpass4bufR[allpass4indexR];
-		allpass4bufR[allpass4indexR] = outputR + (bufout >> 1);
-		outputR = sat16(bufout - outputR, 1);
-		if (++allpass4indexR >= sizeof(allpass4bufR)/sizeof(int16_t)) allpass4indexR = 0;
-
-		outblockR->data[i] = sat16(outputR * 30, 0);
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		outblockL->data[i] = sat16(outL[i] * 30, 0);
+		outblockR->data[i] = sat16(outR[i] * 30, 0);
 	}
 	transmit(outblockL, 0);
 	transmit(outblockR, 1);
 	release(outblockL);
 	release(outblockR);
-	if (block != &zeroblock) release((audio_block_t *)block);
 
-#elif defined(KINETISL)
+#else
 	audio_block_t *block;
 	block = receiveReadOnly(0);
 	if (block) release(block);
 #endif
 }
 
-
-
@@ -44,6 +44,7 @@ public:
 		else if (n < 0.0f) n = 0.0f;
 		int x1 = (int)(n * 13107.2f);
 		int x2 = 32768 - x1;
+		if (x2 > 32767) x2 = 32767; // damping(0) must fit int16_t
 		__disable_irq();
 		combdamp1 = x1;
 		combdamp2 = x2;
@@ -104,80 +105,53 @@ public:
 		else if (n < 0.0f) n = 0.0f;
 		int x1 = (int)(n * 13107.2f);
 		int x2 = 32768 - x1;
+		if (x2 > 32767) x2 = 32767; // damping(0) must fit int16_t
 		__disable_irq();
 		combdamp1 = x1;
 		combdamp2 = x2;
 		__enable_irq();
 	}
 private:
+	// Left and right share each buffer, packed as 2 samples per word,
+	// with left in the low half.  Right uses the full buffer length
+	// and left is 23 samples shorter, for the usual stereo spread.
+	// Both channels are updated together in one pass.
 	audio_block_t *inputQueueArray[1];
-	int16_t comb1bufL[1116];
-	int16_t comb2bufL[1188];
-	int16_t comb3bufL[1277];
-	int16_t comb4bufL[1356];
-	int16_t comb5bufL[1422];
-	int16_t comb6bufL[1491];
-	int16_t comb7bufL[1557];
-	int16_t comb8bufL[1617];
-	uint16_t comb1indexL;
-	uint16_t comb2indexL;
-	uint16_t comb3indexL;
-	uint16_t comb4indexL;
-	uint16_t comb5indexL;
-	uint16_t comb6indexL;
-	uint16_t comb7indexL;
-	uint16_t comb8indexL;
-	int16_t comb1filterL;
-	int16_t comb2filterL;
-	int16_t comb3filterL;
-	int16_t comb4filterL;
-	int16_t comb5filterL;
-	int16_t comb6filterL;
-	int16_t comb7filterL;
-	int16_t comb8filterL;
-	int16_t comb1bufR[1139];
-	int16_t comb2bufR[1211];
-	int16_t comb3bufR[1300];
-	int16_t comb4bufR[1379];
-	int16_t comb5bufR[1445];
-	int16_t comb6bufR[1514];
-	int16_t comb7bufR[1580];
-	int16_t comb8bufR[1640];
-	uint16_t comb1indexR;
-	uint16_t comb2indexR;
-	uint16_t comb3indexR;
-	uint16_t comb4indexR;
-	uint16_t comb5indexR;
-	uint16_t comb6indexR;
-	uint16_t comb7indexR;
-	uint16_t comb8indexR;
-	int16_t comb1filterR;
-	int16_t comb2filterR;
-	int16_t comb3filterR;
-	int16_t comb4filterR;
-	int16_t comb5filterR;
-	int16_t comb6filterR;
-	int16_t comb7filterR;
-	int16_t comb8filterR;
+	uint32_t comb1buf[1139];
+	uint32_t comb2buf[1211];
+	uint32_t comb3buf[1300];
+	uint32_t comb4buf[1379];
+	uint32_t comb5buf[1445];
+	uint32_t comb6buf[1514];
+	uint32_t comb7buf[1580];
+	uint32_t comb8buf[1640];
+	uint16_t comb1index;
+	uint16_t comb2index;
+	uint16_t comb3index;
+	uint16_t comb4index;
+	uint16_t comb5index;
+	uint16_t comb6index;
+	uint16_t comb7index;
+	uint16_t comb8index;
+	uint32_t comb1filter;
+	uint32_t comb2filter;
+	uint32_t comb3filter;
+	uint32_t comb4filter;
+	uint32_t comb5filter;
+	uint32_t comb6filter;
+	uint32_t comb7filter;
+	uint32_t comb8filter;
 	int16_t combdamp1;
 	int16_t combdamp2;
 	int16_t combfeeback;
-	int16_t allpass1bufL[556];
-	int16_t allpass2bufL[441];
-	int16_t allpass3bufL[341];
-	int16_t allpass4bufL[225];
-	uint16_t allpass1indexL;
-	uint16_t allpass2indexL;
-	uint16_t allpass3indexL;
-	uint16_t allpass4indexL;
-	int16_t allpass1bufR[579];
-	int16_t allpass2bufR[464];
-	int16_t allpass3bufR[364];
-	int16_t allpass4bufR[248];
-	uint16_t allpass1indexR;
-	uint16_t allpass2indexR;
-	uint16_t allpass3indexR;
-	uint16_t allpass4indexR;
+	uint32_t allpass1buf[579];
+	uint32_t allpass2buf[464];
+	uint32_t allpass3buf[364];
+	uint32_t allpass4buf[248];
+	uint16_t allpass1index;
+	uint16_t allpass2index;
+	uint16_t allpass3index;
+	uint16_t allpass4index;
 };
 
 
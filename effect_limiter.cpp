@@ -0,0 +1,187 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(KINETISL)
+
+#include <Arduino.h>
+#include "effect_limiter.h"
+#include "utility/dspinst.h"
+#include "utility/truepeak.h"
+
+#define UNITY_GAIN (1 << 23)
+
+// The gain for each sample is the minimum of the gain every peak in the
+// lookahead window requires, released exponentially, then averaged over
+// the lookahead window.  The average reaches each peak's gain exactly as
+// that peak leaves the delay line, so the output never exceeds the
+// threshold, yet the gain always moves smoothly.
+
+void AudioEffectLimiter::update(void)
+{
+	audio_block_t *in[2], *out[2];
+	int16_t x[2][11 + AUDIO_BLOCK_SAMPLES];
+	int32_t peak[AUDIO_BLOCK_SAMPLES];
+	float gain[AUDIO_BLOCK_SAMPLES];
+	uint32_t c, i, k;
+	bool active[2];
+
+	const uint32_t L = window;
+	const uint32_t delay = L - 1 + 6;
+	const float thr = threshold_level;
+	const float ingain = gain_linear;
+	const float thr8192 = thr * 8192.0f / ingain;
+	const uint32_t flush_blocks = (delay + AUDIO_BLOCK_SAMPLES - 1) / AUDIO_BLOCK_SAMPLES + 1;
+
+	for (c=0; c < 2; c++) {
+		in[c] = receiveReadOnly(c);
+		if (in[c]) {
+			flush[c] = flush_blocks;
+		} else if (flush[c] > 0) {
+			flush[c]--;
+		}
+		active[c] = (flush[c] > 0);
+	}
+	if (!active[0] && !active[1]) {
+		reduction = 0.0f;
+		return;
+	}
+
+	// find the peak near each sample, 8192 = 1 sample unit
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) peak[i] = 0;
+	for (c=0; c < 2; c++) {
+		if (!active[c]) continue;
+		int16_t *p = x[c];
+		memcpy(p, history[c], sizeof(int16_t) * 11);
+		if (in[c]) {
+			memcpy(p + 11, in[c]->data, sizeof(int16_t) * AUDIO_BLOCK_SAMPLES);
+		} else {
+			memset(p + 11, 0, sizeof(int16_t) * AUDIO_BLOCK_SAMPLES);
+		}
+		memcpy(history[c], p + AUDIO_BLOCK_SAMPLES, sizeof(int16_t) * 11);
+		int32_t maxabs = 0;
+		for (i=0; i < 11 + AUDIO_BLOCK_SAMPLES; i++) {
+			int32_t n = abs(p[i]);
+			if (n > maxabs) maxabs = n;
+		}
+		if (truepeak_enabled && (float)maxabs * TRUEPEAK_GAIN_BOUND > thr8192) {
+			for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				const int16_t *w = p + i;
+				int32_t y0=0, y1=0, y2=0, y3=0;
+				for (k=0; k < 12; k++) {
+					y0 += truepeak_phase0[k] * w[11 - k];
+					y1 += truepeak_phase1[k] * w[11 - k];
+					y2 += truepeak_phase1[k] * w[k];
+					y3 += truepeak_phase0[k] * w[k];
+				}
+				int32_t m = abs(w[5]) << 13;
+				if (abs(y0) > m) m = abs(y0);
+				if (abs(y1) > m) m = abs(y1);
+				if (abs(y2) > m) m = abs(y2);
+				if (abs(y3) > m) m = abs(y3);
+				if (m > peak[i]) peak[i] = m;
+			}
+		} else if ((float)(maxabs << 13) > thr8192) {
+			for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				int32_t m = abs(p[i + 5]) << 13;
+				if (m > peak[i]) peak[i] = m;
+			}
+		}
+	}
+
+	// compute the gain for each sample
+	const float scale = ingain / ((float)L * (float)UNITY_GAIN);
+	const uint32_t rel = release_coef;
+	uint32_t env = envelope;
+	uint32_t sum = box_sum;
+	uint32_t bindex = box_index;
+	uint32_t first = deque_first;
+	uint32_t count = deque_count;
+	uint32_t t = now;
+	uint32_t minsum = sum;
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		uint32_t target = UNITY_GAIN;
+		if ((float)peak[i] > thr8192) {
+			target = (uint32_t)(thr8192 / (float)peak[i] * (float)UNITY_GAIN);
+		}
+		// sliding window minimum, O(1) amortized per sample
+		if (count > 0 && t - deque_time[first] >= L) {
+			first = (first + 1) & (LIMITER_MAX_LOOKAHEAD - 1);
+			count--;
+		}
+		while (count > 0 && deque_value[(first + count - 1) &
+		  (LIMITER_MAX_LOOKAHEAD - 1)] >= target) {
+			count--;
+		}
+		k = (first + count) & (LIMITER_MAX_LOOKAHEAD - 1);
+		deque_value[k] = target;
+		deque_time[k] = t++;
+		count++;
+		uint32_t hold = deque_value[first];
+		// instant attack, exponential release
+		if (hold <= env) {
+			env = hold;
+		} else {
+			env += (uint32_t)(((uint64_t)(hold - env) * rel + 0xFFFFFFFFu) >> 32);
+		}
+		// moving average across the lookahead window
+		sum += env - box[bindex];
+		box[bindex] = env;
+		if (++bindex >= L) bindex = 0;
+		if (sum < minsum) minsum = sum;
+		gain[i] = (float)sum * scale;
+	}
+	envelope = env;
+	box_sum = sum;
+	box_index = bindex;
+	deque_first = first;
+	deque_count = count;
+	now = t;
+	reduction = 20.0f * log10f((float)minsum / ((float)L * (float)UNITY_GAIN));
+
+	// apply the gain to the delayed audio
+	const uint32_t head = delay_head;
+	for (c=0; c < 2; c++) {
+		if (!active[c]) continue;
+		out[c] = allocate();
+		int16_t *dl = delayline[c];
+		const int16_t *p = x[c] + 11;
+		uint32_t h = head;
+		for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			dl[h] = p[i];
+			int32_t n = (int32_t)((float)dl[(h - delay) & (LIMITER_DELAY_SIZE - 1)] * gain[i]);
+			if (out[c]) out[c]->data[i] = saturate16(n);
+			h = (h + 1) & (LIMITER_DELAY_SIZE - 1);
+		}
+		if (out[c]) {
+			transmit(out[c], c);
+			release(out[c]);
+		}
+		if (in[c]) release(in[c]);
+	}
+	delay_head = (head + AUDIO_BLOCK_SAMPLES) & (LIMITER_DELAY_SIZE - 1);
+}
+
+#endif
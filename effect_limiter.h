@@ -0,0 +1,125 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef effect_limiter_h_
+#define effect_limiter_h_
+
+#if !defined(KINETISL)
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+#define LIMITER_MAX_LOOKAHEAD	256	// samples, 5.8 ms
+#define LIMITER_DELAY_SIZE	512	// must be a power of 2, above max lookahead + 6
+
+class AudioEffectLimiter : public AudioStream
+{
+public:
+	AudioEffectLimiter(void) : AudioStream(2, inputQueueArray) {
+		threshold_level = powf(10.0f, -1.0f / 20.0f) * 32767.0f;
+		release_coef = release_to_coef(0.05f);
+		gain_linear = 1.0f;
+		truepeak_enabled = true;
+		window = 88;
+		envelope = 1 << 23;
+		box_sum = envelope * window;
+		for (int i=0; i < LIMITER_MAX_LOOKAHEAD; i++) box[i] = envelope;
+	}
+	// Set the ceiling (dBFS, or dBTP when true peak is enabled) and
+	// the release time, in seconds.
+	void limit(float threshold = -1.0f, float release = 0.05f) {
+		if (threshold > 0.0f) threshold = 0.0f;
+		if (threshold < -60.0f) threshold = -60.0f;
+		float level = powf(10.0f, threshold / 20.0f) * 32767.0f;
+		uint32_t coef = release_to_coef(release);
+		__disable_irq();
+		threshold_level = level;
+		release_coef = coef;
+		__enable_irq();
+	}
+	// How far ahead peaks are seen, which is also the attack time.
+	// Audio is delayed by this amount plus 6 samples.
+	void lookahead(float milliseconds) {
+		int n = milliseconds * (AUDIO_SAMPLE_RATE_EXACT / 1000.0f) + 0.5f;
+		if (n < 1) n = 1;
+		if (n > LIMITER_MAX_LOOKAHEAD) n = LIMITER_MAX_LOOKAHEAD;
+		__disable_irq();
+		window = n;
+		deque_count = 0;
+		box_index = 0;
+		box_sum = envelope * n;
+		for (int i=0; i < n; i++) box[i] = envelope;
+		__enable_irq();
+	}
+	// Gain before limiting, in dB, to raise the loudness of the output.
+	void inputGain(float gain) {
+		if (gain < -24.0f) gain = -24.0f;
+		if (gain > 24.0f) gain = 24.0f;
+		gain_linear = powf(10.0f, gain / 20.0f);
+	}
+	// Detect inter-sample peaks with 4x oversampling (default on).
+	void truePeak(bool enable) {
+		truepeak_enabled = enable;
+	}
+	// Largest gain reduction during the most recent update, in dB.
+	float gainReduction(void) {
+		return reduction;
+	}
+	virtual void update(void);
+private:
+	static uint32_t release_to_coef(float seconds) {
+		if (seconds < 0.001f) seconds = 0.001f;
+		if (seconds > 4.0f) seconds = 4.0f;
+		float c = 1.0f - expf(-1.0f / (seconds * AUDIO_SAMPLE_RATE_EXACT));
+		return c * 4294967295.0f;
+	}
+	audio_block_t *inputQueueArray[2];
+	float threshold_level;		// ceiling, in sample units
+	float gain_linear;
+	volatile float reduction = 0.0f;
+	uint32_t release_coef;		// fraction of the way to the target per sample, 0.32
+	bool truepeak_enabled;
+	uint8_t flush[2] = {0, 0};	// blocks remaining to empty the delay line
+	uint16_t window;		// lookahead length, in samples
+	uint16_t delay_head = 0;
+	int16_t history[2][11] = {};
+	int16_t delayline[2][LIMITER_DELAY_SIZE] = {};
+	// running minimum of the target gain over the lookahead window
+	uint32_t deque_value[LIMITER_MAX_LOOKAHEAD];
+	uint32_t deque_time[LIMITER_MAX_LOOKAHEAD];
+	uint16_t deque_first = 0;
+	uint16_t deque_count = 0;
+	uint32_t now = 0;
+	// gains are 1.23 fixed point, so the moving average never drifts
+	uint32_t envelope;
+	uint32_t box[LIMITER_MAX_LOOKAHEAD];
+	uint32_t box_sum;
+	uint16_t box_index = 0;
+};
+
+#endif
+
+#endif
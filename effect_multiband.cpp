@@ -0,0 +1,197 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(KINETISL)
+
+#include <Arduino.h>
+#include "effect_multiband.h"
+#include "effect_dynamics.h"
+#include "biquad.h"
+#include "utility/dspinst.h"
+
+// Each crossover point is a Linkwitz-Riley 4th order filter, made of two
+// identical 2nd order Butterworth sections.  The lowpass and highpass
+// outputs always sum to a 2nd order allpass, so bands below a crossover
+// point pass through that allpass to stay in phase with the bands above.
+// With 3 bands, the low band is LP(f1) AP(f2), the middle is HP(f1) LP(f2)
+// and the high band is HP(f1) HP(f2), and all three sum flat.
+
+#define BUTTERWORTH_Q 0.70710678f
+
+// The gain computer and gain smoothing follow AudioEffectDynamics, with
+// a stereo linked peak detector and per sample attack & release.
+
+static inline float exp2f_approx(float x)
+{
+	// 2^x = 2^i * 2^f, with a cubic for 2^f, within 0.001 dB
+	if (x < -126.0f) return 0.0f;
+	float fi = floorf(x);
+	float f = x - fi;
+	float p = 1.0f + f * (0.69583356f + f * (0.22606716f + f * 0.07944023f));
+	union { float f; int32_t i; } u;
+	u.f = p;
+	u.i += (int32_t)fi << 23;
+	return u.f;
+}
+
+// Direct form 2 transposed, using the coefficient order from biquad.h
+static void biquad(const float *coef, float *state, const float *in, float *out)
+{
+	const float b0 = coef[0], b1 = coef[1], b2 = coef[2], a1 = coef[3], a2 = coef[4];
+	float s1 = state[0], s2 = state[1];
+	for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		float x = in[i];
+		float y = b0 * x + s1;
+		s1 = b1 * x + a1 * y + s2;
+		s2 = b2 * x + a2 * y;
+		out[i] = y;
+	}
+	state[0] = s1;
+	state[1] = s2;
+}
+
+void AudioEffectMultibandCompressor::setcrossover(int n, float f1, float f2, float f3)
+{
+	const float fmin = 20.0f, fmax = AUDIO_SAMPLE_RATE_EXACT * 0.45f;
+	float freq[MULTIBAND_MAX_BANDS-1] = {f1, f2, f3};
+	int i;
+
+	for (i=0; i < n; i++) {
+		float lower = (i > 0) ? freq[i-1] : fmin;
+		if (freq[i] < lower) freq[i] = lower;
+		if (freq[i] > fmax) freq[i] = fmax;
+		getCoefficients<float>(lowpass[i], BiquadType::LOW_PASS, 0.0,
+			freq[i], AUDIO_SAMPLE_RATE_EXACT, BUTTERWORTH_Q);
+		getCoefficients<float>(highpass[i], BiquadType::HIGH_PASS, 0.0,
+			freq[i], AUDIO_SAMPLE_RATE_EXACT, BUTTERWORTH_Q);
+		getCoefficients<float>(allpass[i], BiquadType::ALL_PASS, 0.0,
+			freq[i], AUDIO_SAMPLE_RATE_EXACT, BUTTERWORTH_Q);
+	}
+	splits = n;
+	memset(lpstate, 0, sizeof(lpstate));
+	memset(hpstate, 0, sizeof(hpstate));
+	memset(apstate, 0, sizeof(apstate));
+}
+
+void AudioEffectMultibandCompressor::setcompression(struct band_param &p, float threshold,
+	float attack, float release, float ratio, float kneeWidth)
+{
+	threshold = constrain(threshold, MIN_DB, MAX_DB);
+	attack = constrain(attack, 0.0001f, MAX_T);
+	release = constrain(release, 0.001f, MAX_T);
+	ratio = constrain(fabsf(ratio), RATIO_OFF, RATIO_INFINITY);
+	kneeWidth = constrain(fabsf(kneeWidth), 0.0f, 32.0f);
+
+	p.threshold = threshold;
+	p.halfknee = kneeWidth * 0.5f;
+	p.kneescale = (kneeWidth > 0.0f) ? 1.0f / (kneeWidth * 2.0f) : 0.0f;
+	p.lowknee = powf(10.0f, (threshold - p.halfknee) / 20.0f);
+	p.slope = 1.0f / ratio - 1.0f;
+	// 10% to 90% of a step in the given time
+	p.attack = expf(-2.1972246f / (attack * AUDIO_SAMPLE_RATE_EXACT));
+	p.release = expf(-2.1972246f / (release * AUDIO_SAMPLE_RATE_EXACT));
+}
+
+void AudioEffectMultibandCompressor::update(void)
+{
+	audio_block_t *in[2], *out[2];
+	int port[2];
+	int c, i, b, j, nch=0;
+
+	// either input may be used alone, for mono
+	for (c=0; c < 2; c++) {
+		audio_block_t *block = receiveReadOnly(c);
+		if (block) {
+			in[nch] = block;
+			port[nch++] = c;
+		}
+	}
+	if (nch == 0) return;
+	for (c=0; c < nch; c++) {
+		for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			rest[c][i] = (float)in[c]->data[i] * (1.0f / 32768.0f);
+			sum[c][i] = 0.0f;
+		}
+	}
+
+	const int n = splits;
+	for (b=0; b <= n; b++) {
+		// split off the next band
+		for (c=0; c < nch; c++) {
+			const int s = port[c];
+			if (b < n) {
+				biquad(lowpass[b], lpstate[s][b][0], rest[c], band[c]);
+				biquad(lowpass[b], lpstate[s][b][1], band[c], band[c]);
+				for (j=b+1; j < n; j++) {
+					biquad(allpass[j], apstate[s][b][j-b-1], band[c], band[c]);
+				}
+				biquad(highpass[b], hpstate[s][b][0], rest[c], rest[c]);
+				biquad(highpass[b], hpstate[s][b][1], rest[c], rest[c]);
+			} else {
+				memcpy(band[c], rest[c], sizeof(band[c]));
+			}
+		}
+		// compress the band, with the gain linked across channels
+		const struct band_param &p = bandparam[b];
+		const float makeup = p.makeup;
+		float state = gainstate[b];
+		for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			float level = fabsf(band[0][i]);
+			if (nch > 1 && fabsf(band[1][i]) > level) level = fabsf(band[1][i]);
+			float reduction = 0.0f;
+			if (level > p.lowknee) {
+				float over = 6.0206f * log2f_approx(level) - p.threshold;
+				if (over >= p.halfknee) {
+					reduction = over * p.slope;
+				} else {
+					float k = over + p.halfknee;
+					reduction = p.slope * k * k * p.kneescale;
+				}
+			}
+			float a = (reduction < state) ? p.attack : p.release;
+			state = reduction + a * (state - reduction);
+			float gain = exp2f_approx((state + makeup) * (1.0f / 6.0206f));
+			sum[0][i] += band[0][i] * gain;
+			if (nch > 1) sum[1][i] += band[1][i] * gain;
+		}
+		if (state > -1e-6f) state = 0.0f;
+		gainstate[b] = state;
+	}
+
+	for (c=0; c < nch; c++) {
+		out[c] = allocate();
+		if (out[c]) {
+			for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				out[c]->data[i] = saturate16((int32_t)(sum[c][i] * 32768.0f));
+			}
+			transmit(out[c], port[c]);
+			release(out[c]);
+		}
+		release(in[c]);
+	}
+}
+
+#endif
@@ -0,0 +1,121 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef effect_multiband_h_
+#define effect_multiband_h_
+
+#if !defined(KINETISL)
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+#define MULTIBAND_MAX_BANDS	4
+
+class AudioEffectMultibandCompressor : public AudioStream
+{
+public:
+	AudioEffectMultibandCompressor(void) : AudioStream(2, inputQueueArray) {
+		setcrossover(2, 200.0f, 2000.0f, 0.0f);
+		for (int i=0; i < MULTIBAND_MAX_BANDS; i++) {
+			setcompression(bandparam[i], -20.0f, 0.005f, 0.1f, 4.0f, 6.0f);
+			bandparam[i].makeup = 0.0f;
+			gainstate[i] = 0.0f;
+		}
+	}
+	// Split into 2, 3 or 4 bands with Linkwitz-Riley 4th order crossovers.
+	void crossover(float freq1) {
+		update_crossover(1, freq1, 0.0f, 0.0f);
+	}
+	void crossover(float freq1, float freq2) {
+		update_crossover(2, freq1, freq2, 0.0f);
+	}
+	void crossover(float freq1, float freq2, float freq3) {
+		update_crossover(3, freq1, freq2, freq3);
+	}
+	// Compression settings for one band, numbered from lowest frequency.
+	// threshold & kneeWidth are in dBFS, attack & release in seconds,
+	// ratio is x:1, the same as AudioEffectDynamics.
+	void compression(unsigned int band, float threshold = -20.0f, float attack = 0.005f,
+	  float release = 0.1f, float ratio = 4.0f, float kneeWidth = 6.0f) {
+		if (band >= MULTIBAND_MAX_BANDS) return;
+		struct band_param p = bandparam[band];
+		setcompression(p, threshold, attack, release, ratio, kneeWidth);
+		__disable_irq();
+		bandparam[band] = p;
+		__enable_irq();
+	}
+	// Gain added to one band after compression, in dB.
+	void makeupGain(unsigned int band, float gain) {
+		if (band >= MULTIBAND_MAX_BANDS) return;
+		if (gain < -24.0f) gain = -24.0f;
+		if (gain > 24.0f) gain = 24.0f;
+		bandparam[band].makeup = gain;
+	}
+	// Current gain reduction of one band, in dB (zero or negative).
+	float gainReduction(unsigned int band) {
+		if (band >= MULTIBAND_MAX_BANDS) return 0.0f;
+		return gainstate[band];
+	}
+	virtual void update(void);
+private:
+	struct band_param {
+		float threshold;	// dBFS
+		float lowknee;		// linear level where the knee begins
+		float halfknee;		// dB
+		float kneescale;	// 1 / (2 * kneeWidth)
+		float slope;		// 1/ratio - 1
+		float attack;		// one pole coefficients, per sample
+		float release;
+		float makeup;		// dB
+	};
+	void update_crossover(int n, float f1, float f2, float f3) {
+		__disable_irq();
+		setcrossover(n, f1, f2, f3);
+		__enable_irq();
+	}
+	void setcrossover(int n, float f1, float f2, float f3);
+	static void setcompression(struct band_param &p, float threshold, float attack,
+	  float release, float ratio, float kneeWidth);
+	audio_block_t *inputQueueArray[2];
+	uint8_t splits;			// number of bands - 1
+	float lowpass[MULTIBAND_MAX_BANDS-1][5];
+	float highpass[MULTIBAND_MAX_BANDS-1][5];
+	float allpass[MULTIBAND_MAX_BANDS-1][5];
+	// filter state, 2 per biquad: [channel][split][stage][2]
+	float lpstate[2][MULTIBAND_MAX_BANDS-1][2][2];
+	float hpstate[2][MULTIBAND_MAX_BANDS-1][2][2];
+	float apstate[2][MULTIBAND_MAX_BANDS-1][MULTIBAND_MAX_BANDS-2][2];
+	struct band_param bandparam[MULTIBAND_MAX_BANDS];
+	volatile float gainstate[MULTIBAND_MAX_BANDS];	// smoothed gain reduction, dB
+	// working buffers for update(), kept here rather than on the stack
+	float rest[2][AUDIO_BLOCK_SAMPLES];
+	float band[2][AUDIO_BLOCK_SAMPLES];
+	float sum[2][AUDIO_BLOCK_SAMPLES];
+};
+
+#endif
+
+#endif
@@ -0,0 +1,231 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+#include "effect_reverb_fdn.h"
+
+// Relative delay line lengths, mutually prime so the echoes of the
+// lines rarely coincide.  Fewer lines use an evenly spread subset.
+static const uint16_t fdn_lengths[FDN_MAX_LINES] = {
+	617, 683, 757, 827, 907, 991, 1087, 1181,
+	1283, 1399, 1523, 1657, 1801, 1951, 2113, 2287
+};
+
+static const int16_t zerodata[AUDIO_BLOCK_SAMPLES] = { 0 };
+
+bool AudioEffectReverbFDN::begin(int16_t *memory, uint32_t len, unsigned int lines)
+{
+	unsigned int i, step;
+	uint32_t total, extra, maxlen;
+
+	__disable_irq();
+	numlines = 0;
+	__enable_irq();
+	if (memory == NULL) return false;
+	if (lines >= 16) lines = 16;
+	else if (lines >= 8) lines = 8;
+	else lines = 4;
+	if (len < lines * FDN_MIN_LENGTH) return false;
+
+	step = FDN_MAX_LINES / lines;
+	total = 0;
+	for (i=0; i < lines; i++) {
+		total += fdn_lengths[i * step + step / 2] - FDN_MIN_LENGTH;
+	}
+	// every line gets FDN_MIN_LENGTH, and the rest of the memory is
+	// divided in proportion to the nominal lengths, up to twice them,
+	// because longer lines only make the echoes less dense
+	extra = len - lines * FDN_MIN_LENGTH;
+	if (extra > total * 2) extra = total * 2;
+	maxlen = 0;
+	for (i=0; i < lines; i++) {
+		uint32_t n = fdn_lengths[i * step + step / 2] - FDN_MIN_LENGTH;
+		n = FDN_MIN_LENGTH + n * extra / total;
+		line[i] = memory;
+		length[i] = n;
+		index[i] = 0;
+		lowpass[i] = 0.0f;
+		memset(memory, 0, n * sizeof(int16_t));
+		memory += n;
+		if (n > maxlen) maxlen = n;
+	}
+	maxlength = maxlen;
+	silence = maxlen;
+	numlines = lines;
+	compute_feedback();
+	return true;
+}
+
+void AudioEffectReverbFDN::compute_feedback(void)
+{
+	float g[FDN_MAX_LINES];
+	unsigned int i, n = numlines;
+
+	if (n == 0) return;
+	// each line loses 60 dB in rt60 seconds, no matter its length
+	float norm = (mixtype == FDN_MATRIX_HADAMARD) ? 1.0f / sqrtf(n) : 1.0f;
+	for (i=0; i < n; i++) {
+		float t = (float)length[i] / (AUDIO_SAMPLE_RATE_EXACT * rt60);
+		g[i] = powf(10.0f, -3.0f * t) * norm;
+	}
+	__disable_irq();
+	for (i=0; i < n; i++) feedback[i] = g[i];
+	__enable_irq();
+}
+
+static inline void mix_hadamard(float *v, unsigned int n)
+{
+	for (unsigned int h=1; h < n; h <<= 1) {
+		for (unsigned int i=0; i < n; i += h << 1) {
+			for (unsigned int j=i; j < i + h; j++) {
+				float a = v[j];
+				float b = v[j + h];
+				v[j] = a + b;
+				v[j + h] = a - b;
+			}
+		}
+	}
+}
+
+static inline void mix_householder(float *v, unsigned int n)
+{
+	float sum = 0.0f;
+	for (unsigned int i=0; i < n; i++) sum += v[i];
+	sum *= 2.0f / (float)n;
+	for (unsigned int i=0; i < n; i++) v[i] -= sum;
+}
+
+static inline int16_t saturate16f(float n)
+{
+	if (n > 32767.0f) return 32767;
+	if (n < -32767.0f) return -32767;
+	return (int16_t)n;
+}
+
+void AudioEffectReverbFDN::update(void)
+{
+	audio_block_t *inleft, *inright, *outleft, *outright;
+	float lp[FDN_MAX_LINES], fb[FDN_MAX_LINES], v[FDN_MAX_LINES];
+	const int16_t *pl, *pr;
+	unsigned int i, s, offset;
+	const unsigned int n = numlines;
+	const bool hadamard = (mixtype == FDN_MATRIX_HADAMARD);
+	const float d = damp;
+	const float ingain = 1.0f / sqrtf(n);
+	const float outgain = 2.0f / sqrtf(n);
+	bool nonzero = false;
+
+	inleft = receiveReadOnly(0);
+	inright = receiveReadOnly(1);
+	if (n == 0 || (!inleft && !inright && silence >= maxlength)) {
+		// not configured, or silent input and the tail has fully decayed
+		if (inleft) release(inleft);
+		if (inright) release(inright);
+		return;
+	}
+	outleft = allocate();
+	outright = allocate();
+	if (!outleft || !outright) {
+		if (outleft) release(outleft);
+		if (outright) release(outright);
+		if (inleft) release(inleft);
+		if (inright) release(inright);
+		return;
+	}
+	pl = (inleft) ? inleft->data : zerodata;
+	pr = (inright) ? inright->data : zerodata;
+
+	for (i=0; i < n; i++) {
+		lp[i] = lowpass[i];
+		fb[i] = feedback[i];
+	}
+	for (offset=0; offset < AUDIO_BLOCK_SAMPLES; offset += FDN_CHUNK) {
+		// read the oldest FDN_CHUNK samples from every line
+		for (i=0; i < n; i++) {
+			const int16_t *p = line[i];
+			unsigned int idx = index[i];
+			const unsigned int len = length[i];
+			for (s=0; s < FDN_CHUNK; s++) {
+				chunk[i][s] = p[idx];
+				if (++idx >= len) idx = 0;
+			}
+		}
+		// damp, scale, mix, and add input, one sample at a time
+		for (s=0; s < FDN_CHUNK; s++) {
+			float left = 0.0f, right = 0.0f;
+			for (i=0; i < n; i += 2) {
+				float y0 = chunk[i][s];
+				float y1 = chunk[i+1][s];
+				left += y0;
+				right += y1;
+				lp[i] += d * (y0 - lp[i]);
+				lp[i+1] += d * (y1 - lp[i+1]);
+				v[i] = lp[i] * fb[i];
+				v[i+1] = lp[i+1] * fb[i+1];
+			}
+			if (hadamard) {
+				mix_hadamard(v, n);
+			} else {
+				mix_householder(v, n);
+			}
+			float xl = pl[offset + s] * ingain;
+			float xr = pr[offset + s] * ingain;
+			for (i=0; i < n; i += 2) {
+				chunk[i][s] = v[i] + xl;
+				chunk[i+1][s] = v[i+1] + xr;
+			}
+			outleft->data[offset + s] = saturate16f(left * outgain);
+			outright->data[offset + s] = saturate16f(right * outgain);
+		}
+		// write the new samples back in the same place
+		for (i=0; i < n; i++) {
+			int16_t *p = line[i];
+			unsigned int idx = index[i];
+			const unsigned int len = length[i];
+			for (s=0; s < FDN_CHUNK; s++) {
+				int16_t val = saturate16f(chunk[i][s]);
+				if (val) nonzero = true;
+				p[idx] = val;
+				if (++idx >= len) idx = 0;
+			}
+			index[i] = idx;
+		}
+	}
+	for (i=0; i < n; i++) lowpass[i] = lp[i];
+	// the tail has decayed when every line has been rewritten with zeros
+	if (nonzero) {
+		silence = 0;
+	} else if (silence < maxlength) {
+		silence += AUDIO_BLOCK_SAMPLES;
+	}
+
+	if (inleft) release(inleft);
+	if (inright) release(inright);
+	transmit(outleft, 0);
+	transmit(outright, 1);
+	release(outleft);
+	release(outright);
+}
@@ -0,0 +1,94 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef effect_reverb_fdn_h_
+#define effect_reverb_fdn_h_
+#include <Arduino.h>
+#include "AudioStream.h"
+
+#define FDN_MAX_LINES   16
+#define FDN_MIN_LENGTH  32
+
+// lines are processed in chunks, so memory reads and writes are
+// contiguous and the mixing matrix works on values held in registers
+#if AUDIO_BLOCK_SAMPLES < 32
+#define FDN_CHUNK AUDIO_BLOCK_SAMPLES
+#else
+#define FDN_CHUNK 32
+#endif
+
+enum AudioEffectReverbFDNMatrix {
+	FDN_MATRIX_HADAMARD,
+	FDN_MATRIX_HOUSEHOLDER
+};
+
+class AudioEffectReverbFDN : public AudioStream
+{
+public:
+	AudioEffectReverbFDN(void) : AudioStream(2, inputQueueArray) {
+		numlines = 0;
+		mixtype = FDN_MATRIX_HADAMARD;
+		rt60 = 2.0f;
+		damp = 0.5f;
+		maxlength = 0;
+		silence = 0;
+	}
+	// delay memory is supplied by the sketch, so it may be placed in
+	// DMAMEM, EXTMEM or fast RAM, and sized to trade density for RAM
+	bool begin(int16_t *memory, uint32_t length, unsigned int lines = 8);
+	void reverbTime(float seconds) {
+		if (seconds < 0.05f) seconds = 0.05f;
+		rt60 = seconds;
+		compute_feedback();
+	}
+	void damping(float n) {
+		if (n > 1.0f) n = 1.0f;
+		else if (n < 0.0f) n = 0.0f;
+		damp = 1.0f - n * 0.9f;
+	}
+	void matrix(AudioEffectReverbFDNMatrix type) {
+		mixtype = type;
+		compute_feedback();
+	}
+	virtual void update(void);
+private:
+	void compute_feedback(void);
+	unsigned int numlines;
+	AudioEffectReverbFDNMatrix mixtype;
+	float rt60;
+	float damp;
+	uint32_t maxlength;   // longest line, in samples
+	uint32_t silence;     // samples since anything nonzero was written
+	int16_t *line[FDN_MAX_LINES];
+	uint16_t length[FDN_MAX_LINES];
+	uint16_t index[FDN_MAX_LINES];
+	float feedback[FDN_MAX_LINES];
+	float lowpass[FDN_MAX_LINES];
+	float chunk[FDN_MAX_LINES][FDN_CHUNK];
+	audio_block_t *inputQueueArray[2];
+};
+
+#endif
@@ -0,0 +1,199 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+#include "effect_vocoder.h"
+
+// Each band is a 4th order bandpass, built from 2 identical 2nd order
+// sections.  For the pair to be -3 dB at the requested bandwidth, each
+// section needs a Q lower by sqrt(sqrt(2) - 1).
+#define CASCADE_Q_SCALE 0.643594f
+
+void AudioEffectVocoder::compute_band(unsigned int band, float frequency, float q)
+{
+	if (frequency < 20.0f) frequency = 20.0f;
+	if (frequency > AUDIO_SAMPLE_RATE_EXACT * 0.45f) {
+		frequency = AUDIO_SAMPLE_RATE_EXACT * 0.45f;
+	}
+	if (q < 0.1f) q = 0.1f;
+	float w0 = frequency * (2.0f * 3.141592654f / AUDIO_SAMPLE_RATE_EXACT);
+	float alpha = sinf(w0) / (q * CASCADE_Q_SCALE * 2.0f);
+	float scale = 1.0f / (1.0f + alpha);
+	float coef_b0 = alpha * scale;
+	float coef_a1 = -2.0f * cosf(w0) * scale;
+	float coef_a2 = (1.0f - alpha) * scale;
+	__disable_irq();
+	b0[band] = coef_b0;
+	a1[band] = coef_a1;
+	a2[band] = coef_a2;
+	__enable_irq();
+}
+
+void AudioEffectVocoder::bands(unsigned int num, float lowFreq, float highFreq, float q)
+{
+	if (num < 1) num = 1;
+	if (num > VOCODER_MAX_BANDS) num = VOCODER_MAX_BANDS;
+	if (lowFreq < 20.0f) lowFreq = 20.0f;
+	if (highFreq < lowFreq) highFreq = lowFreq;
+	float ratio = 1.0f;
+	if (num > 1) ratio = powf(highFreq / lowFreq, 1.0f / (float)(num - 1));
+	if (q <= 0.0f) {
+		// adjacent bands cross at their -3 dB points
+		if (ratio > 1.0001f) {
+			q = sqrtf(ratio) / (ratio - 1.0f);
+		} else {
+			q = 1.0f;
+		}
+	}
+	float freq = lowFreq;
+	for (unsigned int i=0; i < num; i++) {
+		compute_band(i, freq, q);
+		freq *= ratio;
+	}
+	__disable_irq();
+	numbands = num;
+	__enable_irq();
+}
+
+void AudioEffectVocoder::bandFrequency(unsigned int band, float frequency, float q)
+{
+	if (band >= VOCODER_MAX_BANDS) return;
+	compute_band(band, frequency, q);
+	if (band >= numbands) {
+		__disable_irq();
+		for (unsigned int i=numbands; i < band; i++) {
+			// fill any skipped bands with a copy of this one, silenced
+			b0[i] = b0[band];
+			a1[i] = a1[band];
+			a2[i] = a2[band];
+			bandgain[i] = 0.0f;
+		}
+		numbands = band + 1;
+		__enable_irq();
+	}
+}
+
+static const int16_t zerodata[AUDIO_BLOCK_SAMPLES] = { 0 };
+
+void AudioEffectVocoder::update(void)
+{
+	audio_block_t *modulator, *carrier, *block=NULL;
+	const int16_t *in;
+	float sum[AUDIO_BLOCK_SAMPLES];
+	const float atk = attack_coef;
+	const float rel = release_coef;
+	unsigned int band, i;
+
+	modulator = receiveReadOnly(0);
+	carrier = receiveReadOnly(1);
+	if (!modulator && !carrier) return;
+	if (carrier) {
+		block = allocate();
+		if (!block) {
+			AudioStream::release(carrier);
+			carrier = NULL;
+		}
+	}
+	in = (modulator) ? modulator->data : zerodata;
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) sum[i] = 0.0f;
+
+	for (band=0; band < numbands; band++) {
+		const float c0 = b0[band];
+		const float c1 = a1[band];
+		const float c2 = a2[band];
+		float s0 = modstate[band][0];
+		float s1 = modstate[band][1];
+		float s2 = modstate[band][2];
+		float s3 = modstate[band][3];
+		float e = env[band];
+		float x, y1, y2, r;
+
+		if (!carrier) {
+			// no carrier, only keep the envelope followers running
+			for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				x = in[i];
+				y1 = c0 * x + s0;
+				s0 = s1 - c1 * y1;
+				s1 = -c0 * x - c2 * y1;
+				y2 = c0 * y1 + s2;
+				s2 = s3 - c1 * y2;
+				s3 = -c0 * y1 - c2 * y2;
+				r = fabsf(y2);
+				e += (r - e) * ((r > e) ? atk : rel);
+			}
+		} else {
+			const int16_t *cin = carrier->data;
+			const float g = bandgain[band];
+			float t0 = carstate[band][0];
+			float t1 = carstate[band][1];
+			float t2 = carstate[band][2];
+			float t3 = carstate[band][3];
+			for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+				// analysis: modulator band level
+				x = in[i];
+				y1 = c0 * x + s0;
+				s0 = s1 - c1 * y1;
+				s1 = -c0 * x - c2 * y1;
+				y2 = c0 * y1 + s2;
+				s2 = s3 - c1 * y2;
+				s3 = -c0 * y1 - c2 * y2;
+				r = fabsf(y2);
+				e += (r - e) * ((r > e) ? atk : rel);
+				// synthesis: same band of the carrier, scaled by the level
+				x = cin[i];
+				y1 = c0 * x + t0;
+				t0 = t1 - c1 * y1;
+				t1 = -c0 * x - c2 * y1;
+				y2 = c0 * y1 + t2;
+				t2 = t3 - c1 * y2;
+				t3 = -c0 * y1 - c2 * y2;
+				sum[i] += y2 * e * g;
+			}
+			carstate[band][0] = t0;
+			carstate[band][1] = t1;
+			carstate[band][2] = t2;
+			carstate[band][3] = t3;
+		}
+		modstate[band][0] = s0;
+		modstate[band][1] = s1;
+		modstate[band][2] = s2;
+		modstate[band][3] = s3;
+		env[band] = e;
+	}
+	if (modulator) AudioStream::release(modulator);
+	if (!carrier) return;
+	AudioStream::release(carrier);
+
+	const float mult = outmult;
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		float n = sum[i] * mult;
+		if (n > 32767.0f) n = 32767.0f;
+		if (n < -32768.0f) n = -32768.0f;
+		block->data[i] = (int16_t)n;
+	}
+	transmit(block);
+	AudioStream::release(block);
+}
@@ -0,0 +1,98 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef effect_vocoder_h_
+#define effect_vocoder_h_
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+#define VOCODER_MAX_BANDS 32
+
+class AudioEffectVocoder : public AudioStream
+{
+public:
+	AudioEffectVocoder(void) : AudioStream(2, inputQueueArray) {
+		numbands = 0;
+		outmult = 1.0f / 32768.0f;
+		for (int i=0; i < VOCODER_MAX_BANDS; i++) {
+			bandgain[i] = 1.0f;
+			env[i] = 0.0f;
+			for (int j=0; j < 4; j++) {
+				modstate[i][j] = 0.0f;
+				carstate[i][j] = 0.0f;
+			}
+		}
+		attack(2.0f);
+		release(20.0f);
+		bands(16, 150.0f, 6000.0f);
+	}
+	// space "num" bands logarithmically from lowFreq to highFreq
+	void bands(unsigned int num, float lowFreq, float highFreq, float q = 0.0f);
+	// set one band's center frequency and bandwidth (Q)
+	void bandFrequency(unsigned int band, float frequency, float q);
+	void attack(float milliseconds) {
+		attack_coef = smoothing(milliseconds);
+	}
+	void release(float milliseconds) {
+		release_coef = smoothing(milliseconds);
+	}
+	void gain(float level) {
+		outmult = level * (1.0f / 32768.0f);
+	}
+	void gain(unsigned int band, float level) {
+		if (band >= VOCODER_MAX_BANDS) return;
+		bandgain[band] = level;
+	}
+	float envelope(unsigned int band) {
+		if (band >= numbands) return 0.0f;
+		return env[band] * (1.0f / 32768.0f);
+	}
+	virtual void update(void);
+private:
+	static float smoothing(float milliseconds) {
+		float n = milliseconds * (AUDIO_SAMPLE_RATE_EXACT / 1000.0f);
+		if (n < 1.0f) return 1.0f;
+		return 1.0f - expf(-1.0f / n);
+	}
+	void compute_band(unsigned int band, float frequency, float q);
+	unsigned int numbands;
+	float attack_coef;
+	float release_coef;
+	float outmult;
+	// bandpass coefficients, b1 is always 0 and b2 is always -b0
+	float b0[VOCODER_MAX_BANDS];
+	float a1[VOCODER_MAX_BANDS];
+	float a2[VOCODER_MAX_BANDS];
+	float bandgain[VOCODER_MAX_BANDS];
+	// each band is 2 cascaded biquads for both modulator and carrier
+	float modstate[VOCODER_MAX_BANDS][4];
+	float carstate[VOCODER_MAX_BANDS][4];
+	float env[VOCODER_MAX_BANDS];
+	audio_block_t *inputQueueArray[2];
+};
+
+#endif
@@ -0,0 +1,92 @@
+// Dial Tone (DTMF) decoding example, using a single tone bank.
+//
+// The audio with dial tones is connected to audio shield
+// Left Line-In pin.  Dial tone output is produced on the
+// Line-Out and headphones.
+//
+// Use the Arduino Serial Monitor to watch for incoming
+// dial tones, and to send digits to be played as dial tones.
+//
+// This example code is in the public domain.
+
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+// Create the Audio components.  These should be created in the
+// order data flows, inputs/sources -> processing -> outputs
+//
+AudioInputI2S            audioIn;
+AudioAnalyzeToneBank     tones;    // detects all 8 DTMF tones
+AudioSynthWaveformSine   sine1;    // 2 sine wave
+AudioSynthWaveformSine   sine2;    // to create DTMF
+AudioMixer4              mixer;
+AudioOutputI2S           audioOut;
+
+// Create Audio connections between the components
+//
+AudioConnection patchCord01(audioIn, 0, tones, 0);
+AudioConnection patchCord10(sine1, 0, mixer, 0);
+AudioConnection patchCord11(sine2, 0, mixer, 1);
+AudioConnection patchCord12(mixer, 0, audioOut, 0);
+AudioConnection patchCord13(mixer, 0, audioOut, 1);
+
+// Create an object to control the audio shield.
+// 
+AudioControlSGTL5000 audioShield;
+
+const float row[4] = {697, 770, 852, 941};
+const float column[4] = {1209, 1336, 1477, 1633};
+const char keys[] = "123A456B789C*0#D";
+
+void setup() {
+  // Audio connections require memory to work.  For more
+  // detailed information, see the MemoryAndCpuUsage example
+  AudioMemory(12);
+
+  // Enable the audio shield and set the output volume.
+  audioShield.enable();
+  audioShield.volume(0.5);
+
+  while (!Serial) ;
+  delay(100);
+
+  // Measure all 8 DTMF frequencies, and decode keys
+  tones.dtmf();
+  tones.threshold(0.02);
+}
+
+void loop() {
+  // print every key received
+  char key = tones.readDTMF();
+  if (key) {
+    Serial.print("Key: ");
+    Serial.println(key);
+  }
+
+  // check if any data has arrived from the serial monitor
+  if (Serial.available()) {
+    char c = Serial.read();
+    for (int i=0; i < 16; i++) {
+      if (c == keys[i]) {
+        Serial.print("Sending digit ");
+        Serial.println(c);
+        AudioNoInterrupts();
+        sine1.frequency(row[i / 4]);
+        sine1.amplitude(0.4);
+        sine2.frequency(column[i % 4]);
+        sine2.amplitude(0.45);
+        AudioInterrupts();
+        delay(100);
+        AudioNoInterrupts();
+        sine1.amplitude(0);
+        sine2.amplitude(0);
+        AudioInterrupts();
+        delay(50);
+      }
+    }
+  }
+}
@@ -0,0 +1,54 @@
+/* Measure EBU R128 loudness of the audio shield line input
+ *
+ * Prints momentary, short-term and integrated loudness in LUFS.
+ * Send any character from the Arduino Serial Monitor to begin
+ * a new integrated measurement.
+ *
+ * This example code is in the public domain
+ */
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioInputI2S          audioInput;
+AudioAnalyzeLoudness   loudness;
+AudioOutputI2S         audioOutput;
+AudioConnection        c1(audioInput, 0, loudness, 0);
+AudioConnection        c2(audioInput, 1, loudness, 1);
+AudioConnection        c3(audioInput, 0, audioOutput, 0);
+AudioConnection        c4(audioInput, 1, audioOutput, 1);
+AudioControlSGTL5000   audioShield;
+
+void setup() {
+  AudioMemory(12);
+  audioShield.enable();
+  audioShield.inputSelect(AUDIO_INPUT_LINEIN);
+  audioShield.volume(0.5);
+  Serial.begin(9600);
+}
+
+int count = 0;
+
+void loop() {
+  if (Serial.available()) {
+    while (Serial.available()) Serial.read();
+    loudness.reset();
+    Serial.println("Integrated loudness reset");
+  }
+  if (loudness.available()) {
+    // new readings every 100 ms, print every 5th
+    if (++count >= 5) {
+      count = 0;
+      Serial.print("M: ");
+      Serial.print(loudness.readMomentary(), 1);
+      Serial.print("  S: ");
+      Serial.print(loudness.readShortTerm(), 1);
+      Serial.print("  I: ");
+      Serial.print(loudness.readIntegrated(), 1);
+      Serial.println(" LUFS");
+    }
+  }
+}
@@ -0,0 +1,63 @@
+/* Show peak, RMS, true peak, PPM and VU levels for 8 I2S inputs,
+ * using a single AudioAnalyzeMeter object.
+ *
+ * Connect 8 INMP411 I2S microphones to Teensy 4.0, as described
+ * in the PeakAndRMSMeter8Channel example.
+ *
+ * This example code is in the public domain
+ */
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioInputI2SOct     audioInput;
+AudioAnalyzeMeter    meter;
+
+AudioConnection c1(audioInput, 0, meter, 0);
+AudioConnection c2(audioInput, 1, meter, 1);
+AudioConnection c3(audioInput, 2, meter, 2);
+AudioConnection c4(audioInput, 3, meter, 3);
+AudioConnection c5(audioInput, 4, meter, 4);
+AudioConnection c6(audioInput, 5, meter, 5);
+AudioConnection c7(audioInput, 6, meter, 6);
+AudioConnection c8(audioInput, 7, meter, 7);
+
+void setup() {
+  AudioMemory(20);
+  Serial.begin(9600);
+  meter.period(100);           // publish levels 10 times per second
+  meter.vuBallistics(300);     // classic VU needle response
+  meter.ppmBallistics(10, 24.0 / 2.8);  // IEC Type II PPM
+}
+
+// convert a level from 0 to 1.0 into decibels, or -99 for silence
+float dB(float level) {
+  if (level < 0.00001) return -99.0;
+  return 20.0 * log10f(level);
+}
+
+void loop() {
+  if (meter.available()) {
+    audio_meter_levels_t levels;
+    for (int ch=0; ch < 8; ch++) {
+      meter.read(ch, &levels);
+      Serial.print("ch");
+      Serial.print(ch + 1);
+      Serial.print(": pk=");
+      Serial.print(dB(levels.peak), 1);
+      Serial.print(" rms=");
+      Serial.print(dB(levels.rms), 1);
+      Serial.print(" tp=");
+      Serial.print(dB(levels.truePeak), 1);
+      Serial.print(" ppm=");
+      Serial.print(dB(levels.ppm), 1);
+      Serial.print(" vu=");
+      Serial.print(dB(levels.vu), 1);
+      Serial.println();
+    }
+    Serial.println();
+  }
+}
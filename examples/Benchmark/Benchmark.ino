@@ -0,0 +1,514 @@
+// Benchmark
+//
+// This example measures the CPU time of audio library objects.
+// Each object is run alone, and in a few typical chains, for
+// thousands of blocks with the same input signals every time.
+// The results are printed as JSON, so runs from different
+// library versions or boards can be saved and compared with
+// any diff or JSON tool.
+//
+// No audio input or output is used.  Without one, the library
+// never runs its own updates, so this program calls update()
+// on one configuration at a time and times only that call.
+// On Teensy 3.x and 4.x the ARM DWT cycle counter gives exact
+// cycle counts.  Other boards fall back to micros().
+//
+// Results for each configuration:
+//   cycles_per_block    average CPU cycles for one update()
+//   min_cycles          fastest update(), least disturbed by interrupts
+//   max_cycles          slowest update()
+//   ns_per_block        average time for one update()
+//   cycles_per_sample   average cycles divided by AUDIO_BLOCK_SAMPLES
+//   cpu_percent         share of the CPU, like AudioProcessorUsage()
+//   memory_blocks       most audio blocks in use at once
+//
+// The buffers and delay lines used here need more than the
+// 64K RAM of Teensy 3.2.  On smaller boards, remove entries
+// from the benchmarks[] list, with the objects they use.
+// Objects not available on Teensy LC are left out there.
+//
+// To measure on a PC, without any Teensy, run "make benchmark"
+// in extras/hosttest.  Host results only compare versions of
+// the portable C code on that PC, not the ARM instructions.
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+
+#define BENCH_BLOCKS 3000     // blocks timed for each configuration
+#define BENCH_WARMUP 20       // blocks run untimed before each one
+
+#if defined(ARM_DWT_CYCCNT)
+  #define BENCH_TIMER "dwt"
+  static inline uint32_t timer_read() { return ARM_DWT_CYCCNT; }
+  static const float timer_to_cycles = 1.0f;
+#else
+  #define BENCH_TIMER "micros"
+  static inline uint32_t timer_read() { return micros(); }
+  static const float timer_to_cycles = F_CPU / 1000000.0f;
+#endif
+
+// update() is not public in every object, but a derived class
+// may call it.  Bench<T> is T with a public run() function.
+template <class T> class Bench : public T {
+public:
+  void run() { this->update(); }
+};
+
+// input signals, the same for every configuration
+Bench<AudioSynthWaveformSine>      srcSine;
+Bench<AudioSynthNoiseWhite>        srcNoise;
+
+// objects measured alone
+Bench<AudioSynthWaveformSine>      sine1;
+Bench<AudioSynthWaveformSineHires> sineHires1;
+Bench<AudioSynthWaveformSineModulated> sineFM1;
+Bench<AudioSynthWaveform>          waveform1;
+Bench<AudioSynthWaveformModulated> waveformMod1;
+Bench<AudioSynthNoiseWhite>        noise1;
+Bench<AudioSynthNoisePink>         pink1;
+Bench<AudioSynthKarplusStrong>     string1;
+Bench<AudioSynthSimpleDrum>        drum1;
+Bench<AudioSynthWavetable>         wavetable1;
+#if !defined(KINETISL)
+Bench<AudioSynthAdditive>          additive1;
+#endif
+Bench<AudioSynthFM>                fm1;
+Bench<AudioSynthFMPoly>            fmpoly1;
+Bench<AudioFilterBiquad>           biquad1;
+Bench<AudioFilterFIR>              fir1;
+Bench<AudioFilterStateVariable>    filter1;
+Bench<AudioFilterLadder>           ladder1;
+#if !defined(KINETISL)
+Bench<AudioFilterCrossover>        crossover1;
+#endif
+Bench<AudioEffectEnvelope>         envelope1;
+Bench<AudioEffectDelay>            delay1;
+Bench<AudioEffectFreeverb>         freeverb1;
+Bench<AudioEffectFreeverbStereo>   freeverbs1;
+Bench<AudioEffectReverb>           reverb1;
+Bench<AudioEffectReverbFDN>        reverbfdn1;
+Bench<AudioEffectChorus>           chorus1;
+Bench<AudioEffectFlange>           flange1;
+Bench<AudioEffectBitcrusher>       bitcrusher1;
+Bench<AudioEffectWaveFolder>       wavefolder1;
+Bench<AudioEffectWaveshaper>       waveshaper1;
+Bench<AudioEffectDistortion>       distortion1;
+#if !defined(KINETISL)
+Bench<AudioEffectMultibandCompressor> multiband1;
+Bench<AudioEffectLimiter>          limiter1;
+#endif
+Bench<AudioEffectGranular>         granular1;
+Bench<AudioEffectVocoder>          vocoder1;
+Bench<AudioEffectMultiply>         multiply1;
+Bench<AudioEffectRectifier>        rectifier1;
+Bench<AudioEffectMidSide>          midside1;
+Bench<AudioEffectDigitalCombine>   combine1;
+Bench<AudioMixer4>                 mixer1;
+Bench<AudioAmplifier>              amp1;
+Bench<AudioMixerMatrix>            matrix1;
+Bench<AudioAnalyzePeak>            peak1;
+Bench<AudioAnalyzeRMS>             rms1;
+Bench<AudioAnalyzeFFT256>          fft256_1;
+Bench<AudioAnalyzeFFT1024>         fft1024_1;
+Bench<AudioAnalyzeNoteFrequency>   notefreq1;
+Bench<AudioAnalyzeToneDetect>      tone1;
+Bench<AudioAnalyzeToneBank>        tonebank1;
+Bench<AudioAnalyzeMeter>           meter1;
+Bench<AudioAnalyzeLoudness>        loudness1;
+Bench<AudioPlayMemory>             playMem1;
+Bench<AudioPlayQueue>              queue1;
+
+// a synth voice: oscillator, filter, envelope
+Bench<AudioSynthWaveform>          voiceOsc;
+Bench<AudioFilterLadder>           voiceFilter;
+Bench<AudioEffectEnvelope>         voiceEnv;
+AudioConnection                    patchCord1(voiceOsc, voiceFilter);
+AudioConnection                    patchCord2(voiceFilter, voiceEnv);
+
+// an effects send: filter, reverb, and a dry/wet mixer
+Bench<AudioFilterBiquad>           sendFilter;
+Bench<AudioEffectFreeverb>         sendVerb;
+Bench<AudioMixer4>                 sendMix;
+AudioConnection                    patchCord3(sendFilter, sendVerb);
+AudioConnection                    patchCord4(sendFilter, 0, sendMix, 0);
+AudioConnection                    patchCord5(sendVerb, 0, sendMix, 1);
+
+// connections from the input signals, changed for each configuration
+AudioConnection                    input[8];
+
+// buffers some objects need
+#define CHORUS_DELAY_LENGTH (16*AUDIO_BLOCK_SAMPLES)
+#define FLANGE_DELAY_LENGTH (6*AUDIO_BLOCK_SAMPLES)
+#define GRANULAR_MEMORY_SIZE 6400
+#define REVERB_MEMORY 12000
+#define SOUND_LENGTH 4096
+short chorusBuffer[CHORUS_DELAY_LENGTH];
+short flangeBuffer[FLANGE_DELAY_LENGTH];
+int16_t granularMemory[GRANULAR_MEMORY_SIZE];
+DMAMEM int16_t reverbMemory[REVERB_MEMORY];
+short firCoefficients[64];
+float waveshape[257];
+unsigned int soundPCM[1 + SOUND_LENGTH/2];   // 16 bit PCM, for AudioPlayMemory
+unsigned int soundUlaw[1 + SOUND_LENGTH/4];  // u-law
+int16_t wavetableSine[258];
+
+// one cycle of sine, looped, with vibrato
+const AudioSynthWavetable::sample_data wavetableSamples[1] = {
+  {
+    wavetableSine, true, 9,
+    (1 << (32 - 9)) * 256.0 / AUDIO_SAMPLE_RATE_EXACT,
+    (uint32_t)256 << (32 - 9), (uint32_t)256 << (32 - 9), (uint32_t)256 << (32 - 9),
+    UINT16_MAX,
+    0, uint32_t(10 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+    0, uint32_t(200 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+    uint32_t(300 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+    int32_t((1.0 - WAVETABLE_DECIBEL_SHIFT(-6.0)) * AudioSynthWavetable::UNITY_GAIN),
+    0, uint32_t(5.0 * AudioSynthWavetable::LFO_PERIOD * (UINT32_MAX / AUDIO_SAMPLE_RATE_EXACT)),
+    (WAVETABLE_CENTS_SHIFT(10) - 1.0) * 4, (1.0 - WAVETABLE_CENTS_SHIFT(-10)) * 4,
+    0, uint32_t(3.0 * AudioSynthWavetable::LFO_PERIOD * (UINT32_MAX / AUDIO_SAMPLE_RATE_EXACT)),
+    (WAVETABLE_CENTS_SHIFT(0) - 1.0) * 4, (1.0 - WAVETABLE_CENTS_SHIFT(0)) * 4,
+    int32_t(UINT16_MAX * (WAVETABLE_DECIBEL_SHIFT(-1.0) - 1.0)) * 4,
+    int32_t(UINT16_MAX * (1.0 - WAVETABLE_DECIBEL_SHIFT(1.0))) * 4,
+  },
+};
+const uint8_t wavetableRanges[] = {127, };
+const AudioSynthWavetable::instrument_data wavetableInstrument = {1, wavetableRanges, wavetableSamples};
+
+// Each configuration has a setup function, to configure the object and
+// connect its inputs, and a function to update it, which is timed.
+// The input signals are updated before each timed call.
+struct benchmark {
+  const char *object;
+  const char *config;
+  void (*begin)();
+  void (*update)();
+};
+
+void connectSine(AudioStream &dest, int n = 1) {
+  for (int i=0; i < n; i++) input[i].connect(srcSine, 0, dest, i);
+}
+void connectNoise(AudioStream &dest, int n = 1) {
+  for (int i=0; i < n; i++) input[i].connect(srcNoise, 0, dest, i);
+}
+void connectBoth(AudioStream &dest) {
+  input[0].connect(srcSine, 0, dest, 0);
+  input[1].connect(srcNoise, 0, dest, 1);
+}
+
+const benchmark benchmarks[] = {
+  // synthesis
+  {"AudioSynthWaveformSine", "440 Hz",
+    []{ sine1.frequency(440); sine1.amplitude(0.8); },
+    []{ sine1.run(); }},
+  {"AudioSynthWaveformSineHires", "440 Hz",
+    []{ sineHires1.frequency(440); sineHires1.amplitude(0.8); },
+    []{ sineHires1.run(); }},
+  {"AudioSynthWaveformSineModulated", "FM by sine",
+    []{ sineFM1.frequency(440); sineFM1.amplitude(0.8); connectSine(sineFM1); },
+    []{ sineFM1.run(); }},
+  {"AudioSynthWaveform", "sawtooth",
+    []{ waveform1.begin(0.8, 220, WAVEFORM_SAWTOOTH); },
+    []{ waveform1.run(); }},
+  {"AudioSynthWaveform", "bandlimited sawtooth",
+    []{ waveform1.begin(0.8, 220, WAVEFORM_BANDLIMIT_SAWTOOTH); },
+    []{ waveform1.run(); }},
+  {"AudioSynthWaveformModulated", "sine, FM and shape inputs",
+    []{ waveformMod1.begin(0.8, 220, WAVEFORM_SINE); connectSine(waveformMod1, 2); },
+    []{ waveformMod1.run(); }},
+  {"AudioSynthNoiseWhite", "",
+    []{ noise1.amplitude(0.5); },
+    []{ noise1.run(); }},
+  {"AudioSynthNoisePink", "",
+    []{ pink1.amplitude(0.5); },
+    []{ pink1.run(); }},
+  {"AudioSynthKarplusStrong", "110 Hz",
+    []{ string1.noteOn(110, 0.8); },
+    []{ string1.run(); }},
+  {"AudioSynthSimpleDrum", "10 s note",
+    []{ drum1.frequency(60); drum1.length(10000); drum1.pitchMod(0.55); drum1.noteOn(); },
+    []{ drum1.run(); }},
+  {"AudioSynthWavetable", "looped sample, vibrato",
+    []{ wavetable1.setInstrument(wavetableInstrument); wavetable1.amplitude(1.0);
+        wavetable1.playFrequency(440); },
+    []{ wavetable1.run(); }},
+#if !defined(KINETISL)
+  {"AudioSynthAdditive", "64 partials",
+    []{ for (int i=0; i < 64; i++) additive1.partial(i, 55.0 * (i + 1), 0.5 / (i + 1)); },
+    []{ additive1.run(); }},
+#endif
+  {"AudioSynthFM", "algorithm 5",
+    []{ fm1.algorithm(5); fm1.noteOn(220.0f, 1.0f); },
+    []{ fm1.run(); }},
+  {"AudioSynthFMPoly", "8 voices",
+    []{ fmpoly1.algorithm(5);
+        for (int i=0; i < 8; i++) fmpoly1.noteOn((uint8_t)(48 + i * 4), 0.8f); },
+    []{ fmpoly1.run(); }},
+
+  // filters
+  {"AudioFilterBiquad", "4 stages",
+    []{ for (int i=0; i < 4; i++) biquad1.setLowpass(i, 2000, 0.707);
+        connectNoise(biquad1); },
+    []{ biquad1.run(); }},
+  {"AudioFilterFIR", "64 taps",
+    []{ fir1.begin(firCoefficients, 64); connectNoise(fir1); },
+    []{ fir1.run(); }},
+  {"AudioFilterStateVariable", "frequency input",
+    []{ filter1.frequency(1000); filter1.resonance(2.0); connectBoth(filter1); },
+    []{ filter1.run(); }},
+  {"AudioFilterLadder", "",
+    []{ ladder1.frequency(1000); ladder1.resonance(0.6); connectNoise(ladder1); },
+    []{ ladder1.run(); }},
+#if !defined(KINETISL)
+  {"AudioFilterCrossover", "4 bands",
+    []{ crossover1.frequency(200, 1000, 5000); connectNoise(crossover1); },
+    []{ crossover1.run(); }},
+#endif
+
+  // effects
+  {"AudioEffectEnvelope", "sustain",
+    []{ envelope1.attack(1); envelope1.sustain(0.5); envelope1.noteOn(); connectSine(envelope1); },
+    []{ envelope1.run(); }},
+  {"AudioEffectDelay", "3 taps, 100 ms",
+    []{ delay1.delay(0, 25); delay1.delay(1, 50); delay1.delay(2, 100); connectSine(delay1); },
+    []{ delay1.run(); }},
+  {"AudioEffectFreeverb", "",
+    []{ freeverb1.roomsize(0.7); connectNoise(freeverb1); },
+    []{ freeverb1.run(); }},
+  {"AudioEffectFreeverbStereo", "",
+    []{ freeverbs1.roomsize(0.7); connectNoise(freeverbs1); },
+    []{ freeverbs1.run(); }},
+  {"AudioEffectReverb", "1.5 s",
+    []{ reverb1.reverbTime(1.5); connectNoise(reverb1); },
+    []{ reverb1.run(); }},
+  {"AudioEffectReverbFDN", "8 lines",
+    []{ reverbfdn1.begin(reverbMemory, REVERB_MEMORY, 8); reverbfdn1.reverbTime(2.0);
+        connectNoise(reverbfdn1, 2); },
+    []{ reverbfdn1.run(); }},
+  {"AudioEffectChorus", "4 voices",
+    []{ chorus1.begin(chorusBuffer, CHORUS_DELAY_LENGTH, 4); connectSine(chorus1); },
+    []{ chorus1.run(); }},
+  {"AudioEffectFlange", "",
+    []{ flange1.begin(flangeBuffer, FLANGE_DELAY_LENGTH, FLANGE_DELAY_LENGTH/4,
+          FLANGE_DELAY_LENGTH/4, 0.5); connectSine(flange1); },
+    []{ flange1.run(); }},
+  {"AudioEffectBitcrusher", "8 bits, 11025 Hz",
+    []{ bitcrusher1.bits(8); bitcrusher1.sampleRate(11025); connectSine(bitcrusher1); },
+    []{ bitcrusher1.run(); }},
+  {"AudioEffectWaveFolder", "",
+    []{ connectBoth(wavefolder1); },
+    []{ wavefolder1.run(); }},
+  {"AudioEffectWaveshaper", "257 points",
+    []{ waveshaper1.shape(waveshape, 257); connectSine(waveshaper1); },
+    []{ waveshaper1.run(); }},
+  {"AudioEffectDistortion", "4x oversampling",
+    []{ distortion1.drive(8.0); distortion1.oversample(4); connectSine(distortion1); },
+    []{ distortion1.run(); }},
+#if !defined(KINETISL)
+  {"AudioEffectMultibandCompressor", "3 bands, stereo",
+    []{ multiband1.crossover(300, 3000); connectNoise(multiband1, 2); },
+    []{ multiband1.run(); }},
+  {"AudioEffectLimiter", "2 ms lookahead, stereo",
+    []{ limiter1.lookahead(2.0); limiter1.inputGain(4.0); connectNoise(limiter1, 2); },
+    []{ limiter1.run(); }},
+#endif
+  {"AudioEffectGranular", "pitch shift",
+    []{ granular1.begin(granularMemory, GRANULAR_MEMORY_SIZE); granular1.setSpeed(1.5);
+        granular1.beginPitchShift(40); connectSine(granular1); },
+    []{ granular1.run(); }},
+  {"AudioEffectVocoder", "19 bands",
+    []{ vocoder1.bands(19, 110.0, 7040.0); connectBoth(vocoder1); },
+    []{ vocoder1.run(); }},
+  {"AudioEffectMultiply", "",
+    []{ connectBoth(multiply1); },
+    []{ multiply1.run(); }},
+  {"AudioEffectRectifier", "",
+    []{ connectSine(rectifier1); },
+    []{ rectifier1.run(); }},
+  {"AudioEffectMidSide", "encode",
+    []{ midside1.encode(); connectBoth(midside1); },
+    []{ midside1.run(); }},
+  {"AudioEffectDigitalCombine", "XOR",
+    []{ combine1.setCombineMode(AudioEffectDigitalCombine::XOR); connectBoth(combine1); },
+    []{ combine1.run(); }},
+
+  // mixers
+  {"AudioMixer4", "4 inputs",
+    []{ for (int i=0; i < 4; i++) mixer1.gain(i, 0.25); connectSine(mixer1, 4); },
+    []{ mixer1.run(); }},
+  {"AudioAmplifier", "gain 0.5",
+    []{ amp1.gain(0.5); connectSine(amp1); },
+    []{ amp1.run(); }},
+  {"AudioMixerMatrix", "8 inputs, 8 outputs",
+    []{ for (int i=0; i < 8; i++) for (int o=0; o < 8; o++) matrix1.gain(i, o, 0.1);
+        matrix1.commit(false); connectSine(matrix1, 8); },
+    []{ matrix1.run(); }},
+
+  // analysis
+  {"AudioAnalyzePeak", "",
+    []{ connectSine(peak1); },
+    []{ peak1.run(); }},
+  {"AudioAnalyzeRMS", "",
+    []{ connectSine(rms1); },
+    []{ rms1.run(); }},
+  {"AudioAnalyzeFFT256", "",
+    []{ connectNoise(fft256_1); },
+    []{ fft256_1.run(); }},
+  {"AudioAnalyzeFFT1024", "",
+    []{ connectNoise(fft1024_1); },
+    []{ fft1024_1.run(); }},
+  {"AudioAnalyzeNoteFrequency", "",
+    []{ notefreq1.begin(0.15); connectSine(notefreq1); },
+    []{ notefreq1.run(); }},
+  {"AudioAnalyzeToneDetect", "",
+    []{ tone1.frequency(440); connectSine(tone1); },
+    []{ tone1.run(); }},
+  {"AudioAnalyzeToneBank", "DTMF",
+    []{ tonebank1.dtmf(); connectSine(tonebank1); },
+    []{ tonebank1.run(); }},
+  {"AudioAnalyzeMeter", "stereo",
+    []{ connectSine(meter1, 2); },
+    []{ meter1.run(); }},
+  {"AudioAnalyzeLoudness", "stereo",
+    []{ connectSine(loudness1, 2); },
+    []{ loudness1.run(); }},
+
+  // players, with sources in memory
+  {"AudioPlayMemory", "16 bit PCM",
+    []{ playMem1.play(soundPCM); },
+    []{ if (!playMem1.isPlaying()) playMem1.play(soundPCM); playMem1.run(); }},
+  {"AudioPlayMemory", "u-law",
+    []{ playMem1.play(soundUlaw); },
+    []{ if (!playMem1.isPlaying()) playMem1.play(soundUlaw); playMem1.run(); }},
+  {"AudioPlayQueue", "",
+    []{ queue1.setBehaviour(AudioPlayQueue::NON_STALLING); },
+    []{ queue1.play(wavetableSine, AUDIO_BLOCK_SAMPLES); queue1.run(); }},
+
+  // chains, timing every object in them
+  {"chain", "waveform > ladder > envelope",
+    []{ voiceOsc.begin(0.8, 110, WAVEFORM_BANDLIMIT_SAWTOOTH); voiceFilter.frequency(800);
+        voiceFilter.resonance(0.5); voiceEnv.sustain(0.7); voiceEnv.noteOn(); },
+    []{ voiceOsc.run(); voiceFilter.run(); voiceEnv.run(); }},
+  {"chain", "biquad > freeverb > mixer",
+    []{ sendFilter.setHighpass(0, 200); sendVerb.roomsize(0.8); sendMix.gain(0, 0.6);
+        sendMix.gain(1, 0.4); connectSine(sendFilter); },
+    []{ sendFilter.run(); sendVerb.run(); sendMix.run(); }},
+};
+
+void makeTables() {
+  // sine tables and waveshape
+  for (int i=0; i < 258; i++) {
+    wavetableSine[i] = 20000.0 * sin(i * (2.0 * PI / 256.0));
+  }
+  for (int i=0; i < 257; i++) {
+    waveshape[i] = tanhf((i - 128) / 64.0f);
+  }
+  // windowed sinc lowpass at 1/8 of the sample rate
+  for (int i=0; i < 64; i++) {
+    float x = i - 31.5f;
+    float s = sinf(PI * x / 4.0f) / (PI * x);
+    float w = 0.54f - 0.46f * cosf(2.0f * PI * i / 63.0f);
+    firCoefficients[i] = s * w * 32767.0f;
+  }
+  // sounds for AudioPlayMemory: a sweep as 16 bit PCM, noise as u-law
+  soundPCM[0] = 0x81000000 | SOUND_LENGTH;
+  int16_t *pcm = (int16_t *)(soundPCM + 1);
+  float phase = 0;
+  for (int i=0; i < SOUND_LENGTH; i++) {
+    phase += (100.0f + i) * (2.0f * PI / AUDIO_SAMPLE_RATE_EXACT);
+    pcm[i] = 16000.0f * sinf(phase);
+  }
+  soundUlaw[0] = 0x01000000 | SOUND_LENGTH;
+  uint32_t seed = 1;
+  for (int i=1; i <= SOUND_LENGTH/4; i++) {
+    seed = seed * 1664525 + 1013904223;
+    soundUlaw[i] = seed;
+  }
+}
+
+void printNumber(const char *name, float n, int digits) {
+  Serial.print(", \"");
+  Serial.print(name);
+  Serial.print("\": ");
+  Serial.print(n, digits);
+}
+
+void runBenchmark(const benchmark &b, bool last) {
+  // objects measured earlier may still hold blocks, like the delay
+  int held = AudioMemoryUsage();
+  b.begin();
+  for (int i=0; i < BENCH_WARMUP; i++) {
+    srcSine.run();
+    srcNoise.run();
+    b.update();
+  }
+  AudioMemoryUsageMaxReset();
+  uint64_t total = 0;
+  uint32_t min = 0xFFFFFFFF, max = 0;
+  for (int i=0; i < BENCH_BLOCKS; i++) {
+    srcSine.run();
+    srcNoise.run();
+    uint32_t begin = timer_read();
+    b.update();
+    uint32_t n = timer_read() - begin;
+    total += n;
+    if (n < min) min = n;
+    if (n > max) max = n;
+  }
+  for (int i=0; i < 8; i++) input[i].disconnect();
+
+  float cycles = total * timer_to_cycles / BENCH_BLOCKS;
+  float period = AUDIO_BLOCK_SAMPLES / AUDIO_SAMPLE_RATE_EXACT * F_CPU;
+  Serial.print("    {\"object\": \"");
+  Serial.print(b.object);
+  Serial.print("\", \"config\": \"");
+  Serial.print(b.config);
+  Serial.print("\"");
+  printNumber("cycles_per_block", cycles, 1);
+  printNumber("min_cycles", min * timer_to_cycles, 0);
+  printNumber("max_cycles", max * timer_to_cycles, 0);
+  printNumber("ns_per_block", cycles * (1.0e9f / F_CPU), 0);
+  printNumber("cycles_per_sample", cycles / AUDIO_BLOCK_SAMPLES, 2);
+  printNumber("cpu_percent", cycles * 100.0f / period, 3);
+  printNumber("memory_blocks", AudioMemoryUsageMax() - held, 0);
+  Serial.println(last ? "}" : "},");
+}
+
+void setup() {
+  AudioMemory(120);
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ; // wait for the Arduino Serial Monitor
+#if defined(ARM_DWT_CYCCNT)
+  ARM_DEMCR |= ARM_DEMCR_TRCENA;
+  ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#endif
+  makeTables();
+  srcSine.frequency(440);
+  srcSine.amplitude(0.8);
+  srcNoise.amplitude(0.5);
+
+  const int count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+  Serial.println("{");
+  Serial.print("  \"f_cpu\": ");
+  Serial.print(F_CPU);
+  Serial.println(",");
+  Serial.print("  \"block_samples\": ");
+  Serial.print(AUDIO_BLOCK_SAMPLES);
+  Serial.println(",");
+  Serial.print("  \"sample_rate\": ");
+  Serial.print(AUDIO_SAMPLE_RATE_EXACT, 2);
+  Serial.println(",");
+  Serial.print("  \"blocks\": ");
+  Serial.print(BENCH_BLOCKS);
+  Serial.println(",");
+  Serial.println("  \"timer\": \"" BENCH_TIMER "\",");
+  Serial.println("  \"results\": [");
+  for (int i=0; i < count; i++) {
+    runBenchmark(benchmarks[i], i == count - 1);
+  }
+  Serial.println("  ]");
+  Serial.println("}");
+}
+
+void loop() {
+}
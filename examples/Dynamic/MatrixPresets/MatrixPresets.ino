@@ -0,0 +1,98 @@
+// Switch between routing presets using AudioMixerMatrix
+//
+// Four sources feed an 8x8 matrix.  Each preset changes many routes at
+// once: all the changes are staged, then committed together.  They are
+// heard at the same moment, with a short crossfade, and without any
+// need for AudioNoInterrupts().
+//
+// Send '1' to '3' from the Arduino Serial Monitor to change presets.
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioSynthWaveform       bass;
+AudioSynthWaveform       lead;
+AudioSynthWaveformSine   pad;
+AudioSynthNoiseWhite     noise;
+AudioMixerMatrix         matrix;
+AudioEffectFreeverb      reverb;
+AudioOutputI2S           i2s1;
+AudioConnection          patchCord1(bass, 0, matrix, 0);
+AudioConnection          patchCord2(lead, 0, matrix, 1);
+AudioConnection          patchCord3(pad, 0, matrix, 2);
+AudioConnection          patchCord4(noise, 0, matrix, 3);
+AudioConnection          patchCord5(reverb, 0, matrix, 4);
+AudioConnection          patchCord6(matrix, 0, i2s1, 0);
+AudioConnection          patchCord7(matrix, 1, i2s1, 1);
+AudioConnection          patchCord8(matrix, 2, reverb, 0);
+AudioControlSGTL5000     sgtl5000_1;
+
+// matrix outputs
+#define LEFT   0
+#define RIGHT  1
+#define SEND   2
+// matrix inputs
+#define BASS   0
+#define LEAD   1
+#define PAD    2
+#define NOISE  3
+#define RETURN 4
+
+void preset(int n) {
+  matrix.disconnectAll();
+  switch (n) {
+  case 0:  // dry, bass in the center, lead left
+    matrix.gain(BASS, LEFT, 0.3);
+    matrix.gain(BASS, RIGHT, 0.3);
+    matrix.gain(LEAD, LEFT, 0.3);
+    break;
+  case 1:  // lead right with reverb, pad added
+    matrix.gain(BASS, LEFT, 0.3);
+    matrix.gain(BASS, RIGHT, 0.3);
+    matrix.gain(LEAD, RIGHT, 0.3);
+    matrix.gain(LEAD, SEND, 0.4);
+    matrix.gain(PAD, LEFT, 0.15);
+    matrix.gain(PAD, RIGHT, 0.15);
+    matrix.gain(RETURN, LEFT, 0.5);
+    matrix.gain(RETURN, RIGHT, 0.5);
+    break;
+  case 2:  // everything through the reverb, with some noise
+    matrix.gain(BASS, SEND, 0.3);
+    matrix.gain(LEAD, SEND, 0.3);
+    matrix.gain(PAD, SEND, 0.3);
+    matrix.gain(NOISE, SEND, 0.02);
+    matrix.gain(RETURN, LEFT, 0.8);
+    matrix.gain(RETURN, RIGHT, -0.8);  // inverted for width
+    break;
+  }
+  matrix.commit();
+}
+
+void setup() {
+  AudioMemory(20);
+  sgtl5000_1.enable();
+  sgtl5000_1.volume(0.5);
+  bass.begin(1.0, 55.0, WAVEFORM_SAWTOOTH);
+  lead.begin(1.0, 440.0, WAVEFORM_SQUARE);
+  pad.amplitude(1.0);
+  pad.frequency(220.0);
+  noise.amplitude(1.0);
+  reverb.roomsize(0.8);
+  preset(0);
+}
+
+void loop() {
+  if (Serial.available()) {
+    char c = Serial.read();
+    if (c >= '1' && c <= '3') {
+      preset(c - '1');
+      Serial.print("Preset ");
+      Serial.println(c);
+    }
+  }
+}
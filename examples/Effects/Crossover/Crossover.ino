@@ -0,0 +1,43 @@
+// Active speaker crossover example
+//
+// The line input (left channel) is split into 2 bands at 2200 Hz
+// with 8th order Linkwitz-Riley filters.  The low band drives the
+// woofer amplifier from the left output, and the high band drives
+// the tweeter amplifier from the right output.  The tweeter is
+// quieter and delayed, to match a woofer whose acoustic center
+// is 8.5 mm further back.
+//
+// For 3 or 4 way speakers, use frequency() with 2 or 3 numbers
+// and an output with more channels, like AudioOutputTDM.
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioInputI2S          audioIn;
+AudioFilterCrossover   crossover;
+AudioOutputI2S         audioOut;
+AudioConnection        patchCord1(audioIn, 0, crossover, 0);
+AudioConnection        patchCord2(crossover, 0, audioOut, 0);
+AudioConnection        patchCord3(crossover, 1, audioOut, 1);
+AudioControlSGTL5000   audioShield;
+
+void setup() {
+  AudioMemory(8);
+  audioShield.enable();
+  audioShield.inputSelect(AUDIO_INPUT_LINEIN);
+  audioShield.volume(0.5);
+
+  crossover.order(8);
+  crossover.frequency(2200);
+  crossover.gain(0, 1.0);
+  crossover.gain(1, 0.7);    // tweeter is 3 dB more sensitive
+  crossover.delay(1, 0.025); // 8.5 mm at 343 m/s
+}
+
+void loop() {
+}
@@ -0,0 +1,61 @@
+// Oversampled distortion example
+//
+// A guitar or other instrument connected to the audio shield
+// line input is distorted with a hard clipping curve.  Send
+// '1', '2', '4' or '8' from the Arduino Serial Monitor to change
+// the oversampling, and 'a' to turn anti-aliasing on or off.
+// Listen for the harsh, inharmonic aliasing at 1X without ADAA.
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioInputI2S          audioIn;
+AudioEffectDistortion  distortion;
+AudioOutputI2S         audioOut;
+AudioConnection        patchCord1(audioIn, 0, distortion, 0);
+AudioConnection        patchCord2(distortion, 0, audioOut, 0);
+AudioConnection        patchCord3(distortion, 0, audioOut, 1);
+AudioControlSGTL5000   audioShield;
+
+// input -1.0 to +1.0 maps to output -0.7 to +0.7, and anything
+// beyond +/-1.0 (after drive) is clipped at +/-0.7
+float hardClip[3] = {-0.7, 0.0, 0.7};
+
+bool antialias = true;
+
+void setup() {
+  AudioMemory(8);
+  audioShield.enable();
+  audioShield.inputSelect(AUDIO_INPUT_LINEIN);
+  audioShield.volume(0.4);
+
+  distortion.shape(hardClip, 3);
+  distortion.drive(8.0);
+  distortion.oversample(2);
+  distortion.adaa(antialias);
+}
+
+void loop() {
+  if (Serial.available()) {
+    char c = Serial.read();
+    if (c == '1' || c == '2' || c == '4' || c == '8') {
+      distortion.oversample(c - '0');
+      Serial.print("Oversample ");
+      Serial.println(c);
+    } else if (c == 'a') {
+      antialias = !antialias;
+      distortion.adaa(antialias);
+      Serial.print("ADAA ");
+      Serial.println(antialias ? "on" : "off");
+    }
+  }
+  // uncomment to see how much CPU time each setting uses
+  //Serial.print("CPU=");
+  //Serial.println(AudioProcessorUsageMax());
+  //delay(500);
+}
@@ -0,0 +1,59 @@
+// Multiband compressor and lookahead limiter example
+//
+// Stereo line input is compressed in 3 bands, then limited to
+// -1 dBFS with 6 dB of extra gain, for a louder output which
+// never clips.  The gain reduction of each band and the limiter
+// is printed to the Arduino Serial Monitor.
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioInputI2S                   audioIn;
+AudioEffectMultibandCompressor  multiband;
+AudioEffectLimiter              limiter;
+AudioOutputI2S                  audioOut;
+AudioConnection                 patchCord1(audioIn, 0, multiband, 0);
+AudioConnection                 patchCord2(audioIn, 1, multiband, 1);
+AudioConnection                 patchCord3(multiband, 0, limiter, 0);
+AudioConnection                 patchCord4(multiband, 1, limiter, 1);
+AudioConnection                 patchCord5(limiter, 0, audioOut, 0);
+AudioConnection                 patchCord6(limiter, 1, audioOut, 1);
+AudioControlSGTL5000            audioShield;
+
+void setup() {
+  AudioMemory(12);
+  audioShield.enable();
+  audioShield.inputSelect(AUDIO_INPUT_LINEIN);
+  audioShield.volume(0.5);
+
+  multiband.crossover(150, 2500);
+  // band, threshold, attack, release, ratio, knee
+  multiband.compression(0, -24.0, 0.010, 0.200, 4.0, 6.0);
+  multiband.compression(1, -20.0, 0.005, 0.100, 3.0, 6.0);
+  multiband.compression(2, -24.0, 0.002, 0.050, 4.0, 6.0);
+  multiband.makeupGain(0, 4.0);
+  multiband.makeupGain(1, 3.0);
+  multiband.makeupGain(2, 4.0);
+
+  limiter.limit(-1.0, 0.05);
+  limiter.lookahead(2.0);
+  limiter.inputGain(6.0);
+}
+
+void loop() {
+  Serial.print("Bands: ");
+  for (int i=0; i < 3; i++) {
+    Serial.print(multiband.gainReduction(i), 1);
+    Serial.print(" ");
+  }
+  Serial.print(" Limiter: ");
+  Serial.print(limiter.gainReduction(), 1);
+  Serial.print(" dB,  CPU=");
+  Serial.println(AudioProcessorUsageMax());
+  delay(200);
+}
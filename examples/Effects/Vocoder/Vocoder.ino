@@ -0,0 +1,55 @@
+/* Channel vocoder using the AudioEffectVocoder filter bank
+ *
+ * Connect a microphone or voice signal to the left line input, and
+ * a synth or instrument to the right line input.  The voice shapes
+ * the spectrum of the instrument, which is heard on both outputs.
+ *
+ * This does the same job as the Vocoder19Band example, but with a
+ * single filter bank object instead of about 170 separate objects,
+ * so it needs much less CPU time and only a few audio blocks.
+ *
+ * This example code is in the public domain.
+ */
+#include <Audio.h>
+
+const int myInput = AUDIO_INPUT_LINEIN;
+
+AudioInputI2S            i2s1;
+AudioSynthNoiseWhite     noise1;
+AudioMixer4              mixer1;
+AudioEffectVocoder       vocoder1;
+AudioOutputI2S           i2s2;
+AudioConnection          patchCord1(i2s1, 0, vocoder1, 0);  // voice (modulator)
+AudioConnection          patchCord2(i2s1, 1, mixer1, 0);    // instrument
+AudioConnection          patchCord3(noise1, 0, mixer1, 1);  // sibilance
+AudioConnection          patchCord4(mixer1, 0, vocoder1, 1); // carrier
+AudioConnection          patchCord5(vocoder1, 0, i2s2, 0);
+AudioConnection          patchCord6(vocoder1, 0, i2s2, 1);
+AudioControlSGTL5000     sgtl5000_1;
+
+void setup() {
+  Serial.begin(115200);
+  AudioMemory(12);
+  sgtl5000_1.enable();
+  sgtl5000_1.inputSelect(myInput);
+  sgtl5000_1.volume(0.7);
+
+  noise1.amplitude(0.7);      // controls sibilance (hiss syllables)
+  mixer1.gain(0, 0.7);        // instrument level
+  mixer1.gain(1, 0.1);        // noise level
+
+  vocoder1.bands(19, 110.0, 7040.0);  // same range as Vocoder19Band
+  vocoder1.attack(2.0);
+  vocoder1.release(25.0);
+  vocoder1.gain(2.0);
+}
+
+void loop() {
+  Serial.print(AudioProcessorUsage());
+  Serial.print("/");
+  Serial.print(AudioProcessorUsageMax());
+  Serial.print("  memory: ");
+  Serial.println(AudioMemoryUsageMax());
+  AudioProcessorUsageMaxReset();
+  delay(100);
+}
@@ -0,0 +1,648 @@
+// GoldenOutput
+//
+// This example checks that audio objects still produce the same
+// output as a known good version of the library.  Use it before
+// and after changing or optimizing the library code.
+//
+// Each object gets the same input signals every time: a chirp from
+// 20 Hz to about 8 kHz and pseudo-random noise, computed with integer
+// math only.  It runs for 100 blocks.  A signature of all its output is then
+// compared to golden.h:
+//   - Integer code paths must match exactly (CRC32 of every sample).
+//   - Floating point code paths may round differently between
+//     compilers, so their RMS and peak must match within the
+//     tolerance given in the checks[] list.
+//
+// The integer paths differ by processor.  Teensy 3.x and 4.x use
+// the ARM_ARCH_7EM DSP instructions, and Teensy LC uses the
+// KINETISL C code.  Objects set to a frequency in Hz also give
+// different samples at Teensy 3.x and LC's 44117.647 Hz sample rate
+// than at Teensy 4's 44100 Hz.  So golden.h has a table for each
+// code path and sample rate.
+//
+// To record golden values, run this on a known good version of
+// the library.  Checks without a golden value print "RECORD", and
+// at the end a new table is printed.  Copy it from the Arduino
+// Serial Monitor into golden.h and add it to the goldens[] list,
+// then upload again to compare.  extras/hosttest builds this on a
+// PC for each table, with "make golden".
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+#include <effect_dynamics.h>  // not included by Audio.h
+
+#define CHECK_BLOCKS 100
+
+#if defined(__ARM_ARCH_7EM__)
+  #define CODE_PATH "ARM_ARCH_7EM"
+#elif defined(KINETISL)
+  #define CODE_PATH "KINETISL"
+#else
+  #define CODE_PATH "generic"
+#endif
+
+// the sample rate, rounded down to a whole number of Hz
+#define SAMPLE_RATE ((uint32_t)AUDIO_SAMPLE_RATE_EXACT)
+
+struct golden_t {
+  const char *object;
+  const char *config;
+  uint32_t crc;
+  float rms;
+  int32_t peak;
+};
+struct golden_set {
+  const char *path;
+  uint32_t rate;
+  const golden_t *golden;
+};
+#include "golden.h"
+
+// signature of everything an object produced
+struct signature {
+  uint32_t crc;
+  double sumsq;
+  int32_t peak;
+  uint32_t count;
+};
+
+void addByte(signature &s, uint8_t b) {
+  s.crc ^= b;
+  for (int i=0; i < 8; i++) {
+    s.crc = (s.crc >> 1) ^ (0xEDB88320 & -(s.crc & 1));
+  }
+}
+
+void addSamples(signature &s, const int16_t *data, int n) {
+  for (int i=0; i < n; i++) {
+    int32_t v = data[i];
+    addByte(s, v & 255);
+    addByte(s, (v >> 8) & 255);
+    s.sumsq += (double)v * v;
+    if (abs(v) > s.peak) s.peak = abs(v);
+  }
+  s.count += n;
+}
+
+// analyzer results are added as 16 bit numbers
+void addValue(signature &s, float n) {
+  int16_t v = constrain(n * 32767.0f, -32768.0f, 32767.0f);
+  addSamples(s, &v, 1);
+}
+
+// update() is not public in every object, but a derived class
+// may call it.  Bench<T> is T with a public run() function.
+template <class T> class Bench : public T {
+public:
+  void run() { this->update(); }
+};
+
+// input signals, and queues to capture up to 4 outputs
+Bench<AudioPlayQueue>              inputA;
+Bench<AudioPlayQueue>              inputB;
+Bench<AudioRecordQueue>            output[4];
+
+// objects checked
+Bench<AudioSynthWaveformSine>      sine1;
+Bench<AudioSynthWaveformSineHires> sineHires1;
+Bench<AudioSynthWaveformSineModulated> sineFM1;
+Bench<AudioSynthWaveform>          waveform1;
+Bench<AudioSynthWaveform>          waveform2;
+Bench<AudioSynthWaveformModulated> waveformMod1;
+Bench<AudioSynthWaveformDc>        dc1;
+Bench<AudioSynthWaveformPWM>       pwm1;
+Bench<AudioSynthToneSweep>         sweep1;
+Bench<AudioSynthNoiseWhite>        noise1;
+Bench<AudioSynthNoisePink>         pink1;
+Bench<AudioSynthKarplusStrong>     string1;
+Bench<AudioSynthSimpleDrum>        drum1;
+Bench<AudioSynthWavetable>         wavetable1;
+#if !defined(KINETISL)
+Bench<AudioSynthAdditive>          additive1;
+#endif
+Bench<AudioSynthFM>                fm1;
+Bench<AudioSynthFMPoly>            fmpoly1;
+Bench<AudioPlayMemory>             playMem1;
+Bench<AudioFilterBiquad>           biquad1;
+Bench<AudioFilterFIR>              fir1;
+Bench<AudioFilterStateVariable>    filter1;
+Bench<AudioFilterLadder>           ladder1;
+#if !defined(KINETISL)
+Bench<AudioFilterCrossover>        crossover1;
+#endif
+Bench<AudioEffectEnvelope>         envelope1;
+Bench<AudioEffectFade>             fade1;
+Bench<AudioEffectDelay>            delay1;
+Bench<AudioEffectFreeverb>         freeverb1;
+Bench<AudioEffectFreeverbStereo>   freeverbs1;
+Bench<AudioEffectReverb>           reverb1;
+Bench<AudioEffectReverbFDN>        reverbfdn1;
+Bench<AudioEffectChorus>           chorus1;
+Bench<AudioEffectFlange>           flange1;
+Bench<AudioEffectGranular>         granular1;
+Bench<AudioEffectBitcrusher>       bitcrusher1;
+Bench<AudioEffectWaveFolder>       wavefolder1;
+Bench<AudioEffectWaveshaper>       waveshaper1;
+Bench<AudioEffectDistortion>       distortion1;
+#if !defined(KINETISL)
+Bench<AudioEffectDynamics>         dynamics1;
+Bench<AudioEffectMultibandCompressor> multiband1;
+Bench<AudioEffectLimiter>          limiter1;
+#endif
+Bench<AudioEffectVocoder>          vocoder1;
+Bench<AudioEffectMultiply>         multiply1;
+Bench<AudioEffectRectifier>        rectifier1;
+Bench<AudioEffectMidSide>          midside1;
+Bench<AudioEffectDigitalCombine>   combine1;
+Bench<AudioMixer4>                 mixer1;
+Bench<AudioMixer4>                 mixer2;
+Bench<AudioAmplifier>              amp1;
+Bench<AudioMixerMatrix>            matrix1;
+Bench<AudioAnalyzePeak>            peak1;
+Bench<AudioAnalyzeRMS>             rms1;
+Bench<AudioAnalyzeFFT256>          fft256_1;
+Bench<AudioAnalyzeFFT1024>         fft1024_1;
+Bench<AudioAnalyzeToneDetect>      tone1;
+Bench<AudioAnalyzeToneBank>        tonebank1;
+Bench<AudioAnalyzeNoteFrequency>   notefreq1;
+Bench<AudioAnalyzeMeter>           meter1;
+Bench<AudioAnalyzeLoudness>        loudness1;
+
+// connections, changed for each check
+AudioConnection                    inputCord[8];
+AudioConnection                    outputCord[4];
+
+#define CHORUS_DELAY_LENGTH (16*AUDIO_BLOCK_SAMPLES)
+#define FLANGE_DELAY_LENGTH (6*AUDIO_BLOCK_SAMPLES)
+#define GRANULAR_MEMORY_SIZE 6400
+#define REVERB_MEMORY 12000
+short chorusBuffer[CHORUS_DELAY_LENGTH];
+short flangeBuffer[FLANGE_DELAY_LENGTH];
+int16_t granularMemory[GRANULAR_MEMORY_SIZE];
+DMAMEM int16_t reverbMemory[REVERB_MEMORY];
+const short firCoefficients[16] = {
+  -112, -284, -394, 0, 1344, 3542, 5787, 7117,
+  7117, 5787, 3542, 1344, 0, -394, -284, -112
+};
+const float softClip[4] = {0, 1.5, 0, -0.5};  // 1.5x - 0.5x^3
+float waveshape[17] = {
+  -0.9, -0.85, -0.8, -0.7, -0.6, -0.45, -0.3, -0.15, 0,
+  0.15, 0.3, 0.45, 0.6, 0.7, 0.8, 0.85, 0.9
+};
+// 1000 samples of 16 bit PCM, 2 per word, after the format and length,
+// padded to 1024 samples like wav2sketch
+unsigned int soundPCM[1 + 512];
+
+// one cycle of sine, looped, with vibrato and tremolo, released
+// halfway through the check
+int16_t wavetableSine[258];
+const AudioSynthWavetable::sample_data wavetableSamples[1] = {
+  {
+    wavetableSine, true, 9,
+    (1 << (32 - 9)) * 256.0 / AUDIO_SAMPLE_RATE_EXACT,
+    (uint32_t)256 << (32 - 9), (uint32_t)256 << (32 - 9), (uint32_t)256 << (32 - 9),
+    UINT16_MAX,
+    0, uint32_t(10 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+    0, uint32_t(200 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+    uint32_t(50 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+    int32_t((1.0 - WAVETABLE_DECIBEL_SHIFT(-6.0)) * AudioSynthWavetable::UNITY_GAIN),
+    0, uint32_t(5.0 * AudioSynthWavetable::LFO_PERIOD * (UINT32_MAX / AUDIO_SAMPLE_RATE_EXACT)),
+    (WAVETABLE_CENTS_SHIFT(10) - 1.0) * 4, (1.0 - WAVETABLE_CENTS_SHIFT(-10)) * 4,
+    uint32_t(20 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::LFO_PERIOD),
+    uint32_t(3.0 * AudioSynthWavetable::LFO_PERIOD * (UINT32_MAX / AUDIO_SAMPLE_RATE_EXACT)),
+    (WAVETABLE_CENTS_SHIFT(0) - 1.0) * 4, (1.0 - WAVETABLE_CENTS_SHIFT(0)) * 4,
+    int32_t(UINT16_MAX * (WAVETABLE_DECIBEL_SHIFT(-1.0) - 1.0)) * 4,
+    int32_t(UINT16_MAX * (1.0 - WAVETABLE_DECIBEL_SHIFT(1.0))) * 4,
+  },
+};
+const uint8_t wavetableRanges[] = {127, };
+const AudioSynthWavetable::instrument_data wavetableInstrument = {1, wavetableRanges, wavetableSamples};
+int wavetableBlocks;
+
+// The chirp sweeps a triangle wave from 20 Hz to about 8 kHz in 100
+// blocks, and the noise is a 32 bit xorshift generator.  Both restart
+// for every check.
+uint32_t chirpPhase, chirpIncrement, noiseState;
+
+void resetInputs() {
+  chirpPhase = 0;
+  chirpIncrement = 20 * 97391;  // 20 Hz, 2^32 / 44100 = 97391
+  noiseState = 2463534242;
+}
+
+void updateInputs() {
+  int16_t a[AUDIO_BLOCK_SAMPLES], b[AUDIO_BLOCK_SAMPLES];
+  for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+    int32_t tri = (chirpPhase >> 15) & 0xFFFF;
+    if (chirpPhase & 0x80000000) tri = 0xFFFF - tri;
+    a[i] = (tri - 0x8000) * 3 / 4;
+    chirpPhase += chirpIncrement;
+    chirpIncrement += 60000;
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+    b[i] = (int32_t)noiseState >> 18;
+  }
+  inputA.play(a, AUDIO_BLOCK_SAMPLES);
+  inputB.play(b, AUDIO_BLOCK_SAMPLES);
+  inputA.run();
+  inputB.run();
+}
+
+void connectA(AudioStream &dest, int n = 1) {
+  for (int i=0; i < n; i++) inputCord[i].connect(inputA, 0, dest, i);
+}
+void connectB(AudioStream &dest, int n = 1) {
+  for (int i=0; i < n; i++) inputCord[i].connect(inputB, 0, dest, i);
+}
+void connectAB(AudioStream &dest) {
+  inputCord[0].connect(inputA, 0, dest, 0);
+  inputCord[1].connect(inputB, 0, dest, 1);
+}
+void listen(AudioStream &src, int n = 1) {
+  for (int i=0; i < n; i++) outputCord[i].connect(src, i, output[i], 0);
+}
+
+// Each check configures and connects an object, then updates it once
+// per block.  Analyzers add their results to the signature instead.
+struct check {
+  const char *object;
+  const char *config;
+  float tolerance;     // 0 for bit exact, otherwise allowed RMS ratio error
+  void (*begin)();
+  void (*update)();
+  void (*result)(signature &s);
+};
+
+const check checks[] = {
+  {"AudioSynthWaveformSine", "1 kHz", 0,
+    []{ sine1.frequency(1000); sine1.amplitude(0.9); listen(sine1); },
+    []{ sine1.run(); }, NULL},
+  {"AudioSynthWaveformSineHires", "1 kHz", 0,
+    []{ sineHires1.frequency(1000); sineHires1.amplitude(0.9); listen(sineHires1, 2); },
+    []{ sineHires1.run(); }, NULL},
+  {"AudioSynthWaveformSineModulated", "FM by chirp", 0,
+    []{ sineFM1.frequency(1000); sineFM1.amplitude(0.9); connectA(sineFM1); listen(sineFM1); },
+    []{ sineFM1.run(); }, NULL},
+  {"AudioSynthWaveform", "sawtooth", 0,
+    []{ waveform1.begin(0.9, 330, WAVEFORM_SAWTOOTH); listen(waveform1); },
+    []{ waveform1.run(); }, NULL},
+  {"AudioSynthWaveform", "bandlimited square", 0,
+    []{ waveform2.begin(0.9, 330, WAVEFORM_BANDLIMIT_SQUARE); listen(waveform2); },
+    []{ waveform2.run(); }, NULL},
+  {"AudioSynthWaveformModulated", "triangle, FM by chirp", 0,
+    []{ waveformMod1.begin(0.9, 330, WAVEFORM_TRIANGLE); connectA(waveformMod1);
+        listen(waveformMod1); },
+    []{ waveformMod1.run(); }, NULL},
+  {"AudioSynthWaveformDc", "50 ms ramp", 0,
+    []{ dc1.amplitude(0.8, 50); listen(dc1); },
+    []{ dc1.run(); }, NULL},
+  {"AudioSynthWaveformPWM", "chirp", 0,
+    []{ pwm1.frequency(220); pwm1.amplitude(0.8); connectA(pwm1); listen(pwm1); },
+    []{ pwm1.run(); }, NULL},
+  {"AudioSynthToneSweep", "100 Hz to 4 kHz", 0,
+    []{ sweep1.play(0.8, 100, 4000, 0.3); listen(sweep1); },
+    []{ sweep1.run(); }, NULL},
+  {"AudioSynthNoiseWhite", "", 0,
+    []{ noise1.amplitude(0.5); listen(noise1); },
+    []{ noise1.run(); }, NULL},
+  {"AudioSynthNoisePink", "", 0,
+    []{ pink1.amplitude(0.5); listen(pink1); },
+    []{ pink1.run(); }, NULL},
+  {"AudioSynthKarplusStrong", "220 Hz", 0,
+    []{ string1.noteOn(220, 0.8); listen(string1); },
+    []{ string1.run(); }, NULL},
+  {"AudioSynthSimpleDrum", "", 0,
+    []{ drum1.frequency(80); drum1.length(500); drum1.pitchMod(0.6); drum1.noteOn();
+        listen(drum1); },
+    []{ drum1.run(); }, NULL},
+  {"AudioSynthWavetable", "vibrato, tremolo, released", 0,
+    []{ for (int i=0; i < 258; i++) wavetableSine[i] = 20000.0 * sin(i * (2.0 * PI / 256.0));
+        wavetable1.setInstrument(wavetableInstrument); wavetable1.amplitude(1.0);
+        wavetable1.playFrequency(440); wavetableBlocks = 0; listen(wavetable1); },
+    []{ wavetable1.run(); if (++wavetableBlocks == CHECK_BLOCKS / 2) wavetable1.stop(); }, NULL},
+#if !defined(KINETISL)
+  {"AudioSynthAdditive", "16 partials", 0,
+    []{ for (int i=0; i < 16; i++) additive1.partial(i, 110.0 * (i + 1), 0.5 / (i + 1));
+        listen(additive1); },
+    []{ additive1.run(); }, NULL},
+#endif
+  {"AudioSynthFM", "algorithm 5", 0.001,
+    []{ fm1.algorithm(5); fm1.noteOn(220.0f, 1.0f); listen(fm1); },
+    []{ fm1.run(); }, NULL},
+  {"AudioSynthFMPoly", "3 notes", 0.001,
+    []{ fmpoly1.noteOn(57); fmpoly1.noteOn(61); fmpoly1.noteOn(64); listen(fmpoly1); },
+    []{ fmpoly1.run(); }, NULL},
+  {"AudioPlayMemory", "16 bit PCM", 0,
+    []{ for (int i=0; i < 500; i++) soundPCM[1 + i] = (i * 40) | ((-i * 40) << 16);
+        soundPCM[0] = 0x81000000 | 1000; playMem1.play(soundPCM); listen(playMem1); },
+    []{ playMem1.run(); }, NULL},
+  {"AudioPlayQueue", "noise input", 0,
+    []{ listen(inputB); },
+    []{ }, NULL},
+
+  {"AudioFilterBiquad", "2 stage lowpass", 0,
+    []{ biquad1.setLowpass(0, 1000, 0.707); biquad1.setLowpass(1, 1000, 0.707);
+        connectB(biquad1); listen(biquad1); },
+    []{ biquad1.run(); }, NULL},
+  {"AudioFilterFIR", "16 taps", 0,
+    []{ fir1.begin(firCoefficients, 16); connectB(fir1); listen(fir1); },
+    []{ fir1.run(); }, NULL},
+  {"AudioFilterStateVariable", "chirp control", 0,
+    []{ filter1.frequency(1000); filter1.resonance(2.0); connectAB(filter1); listen(filter1, 3); },
+    []{ filter1.run(); }, NULL},
+  {"AudioFilterLadder", "", 0.001,
+    []{ ladder1.frequency(1000); ladder1.resonance(0.6); connectB(ladder1); listen(ladder1); },
+    []{ ladder1.run(); }, NULL},
+#if !defined(KINETISL)
+  {"AudioFilterCrossover", "3 bands", 0.001,
+    []{ crossover1.frequency(300, 3000); connectB(crossover1); listen(crossover1, 3); },
+    []{ crossover1.run(); }, NULL},
+#endif
+
+  {"AudioEffectEnvelope", "", 0,
+    []{ envelope1.attack(20); envelope1.decay(50); envelope1.sustain(0.5); envelope1.noteOn();
+        connectA(envelope1); listen(envelope1); },
+    []{ envelope1.run(); }, NULL},
+  {"AudioEffectFade", "100 ms out", 0,
+    []{ fade1.fadeOut(100); connectA(fade1); listen(fade1); },
+    []{ fade1.run(); }, NULL},
+  {"AudioEffectDelay", "2 taps", 0,
+    []{ delay1.delay(0, 5); delay1.delay(1, 30); connectA(delay1); listen(delay1, 2); },
+    []{ delay1.run(); }, NULL},
+  {"AudioEffectFreeverb", "", 0,
+    []{ freeverb1.roomsize(0.7); connectB(freeverb1); listen(freeverb1); },
+    []{ freeverb1.run(); }, NULL},
+  {"AudioEffectFreeverbStereo", "", 0,
+    []{ freeverbs1.roomsize(0.7); connectB(freeverbs1); listen(freeverbs1, 2); },
+    []{ freeverbs1.run(); }, NULL},
+  {"AudioEffectReverb", "", 0,
+    []{ reverb1.reverbTime(1.0); connectB(reverb1); listen(reverb1); },
+    []{ reverb1.run(); }, NULL},
+  {"AudioEffectReverbFDN", "8 lines", 0.001,
+    []{ reverbfdn1.begin(reverbMemory, REVERB_MEMORY, 8); reverbfdn1.reverbTime(1.5);
+        connectB(reverbfdn1); listen(reverbfdn1, 2); },
+    []{ reverbfdn1.run(); }, NULL},
+  {"AudioEffectChorus", "3 voices", 0,
+    []{ chorus1.begin(chorusBuffer, CHORUS_DELAY_LENGTH, 3); connectA(chorus1); listen(chorus1); },
+    []{ chorus1.run(); }, NULL},
+  {"AudioEffectFlange", "", 0,
+    []{ flange1.begin(flangeBuffer, FLANGE_DELAY_LENGTH, FLANGE_DELAY_LENGTH/4,
+          FLANGE_DELAY_LENGTH/4, 0.5); connectA(flange1); listen(flange1); },
+    []{ flange1.run(); }, NULL},
+  {"AudioEffectGranular", "pitch shift", 0.001,
+    []{ granular1.begin(granularMemory, GRANULAR_MEMORY_SIZE); granular1.setSpeed(1.5);
+        granular1.beginPitchShift(40); connectA(granular1); listen(granular1); },
+    []{ granular1.run(); }, NULL},
+  {"AudioEffectBitcrusher", "6 bits, 8 kHz", 0,
+    []{ bitcrusher1.bits(6); bitcrusher1.sampleRate(8000); connectA(bitcrusher1);
+        listen(bitcrusher1); },
+    []{ bitcrusher1.run(); }, NULL},
+  {"AudioEffectWaveFolder", "", 0,
+    []{ connectAB(wavefolder1); listen(wavefolder1); },
+    []{ wavefolder1.run(); }, NULL},
+  {"AudioEffectWaveshaper", "17 points", 0,
+    []{ waveshaper1.shape(waveshape, 17); connectA(waveshaper1); listen(waveshaper1); },
+    []{ waveshaper1.run(); }, NULL},
+  {"AudioEffectDistortion", "cubic, 2x oversampling", 0.001,
+    []{ distortion1.polynomial(softClip, 4); distortion1.drive(6.0); distortion1.oversample(2);
+        connectA(distortion1); listen(distortion1); },
+    []{ distortion1.run(); }, NULL},
+#if !defined(KINETISL)
+  {"AudioEffectDynamics", "compression", 0.001,
+    []{ dynamics1.compression(-20.0f, 0.01f, 0.1f, 4.0f); connectA(dynamics1);
+        listen(dynamics1); },
+    []{ dynamics1.run(); }, NULL},
+  {"AudioEffectMultibandCompressor", "3 bands, stereo", 0.001,
+    []{ multiband1.crossover(300, 3000); connectAB(multiband1); listen(multiband1, 2); },
+    []{ multiband1.run(); }, NULL},
+  {"AudioEffectLimiter", "stereo", 0.001,
+    []{ limiter1.inputGain(4.0); connectA(limiter1, 2); listen(limiter1, 2); },
+    []{ limiter1.run(); }, NULL},
+#endif
+  {"AudioEffectVocoder", "8 bands", 0.001,
+    []{ vocoder1.bands(8, 200.0, 6000.0); connectAB(vocoder1); listen(vocoder1); },
+    []{ vocoder1.run(); }, NULL},
+  {"AudioEffectMultiply", "", 0,
+    []{ connectAB(multiply1); listen(multiply1); },
+    []{ multiply1.run(); }, NULL},
+  {"AudioEffectRectifier", "", 0,
+    []{ connectA(rectifier1); listen(rectifier1); },
+    []{ rectifier1.run(); }, NULL},
+  {"AudioEffectMidSide", "encode", 0,
+    []{ midside1.encode(); connectAB(midside1); listen(midside1, 2); },
+    []{ midside1.run(); }, NULL},
+  {"AudioEffectDigitalCombine", "XOR", 0,
+    []{ combine1.setCombineMode(AudioEffectDigitalCombine::XOR); connectAB(combine1);
+        listen(combine1); },
+    []{ combine1.run(); }, NULL},
+
+  {"AudioMixer4", "unity gain", 0,
+    []{ for (int i=0; i < 4; i++) mixer1.gain(i, 1.0); connectAB(mixer1);
+        inputCord[2].connect(inputA, 0, mixer1, 2); listen(mixer1); },
+    []{ mixer1.run(); }, NULL},
+  {"AudioMixer4", "mixed gains", 0,
+    []{ mixer2.gain(0, 0.7); mixer2.gain(1, -0.35); mixer2.gain(2, 1.5);
+        connectAB(mixer2); inputCord[2].connect(inputA, 0, mixer2, 2); listen(mixer2); },
+    []{ mixer2.run(); }, NULL},
+  {"AudioAmplifier", "gain 2.5", 0,
+    []{ amp1.gain(2.5); connectA(amp1); listen(amp1); },
+    []{ amp1.run(); }, NULL},
+  {"AudioMixerMatrix", "2 inputs, 2 outputs", 0,
+    []{ matrix1.gain(0, 0, 0.8); matrix1.gain(1, 0, 0.3); matrix1.gain(0, 1, -0.5);
+        matrix1.gain(1, 1, 1.0); matrix1.commit(false); connectAB(matrix1); listen(matrix1, 2); },
+    []{ matrix1.run(); }, NULL},
+
+  {"AudioAnalyzePeak", "", 0,
+    []{ connectA(peak1); },
+    []{ peak1.run(); },
+    [](signature &s){ if (peak1.available()) addValue(s, peak1.read()); }},
+  {"AudioAnalyzeRMS", "", 0.001,
+    []{ connectB(rms1); },
+    []{ rms1.run(); },
+    [](signature &s){ if (rms1.available()) addValue(s, rms1.read()); }},
+  {"AudioAnalyzeFFT256", "", 0,
+    []{ connectB(fft256_1); },
+    []{ fft256_1.run(); },
+    [](signature &s){ if (fft256_1.available()) {
+        for (int i=0; i < 128; i++) addValue(s, fft256_1.read(i)); } }},
+  {"AudioAnalyzeFFT1024", "", 0,
+    []{ connectB(fft1024_1); },
+    []{ fft1024_1.run(); },
+    [](signature &s){ if (fft1024_1.available()) {
+        for (int i=0; i < 512; i++) addValue(s, fft1024_1.read(i)); } }},
+  {"AudioAnalyzeToneDetect", "1 kHz", 0.001,
+    []{ tone1.frequency(1000, 20); connectA(tone1); },
+    []{ tone1.run(); },
+    [](signature &s){ if (tone1.available()) addValue(s, tone1.read()); }},
+  // an odd number of tones, so the last runs alone
+  {"AudioAnalyzeToneBank", "5 tones", 0.001,
+    []{ for (int i=0; i < 5; i++) tonebank1.frequency(i, 250 * (i + 1)); connectA(tonebank1); },
+    []{ tonebank1.run(); },
+    [](signature &s){ if (tonebank1.available()) {
+        for (int i=0; i < 5; i++) addValue(s, tonebank1.read(i)); } }},
+  // frequency is added in units of 10 kHz
+  {"AudioAnalyzeNoteFrequency", "chirp", 0.001,
+    []{ notefreq1.begin(0.15); connectA(notefreq1); },
+    []{ notefreq1.run(); },
+    [](signature &s){ if (notefreq1.available()) {
+        addValue(s, notefreq1.read() * 0.0001f); addValue(s, notefreq1.probability()); } }},
+  {"AudioAnalyzeMeter", "stereo", 0.001,
+    []{ connectAB(meter1); },
+    []{ meter1.run(); },
+    [](signature &s){ if (meter1.available()) for (int c=0; c < 2; c++) {
+        addValue(s, meter1.readPeak(c)); addValue(s, meter1.readRMS(c));
+        addValue(s, meter1.readPPM(c)); addValue(s, meter1.readVU(c)); } }},
+  // loudness is added in units of 100 LU
+  {"AudioAnalyzeLoudness", "stereo", 0.001,
+    []{ connectAB(loudness1); },
+    []{ loudness1.run(); },
+    [](signature &s){ if (loudness1.available()) {
+        addValue(s, loudness1.readMomentary() * 0.01f);
+        addValue(s, loudness1.readShortTerm() * 0.01f); } }},
+};
+
+void runCheck(const check &c, signature &s) {
+  s.crc = 0xFFFFFFFF;
+  s.sumsq = 0;
+  s.peak = 0;
+  s.count = 0;
+  resetInputs();
+  c.begin();
+  for (int i=0; i < 4; i++) output[i].begin();
+  for (int n=0; n < CHECK_BLOCKS; n++) {
+    updateInputs();
+    c.update();
+    for (int i=0; i < 4; i++) {
+      output[i].run();
+      while (output[i].available()) {
+        addSamples(s, output[i].readBuffer(), AUDIO_BLOCK_SAMPLES);
+        output[i].freeBuffer();
+      }
+    }
+    if (c.result) c.result(s);
+  }
+  for (int i=0; i < 4; i++) {
+    output[i].end();
+    output[i].clear();
+    outputCord[i].disconnect();
+  }
+  for (int i=0; i < 8; i++) inputCord[i].disconnect();
+  s.crc = ~s.crc;
+}
+
+// the golden.h table for this code path and sample rate, or NULL
+const golden_t * findTable() {
+  for (const golden_set *t = goldens; t->path; t++) {
+    if (strcmp(t->path, CODE_PATH) == 0 && t->rate == SAMPLE_RATE) return t->golden;
+  }
+  return NULL;
+}
+
+const golden_t * findGolden(const golden_t *table, const check &c) {
+  if (!table) return NULL;
+  for (const golden_t *g = table; g->object; g++) {
+    if (strcmp(g->object, c.object) == 0 && strcmp(g->config, c.config) == 0) return g;
+  }
+  return NULL;
+}
+
+void setup() {
+  AudioMemory(50);
+  Serial.begin(9600);
+  while (!Serial && millis() < 4000) ; // wait for the Arduino Serial Monitor
+  inputA.setBehaviour(AudioPlayQueue::NON_STALLING);
+  inputB.setBehaviour(AudioPlayQueue::NON_STALLING);
+
+  const int count = sizeof(checks) / sizeof(checks[0]);
+  static signature result[sizeof(checks) / sizeof(checks[0])];
+  int passed = 0, failed = 0, recorded = 0;
+
+  Serial.print("Golden output check, " CODE_PATH " code path, ");
+  Serial.print(SAMPLE_RATE);
+  Serial.println(" Hz");
+  const golden_t *table = findTable();
+  if (!table) {
+    Serial.println("golden.h has no table for this code path and sample rate,");
+    Serial.println("so all results will be recorded");
+  }
+  for (int i=0; i < count; i++) {
+    const check &c = checks[i];
+    signature &s = result[i];
+    runCheck(c, s);
+    float rms = s.count ? sqrt(s.sumsq / s.count) : 0;
+    const golden_t *g = findGolden(table, c);
+    if (!g) {
+      Serial.print("RECORD ");
+      recorded++;
+    } else if (c.tolerance == 0 ? s.crc == g->crc :
+      fabsf(rms - g->rms) <= c.tolerance * max(g->rms, 1.0f) &&
+      abs(s.peak - g->peak) <= max(4, (int)(c.tolerance * g->peak))) {
+      Serial.print("pass   ");
+      passed++;
+    } else {
+      Serial.print("FAIL   ");
+      failed++;
+    }
+    Serial.print(c.object);
+    Serial.print(" (");
+    Serial.print(c.config);
+    Serial.print(")");
+    if (g && c.tolerance == 0 && s.crc != g->crc) {
+      Serial.print(", crc ");
+      Serial.print(s.crc, HEX);
+      Serial.print(" expected ");
+      Serial.print(g->crc, HEX);
+    } else if (g && c.tolerance != 0) {
+      Serial.print(", rms ");
+      Serial.print(rms, 2);
+      Serial.print(" expected ");
+      Serial.print(g->rms, 2);
+      Serial.print(", peak ");
+      Serial.print(s.peak);
+      Serial.print(" expected ");
+      Serial.print(g->peak);
+    }
+    Serial.println();
+  }
+  Serial.print(passed);
+  Serial.print(" passed, ");
+  Serial.print(failed);
+  Serial.print(" failed, ");
+  Serial.print(recorded);
+  Serial.println(" without golden values");
+
+  if (recorded) {
+    Serial.println();
+    Serial.print("// " CODE_PATH " code path, ");
+    Serial.print(SAMPLE_RATE);
+    Serial.println(" Hz, recorded by GoldenOutput.ino");
+    Serial.print("const golden_t golden_" CODE_PATH "_");
+    Serial.print(SAMPLE_RATE);
+    Serial.println("[] = {");
+    for (int i=0; i < count; i++) {
+      Serial.print("  {\"");
+      Serial.print(checks[i].object);
+      Serial.print("\", \"");
+      Serial.print(checks[i].config);
+      Serial.print("\", 0x");
+      Serial.print(result[i].crc, HEX);
+      Serial.print(", ");
+      Serial.print(result[i].count ? sqrt(result[i].sumsq / result[i].count) : 0, 3);
+      Serial.print(", ");
+      Serial.print(result[i].peak);
+      Serial.println("},");
+    }
+    Serial.println("  {NULL, NULL, 0, 0, 0}");
+    Serial.println("};");
+    Serial.print("// in goldens[]: {\"" CODE_PATH "\", ");
+    Serial.print(SAMPLE_RATE);
+    Serial.print(", golden_" CODE_PATH "_");
+    Serial.print(SAMPLE_RATE);
+    Serial.println("},");
+  }
+}
+
+void loop() {
+}
@@ -0,0 +1,213 @@
+// golden.h, recorded by GoldenOutput.ino
+//
+// Recorded on a PC by extras/hosttest ("make golden"), from the library
+// at commit 72daf94, before the block size independence changes.  Some
+// objects intentionally changed output since then, and objects added
+// since then have no older version, so these are recorded from the
+// version which changed or added them:
+//   AudioSynthKarplusStrong - the input before each block is kept
+//   AudioEffectBitcrusher   - the sample hold continues across blocks
+//   AudioSynthToneSweep     - the phase step follows the sweep every sample
+//   AudioEffectDynamics     - smoothing uses per-sample time constants
+//   AudioSynthAdditive, AudioSynthFM, AudioSynthFMPoly,
+//   AudioFilterCrossover, AudioEffectReverbFDN, AudioEffectDistortion,
+//   AudioEffectMultibandCompressor, AudioEffectLimiter,
+//   AudioEffectVocoder, AudioMixerMatrix, AudioAnalyzeToneBank,
+//   AudioAnalyzeMeter, AudioAnalyzeLoudness
+// On Teensy LC, 72daf94's AudioAnalyzeFFT256 kept every block it was
+// given, so AudioAnalyzeNoteFrequency ran out of memory and gave no
+// results.  Its Teensy LC values are also from the current version.
+
+// ARM_ARCH_7EM code path, 44100 Hz (Teensy 4)
+const golden_t golden_ARM_ARCH_7EM_44100[] = {
+  {"AudioSynthWaveformSine", "1 kHz", 0x95755EF5, 20850.764, 29489},
+  {"AudioSynthWaveformSineHires", "1 kHz", 0x31F87A8D, 21009.638, 32768},
+  {"AudioSynthWaveformSineModulated", "FM by chirp", 0xEB9F7D2, 20767.331, 29490},
+  {"AudioSynthWaveform", "sawtooth", 0x1F870DBF, 17042.132, 29490},
+  {"AudioSynthWaveform", "bandlimited square", 0xB590E9C3, 22034.815, 26993},
+  {"AudioSynthWaveformModulated", "triangle, FM by chirp", 0x297DB25, 16617.878, 29490},
+  {"AudioSynthWaveformDc", "50 ms ramp", 0xE65C9BC9, 24662.443, 26213},
+  {"AudioSynthWaveformPWM", "chirp", 0xAA6E236B, 26021.497, 32748},
+  {"AudioSynthToneSweep", "100 Hz to 4 kHz", 0x9C0F15A0, 18532.209, 26213},
+  {"AudioSynthNoiseWhite", "", 0x1C97D9C4, 9440.458, 16384},
+  {"AudioSynthNoisePink", "", 0x3C21627F, 3010.847, 10390},
+  {"AudioSynthKarplusStrong", "220 Hz", 0x290415D2, 4038.919, 22957},
+  {"AudioSynthSimpleDrum", "", 0x949BEB61, 6753.615, 16253},
+  {"AudioSynthWavetable", "vibrato, tremolo, released", 0x8886BE20, 7469.974, 14141},
+  {"AudioSynthAdditive", "16 partials", 0xBA25BD3E, 14472.371, 28812},
+  {"AudioSynthFM", "algorithm 5", 0x535001C3, 30810.505, 32768},
+  {"AudioSynthFMPoly", "3 notes", 0xB4877537, 29151.924, 32768},
+  {"AudioPlayMemory", "16 bit PCM", 0xFD814E00, 11393.769, 19960},
+  {"AudioPlayQueue", "noise input", 0x26CFF0D8, 4706.651, 8191},
+  {"AudioFilterBiquad", "2 stage lowpass", 0x255F489, 847.527, 2869},
+  {"AudioFilterFIR", "16 taps", 0xDC4B0BE5, 1982.262, 7022},
+  {"AudioFilterStateVariable", "chirp control", 0xF0BDD98B, 11442.420, 32768},
+  {"AudioFilterLadder", "", 0x3D5DE191, 664.595, 2023},
+  {"AudioFilterCrossover", "3 bands", 0xBDDEF2FB, 2610.740, 13070},
+  {"AudioEffectEnvelope", "", 0xDD0D34B2, 8025.916, 24271},
+  {"AudioEffectFade", "100 ms out", 0x624C54F6, 8781.221, 24575},
+  {"AudioEffectDelay", "2 taps", 0x74844FF3, 13793.536, 24576},
+  {"AudioEffectFreeverb", "", 0xE1E4886E, 2627.365, 12000},
+  {"AudioEffectFreeverbStereo", "", 0xEA8C9D65, 2607.931, 12000},
+  {"AudioEffectReverb", "", 0x8F073541, 1114.723, 5059},
+  {"AudioEffectReverbFDN", "8 lines", 0xBC90837A, 1920.471, 9840},
+  {"AudioEffectChorus", "3 voices", 0x5270357, 8044.399, 18682},
+  {"AudioEffectFlange", "", 0x95C0D121, 9814.454, 24315},
+  {"AudioEffectGranular", "pitch shift", 0x15AD08D7, 12826.065, 24570},
+  {"AudioEffectBitcrusher", "6 bits, 8 kHz", 0xEF8E7497, 14102.080, 24576},
+  {"AudioEffectWaveFolder", "", 0x6EBC5D4E, 16844.437, 32765},
+  {"AudioEffectWaveshaper", "17 points", 0x82250A3B, 16236.012, 26213},
+  {"AudioEffectDistortion", "cubic, 2x oversampling", 0x42395F01, 29558.392, 32768},
+  {"AudioEffectDynamics", "compression", 0xEC530F57, 1906.346, 8016},
+  {"AudioEffectMultibandCompressor", "3 bands, stereo", 0xD911DCBB, 4069.690, 15662},
+  {"AudioEffectLimiter", "stereo", 0xA4AC09E4, 16666.047, 29203},
+  {"AudioEffectVocoder", "8 bands", 0x81598BEC, 647.582, 2669},
+  {"AudioEffectMultiply", "", 0xE8457B7B, 2046.906, 6074},
+  {"AudioEffectRectifier", "", 0xF5C72641, 14228.031, 24576},
+  {"AudioEffectMidSide", "encode", 0x89A75AB8, 7493.154, 16283},
+  {"AudioEffectDigitalCombine", "XOR", 0xAA7C53D1, 14145.793, 24574},
+  {"AudioMixer4", "unity gain", 0x7685824B, 24471.818, 32768},
+  {"AudioMixer4", "mixed gains", 0x81E6FA68, 25318.182, 32768},
+  {"AudioAmplifier", "gain 2.5", 0x1A8817A1, 26340.590, 32768},
+  {"AudioMixerMatrix", "2 inputs, 2 outputs", 0x8B6BAA10, 10107.651, 22006},
+  {"AudioAnalyzePeak", "", 0x63141F4E, 24390.207, 24576},
+  {"AudioAnalyzeRMS", "", 0xC10E1CD1, 4706.140, 5105},
+  {"AudioAnalyzeFFT256", "", 0x4CB5D6A2, 357.638, 597},
+  {"AudioAnalyzeFFT1024", "", 0x797A5F00, 178.481, 571},
+  {"AudioAnalyzeToneDetect", "1 kHz", 0x5BB80FA8, 1802.986, 6567},
+  {"AudioAnalyzeToneBank", "5 tones", 0x244D32D, 1461.037, 5562},
+  {"AudioAnalyzeNoteFrequency", "chirp", 0xB6F252B9, 26135.046, 30779},
+  {"AudioAnalyzeMeter", "stereo", 0xD45D038F, 14624.042, 24576},
+  {"AudioAnalyzeLoudness", "stereo", 0x943341EF, 4767.075, 6584},
+  {NULL, NULL, 0, 0, 0}
+};
+
+// ARM_ARCH_7EM code path, 44117 Hz (Teensy 3.x)
+const golden_t golden_ARM_ARCH_7EM_44117[] = {
+  {"AudioSynthWaveformSine", "1 kHz", 0xB240F3FA, 20848.330, 29489},
+  {"AudioSynthWaveformSineHires", "1 kHz", 0xAE651E1C, 21162.825, 32768},
+  {"AudioSynthWaveformSineModulated", "FM by chirp", 0x5AD8DAD1, 20754.671, 29491},
+  {"AudioSynthWaveform", "sawtooth", 0xB3B67296, 17043.165, 29490},
+  {"AudioSynthWaveform", "bandlimited square", 0x1BF20F0E, 22034.817, 26993},
+  {"AudioSynthWaveformModulated", "triangle, FM by chirp", 0x166862D2, 17173.530, 29491},
+  {"AudioSynthWaveformDc", "50 ms ramp", 0xE65C9BC9, 24662.443, 26213},
+  {"AudioSynthWaveformPWM", "chirp", 0x2295ED43, 26038.539, 32655},
+  {"AudioSynthToneSweep", "100 Hz to 4 kHz", 0xD488BF81, 18531.834, 26213},
+  {"AudioSynthNoiseWhite", "", 0x1C97D9C4, 9440.458, 16384},
+  {"AudioSynthNoisePink", "", 0x3C21627F, 3010.847, 10390},
+  {"AudioSynthKarplusStrong", "220 Hz", 0x884721B3, 4168.930, 22957},
+  {"AudioSynthSimpleDrum", "", 0x89163006, 6754.724, 16253},
+  {"AudioSynthWavetable", "vibrato, tremolo, released", 0x56268A8F, 7469.997, 14144},
+  {"AudioSynthAdditive", "16 partials", 0x84AC902B, 14468.643, 28812},
+  {"AudioSynthFM", "algorithm 5", 0x49449743, 30814.175, 32768},
+  {"AudioSynthFMPoly", "3 notes", 0xD39A060A, 29155.377, 32768},
+  {"AudioPlayMemory", "16 bit PCM", 0xFD814E00, 11393.769, 19960},
+  {"AudioPlayQueue", "noise input", 0x26CFF0D8, 4706.651, 8191},
+  {"AudioFilterBiquad", "2 stage lowpass", 0xD6697D82, 847.327, 2868},
+  {"AudioFilterFIR", "16 taps", 0xDC4B0BE5, 1982.262, 7022},
+  {"AudioFilterStateVariable", "chirp control", 0x2B32FFFE, 11441.260, 32768},
+  {"AudioFilterLadder", "", 0x8AE24428, 664.449, 2022},
+  {"AudioFilterCrossover", "3 bands", 0xCB220124, 2610.780, 13067},
+  {"AudioEffectEnvelope", "", 0xDD0D34B2, 8025.916, 24271},
+  {"AudioEffectFade", "100 ms out", 0x624C54F6, 8781.221, 24575},
+  {"AudioEffectDelay", "2 taps", 0x4951C8AD, 13792.864, 24576},
+  {"AudioEffectFreeverb", "", 0xE1E4886E, 2627.365, 12000},
+  {"AudioEffectFreeverbStereo", "", 0xEA8C9D65, 2607.931, 12000},
+  {"AudioEffectReverb", "", 0x8F073541, 1114.723, 5059},
+  {"AudioEffectReverbFDN", "8 lines", 0xC9F388AB, 1920.539, 9840},
+  {"AudioEffectChorus", "3 voices", 0x5270357, 8044.399, 18682},
+  {"AudioEffectFlange", "", 0xC817F757, 9815.655, 24304},
+  {"AudioEffectGranular", "pitch shift", 0x5A6B1ADB, 12823.094, 24570},
+  {"AudioEffectBitcrusher", "6 bits, 8 kHz", 0xEF8E7497, 14102.080, 24576},
+  {"AudioEffectWaveFolder", "", 0x6EBC5D4E, 16844.437, 32765},
+  {"AudioEffectWaveshaper", "17 points", 0x82250A3B, 16236.012, 26213},
+  {"AudioEffectDistortion", "cubic, 2x oversampling", 0x42395F01, 29558.392, 32768},
+  {"AudioEffectDynamics", "compression", 0x1E032CB6, 1903.707, 8008},
+  {"AudioEffectMultibandCompressor", "3 bands, stereo", 0x37CA2DED, 4069.454, 15664},
+  {"AudioEffectLimiter", "stereo", 0x150FB134, 16665.933, 29203},
+  {"AudioEffectVocoder", "8 bands", 0x2E2F52D3, 647.455, 2671},
+  {"AudioEffectMultiply", "", 0xE8457B7B, 2046.906, 6074},
+  {"AudioEffectRectifier", "", 0xF5C72641, 14228.031, 24576},
+  {"AudioEffectMidSide", "encode", 0x89A75AB8, 7493.154, 16283},
+  {"AudioEffectDigitalCombine", "XOR", 0xAA7C53D1, 14145.793, 24574},
+  {"AudioMixer4", "unity gain", 0x7685824B, 24471.818, 32768},
+  {"AudioMixer4", "mixed gains", 0x81E6FA68, 25318.182, 32768},
+  {"AudioAmplifier", "gain 2.5", 0x1A8817A1, 26340.590, 32768},
+  {"AudioMixerMatrix", "2 inputs, 2 outputs", 0x8B6BAA10, 10107.651, 22006},
+  {"AudioAnalyzePeak", "", 0x63141F4E, 24390.207, 24576},
+  {"AudioAnalyzeRMS", "", 0xC10E1CD1, 4706.140, 5105},
+  {"AudioAnalyzeFFT256", "", 0x4CB5D6A2, 357.638, 597},
+  {"AudioAnalyzeFFT1024", "", 0x797A5F00, 178.481, 571},
+  {"AudioAnalyzeToneDetect", "1 kHz", 0xD8D212A4, 1808.623, 6591},
+  {"AudioAnalyzeToneBank", "5 tones", 0x82AD523C, 1461.405, 5585},
+  {"AudioAnalyzeNoteFrequency", "chirp", 0x235F2DC9, 26138.178, 30779},
+  {"AudioAnalyzeMeter", "stereo", 0xB6AE7959, 14623.923, 24576},
+  {"AudioAnalyzeLoudness", "stereo", 0x7442C189, 4766.453, 6583},
+  {NULL, NULL, 0, 0, 0}
+};
+
+// KINETISL code path, 44117 Hz (Teensy LC)
+const golden_t golden_KINETISL_44117[] = {
+  {"AudioSynthWaveformSine", "1 kHz", 0x37620492, 20848.346, 29490},
+  {"AudioSynthWaveformSineHires", "1 kHz", 0x0, 0.000, 0},
+  {"AudioSynthWaveformSineModulated", "FM by chirp", 0x0, 0.000, 0},
+  {"AudioSynthWaveform", "sawtooth", 0xB3B67296, 17043.165, 29490},
+  {"AudioSynthWaveform", "bandlimited square", 0x1BF20F0E, 22034.817, 26993},
+  {"AudioSynthWaveformModulated", "triangle, FM by chirp", 0x166862D2, 17173.530, 29491},
+  {"AudioSynthWaveformDc", "50 ms ramp", 0xE65C9BC9, 24662.443, 26213},
+  {"AudioSynthWaveformPWM", "chirp", 0x0, 0.000, 0},
+  {"AudioSynthToneSweep", "100 Hz to 4 kHz", 0xD488BF81, 18531.834, 26213},
+  {"AudioSynthNoiseWhite", "", 0x1C97D9C4, 9440.458, 16384},
+  {"AudioSynthNoisePink", "", 0x3C21627F, 3010.847, 10390},
+  {"AudioSynthKarplusStrong", "220 Hz", 0x0, 0.000, 0},
+  {"AudioSynthSimpleDrum", "", 0x0, 0.000, 0},
+  {"AudioSynthWavetable", "vibrato, tremolo, released", 0x0, 0.000, 0},
+  {"AudioSynthFM", "algorithm 5", 0x49449743, 30814.175, 32768},
+  {"AudioSynthFMPoly", "3 notes", 0xD39A060A, 29155.377, 32768},
+  {"AudioPlayMemory", "16 bit PCM", 0xFD814E00, 11393.769, 19960},
+  {"AudioPlayQueue", "noise input", 0x26CFF0D8, 4706.651, 8191},
+  {"AudioFilterBiquad", "2 stage lowpass", 0x0, 0.000, 0},
+  {"AudioFilterFIR", "16 taps", 0xDC4B0BE5, 1982.262, 7022},
+  {"AudioFilterStateVariable", "chirp control", 0x0, 0.000, 0},
+  {"AudioFilterLadder", "", 0x8AE24428, 664.449, 2022},
+  {"AudioEffectEnvelope", "", 0xDD0D34B2, 8025.916, 24271},
+  {"AudioEffectFade", "100 ms out", 0x624C54F6, 8781.221, 24575},
+  {"AudioEffectDelay", "2 taps", 0x4951C8AD, 13792.864, 24576},
+  {"AudioEffectFreeverb", "", 0x0, 0.000, 0},
+  {"AudioEffectFreeverbStereo", "", 0x0, 0.000, 0},
+  {"AudioEffectReverb", "", 0x8F073541, 1114.723, 5059},
+  {"AudioEffectReverbFDN", "8 lines", 0xC9F388AB, 1920.539, 9840},
+  {"AudioEffectChorus", "3 voices", 0x5270357, 8044.399, 18682},
+  {"AudioEffectFlange", "", 0xC817F757, 9815.655, 24304},
+  {"AudioEffectGranular", "pitch shift", 0x5A6B1ADB, 12823.094, 24570},
+  {"AudioEffectBitcrusher", "6 bits, 8 kHz", 0xEF8E7497, 14102.080, 24576},
+  {"AudioEffectWaveFolder", "", 0x6EBC5D4E, 16844.437, 32765},
+  {"AudioEffectWaveshaper", "17 points", 0x82250A3B, 16236.012, 26213},
+  {"AudioEffectDistortion", "cubic, 2x oversampling", 0x42395F01, 29558.392, 32768},
+  {"AudioEffectVocoder", "8 bands", 0x2E2F52D3, 647.455, 2671},
+  {"AudioEffectMultiply", "", 0x0, 0.000, 0},
+  {"AudioEffectRectifier", "", 0xF5C72641, 14228.031, 24576},
+  {"AudioEffectMidSide", "encode", 0x0, 0.000, 0},
+  {"AudioEffectDigitalCombine", "XOR", 0xAA7C53D1, 14145.793, 24574},
+  {"AudioMixer4", "unity gain", 0x7685824B, 24471.818, 32768},
+  {"AudioMixer4", "mixed gains", 0xB2C52595, 32673.898, 32768},
+  {"AudioAmplifier", "gain 2.5", 0x83E2B7B0, 32766.218, 32768},
+  {"AudioMixerMatrix", "2 inputs, 2 outputs", 0x8B6BAA10, 10107.651, 22006},
+  {"AudioAnalyzePeak", "", 0x63141F4E, 24390.207, 24576},
+  {"AudioAnalyzeRMS", "", 0xC10E1CD1, 4706.140, 5105},
+  {"AudioAnalyzeFFT256", "", 0x0, 0.000, 0},
+  {"AudioAnalyzeFFT1024", "", 0x0, 0.000, 0},
+  {"AudioAnalyzeToneDetect", "1 kHz", 0x0, 0.000, 0},
+  {"AudioAnalyzeToneBank", "5 tones", 0x82AD523C, 1461.405, 5585},
+  {"AudioAnalyzeNoteFrequency", "chirp", 0x235F2DC9, 26138.178, 30779},
+  {"AudioAnalyzeMeter", "stereo", 0xB6AE7959, 14623.923, 24576},
+  {"AudioAnalyzeLoudness", "stereo", 0x0, 0.000, 0},
+  {NULL, NULL, 0, 0, 0}
+};
+
+const golden_set goldens[] = {
+  {"ARM_ARCH_7EM", 44100, golden_ARM_ARCH_7EM_44100},
+  {"ARM_ARCH_7EM", 44117, golden_ARM_ARCH_7EM_44117},
+  {"KINETISL", 44117, golden_KINETISL_44117},
+  {NULL, 0, NULL}
+};
@@ -0,0 +1,62 @@
+// Update volume and tone controls from knobs without waiting for I2C.
+//
+// Normally every SGTL5000 function waits while its settings are sent
+// over I2C, which can take a few milliseconds for functions like
+// eqBands().  With deferWrites(true), settings are only remembered,
+// and flush() sends them.  Calling flush(2) from loop() sends at
+// most 2 registers at a time, so loop() stays fast even while knobs
+// are turned quickly.  Settings which change again before being sent
+// are only sent once, with their newest value.
+//
+// Connect 3 pots to A1 (volume), A2 (bass) and A3 (treble).
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioInputI2S            i2sIn;
+AudioOutputI2S           i2sOut;
+AudioConnection          patchCord1(i2sIn, 0, i2sOut, 0);
+AudioConnection          patchCord2(i2sIn, 1, i2sOut, 1);
+AudioControlSGTL5000     sgtl5000_1;
+
+elapsedMillis msec;
+elapsedMicros loopTime;
+unsigned long loopTimeMax;
+
+void setup() {
+  AudioMemory(4);
+  sgtl5000_1.enable();
+  sgtl5000_1.inputSelect(AUDIO_INPUT_LINEIN);
+  sgtl5000_1.volume(0.5);
+  sgtl5000_1.audioPostProcessorEnable();
+  sgtl5000_1.eqSelect(TONE_CONTROLS);
+  sgtl5000_1.deferWrites(true);
+}
+
+void loop() {
+  // read the knobs about 60 times per second
+  if (msec >= 16) {
+    msec = 0;
+    sgtl5000_1.volume(analogRead(A1) / 1023.0);
+    float bass = analogRead(A2) / 1023.0 * 2.0 - 1.0;
+    float treble = analogRead(A3) / 1023.0 * 2.0 - 1.0;
+    sgtl5000_1.eqBands(bass, treble);
+  }
+
+  // send a couple of changed registers each time loop() runs
+  sgtl5000_1.flush(2);
+
+  unsigned long t = loopTime;
+  loopTime = 0;
+  if (t > loopTimeMax) {
+    loopTimeMax = t;
+    Serial.print("Longest loop: ");
+    Serial.print(loopTimeMax);
+    Serial.println(" us");
+  }
+}
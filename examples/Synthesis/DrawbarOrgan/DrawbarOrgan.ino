@@ -0,0 +1,75 @@
+// Drawbar organ using one additive synthesis object
+//
+// Each note uses 9 sine wave partials, at the pitches of a tonewheel
+// organ's 9 drawbars.  A chord of 4 notes uses 36 partials, all in
+// one AudioSynthAdditive object, with no mixers needed.
+//
+// Send '1', '2' or '3' from the Arduino Serial Monitor to change the
+// drawbar registration.
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioSynthAdditive       organ;
+AudioOutputI2S           i2s1;
+AudioConnection          patchCord1(organ, 0, i2s1, 0);
+AudioConnection          patchCord2(organ, 0, i2s1, 1);
+AudioControlSGTL5000     sgtl5000_1;
+
+// drawbar pitches relative to the note: 16', 5 1/3', 8', 4', 2 2/3',
+// 2', 1 3/5', 1 1/3', 1'
+const float drawbarRatio[9] = {0.5, 1.5, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 8.0};
+
+// drawbar settings, 0 to 8
+const uint8_t registration[3][9] = {
+  {8, 8, 8, 0, 0, 0, 0, 0, 0},  // 888000000, full and warm
+  {8, 0, 8, 8, 0, 0, 0, 0, 8},  // 808800008, bright
+  {6, 8, 8, 6, 0, 0, 0, 0, 0}   // 688600000, jazz
+};
+
+const float chords[4][4] = {
+  {261.63, 329.63, 392.00, 523.25},  // C
+  {220.00, 261.63, 329.63, 440.00},  // Am
+  {174.61, 220.00, 261.63, 349.23},  // F
+  {196.00, 246.94, 293.66, 392.00}   // G
+};
+
+int reg = 0;
+
+void playChord(int chord) {
+  for (int note=0; note < 4; note++) {
+    for (int bar=0; bar < 9; bar++) {
+      // each drawbar step is 3 dB
+      int level = registration[reg][bar];
+      float amp = (level > 0) ? powf(10.0, (level - 8) * 3.0 / 20.0) : 0.0;
+      organ.partial(note * 9 + bar, chords[chord][note] * drawbarRatio[bar], amp);
+    }
+  }
+}
+
+void setup() {
+  AudioMemory(4);
+  sgtl5000_1.enable();
+  sgtl5000_1.volume(0.4);
+  organ.amplitude(0.06);
+}
+
+void loop() {
+  for (int chord=0; chord < 4; chord++) {
+    playChord(chord);
+    Serial.print("Partials: ");
+    Serial.print(organ.activePartials());
+    Serial.print(", CPU: ");
+    Serial.println(AudioProcessorUsageMax());
+    delay(1000);
+    if (Serial.available()) {
+      char c = Serial.read();
+      if (c >= '1' && c <= '3') reg = c - '1';
+    }
+  }
+}
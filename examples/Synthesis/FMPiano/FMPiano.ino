@@ -0,0 +1,86 @@
+// Electric piano using a polyphonic FM synthesizer
+//
+// Algorithm 5 uses three pairs of operators.  Each pair is a carrier
+// with its own modulator: a "tine" pair at 1:14 for the bright attack,
+// and two 1:1 pairs for the body of the tone.  The modulators' envelopes
+// decay faster than the carriers', so each note starts bright and
+// becomes mellow, like a real electric piano.
+//
+// A short melody and chords are played on up to 8 voices, all computed
+// by one AudioSynthFMPoly object.
+//
+// This example code is in the public domain.
+
+#include <Audio.h>
+#include <Wire.h>
+#include <SPI.h>
+#include <SD.h>
+#include <SerialFlash.h>
+
+AudioSynthFMPoly         piano;
+AudioOutputI2S           i2s1;
+AudioConnection          patchCord1(piano, 0, i2s1, 0);
+AudioConnection          patchCord2(piano, 0, i2s1, 1);
+AudioControlSGTL5000     sgtl5000_1;
+
+const uint8_t chords[4][3] = {
+  {60, 64, 67},  // C
+  {57, 60, 64},  // Am
+  {53, 57, 60},  // F
+  {55, 59, 62}   // G
+};
+
+void setup() {
+  AudioMemory(4);
+  sgtl5000_1.enable();
+  sgtl5000_1.volume(0.5);
+
+  piano.algorithm(5);
+  // operators 0 & 1: body
+  piano.ratio(0, 1.0);
+  piano.level(0, 0.5);
+  piano.envelope(0, 2, 2500, 0.0, 300);
+  piano.ratio(1, 1.0);
+  piano.level(1, 0.12);
+  piano.envelope(1, 2, 1200, 0.0, 300);
+  // operators 2 & 3: tine
+  piano.ratio(2, 1.0);
+  piano.level(2, 0.3);
+  piano.envelope(2, 2, 800, 0.0, 200);
+  piano.ratio(3, 14.0);
+  piano.level(3, 0.08);
+  piano.envelope(3, 2, 150, 0.0, 100);
+  // operators 4 & 5: detuned body for a slow chorus
+  piano.ratio(4, 1.0);
+  piano.detune(4, 0.7);
+  piano.level(4, 0.3);
+  piano.envelope(4, 2, 2000, 0.0, 300);
+  piano.ratio(5, 1.0);
+  piano.level(5, 0.1);
+  piano.envelope(5, 2, 1000, 0.0, 300);
+  piano.feedback(0.1);
+  piano.amplitude(0.35);
+}
+
+void loop() {
+  for (int c=0; c < 4; c++) {
+    for (int i=0; i < 3; i++) {
+      piano.noteOn(chords[c][i] - 12, 0.7);
+    }
+    // a melody note on top of each chord
+    for (int i=0; i < 3; i++) {
+      uint8_t note = chords[c][i] + 12;
+      piano.noteOn(note, 0.9);
+      delay(300);
+      piano.noteOff(note);
+    }
+    Serial.print("Voices: ");
+    Serial.print(piano.activeVoices());
+    Serial.print(", CPU: ");
+    Serial.println(AudioProcessorUsageMax());
+    for (int i=0; i < 3; i++) {
+      piano.noteOff(chords[c][i] - 12);
+    }
+    delay(300);
+  }
+}
@@ -0,0 +1,558 @@
+// Reorder an Audio Library patch for signal flow and compute its memory use
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// compile with:  gcc -O2 -Wall -o graphcompile graphcompile.c
+//
+// usage:  graphcompile [-q] [sketch.ino] > sorted.ino
+//
+// Audio objects run their update() in the order they were created, which
+// is the order of their declarations.  When an object runs before the one
+// feeding it, it receives that data one update later: an extra 2.9 ms of
+// latency, and one more audio block held in memory.  The design tool sorts
+// objects by screen position, so patches drawn right to left, or edited
+// by hand, often run out of order.
+//
+// This tool reads the code exported by the design tool (or any sketch
+// with one object declaration and one AudioConnection per line), and
+// rewrites the "GUItool" section with the objects in signal flow order.
+// Without those markers, the objects and connections are gathered where
+// the first object was declared, and every other line is kept as it is.
+// It reports connections which must still be delayed (true feedback
+// loops), objects which never reach an output, and the number of audio
+// blocks the patch needs, found from the lifetime of every block within
+// one update cycle.  That number is the minimum for AudioMemory().
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+
+#define MAX_LINES	20000
+#define MAX_OBJECTS	2000
+#define MAX_CONNECTIONS	8000
+#define MAX_PORTS	16
+
+struct object {
+	char type[64];
+	char name[64];
+	const char *line;
+	int order;		// position in the original declarations
+	int pos;		// position after sorting
+	int placed;
+	int used;		// reaches an output, recorder or analyzer
+};
+
+struct connection {
+	int src, srcport;
+	int dst, dstport;
+};
+
+char *lines[MAX_LINES];
+char patch[MAX_LINES];		// line is an object or connection
+int nlines=0;
+struct object obj[MAX_OBJECTS];
+int nobj=0;
+struct connection conn[MAX_CONNECTIONS];
+int nconn=0;
+int sorted[MAX_OBJECTS];
+int quiet=0;
+
+void die(const char *format, ...) __attribute__ ((format (printf, 1, 2), noreturn));
+
+// Blocks held inside objects, in addition to those passed between them.
+// Inputs hold the blocks the DMA is filling, outputs hold 2 blocks per
+// connected channel waiting for the DMA, and queues hold at least the
+// block the sketch is using plus 1 waiting.
+#define HELD_FIXED	0
+#define HELD_PER_INPUT	1	// blocks for each connected input port
+#define HELD_AT_LEAST	2	// more, depending on settings
+struct held {
+	const char *type;
+	int blocks;
+	int kind;
+};
+const struct held held_blocks[] = {
+	{"AudioAnalyzeFFT1024", 8, HELD_FIXED},
+	{"AudioAnalyzeFFT256", 2, HELD_FIXED},
+	{"AudioAnalyzeNoteFrequency", 48, HELD_FIXED},
+	{"AudioEffectDelay", 0, HELD_AT_LEAST},
+	{"AudioRecordQueue", 2, HELD_AT_LEAST},
+	{"AudioPlayQueue", 2, HELD_AT_LEAST},
+	{"AudioInputI2S", 2, HELD_FIXED},
+	{"AudioInputI2Sslave", 2, HELD_FIXED},
+	{"AudioInputI2S2", 2, HELD_FIXED},
+	{"AudioInputI2S2slave", 2, HELD_FIXED},
+	{"AudioInputI2SQuad", 4, HELD_FIXED},
+	{"AudioInputI2SHex", 6, HELD_FIXED},
+	{"AudioInputI2SOct", 8, HELD_FIXED},
+	{"AudioInputTDM", 16, HELD_FIXED},
+	{"AudioInputTDM2", 16, HELD_FIXED},
+	{"AudioInputPDM", 1, HELD_FIXED},
+	{"AudioInputAnalog", 1, HELD_FIXED},
+	{"AudioInputAnalogStereo", 2, HELD_FIXED},
+	{"AudioOutputI2S", 2, HELD_PER_INPUT},
+	{"AudioOutputI2Sslave", 2, HELD_PER_INPUT},
+	{"AudioOutputI2S2", 2, HELD_PER_INPUT},
+	{"AudioOutputI2S2slave", 2, HELD_PER_INPUT},
+	{"AudioOutputI2SQuad", 2, HELD_PER_INPUT},
+	{"AudioOutputI2SHex", 2, HELD_PER_INPUT},
+	{"AudioOutputI2SOct", 2, HELD_PER_INPUT},
+	{"AudioOutputTDM", 1, HELD_PER_INPUT},
+	{"AudioOutputTDM2", 1, HELD_PER_INPUT},
+	{"AudioOutputSPDIF3", 2, HELD_PER_INPUT},
+	{"AudioOutputPT8211", 2, HELD_PER_INPUT},
+	{"AudioOutputPT8211_2", 2, HELD_PER_INPUT},
+	{"AudioOutputMQS", 2, HELD_PER_INPUT},
+	{"AudioOutputPWM", 2, HELD_PER_INPUT},
+	{"AudioOutputAnalog", 2, HELD_PER_INPUT},
+	{"AudioOutputAnalogStereo", 2, HELD_PER_INPUT},
+	{"AudioOutputUSB", 2, HELD_PER_INPUT},
+	{NULL, 0, 0}
+};
+
+// number of input ports with a connection
+int connected_inputs(int n)
+{
+	uint32_t ports=0;
+	int c, count=0;
+
+	for (c=0; c < nconn; c++) {
+		if (conn[c].dst == n && conn[c].dstport < 32) {
+			ports |= 1u << conn[c].dstport;
+		}
+	}
+	for (; ports; ports &= ports - 1) count++;
+	return count;
+}
+
+int is_control(const char *type)
+{
+	return strncmp(type, "AudioControl", 12) == 0;
+}
+
+// Objects which consume audio without passing it on
+int is_sink(const char *type)
+{
+	return strncmp(type, "AudioOutput", 11) == 0
+		|| strncmp(type, "AudioRecord", 11) == 0
+		|| strncmp(type, "AudioAnalyze", 12) == 0;
+}
+
+const char * skip_space(const char *p)
+{
+	while (isspace((unsigned char)*p)) p++;
+	return p;
+}
+
+// copy one C identifier, return pointer after it, or NULL if none
+const char * identifier(const char *p, char *buf, size_t size)
+{
+	size_t n=0;
+
+	p = skip_space(p);
+	if (!isalpha((unsigned char)*p) && *p != '_') return NULL;
+	while (isalnum((unsigned char)*p) || *p == '_') {
+		if (n < size - 1) buf[n++] = *p;
+		p++;
+	}
+	buf[n] = 0;
+	return p;
+}
+
+int find_object(const char *name)
+{
+	int i;
+
+	for (i=0; i < nobj; i++) {
+		if (strcmp(obj[i].name, name) == 0) return i;
+	}
+	return -1;
+}
+
+// AudioConnection name(src, dst);  or  AudioConnection name(src, n, dst, n);
+int parse_connection(const char *p, int lineno)
+{
+	char name[64], arg[4][64];
+	int nargs=0, i;
+	struct connection *c;
+
+	p = identifier(p, name, sizeof(name));
+	if (!p) return 0;
+	p = skip_space(p);
+	if (*p++ != '(') return 0;
+	while (nargs < 4) {
+		size_t n=0;
+		p = skip_space(p);
+		while (*p && *p != ',' && *p != ')' && !isspace((unsigned char)*p)) {
+			if (n < sizeof(arg[0]) - 1) arg[nargs][n++] = *p;
+			p++;
+		}
+		arg[nargs++][n] = 0;
+		p = skip_space(p);
+		if (*p == ')') break;
+		if (*p++ != ',') return 0;
+	}
+	if (nargs != 2 && nargs != 4) return 0;
+	if (nconn >= MAX_CONNECTIONS) die("too many connections");
+	c = &conn[nconn];
+	c->src = find_object(arg[0]);
+	c->dst = find_object(arg[nargs == 2 ? 1 : 2]);
+	c->srcport = (nargs == 2) ? 0 : atoi(arg[1]);
+	c->dstport = (nargs == 2) ? 0 : atoi(arg[3]);
+	if (c->src < 0 || c->dst < 0) {
+		die("line %d: connection uses an object not declared before it", lineno);
+	}
+	if (c->srcport < 0 || c->srcport >= MAX_PORTS) {
+		die("line %d: output port %d not supported", lineno, c->srcport);
+	}
+	for (i=0; i < nconn; i++) {
+		if (conn[i].dst == c->dst && conn[i].dstport == c->dstport) {
+			fprintf(stderr, "Warning, line %d: input %d of %s has two "
+				"connections, only one can work\n",
+				lineno, c->dstport, obj[c->dst].name);
+		}
+	}
+	nconn++;
+	return 1;
+}
+
+// AudioType name;  with optional constructor arguments
+int parse_object(const char *p, int idx)
+{
+	char type[64], name[64];
+	struct object *o;
+
+	p = identifier(p, type, sizeof(type));
+	if (!p || strncmp(type, "Audio", 5) != 0) return 0;
+	p = identifier(p, name, sizeof(name));
+	if (!p) return 0;
+	p = skip_space(p);
+	if (*p == '(') {
+		while (*p && *p != ')') p++;
+		if (*p) p++;
+		p = skip_space(p);
+	}
+	if (*p != ';') return 0;
+	if (find_object(name) >= 0) die("object \"%s\" declared twice", name);
+	if (nobj >= MAX_OBJECTS) die("too many objects");
+	o = &obj[nobj];
+	strcpy(o->type, type);
+	strcpy(o->name, name);
+	o->line = lines[idx];
+	o->order = nobj;
+	o->placed = 0;
+	o->used = 0;
+	nobj++;
+	return 1;
+}
+
+// can "to" be reached from "from" through objects not yet placed?
+int reaches(int from, int to, char *seen)
+{
+	int c;
+
+	if (from == to) return 1;
+	if (seen[from]) return 0;
+	seen[from] = 1;
+	for (c=0; c < nconn; c++) {
+		if (conn[c].src == from && !obj[conn[c].dst].placed) {
+			if (reaches(conn[c].dst, to, seen)) return 1;
+		}
+	}
+	return 0;
+}
+
+// True when every unplaced object feeding this one is in a loop with it,
+// so this object can start the loop.
+int loop_entry(int n)
+{
+	char *seen = malloc(nobj);
+	int c, ok=1;
+
+	if (!seen) die("unable to allocate memory");
+	for (c=0; c < nconn && ok; c++) {
+		if (conn[c].dst != n || obj[conn[c].src].placed) continue;
+		if (conn[c].src == n) continue;
+		memset(seen, 0, nobj);
+		if (!reaches(n, conn[c].src, seen)) ok = 0;
+	}
+	free(seen);
+	return ok;
+}
+
+// Kahn's algorithm, always taking the earliest declared object which is
+// ready, so independent objects keep their original relative order.  In
+// a feedback loop nothing is ready, and the earliest declared object able
+// to start the loop goes first.  Its input from inside the loop stays
+// delayed.
+void sort_objects(void)
+{
+	int *pending = calloc(nobj, sizeof(int));
+	int n, i, c, best;
+
+	if (!pending) die("unable to allocate memory");
+	for (c=0; c < nconn; c++) {
+		if (conn[c].src != conn[c].dst) pending[conn[c].dst]++;
+	}
+	for (n=0; n < nobj; n++) {
+		best = -1;
+		for (i=0; i < nobj; i++) {
+			if (!obj[i].placed && pending[i] == 0) {
+				best = i;
+				break;
+			}
+		}
+		if (best < 0) {
+			for (i=0; i < nobj; i++) {
+				if (!obj[i].placed && loop_entry(i)) {
+					best = i;
+					break;
+				}
+			}
+		}
+		obj[best].placed = 1;
+		obj[best].pos = n;
+		sorted[n] = best;
+		for (c=0; c < nconn; c++) {
+			if (conn[c].src == best && conn[c].dst != best) {
+				pending[conn[c].dst]--;
+			}
+		}
+	}
+	free(pending);
+}
+
+void mark_used(void)
+{
+	int changed, c, i;
+
+	for (i=0; i < nobj; i++) {
+		if (is_sink(obj[i].type)) obj[i].used = 1;
+	}
+	do {
+		changed = 0;
+		for (c=0; c < nconn; c++) {
+			if (obj[conn[c].dst].used && !obj[conn[c].src].used) {
+				obj[conn[c].src].used = 1;
+				changed = 1;
+			}
+		}
+	} while (changed);
+}
+
+// A connection is delayed when its destination updates before its source.
+int delayed(const struct connection *c, const int *position)
+{
+	return position[c->dst] <= position[c->src];
+}
+
+// Each output port with connections transmits one block per update, shared
+// by all its destinations.  The block lives from the source's update until
+// the last destination's update, or into the next cycle when delayed.
+// The peak of simultaneously live blocks is the memory the patch needs.
+int peak_blocks(const int *position)
+{
+	int *live = calloc(nobj > 0 ? nobj : 1, sizeof(int));
+	int s, port, c, t, end, wrap, peak=0;
+
+	if (!live) die("unable to allocate memory");
+	for (s=0; s < nobj; s++) {
+		for (port=0; port < MAX_PORTS; port++) {
+			end = -1;
+			wrap = -1;
+			for (c=0; c < nconn; c++) {
+				if (conn[c].src != s || conn[c].srcport != port) continue;
+				if (delayed(&conn[c], position)) {
+					if (position[conn[c].dst] > wrap) wrap = position[conn[c].dst];
+				} else {
+					if (position[conn[c].dst] > end) end = position[conn[c].dst];
+				}
+			}
+			if (end < 0 && wrap < 0) continue;
+			if (wrap >= 0) end = nobj - 1;
+			for (t=position[s]; t <= end; t++) live[t]++;
+			for (t=0; t <= wrap; t++) live[t]++;
+		}
+	}
+	for (t=0; t < nobj; t++) {
+		if (live[t] > peak) peak = live[t];
+	}
+	free(live);
+	return peak;
+}
+
+int count_delayed(const int *position)
+{
+	int c, n=0;
+
+	for (c=0; c < nconn; c++) {
+		if (delayed(&conn[c], position)) n++;
+	}
+	return n;
+}
+
+int main(int argc, char **argv)
+{
+	FILE *in = stdin;
+	char buf[4096];
+	int begin=-1, end=-1, i, j, c, n, first, last, markers;
+	int *orig, *now, held=0, variable=0;
+	int peak_orig, peak_now, delay_orig, delay_now;
+
+	for (i=1; i < argc; i++) {
+		if (strcmp(argv[i], "-q") == 0) {
+			quiet = 1;
+		} else if (in == stdin) {
+			in = fopen(argv[i], "r");
+			if (!in) die("unable to read %s", argv[i]);
+		} else {
+			die("usage: graphcompile [-q] [sketch.ino] > sorted.ino");
+		}
+	}
+	while (fgets(buf, sizeof(buf), in)) {
+		if (nlines >= MAX_LINES) die("input too long");
+		lines[nlines] = strdup(buf);
+		if (!lines[nlines]) die("unable to allocate memory");
+		if (strstr(buf, "GUItool: begin")) begin = nlines;
+		if (strstr(buf, "GUItool: end")) end = nlines;
+		nlines++;
+	}
+	if (in != stdin) fclose(in);
+	markers = (begin >= 0 && end > begin);
+	if (!markers) {
+		// no design tool markers, use the entire file
+		first = 0;
+		last = nlines;
+	} else {
+		first = begin + 1;
+		last = end;
+	}
+
+	for (i=first; i < last; i++) {
+		const char *p = skip_space(lines[i]);
+		if (strncmp(p, "AudioConnection", 15) == 0 && isspace((unsigned char)p[15])) {
+			if (!parse_connection(p + 15, i + 1)) {
+				die("line %d: unable to parse connection", i + 1);
+			}
+			patch[i] = 1;
+		} else {
+			patch[i] = parse_object(p, i);
+		}
+	}
+	if (nobj == 0) die("no audio objects found");
+	if (!markers) {
+		// the generated section goes where the first object was, and
+		// all other lines (includes, setup, loop) are kept
+		while (!patch[first]) first++;
+	}
+
+	sort_objects();
+	mark_used();
+	orig = calloc(nobj, sizeof(int));
+	now = calloc(nobj, sizeof(int));
+	if (!orig || !now) die("unable to allocate memory");
+	for (i=0; i < nobj; i++) {
+		orig[i] = obj[i].order;
+		now[i] = obj[i].pos;
+	}
+	peak_orig = peak_blocks(orig);
+	peak_now = peak_blocks(now);
+	delay_orig = count_delayed(orig);
+	delay_now = count_delayed(now);
+	for (i=0; i < nobj; i++) {
+		for (j=0; held_blocks[j].type; j++) {
+			if (strcmp(obj[i].type, held_blocks[j].type) == 0) {
+				if (held_blocks[j].kind == HELD_PER_INPUT) {
+					held += held_blocks[j].blocks * connected_inputs(i);
+				} else {
+					held += held_blocks[j].blocks;
+				}
+				if (held_blocks[j].kind == HELD_AT_LEAST) variable = 1;
+			}
+		}
+	}
+
+	// everything before the generated section is unchanged
+	for (i=0; i < first; i++) fputs(lines[i], stdout);
+	printf("// graphcompile: %d objects, %d connections, %d delayed by feedback\n",
+		nobj, nconn, delay_now);
+	printf("// graphcompile: requires AudioMemory(%d)%s\n", peak_now + held,
+		variable ? " plus blocks held by delays and queues" : "");
+	for (n=0; n < nobj; n++) {
+		i = sorted[n];
+		if (!is_control(obj[i].type)) fputs(obj[i].line, stdout);
+	}
+	printf("\n");
+	for (i=first; i < last; i++) {
+		const char *p = skip_space(lines[i]);
+		if (patch[i] && strncmp(p, "AudioConnection", 15) == 0) fputs(lines[i], stdout);
+	}
+	printf("\n");
+	for (n=0; n < nobj; n++) {
+		i = sorted[n];
+		if (is_control(obj[i].type)) fputs(obj[i].line, stdout);
+	}
+	if (!markers) {
+		for (i=first; i < last; i++) {
+			if (!patch[i]) fputs(lines[i], stdout);
+		}
+	}
+	for (i=last; i < nlines; i++) fputs(lines[i], stdout);
+
+	if (quiet) return 0;
+	fprintf(stderr, "Objects: %d, connections: %d\n", nobj, nconn);
+	fprintf(stderr, "Connections delayed one update: %d before, %d after\n",
+		delay_orig, delay_now);
+	fprintf(stderr, "Audio blocks passed between objects: %d before, %d after\n",
+		peak_orig, peak_now);
+	if (held > 0) fprintf(stderr, "Audio blocks held inside objects: %d\n", held);
+	if (variable) {
+		fprintf(stderr, "Delays and queues hold more blocks, depending on "
+			"their settings\n");
+	}
+	for (c=0; c < nconn; c++) {
+		if (delayed(&conn[c], now)) {
+			fprintf(stderr, "Feedback: %s output %d to %s input %d is delayed\n",
+				obj[conn[c].src].name, conn[c].srcport,
+				obj[conn[c].dst].name, conn[c].dstport);
+		}
+	}
+	for (i=0; i < nobj; i++) {
+		if (!obj[i].used && !is_control(obj[i].type)) {
+			fprintf(stderr, "Unused: %s does not reach any output, "
+				"but still uses CPU time\n", obj[i].name);
+		}
+	}
+	return 0;
+}
+
+void die(const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	fprintf(stderr, "graphcompile: ");
+	vfprintf(stderr, format, args);
+	fprintf(stderr, "\n");
+	va_end(args);
+	exit(1);
+}
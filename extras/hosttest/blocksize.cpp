@@ -0,0 +1,550 @@
+// Host test, every audio object at every supported block size
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// usage:  blocksize -w file     (built with AUDIO_BLOCK_SAMPLES 128)
+//         blocksize file        (built with any other block size)
+//
+// Each object is configured the same way and given the same input
+// signals, a chirp and pseudo-random noise, for RUN_SAMPLES samples.
+// Everything it outputs is kept, and analyzers are read every
+// POLL_SAMPLES samples, which is a whole number of blocks at every
+// size.  The 128 sample build writes the results as the reference,
+// and other builds must match it.  Objects must be identical, except
+// for the few rounding differences allowed in the tests[] list.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include "Audio.h"
+#include "effect_dynamics.h"
+
+#define RUN_SAMPLES   16384
+#define POLL_SAMPLES  1024
+#define MAX_VALUES    (4 * RUN_SAMPLES + 4096)
+
+static unsigned int errors;
+static unsigned int samples;   // samples run so far
+
+static void fail(const char *format, ...)
+{
+	va_list args;
+
+	errors++;
+	va_start(args, format);
+	printf("FAIL ");
+	vprintf(format, args);
+	printf("\n");
+	va_end(args);
+}
+
+// update() is not public in every object, so each update runs through
+// AudioStream::update_all(), which runs the active objects in the order
+// they are created below: inputs, the objects tested, then outputs.
+
+// A chirp sweeping a triangle wave from 20 Hz to about 8 kHz, or 32 bit
+// xorshift noise.  Integer math only, so every build makes the same input.
+class TestInput : public AudioStream
+{
+public:
+	TestInput(bool isnoise) : AudioStream(0, NULL), noise(isnoise) { reset(); }
+	void reset(void) {
+		phase = 0;
+		increment = 20 * 97391;   // 20 Hz, 2^32 / 44100 = 97391
+		state = 2463534242u;
+	}
+	int16_t next(void) {
+		if (noise) {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return (int32_t)state >> 18;
+		}
+		int32_t tri = (phase >> 15) & 0xFFFF;
+		if (phase & 0x80000000) tri = 0xFFFF - tri;
+		phase += increment;
+		increment += 47500;
+		return (tri - 0x8000) * 3 / 4;
+	}
+	virtual void update(void) {
+		audio_block_t *block = allocate();
+		if (!block) return;
+		for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) block->data[i] = next();
+		transmit(block);
+		release(block);
+	}
+private:
+	bool noise;
+	uint32_t phase, increment, state;
+};
+
+TestInput inputA(false);
+TestInput inputB(true);
+
+AudioSynthWaveformSine          sine1;
+AudioSynthWaveformSineHires     sineHires1;
+AudioSynthWaveformSineModulated sineFM1;
+AudioSynthWaveform              waveform1;
+AudioSynthWaveform              waveform2;
+AudioSynthWaveformModulated     waveformMod1;
+AudioSynthWaveformDc            dc1;
+AudioSynthWaveformPWM           pwm1;
+AudioSynthToneSweep             sweep1;
+AudioSynthNoiseWhite            noise1;
+AudioSynthNoisePink             pink1;
+AudioSynthKarplusStrong         string1;
+AudioSynthSimpleDrum            drum1;
+AudioSynthWavetable             wavetable1;
+AudioSynthAdditive              additive1;
+AudioSynthFM                    fm1;
+AudioSynthFMPoly                fmpoly1;
+AudioPlayMemory                 playMem1;
+AudioPlayQueue                  playQueue1;
+AudioFilterBiquad               biquad1;
+AudioFilterFIR                  fir1;
+AudioFilterStateVariable        filter1;
+AudioFilterLadder               ladder1;
+AudioFilterCrossover            crossover1;
+AudioEffectEnvelope             envelope1;
+AudioEffectFade                 fade1;
+AudioEffectDelay                delay1;
+AudioEffectDelay                delay2;
+AudioEffectFreeverb             freeverb1;
+AudioEffectFreeverbStereo       freeverbs1;
+AudioEffectReverb               reverb1;
+AudioEffectReverbFDN            reverbfdn1;
+AudioEffectChorus               chorus1;
+AudioEffectFlange               flange1;
+AudioEffectGranular             granular1;
+AudioEffectBitcrusher           bitcrusher1;
+AudioEffectWaveFolder           wavefolder1;
+AudioEffectWaveshaper           waveshaper1;
+AudioEffectDistortion           distortion1;
+AudioEffectDynamics             dynamics1;
+AudioEffectMultibandCompressor  multiband1;
+AudioEffectLimiter              limiter1;
+AudioEffectVocoder              vocoder1;
+AudioEffectMultiply             multiply1;
+AudioEffectRectifier            rectifier1;
+AudioEffectMidSide              midside1;
+AudioEffectDigitalCombine       combine1;
+AudioMixer4                     mixer1;
+AudioAmplifier                  amp1;
+AudioMixerMatrix                matrix1;
+AudioAnalyzePeak                peak1;
+AudioAnalyzeRMS                 rms1;
+AudioAnalyzeFFT256              fft256_1;
+AudioAnalyzeFFT1024             fft1024_1;
+AudioAnalyzeToneDetect          tone1;
+AudioAnalyzeToneBank            tonebank1;
+AudioAnalyzeNoteFrequency       notefreq1;
+AudioAnalyzeMeter               meter1;
+AudioAnalyzeLoudness            loudness1;
+AudioRecordQueue                recordQueue1;
+
+// everything output by the object tested
+class TestOutput : public AudioStream
+{
+public:
+	TestOutput() : AudioStream(1, inputQueueArray) { }
+	int16_t data[RUN_SAMPLES];
+	unsigned int count;
+	virtual void update(void) {
+		audio_block_t *block = receiveReadOnly();
+		if (count + AUDIO_BLOCK_SAMPLES > RUN_SAMPLES) return;
+		if (block) {
+			memcpy(data + count, block->data, sizeof(block->data));
+			release(block);
+		} else {
+			memset(data + count, 0, sizeof(block->data));
+		}
+		count += AUDIO_BLOCK_SAMPLES;
+	}
+private:
+	audio_block_t *inputQueueArray[1];
+};
+
+TestOutput output[4];
+
+AudioConnection inputCord[8];
+AudioConnection outputCord[4];
+
+static void connectA(AudioStream &dest, int n = 1) {
+	for (int i=0; i < n; i++) inputCord[i].connect(inputA, 0, dest, i);
+}
+static void connectB(AudioStream &dest, int n = 1) {
+	for (int i=0; i < n; i++) inputCord[i].connect(inputB, 0, dest, i);
+}
+static void connectAB(AudioStream &dest) {
+	inputCord[0].connect(inputA, 0, dest, 0);
+	inputCord[1].connect(inputB, 0, dest, 1);
+}
+static void listen(AudioStream &src, int n = 1) {
+	for (int i=0; i < n; i++) outputCord[i].connect(src, i, output[i], 0);
+}
+
+// analyzer results, read every POLL_SAMPLES
+static float values[MAX_VALUES];
+static unsigned int nvalues;
+
+static bool polling(void)
+{
+	return samples % POLL_SAMPLES == 0;
+}
+
+static void value(float n)
+{
+	if (nvalues < MAX_VALUES) values[nvalues++] = n;
+}
+
+#define CHORUS_DELAY_LENGTH (16*128)
+#define FLANGE_DELAY_LENGTH (6*128)
+#define GRANULAR_MEMORY_SIZE 12800
+#define FDN_MEMORY_SIZE 16384
+static short chorusBuffer[CHORUS_DELAY_LENGTH];
+static short flangeBuffer[FLANGE_DELAY_LENGTH];
+static int16_t granularMemory[GRANULAR_MEMORY_SIZE];
+static int16_t fdnMemory[FDN_MEMORY_SIZE];
+static const short firCoefficients[16] = {
+	-112, -284, -394, 0, 1344, 3542, 5787, 7117,
+	7117, 5787, 3542, 1344, 0, -394, -284, -112
+};
+static float waveshape[17] = {
+	-0.9, -0.85, -0.8, -0.7, -0.6, -0.45, -0.3, -0.15, 0,
+	0.15, 0.3, 0.45, 0.6, 0.7, 0.8, 0.85, 0.9
+};
+static const float softClip[4] = {0, 1.5, 0, -0.5};  // 1.5x - 0.5x^3
+// one cycle of sine, looped, with vibrato and tremolo, like the
+// Benchmark example
+static int16_t wavetableSine[258];
+static const AudioSynthWavetable::sample_data wavetableSamples[1] = {
+	{
+		wavetableSine, true, 9,
+		(1 << (32 - 9)) * 256.0 / AUDIO_SAMPLE_RATE_EXACT,
+		(uint32_t)256 << (32 - 9), (uint32_t)256 << (32 - 9), (uint32_t)256 << (32 - 9),
+		UINT16_MAX,
+		0, uint32_t(10 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+		0, uint32_t(200 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+		uint32_t(50 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::ENVELOPE_PERIOD),
+		int32_t((1.0 - WAVETABLE_DECIBEL_SHIFT(-6.0)) * AudioSynthWavetable::UNITY_GAIN),
+		0, uint32_t(5.0 * AudioSynthWavetable::LFO_PERIOD * (UINT32_MAX / AUDIO_SAMPLE_RATE_EXACT)),
+		(WAVETABLE_CENTS_SHIFT(10) - 1.0) * 4, (1.0 - WAVETABLE_CENTS_SHIFT(-10)) * 4,
+		uint32_t(20 * AudioSynthWavetable::SAMPLES_PER_MSEC / AudioSynthWavetable::LFO_PERIOD),
+		uint32_t(3.0 * AudioSynthWavetable::LFO_PERIOD * (UINT32_MAX / AUDIO_SAMPLE_RATE_EXACT)),
+		(WAVETABLE_CENTS_SHIFT(0) - 1.0) * 4, (1.0 - WAVETABLE_CENTS_SHIFT(0)) * 4,
+		int32_t(UINT16_MAX * (WAVETABLE_DECIBEL_SHIFT(-1.0) - 1.0)) * 4,
+		int32_t(UINT16_MAX * (1.0 - WAVETABLE_DECIBEL_SHIFT(1.0))) * 4,
+	},
+};
+static const uint8_t wavetableRanges[] = {127, };
+static const AudioSynthWavetable::instrument_data wavetableInstrument =
+	{1, wavetableRanges, wavetableSamples};
+
+// the noise input again, played through AudioPlayQueue
+static TestInput queueInput(true);
+
+static void queueNext(void)
+{
+	int16_t buf[AUDIO_BLOCK_SAMPLES];
+	for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) buf[i] = queueInput.next();
+	playQueue1.play(buf, AUDIO_BLOCK_SAMPLES);
+}
+
+// 1000 samples of 16 bit PCM, 2 per word, after the format and length,
+// padded to 1024 samples like wav2sketch
+static unsigned int pcm[1 + 512];
+
+struct test {
+	const char *object;
+	const char *config;
+	// 0 for identical results, otherwise the largest difference allowed,
+	// in sample units for audio or the units of read() for analyzers
+	float tolerance;
+	void (*begin)();
+	void (*each)();    // after every update, for analyzers and queues
+	void (*end)();     // optional extra checks
+};
+
+static const test tests[] = {
+	{"AudioSynthWaveformSine", "1 kHz", 0,
+		[]{ sine1.frequency(1000); sine1.amplitude(0.9); listen(sine1); }},
+	{"AudioSynthWaveformSineHires", "1 kHz", 0,
+		[]{ sineHires1.frequency(1000); sineHires1.amplitude(0.9); listen(sineHires1, 2); }},
+	{"AudioSynthWaveformSineModulated", "FM by chirp", 0,
+		[]{ sineFM1.frequency(1000); sineFM1.amplitude(0.9); connectA(sineFM1); listen(sineFM1); }},
+	{"AudioSynthWaveform", "sawtooth", 0,
+		[]{ waveform1.begin(0.9, 330, WAVEFORM_SAWTOOTH); listen(waveform1); }},
+	{"AudioSynthWaveform", "bandlimited square", 0,
+		[]{ waveform2.begin(0.9, 330, WAVEFORM_BANDLIMIT_SQUARE); listen(waveform2); }},
+	{"AudioSynthWaveformModulated", "triangle, FM by chirp", 0,
+		[]{ waveformMod1.begin(0.9, 330, WAVEFORM_TRIANGLE); connectA(waveformMod1);
+			listen(waveformMod1); }},
+	{"AudioSynthWaveformDc", "50 ms ramp", 0,
+		[]{ dc1.amplitude(0.8, 50); listen(dc1); }},
+	{"AudioSynthWaveformPWM", "chirp", 0,
+		[]{ pwm1.frequency(220); pwm1.amplitude(0.8); connectA(pwm1); listen(pwm1); }},
+	{"AudioSynthToneSweep", "100 Hz to 4 kHz", 0,
+		[]{ sweep1.play(0.8, 100, 4000, 0.3); listen(sweep1); }},
+	{"AudioSynthNoiseWhite", "", 0,
+		[]{ noise1.amplitude(0.5); listen(noise1); }},
+	{"AudioSynthNoisePink", "", 0,
+		[]{ pink1.amplitude(0.5); listen(pink1); }},
+	{"AudioSynthKarplusStrong", "220 Hz", 0,
+		[]{ string1.noteOn(220, 0.8); listen(string1); }},
+	{"AudioSynthSimpleDrum", "", 0,
+		[]{ drum1.frequency(80); drum1.length(200); drum1.pitchMod(0.6); drum1.noteOn();
+			listen(drum1); }},
+	{"AudioSynthWavetable", "vibrato, tremolo, released", 0,
+		[]{ for (int i=0; i < 258; i++) wavetableSine[i] = 20000.0 * sin(i * (2.0 * M_PI / 256.0));
+			wavetable1.setInstrument(wavetableInstrument); wavetable1.amplitude(1.0);
+			wavetable1.playFrequency(440); listen(wavetable1); },
+		[]{ if (samples == RUN_SAMPLES / 2) wavetable1.stop(); }},
+	// the phasors' length is corrected once per block, so rounding differs
+	{"AudioSynthAdditive", "16 partials", 1,
+		[]{ for (int i=0; i < 16; i++) additive1.partial(i, 110.0 * (i + 1), 0.5 / (i + 1));
+			listen(additive1); }},
+	{"AudioSynthFM", "algorithm 5", 0,
+		[]{ fm1.algorithm(5); fm1.noteOn(220.0f, 1.0f); listen(fm1); }},
+	{"AudioSynthFMPoly", "3 notes", 0,
+		[]{ fmpoly1.noteOn(57); fmpoly1.noteOn(61); fmpoly1.noteOn(64); listen(fmpoly1); }},
+	{"AudioPlayMemory", "16 bit PCM", 0,
+		[]{ for (int i=0; i < 500; i++) pcm[1 + i] = (i * 40) | ((-i * 40) << 16);
+			pcm[0] = 0x81000000 | 1000; playMem1.play(pcm); listen(playMem1); }},
+	{"AudioPlayQueue", "to AudioRecordQueue", 0,
+		[]{ playQueue1.setBehaviour(AudioPlayQueue::NON_STALLING);
+			inputCord[0].connect(playQueue1, 0, recordQueue1, 0); recordQueue1.begin();
+			queueInput.reset(); queueNext(); },
+		[]{ if (samples < RUN_SAMPLES) queueNext();
+			while (recordQueue1.available()) {
+				const int16_t *p = recordQueue1.readBuffer();
+				for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) value(p[i]);
+				recordQueue1.freeBuffer();
+			} },
+		[]{ recordQueue1.end(); }},
+
+	{"AudioFilterBiquad", "2 stage lowpass", 0,
+		[]{ biquad1.setLowpass(0, 1000, 0.707); biquad1.setLowpass(1, 1000, 0.707);
+			connectB(biquad1); listen(biquad1); }},
+	{"AudioFilterFIR", "16 taps", 0,
+		[]{ fir1.begin(firCoefficients, 16); connectB(fir1); listen(fir1); }},
+	{"AudioFilterStateVariable", "chirp control", 0,
+		[]{ filter1.frequency(1000); filter1.resonance(2.0); connectAB(filter1); listen(filter1, 3); }},
+	{"AudioFilterLadder", "", 0,
+		[]{ ladder1.frequency(1000); ladder1.resonance(0.6); connectB(ladder1); listen(ladder1); }},
+	{"AudioFilterCrossover", "3 bands", 0,
+		[]{ crossover1.frequency(300, 3000); connectB(crossover1); listen(crossover1, 3); }},
+
+	{"AudioEffectEnvelope", "", 0,
+		[]{ envelope1.attack(20); envelope1.decay(50); envelope1.sustain(0.5); envelope1.noteOn();
+			connectA(envelope1); listen(envelope1); }},
+	{"AudioEffectFade", "100 ms out", 0,
+		[]{ fade1.fadeOut(100); connectA(fade1); listen(fade1); }},
+	{"AudioEffectDelay", "2 taps", 0,
+		[]{ delay1.delay(0, 5); delay1.delay(1, 30); connectA(delay1); listen(delay1, 2); }},
+	{"AudioEffectDelay", "limited to 1024 samples", 0,
+		[]{ delay2.setMaxBlocks(1024 / AUDIO_BLOCK_SAMPLES + 1); delay2.delay(0, 100);
+			connectA(delay2); listen(delay2); },
+		NULL,
+		[]{ if (delay2.memoryUsageMax() > 1024 / AUDIO_BLOCK_SAMPLES + 1) {
+				fail("AudioEffectDelay held %u blocks, setMaxBlocks(%u)",
+					delay2.memoryUsageMax(), 1024 / AUDIO_BLOCK_SAMPLES + 1);
+			} }},
+	{"AudioEffectFreeverb", "", 0,
+		[]{ freeverb1.roomsize(0.7); connectB(freeverb1); listen(freeverb1); }},
+	{"AudioEffectFreeverbStereo", "", 0,
+		[]{ freeverbs1.roomsize(0.7); connectB(freeverbs1); listen(freeverbs1, 2); }},
+	{"AudioEffectReverb", "", 0,
+		[]{ reverb1.reverbTime(1.0); connectB(reverb1); listen(reverb1); }},
+	{"AudioEffectReverbFDN", "8 lines", 0,
+		[]{ reverbfdn1.begin(fdnMemory, FDN_MEMORY_SIZE, 8); reverbfdn1.reverbTime(1.5);
+			connectB(reverbfdn1); listen(reverbfdn1, 2); }},
+	{"AudioEffectChorus", "3 voices", 0,
+		[]{ chorus1.begin(chorusBuffer, CHORUS_DELAY_LENGTH, 3); connectA(chorus1); listen(chorus1); }},
+	{"AudioEffectFlange", "", 0,
+		[]{ flange1.begin(flangeBuffer, FLANGE_DELAY_LENGTH, FLANGE_DELAY_LENGTH/4,
+			FLANGE_DELAY_LENGTH/4, 0.5); connectA(flange1); listen(flange1); }},
+	{"AudioEffectGranular", "pitch shift", 0,
+		[]{ granular1.begin(granularMemory, GRANULAR_MEMORY_SIZE); granular1.setSpeed(1.5);
+			granular1.beginPitchShift(40); connectA(granular1); listen(granular1); }},
+	{"AudioEffectBitcrusher", "6 bits, 8 kHz", 0,
+		[]{ bitcrusher1.bits(6); bitcrusher1.sampleRate(8000); connectA(bitcrusher1);
+			listen(bitcrusher1); }},
+	{"AudioEffectWaveFolder", "", 0,
+		[]{ connectAB(wavefolder1); listen(wavefolder1); }},
+	{"AudioEffectWaveshaper", "17 points", 0,
+		[]{ waveshaper1.shape(waveshape, 17); connectA(waveshaper1); listen(waveshaper1); }},
+	{"AudioEffectDistortion", "cubic, 2x oversampling", 0,
+		[]{ distortion1.polynomial(softClip, 4); distortion1.drive(6.0);
+			distortion1.oversample(2); connectA(distortion1); listen(distortion1); }},
+	{"AudioEffectDynamics", "compression", 0,
+		[]{ dynamics1.compression(-20.0f, 0.01f, 0.1f, 4.0f); connectA(dynamics1);
+			listen(dynamics1); }},
+	{"AudioEffectMultibandCompressor", "3 bands, stereo", 0,
+		[]{ multiband1.crossover(300, 3000); connectAB(multiband1); listen(multiband1, 2); }},
+	{"AudioEffectLimiter", "stereo", 0,
+		[]{ limiter1.inputGain(4.0); connectA(limiter1, 2); listen(limiter1, 2); }},
+	{"AudioEffectVocoder", "8 bands", 0,
+		[]{ vocoder1.bands(8, 200.0, 6000.0); connectAB(vocoder1); listen(vocoder1); }},
+	{"AudioEffectMultiply", "", 0,
+		[]{ connectAB(multiply1); listen(multiply1); }},
+	{"AudioEffectRectifier", "", 0,
+		[]{ connectA(rectifier1); listen(rectifier1); }},
+	{"AudioEffectMidSide", "encode", 0,
+		[]{ midside1.encode(); connectAB(midside1); listen(midside1, 2); }},
+	{"AudioEffectDigitalCombine", "XOR", 0,
+		[]{ combine1.setCombineMode(AudioEffectDigitalCombine::XOR); connectAB(combine1);
+			listen(combine1); }},
+
+	{"AudioMixer4", "mixed gains", 0,
+		[]{ mixer1.gain(0, 0.7); mixer1.gain(1, -0.35); mixer1.gain(2, 1.5);
+			connectAB(mixer1); inputCord[2].connect(inputA, 0, mixer1, 2); listen(mixer1); }},
+	{"AudioAmplifier", "gain 2.5", 0,
+		[]{ amp1.gain(2.5); connectA(amp1); listen(amp1); }},
+	{"AudioMixerMatrix", "2 inputs, 2 outputs", 0,
+		[]{ matrix1.gain(0, 0, 0.8); matrix1.gain(1, 0, 0.3); matrix1.gain(0, 1, -0.5);
+			matrix1.gain(1, 1, 1.0); matrix1.commit(false); connectAB(matrix1); listen(matrix1, 2); }},
+	// the crossfade begins at a block which starts at the same sample at
+	// every size, and lasts 128 samples
+	{"AudioMixerMatrix", "crossfade", 0,
+		[]{ matrix1.gain(0, 0, 0.8); matrix1.gain(1, 0, 0.3); matrix1.gain(0, 1, -0.5);
+			matrix1.gain(1, 1, 1.0); matrix1.commit(false); connectAB(matrix1); listen(matrix1, 2); },
+		[]{ if (samples != RUN_SAMPLES / 2) return;
+			matrix1.disconnectAll(); matrix1.gain(1, 0, 1.0); matrix1.gain(0, 1, 0.6);
+			matrix1.commit(); }},
+
+	{"AudioAnalyzePeak", "", 0,
+		[]{ connectA(peak1); },
+		[]{ if (polling()) value(peak1.read()); }},
+	{"AudioAnalyzeRMS", "", 0,
+		[]{ connectB(rms1); },
+		[]{ if (polling()) value(rms1.read()); }},
+	{"AudioAnalyzeFFT256", "", 0,
+		[]{ connectA(fft256_1); },
+		[]{ if (polling()) for (int i=0; i < 128; i++) value(fft256_1.read(i)); }},
+	{"AudioAnalyzeFFT1024", "", 0,
+		[]{ connectA(fft1024_1); },
+		[]{ if (polling()) for (int i=0; i < 512; i++) value(fft1024_1.read(i)); }},
+	{"AudioAnalyzeToneDetect", "1 kHz", 0,
+		[]{ tone1.frequency(1000, 20); connectA(tone1); },
+		[]{ if (polling()) value(tone1.read()); }},
+	{"AudioAnalyzeToneBank", "DTMF", 0,
+		[]{ tonebank1.dtmf(); connectA(tonebank1); },
+		[]{ if (polling()) for (int i=0; i < 8; i++) value(tonebank1.read(i)); }},
+	{"AudioAnalyzeNoteFrequency", "chirp", 0,
+		[]{ notefreq1.begin(0.15); connectA(notefreq1); },
+		[]{ if (polling()) { value(notefreq1.read()); value(notefreq1.probability()); } }},
+	{"AudioAnalyzeMeter", "stereo", 0,
+		// periods are whole blocks, so use one which is at every size
+		[]{ meter1.period(2048 * 1000.0f / AUDIO_SAMPLE_RATE_EXACT); connectAB(meter1); },
+		[]{ if (polling()) for (int c=0; c < 2; c++) {
+			value(meter1.readPeak(c)); value(meter1.readRMS(c));
+			value(meter1.readPPM(c)); value(meter1.readVU(c)); } }},
+	{"AudioAnalyzeLoudness", "stereo", 0,
+		[]{ connectAB(loudness1); },
+		[]{ if (polling()) { value(loudness1.readMomentary()); value(loudness1.readShortTerm()); } }},
+};
+
+#define NUM_TESTS (sizeof(tests) / sizeof(tests[0]))
+
+static void run(const test &t)
+{
+	inputA.reset();
+	inputB.reset();
+	for (int i=0; i < 4; i++) output[i].count = 0;
+	nvalues = 0;
+	t.begin();
+	for (samples = AUDIO_BLOCK_SAMPLES; samples <= RUN_SAMPLES; samples += AUDIO_BLOCK_SAMPLES) {
+		AudioStream::update_all();
+		if (t.each) t.each();
+	}
+	if (t.end) t.end();
+	for (int i=0; i < 8; i++) inputCord[i].disconnect();
+	for (int i=0; i < 4; i++) outputCord[i].disconnect();
+	// all outputs, then the analyzer results
+	for (int i=0; i < 4; i++) {
+		for (unsigned int n=0; n < output[i].count; n++) {
+			if (nvalues < MAX_VALUES) values[nvalues++] = output[i].data[n];
+		}
+	}
+}
+
+int main(int argc, char **argv)
+{
+	static float reference[MAX_VALUES];
+	bool write = argc > 2 && strcmp(argv[1], "-w") == 0;
+	const char *filename = argv[argc - 1];
+	unsigned int passed = 0;
+	FILE *f;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: blocksize [-w] file\n");
+		return 1;
+	}
+	f = fopen(filename, write ? "wb" : "rb");
+	if (!f) {
+		fprintf(stderr, "blocksize: unable to open %s\n", filename);
+		return 1;
+	}
+	AudioMemory(1024 * 128 / AUDIO_BLOCK_SAMPLES);
+	for (unsigned int i=0; i < NUM_TESTS; i++) {
+		const test &t = tests[i];
+		run(t);
+		if (write) {
+			fwrite(&nvalues, sizeof(nvalues), 1, f);
+			fwrite(values, sizeof(float), nvalues, f);
+			continue;
+		}
+		unsigned int n;
+		if (fread(&n, sizeof(n), 1, f) != 1 || n > MAX_VALUES
+		  || fread(reference, sizeof(float), n, f) != n) {
+			fail("%s is not a reference for these tests", filename);
+			break;
+		}
+		if (n != nvalues) {
+			fail("%s (%s) gave %u results, %u expected", t.object, t.config, nvalues, n);
+			continue;
+		}
+		float diff = 0;
+		unsigned int where = 0;
+		for (unsigned int k=0; k < n; k++) {
+			// some analyzers read infinity until their first result
+			if (values[k] == reference[k]) continue;
+			float d = fabsf(values[k] - reference[k]);
+			if (d > diff || d != d) {
+				diff = d;
+				where = k;
+			}
+		}
+		if (diff > t.tolerance || diff != diff) {
+			fail("%s (%s) differs by %g at result %u of %u, %g allowed",
+				t.object, t.config, diff, where, n, t.tolerance);
+		} else {
+			passed++;
+		}
+	}
+	fclose(f);
+	if (write) {
+		printf("blocksize %d: wrote %u references to %s\n", AUDIO_BLOCK_SAMPLES,
+			(unsigned int)NUM_TESTS, filename);
+	} else {
+		printf("blocksize %d: %u of %u objects match, %u errors\n", AUDIO_BLOCK_SAMPLES,
+			passed, (unsigned int)NUM_TESTS, errors);
+	}
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,509 @@
+// Host test for the codec register shadow and deferred writes
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// usage:  codec
+//
+// The WM8731, SGTL5000, CS42448 and TLV320AIC3206 drivers talk to
+// simulated chips on a fake I2C bus.  The same random sequence of
+// settings is applied once with every write sent immediately, and once
+// with deferred writes flushed a few at a time while the bus sometimes
+// fails.  Both must leave the chip with identical registers, and
+// settings which are swept must be coalesced and use no I2C reads.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "Arduino.h"
+#include "Wire.h"
+#include "control_wm8731.h"
+#include "control_sgtl5000.h"
+#include "control_cs42448.h"
+#include "control_tlv320aic3206.h"
+
+TwoWire Wire;
+static unsigned int errors;
+static uint32_t seed = 1;	// the settings to apply
+static uint32_t busseed = 1;	// when to flush, and bus errors
+
+static uint32_t xorshift(uint32_t *state)
+{
+	uint32_t n = *state;
+
+	n ^= n << 13;
+	n ^= n >> 17;
+	n ^= n << 5;
+	return *state = n;
+}
+
+static uint32_t random32(void) { return xorshift(&seed); }
+static uint32_t random_bus(void) { return xorshift(&busseed); }
+
+static void fail(const char *format, ...)
+{
+	va_list args;
+
+	if (errors++ < 20) {
+		va_start(args, format);
+		printf("FAIL ");
+		vprintf(format, args);
+		printf("\n");
+		va_end(args);
+	}
+}
+
+// Registers of a simulated chip.  While "down" is nonzero, that many
+// transactions are refused.
+class FakeChip : public I2CDevice
+{
+public:
+	FakeChip(uint8_t addr) : address(addr) { }
+	uint16_t reg[512];
+	unsigned int down = 0;
+protected:
+	bool busy(uint8_t addr) {
+		if (addr != address) return true;
+		if (down > 0) {
+			down--;
+			return true;
+		}
+		return false;
+	}
+	uint8_t address;
+};
+
+// 7 bit register number and 9 bit data.  Writing the left input or
+// headphone level with bit 8 set also sets the right channel's level.
+class FakeWM8731 : public FakeChip
+{
+public:
+	FakeWM8731() : FakeChip(0x1A) { memset(reg, 0, sizeof(reg)); }
+	bool write(uint8_t addr, const uint8_t *data, unsigned int len) {
+		if (busy(addr) || len != 2) return false;
+		unsigned int r = data[0] >> 1, val = ((data[0] & 1) << 8) | data[1];
+		if (r == 15) {
+			memset(reg, 0, sizeof(reg));
+			return true;
+		}
+		reg[r] = val;
+		if ((r == 0 || r == 2) && (val & 0x100)) {
+			reg[r + 1] = (reg[r + 1] & 0x100) | (val & 0xFF);
+		}
+		return true;
+	}
+	bool read(uint8_t addr, uint8_t *data, unsigned int len) { return false; }
+};
+
+// 16 bit register addresses and data, reads use the last address written
+class FakeSGTL5000 : public FakeChip
+{
+public:
+	FakeSGTL5000() : FakeChip(0x0A) { memset(reg, 0, sizeof(reg)); }
+	bool write(uint8_t addr, const uint8_t *data, unsigned int len) {
+		if (busy(addr) || (len != 2 && len != 4)) return false;
+		pointer = ((data[0] << 8) | data[1]) & 0x1FF;
+		if (len == 4) reg[pointer >> 1] = (data[2] << 8) | data[3];
+		return true;
+	}
+	bool read(uint8_t addr, uint8_t *data, unsigned int len) {
+		if (busy(addr) || len != 2) return false;
+		data[0] = reg[pointer >> 1] >> 8;
+		data[1] = reg[pointer >> 1];
+		return true;
+	}
+private:
+	unsigned int pointer = 0;
+};
+
+// 8 bit register addresses and data.  Bit 7 of the address increments
+// it after each byte.
+class FakeCS42448 : public FakeChip
+{
+public:
+	FakeCS42448() : FakeChip(0x48) { memset(reg, 0, sizeof(reg)); }
+	bool write(uint8_t addr, const uint8_t *data, unsigned int len) {
+		if (busy(addr) || len < 1) return false;
+		unsigned int r = data[0] & 0x7F;
+		for (unsigned int i=1; i < len; i++) {
+			reg[r] = data[i];
+			if (data[0] & 0x80) r++;
+		}
+		return true;
+	}
+	bool read(uint8_t addr, uint8_t *data, unsigned int len) { return false; }
+};
+
+// Pages of 128 registers, selected by register 0 of every page.  Writing
+// 1 to page 0 register 1 resets the chip.  Pages 0, 1, 8 and 9 are kept,
+// at reg[0], reg[128], reg[256] and reg[384].
+class FakeTLV320AIC3206 : public FakeChip
+{
+public:
+	FakeTLV320AIC3206() : FakeChip(0x18) { memset(reg, 0, sizeof(reg)); }
+	bool write(uint8_t addr, const uint8_t *data, unsigned int len) {
+		if (busy(addr) || len < 1 || len > 2) return false;
+		pointer = data[0] & 0x7F;
+		if (len == 1) return true;
+		if (pointer == 0) {
+			page = data[1];
+		} else if (page == 0 && pointer == 1 && (data[1] & 1)) {
+			memset(reg, 0, sizeof(reg));
+			page = 0;
+		} else if (index() >= 0) {
+			reg[index()] = data[1];
+		}
+		return true;
+	}
+	bool read(uint8_t addr, uint8_t *data, unsigned int len) {
+		if (busy(addr) || len != 1) return false;
+		data[0] = (pointer == 0) ? page : (index() >= 0) ? reg[index()] : 0;
+		return true;
+	}
+private:
+	int index(void) {
+		if (page <= 1) return page * 128 + pointer;
+		if (page == 8 || page == 9) return (page - 6) * 128 + pointer;
+		return -1;
+	}
+	unsigned int page = 0, pointer = 0;
+};
+
+// write() is protected, these give the test direct register access
+class TestWM8731 : public AudioControlWM8731
+{
+public:
+	using AudioControlWM8731::write;
+};
+
+// Send everything queued, a few at a time, with the bus sometimes failing.
+template <class Codec>
+static void flush_all(Codec &codec, FakeChip &chip, bool faults = true)
+{
+	int n = 0;
+	while (codec.pendingWrites() > 0) {
+		if (faults && random_bus() % 4 == 0) chip.down = random_bus() % 16;
+		codec.flush(1 + random_bus() % 4);
+		if (++n > 10000) {
+			fail("flush never finished, %d pending", codec.pendingWrites());
+			return;
+		}
+	}
+	chip.down = 0;
+}
+
+static void wm8731_run(FakeWM8731 &chip, bool deferred, uint32_t start, const unsigned int *script, int len)
+{
+	TestWM8731 codec;
+
+	Wire.attach(&chip);
+	codec.enable();
+	seed = start;
+	if (deferred) codec.deferWrites(true);
+	for (int i=0; i < len; i++) {
+		unsigned int reg, val;
+		if (script) {
+			reg = script[i] >> 16;
+			val = script[i] & 0xFFFF;
+		} else {
+			reg = random32() % 4;	// the channel levels
+			if (random32() % 8 == 0) reg = 4 + random32() % 6;
+			val = random32() & 0x1FF;
+		}
+		codec.write(reg, val);
+		if (deferred && random_bus() % 16 == 0) flush_all(codec, chip);
+	}
+	if (deferred) flush_all(codec, chip);
+}
+
+static void wm8731_compare(const unsigned int *script, int len, uint32_t start)
+{
+	FakeWM8731 now, later;
+
+	wm8731_run(now, false, start, script, len);
+	wm8731_run(later, true, start, script, len);
+	for (int r=0; r < 10; r++) {
+		if (now.reg[r] != later.reg[r]) {
+			fail("WM8731 register %d is %03X with deferred writes, %03X without",
+				r, later.reg[r], now.reg[r]);
+		}
+	}
+}
+
+static void wm8731_test(void)
+{
+	// left with both bit, right, left with both bit: right ends with
+	// the left's level, and the same again with a repeated left value
+	static const unsigned int both[] = {0x00117, 0x1000C, 0x00117};
+	static const unsigned int same[] = {0x00117, 0x1000C, 0x00117, 0x00117};
+	static const unsigned int hp[] = {0x30079, 0x201F0, 0x30060, 0x201F0, 0x30050};
+
+	wm8731_compare(both, 3, 1);
+	wm8731_compare(same, 4, 1);
+	wm8731_compare(hp, 5, 1);
+	for (uint32_t n=1; n <= 500; n++) {
+		wm8731_compare(NULL, 1 + n % 40, n);
+	}
+
+	// a volume sweep sends only the final setting
+	FakeWM8731 chip;
+	AudioControlWM8731 codec;
+	Wire.attach(&chip);
+	codec.enable();
+	codec.deferWrites(true);
+	for (int i=0; i <= 100; i++) codec.volume(i / 100.0f);
+	if (codec.pendingWrites() != 2) {
+		fail("WM8731 volume sweep queued %d writes, expected 2", codec.pendingWrites());
+	}
+	codec.flush();
+	if (chip.reg[2] != 0x1FF || chip.reg[3] != 0x0FF) {
+		fail("WM8731 volume(1.0) wrote %03X, %03X", chip.reg[2], chip.reg[3]);
+	}
+}
+
+// The same settings a sketch might change from a user interface.
+static void sgtl5000_steps(AudioControlSGTL5000 &codec, int count)
+{
+	for (int i=0; i < count; i++) {
+		switch (random32() % 8) {
+		  case 0: codec.volume((random32() % 101) / 100.0f); break;
+		  case 1: codec.lineOutLevel(13 + random32() % 19); break;
+		  case 2: codec.dacVolume((random32() % 101) / 100.0f); break;
+		  case 3: codec.lineInLevel(random32() % 16, random32() % 16); break;
+		  case 4: codec.eqBands(((int)(random32() % 201) - 100) / 100.0f,
+			((int)(random32() % 201) - 100) / 100.0f); break;
+		  case 5: codec.micGain(random32() % 64); break;
+		  case 6: codec.inputSelect(random32() % 2); break;
+		  case 7: codec.headphoneSelect(random32() % 2); break;
+		}
+	}
+}
+
+static void sgtl5000_run(FakeSGTL5000 &chip, bool deferred, uint32_t start, int len)
+{
+	AudioControlSGTL5000 codec;
+
+	Wire.attach(&chip);
+	codec.enable();
+	codec.audioPostProcessorEnable();
+	codec.eqSelect(3);
+	seed = start;
+	if (deferred) codec.deferWrites(true);
+	for (int i=0; i < len; i++) {
+		sgtl5000_steps(codec, 1);
+		if (deferred && random_bus() % 16 == 0) flush_all(codec, chip);
+	}
+	if (deferred) flush_all(codec, chip);
+}
+
+static void sgtl5000_test(void)
+{
+	for (uint32_t n=1; n <= 200; n++) {
+		FakeSGTL5000 now, later;
+		sgtl5000_run(now, false, n, 1 + n % 30);
+		sgtl5000_run(later, true, n, 1 + n % 30);
+		for (int r=0; r < SGTL5000_REGISTERS; r++) {
+			if (now.reg[r] != later.reg[r]) {
+				fail("SGTL5000 register %04X is %04X with deferred writes, %04X without",
+					r * 2, later.reg[r], now.reg[r]);
+			}
+		}
+	}
+
+	// once every register has been seen, sweeps need no reads, and
+	// deferred writes are coalesced
+	FakeSGTL5000 chip;
+	AudioControlSGTL5000 codec;
+	Wire.attach(&chip);
+	codec.enable();
+	codec.audioPostProcessorEnable();
+	codec.eqSelect(3);
+	seed = 1;
+	sgtl5000_steps(codec, 200);
+	unsigned int reads = Wire.reads, writes = Wire.writes;
+	codec.deferWrites(true);
+	sgtl5000_steps(codec, 200);
+	if (Wire.reads != reads) {
+		fail("SGTL5000 settings used %d I2C reads after caching", Wire.reads - reads);
+	}
+	if (Wire.writes != writes) {
+		fail("SGTL5000 deferred settings used %d I2C writes before flush",
+			Wire.writes - writes);
+	}
+	if (codec.pendingWrites() > 12) {
+		fail("SGTL5000 200 settings queued %d writes", codec.pendingWrites());
+	}
+	codec.deferWrites(false);
+	if (codec.pendingWrites() != 0) {
+		fail("SGTL5000 deferWrites(false) left %d writes", codec.pendingWrites());
+	}
+}
+
+static void cs42448_steps(AudioControlCS42448 &codec, int count)
+{
+	for (int i=0; i < count; i++) {
+		switch (random32() % 5) {
+		  case 0: codec.volume((random32() % 101) / 100.0f); break;
+		  case 1: codec.inputLevel((random32() % 101) / 25.0f); break;
+		  case 2: codec.invertDAC(random32() & 0xFF); break;
+		  case 3: codec.invertADC(random32() & 0x3F); break;
+		  case 4: codec.filterFreeze(); break;
+		}
+	}
+}
+
+static void cs42448_run(FakeCS42448 &chip, bool deferred, uint32_t start, int len)
+{
+	AudioControlCS42448 codec;
+
+	Wire.attach(&chip);
+	codec.enable();
+	seed = start;
+	if (deferred) codec.deferWrites(true);
+	for (int i=0; i < len; i++) {
+		cs42448_steps(codec, 1);
+		if (deferred && random_bus() % 16 == 0) flush_all(codec, chip);
+	}
+	if (deferred) flush_all(codec, chip);
+}
+
+static void cs42448_test(void)
+{
+	for (uint32_t n=1; n <= 200; n++) {
+		FakeCS42448 now, later;
+		cs42448_run(now, false, n, 1 + n % 30);
+		cs42448_run(later, true, n, 1 + n % 30);
+		for (int r=0; r < CS42448_REGISTERS; r++) {
+			if (now.reg[r] != later.reg[r]) {
+				fail("CS42448 register %02X is %02X with deferred writes, %02X without",
+					r, later.reg[r], now.reg[r]);
+			}
+		}
+	}
+
+	// a volume sweep queues the unmute and 8 volumes, and sends only
+	// the final setting, after which setting it again sends nothing
+	FakeCS42448 chip;
+	AudioControlCS42448 codec;
+	Wire.attach(&chip);
+	codec.enable();
+	unsigned int writes = Wire.writes;
+	codec.deferWrites(true);
+	for (int i=0; i <= 100; i++) codec.volume(i / 100.0f);
+	if (codec.pendingWrites() != 9 || Wire.writes != writes) {
+		fail("CS42448 volume sweep queued %d writes, sent %d, expected 9 and 0",
+			codec.pendingWrites(), Wire.writes - writes);
+	}
+	codec.deferWrites(false);
+	for (int r=0x07; r <= 0x0F; r++) {
+		if (chip.reg[r] != 0) fail("CS42448 volume(1.0) wrote %02X to %02X", chip.reg[r], r);
+	}
+	writes = Wire.writes;
+	codec.volume(1.0f);
+	if (Wire.writes != writes) fail("CS42448 unchanged volume sent %d writes", Wire.writes - writes);
+}
+
+static void tlv320aic3206_steps(AudioControlTLV320AIC3206 &codec, int count)
+{
+	for (int i=0; i < count; i++) {
+		switch (random32() % 8) {
+		  case 0: codec.volume_dB((int)(random32() % 176) / 2.0f - 63.5f); break;
+		  case 1: codec.setInputGain_dB((random32() % 96) / 2.0f); break;
+		  case 2: codec.inputSelect(1 + random32() % 4); break;
+		  case 3: codec.outputSelect(1 + random32() % 3); break;
+		  case 4: codec.setMicBias(random32() % 5); break;
+		  case 5: codec.enableAutoMuteDAC(random32() % 2, random32() % 8); break;
+		  case 6: codec.setHPFonADC(random32() % 2, 5 + random32() % 100, 44100.0f); break;
+		  case 7: codec.enableMicDetect(random32() % 2); break;
+		}
+	}
+}
+
+// The driver prints every bus error, so the bus does not fail here
+static void tlv320aic3206_run(FakeTLV320AIC3206 &chip, bool deferred, uint32_t start, int len)
+{
+	AudioControlTLV320AIC3206 codec;
+
+	Wire.attach(&chip);
+	codec.enable();
+	seed = start;
+	if (deferred) codec.deferWrites(true);
+	for (int i=0; i < len; i++) {
+		tlv320aic3206_steps(codec, 1);
+		if (deferred && random_bus() % 16 == 0) flush_all(codec, chip, false);
+	}
+	if (deferred) flush_all(codec, chip, false);
+}
+
+static void tlv320aic3206_test(void)
+{
+	for (uint32_t n=1; n <= 200; n++) {
+		FakeTLV320AIC3206 now, later;
+		tlv320aic3206_run(now, false, n, 1 + n % 30);
+		tlv320aic3206_run(later, true, n, 1 + n % 30);
+		for (int r=0; r < 512; r++) {
+			if (now.reg[r] != later.reg[r]) {
+				fail("TLV320AIC3206 page %d register %d is %02X with deferred writes, %02X without",
+					(r < 256) ? r / 128 : r / 128 + 6, r % 128, later.reg[r], now.reg[r]);
+			}
+		}
+	}
+
+	// once every register has been seen, settings need no reads, and
+	// changing a register on the current page sends only that register
+	FakeTLV320AIC3206 chip;
+	AudioControlTLV320AIC3206 codec;
+	Wire.attach(&chip);
+	codec.enable();
+	seed = 1;
+	tlv320aic3206_steps(codec, 200);
+	codec.volume_dB(0.0f);
+	unsigned int reads = Wire.reads, writes = Wire.writes;
+	codec.volume_dB(-10.0f);
+	if (Wire.writes != writes + 2) {
+		fail("TLV320AIC3206 volume change sent %d writes, expected 2", Wire.writes - writes);
+	}
+	codec.enableAutoMuteDAC(true, 3);
+	codec.enableAutoMuteDAC(false, 0);
+	codec.setHPFonADC(true, 20.0f, 44100.0f);
+	if (Wire.reads != reads) {
+		fail("TLV320AIC3206 settings used %d I2C reads after caching", Wire.reads - reads);
+	}
+	writes = Wire.writes;
+	codec.deferWrites(true);
+	for (int i=0; i <= 100; i++) codec.volume(i / 100.0f);
+	if (codec.pendingWrites() != 2 || Wire.writes != writes) {
+		fail("TLV320AIC3206 volume sweep queued %d writes, sent %d, expected 2 and 0",
+			codec.pendingWrites(), Wire.writes - writes);
+	}
+	codec.deferWrites(false);
+	if (chip.reg[65] != 30 || chip.reg[66] != 30) {
+		fail("TLV320AIC3206 volume(1.0) wrote %02X, %02X", chip.reg[65], chip.reg[66]);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	wm8731_test();
+	sgtl5000_test();
+	cs42448_test();
+	tlv320aic3206_test();
+	printf("codec: %u errors\n", errors);
+	return errors ? 1 : 0;
+}
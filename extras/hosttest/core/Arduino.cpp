@@ -0,0 +1,100 @@
+// Just enough of the Teensy core to build audio library code on a PC
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <time.h>
+#include "Arduino.h"
+
+usb_serial_class Serial;
+
+static uint64_t nanoseconds(void)
+{
+	static uint64_t start;
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	uint64_t now = (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+	if (start == 0) start = now;
+	return now - start;
+}
+
+uint32_t millis(void)
+{
+	return nanoseconds() / 1000000;
+}
+
+uint32_t micros(void)
+{
+	return nanoseconds() / 1000;
+}
+
+uint32_t ARM_DEMCR, ARM_DWT_CTRL;
+
+uint32_t dwt_cycle_count(void)
+{
+	return nanoseconds() * (F_CPU / 1000000) / 1000;
+}
+
+// the same sequence on every run, unless randomSeed() is used
+static uint32_t seed = 1;
+
+void randomSeed(uint32_t newseed)
+{
+	if (newseed > 0) seed = newseed;
+}
+
+int32_t random(int32_t howbig)
+{
+	if (howbig <= 0) return 0;
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed % howbig;
+}
+
+int32_t random(int32_t howsmall, int32_t howbig)
+{
+	if (howsmall >= howbig) return howsmall;
+	return random(howbig - howsmall) + howsmall;
+}
+
+size_t Print::print(unsigned long n, int base)
+{
+	char buf[8 * sizeof(long) + 1], *p = buf + sizeof(buf) - 1;
+
+	if (base < 2) base = 10;
+	*p = 0;
+	do {
+		unsigned int digit = n % base;
+		*--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+		n /= base;
+	} while (n);
+	return write(p);
+}
+
+int Print::printf(const char *format, ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	int n = vprintf(format, args);
+	va_end(args);
+	return n;
+}
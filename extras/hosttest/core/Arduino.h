@@ -0,0 +1,153 @@
+// Just enough of the Teensy core to build audio library code on a PC
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+#ifndef F_CPU
+#define F_CPU 600000000
+#endif
+#define F_CPU_ACTUAL F_CPU
+
+#define LOW		0
+#define HIGH		1
+#define INPUT		0
+#define OUTPUT		1
+
+#define PI		3.1415926535897932384626433832795
+#define HALF_PI		1.5707963267948966192313216916398
+#define TWO_PI		6.283185307179586476925286766559
+#define DEG_TO_RAD	0.017453292519943295769236907684886
+#define RAD_TO_DEG	57.295779513082320876798154814105
+
+// from newlib's math.h
+#ifndef _M_LN2
+#define _M_LN2		0.693147180559945309417
+#endif
+
+// memory placement only matters on Teensy
+#define DMAMEM
+#define EXTMEM
+#define FASTRUN
+#define FLASHMEM
+#define PROGMEM
+#define PSTR(s) (s)
+#define F(s) (s)
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef uint16_t word;
+
+#ifdef __cplusplus
+#define min(a, b) ({ \
+	__typeof__(a) _a = (a); \
+	__typeof__(b) _b = (b); \
+	(_a < _b) ? _a : _b; \
+})
+#define max(a, b) ({ \
+	__typeof__(a) _a = (a); \
+	__typeof__(b) _b = (b); \
+	(_a > _b) ? _a : _b; \
+})
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define sq(x) ((x)*(x))
+
+// nothing waits, tests run as fast as the PC can go
+static inline void delay(uint32_t msec) { }
+static inline void delayMicroseconds(uint32_t usec) { }
+static inline void yield(void) { }
+uint32_t millis(void);
+uint32_t micros(void);
+
+// the DWT cycle counter, counting the PC's time at F_CPU
+uint32_t dwt_cycle_count(void);
+#define ARM_DWT_CYCCNT (dwt_cycle_count())
+extern uint32_t ARM_DEMCR, ARM_DWT_CTRL;
+#define ARM_DEMCR_TRCENA (1 << 24)
+#define ARM_DWT_CTRL_CYCCNTENA (1 << 0)
+
+// there are no interrupts, update() only runs when called
+static inline void __disable_irq(void) { }
+static inline void __enable_irq(void) { }
+#define cli() __disable_irq()
+#define sei() __enable_irq()
+#define NVIC_ENABLE_IRQ(n) do { } while (0)
+#define NVIC_DISABLE_IRQ(n) do { } while (0)
+#define IRQ_SOFTWARE 0
+
+static inline void pinMode(uint8_t pin, uint8_t mode) { }
+static inline void digitalWrite(uint8_t pin, uint8_t val) { }
+static inline void digitalWriteFast(uint8_t pin, uint8_t val) { }
+
+#ifdef __cplusplus
+int32_t random(int32_t howbig);
+int32_t random(int32_t howsmall, int32_t howbig);
+void randomSeed(uint32_t newseed);
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Serial goes to stdout
+class Print
+{
+public:
+	size_t write(uint8_t c) { return fputc(c, stdout) == EOF ? 0 : 1; }
+	size_t write(const char *s) { return fputs(s, stdout) == EOF ? 0 : strlen(s); }
+	size_t print(const char *s) { return write(s); }
+	size_t print(char c) { return write((uint8_t)c); }
+	size_t print(int n, int base = DEC) { return print((long)n, base); }
+	size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+	size_t print(long n, int base = DEC) {
+		if (base == DEC) return printf("%ld", n);
+		return print((unsigned long)n, base);
+	}
+	size_t print(unsigned long n, int base = DEC);
+	size_t print(double n, int digits = 2) { return printf("%.*f", digits, n); }
+	size_t println(void) { return write("\r\n"); }
+	template <typename T> size_t println(T n) { return print(n) + println(); }
+	template <typename T> size_t println(T n, int format) {
+		return print(n, format) + println();
+	}
+	int printf(const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+	void flush(void) { fflush(stdout); }
+};
+
+class usb_serial_class : public Print
+{
+public:
+	void begin(long baud) { }
+	operator bool() { return true; }
+};
+extern usb_serial_class Serial;
+#endif
+
+#endif
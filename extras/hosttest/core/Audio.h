@@ -0,0 +1,93 @@
+// Audio.h for PC based tests, with the objects which need no hardware
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef Audio_h_
+#define Audio_h_
+
+#include "Arduino.h"
+
+// there is no audio interrupt to hold off
+#define AudioNoInterrupts() do { } while (0)
+#define AudioInterrupts()   do { } while (0)
+
+// the same list as the library's Audio.h, without inputs, outputs
+// and objects which read SD cards, flash chips or SPI memory
+//
+#include "analyze_fft256.h"
+#include "analyze_fft1024.h"
+#include "analyze_print.h"
+#include "analyze_tonedetect.h"
+#include "analyze_tonebank.h"
+#include "analyze_notefreq.h"
+#include "analyze_peak.h"
+#include "analyze_rms.h"
+#include "analyze_meter.h"
+#include "analyze_loudness.h"
+#include "control_sgtl5000.h"
+#include "control_wm8731.h"
+#include "control_ak4558.h"
+#include "control_cs4272.h"
+#include "control_cs42448.h"
+#include "control_tlv320aic3206.h"
+#include "effect_bitcrusher.h"
+#include "effect_chorus.h"
+#include "effect_fade.h"
+#include "effect_flange.h"
+#include "effect_envelope.h"
+#include "effect_multiply.h"
+#include "effect_delay.h"
+#include "effect_midside.h"
+#include "effect_reverb.h"
+#include "effect_freeverb.h"
+#include "effect_reverb_fdn.h"
+#include "effect_waveshaper.h"
+#include "effect_distortion.h"
+#include "effect_multiband.h"
+#include "effect_limiter.h"
+#include "effect_granular.h"
+#include "effect_combine.h"
+#include "effect_rectifier.h"
+#include "effect_wavefolder.h"
+#include "effect_vocoder.h"
+#include "filter_biquad.h"
+#include "filter_fir.h"
+#include "filter_variable.h"
+#include "filter_ladder.h"
+#include "filter_crossover.h"
+#include "mixer.h"
+#include "mixer_matrix.h"
+#include "play_memory.h"
+#include "play_queue.h"
+#include "record_queue.h"
+#include "synth_tonesweep.h"
+#include "synth_sine.h"
+#include "synth_additive.h"
+#include "synth_fm.h"
+#include "synth_waveform.h"
+#include "synth_dc.h"
+#include "synth_whitenoise.h"
+#include "synth_pinknoise.h"
+#include "synth_karplusstrong.h"
+#include "synth_simple_drum.h"
+#include "synth_pwm.h"
+#include "synth_wavetable.h"
+
+#endif
@@ -0,0 +1,176 @@
+// Audio library core for PC based tests
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <stdio.h>
+#include "AudioStream.h"
+
+audio_block_t * AudioStream::memory_pool;
+unsigned int AudioStream::memory_pool_size;
+static uint8_t memory_pool_used[65536];
+
+uint16_t AudioStream::cpu_cycles_total = 0;
+uint16_t AudioStream::cpu_cycles_total_max = 0;
+uint16_t AudioStream::memory_used = 0;
+uint16_t AudioStream::memory_used_max = 0;
+AudioStream * AudioStream::first_update = NULL;
+
+void AudioStream::initialize_memory(audio_block_t *data, unsigned int num)
+{
+	if (num > 65535) num = 65535;
+	memory_pool = data;
+	memory_pool_size = num;
+	for (unsigned int i=0; i < num; i++) {
+		data[i].memory_pool_index = i;
+		memory_pool_used[i] = 0;
+	}
+	memory_used = 0;
+	memory_used_max = 0;
+}
+
+// NULL when every block is in use, the same as on Teensy
+audio_block_t * AudioStream::allocate(void)
+{
+	for (unsigned int i=0; i < memory_pool_size; i++) {
+		if (!memory_pool_used[i]) {
+			memory_pool_used[i] = 1;
+			audio_block_t *block = memory_pool + i;
+			block->ref_count = 1;
+			if (++memory_used > memory_used_max) memory_used_max = memory_used;
+			return block;
+		}
+	}
+	return NULL;
+}
+
+void AudioStream::release(audio_block_t *block)
+{
+	if (block == NULL) return;
+	if (block->ref_count > 1) {
+		block->ref_count--;
+	} else {
+		unsigned int index = block->memory_pool_index;
+		if (block != memory_pool + index || !memory_pool_used[index]) {
+			fprintf(stderr, "AudioStream: release of a block not allocated\n");
+			abort();
+		}
+		memory_pool_used[index] = 0;
+		memory_used--;
+	}
+}
+
+void AudioStream::transmit(audio_block_t *block, unsigned char index)
+{
+	for (AudioConnection *c = destination_list; c != NULL; c = c->next_dest) {
+		if (c->src_index == index) {
+			if (c->dst->inputQueue[c->dest_index] == NULL) {
+				c->dst->inputQueue[c->dest_index] = block;
+				block->ref_count++;
+			}
+		}
+	}
+}
+
+audio_block_t * AudioStream::receiveReadOnly(unsigned int index)
+{
+	if (index >= num_inputs) return NULL;
+	audio_block_t *in = inputQueue[index];
+	inputQueue[index] = NULL;
+	return in;
+}
+
+audio_block_t * AudioStream::receiveWritable(unsigned int index)
+{
+	if (index >= num_inputs) return NULL;
+	audio_block_t *in = inputQueue[index];
+	inputQueue[index] = NULL;
+	if (in && in->ref_count > 1) {
+		audio_block_t *p = allocate();
+		if (p) memcpy(p->data, in->data, sizeof(p->data));
+		in->ref_count--;
+		in = p;
+	}
+	return in;
+}
+
+int AudioConnection::connect(AudioStream &source, unsigned char sourceOutput,
+	AudioStream &destination, unsigned char destinationInput)
+{
+	if (isConnected) disconnect();
+	src = &source;
+	dst = &destination;
+	src_index = sourceOutput;
+	dest_index = destinationInput;
+	return connect();
+}
+
+int AudioConnection::connect(void)
+{
+	if (isConnected) return 0;
+	if (!src || !dst) return 1;
+	if (dest_index >= dst->num_inputs) return 2;
+	for (AudioConnection *p = src->destination_list; p; p = p->next_dest) {
+		if (p->dst == dst && p->dest_index == dest_index) return 3;
+	}
+	next_dest = NULL;
+	if (src->destination_list == NULL) {
+		src->destination_list = this;
+	} else {
+		AudioConnection *p;
+		for (p = src->destination_list; p->next_dest; p = p->next_dest) ;
+		p->next_dest = this;
+	}
+	src->numConnections++;
+	src->active = true;
+	dst->numConnections++;
+	dst->active = true;
+	isConnected = true;
+	return 0;
+}
+
+int AudioConnection::disconnect(void)
+{
+	if (!isConnected) return 1;
+	if (src->destination_list == this) {
+		src->destination_list = next_dest;
+	} else {
+		for (AudioConnection *p = src->destination_list; p; p = p->next_dest) {
+			if (p->next_dest == this) {
+				p->next_dest = next_dest;
+				break;
+			}
+		}
+	}
+	next_dest = NULL;
+	// a block waiting at the input is not delivered
+	AudioStream::release(dst->inputQueue[dest_index]);
+	dst->inputQueue[dest_index] = NULL;
+	if (--src->numConnections == 0) src->active = false;
+	if (--dst->numConnections == 0) dst->active = false;
+	isConnected = false;
+	return 0;
+}
+
+void AudioStream::update_all(void)
+{
+	for (AudioStream *p = first_update; p; p = p->next_update) {
+		if (p->active) p->update();
+	}
+}
@@ -0,0 +1,160 @@
+// Audio library core for PC based tests
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// The same classes and functions as the Teensy core's AudioStream.h, so
+// audio objects build unchanged.  Nothing runs from an interrupt: each
+// object's update() is called by the test, or for all active objects
+// in the order they were created by AudioStream::update_all().
+
+#ifndef AudioStream_h
+#define AudioStream_h
+
+#include "Arduino.h"
+
+#ifndef AUDIO_BLOCK_SAMPLES
+#define AUDIO_BLOCK_SAMPLES  128
+#endif
+
+#ifndef AUDIO_SAMPLE_RATE_EXACT
+#define AUDIO_SAMPLE_RATE_EXACT 44100.0f
+#endif
+
+#define AUDIO_SAMPLE_RATE AUDIO_SAMPLE_RATE_EXACT
+
+class AudioStream;
+class AudioConnection;
+
+typedef struct audio_block_struct {
+	uint8_t  ref_count;
+	uint8_t  reserved1;
+	uint16_t memory_pool_index;
+	int16_t  data[AUDIO_BLOCK_SAMPLES];
+} audio_block_t;
+
+class AudioConnection
+{
+public:
+	AudioConnection(AudioStream &source, AudioStream &destination) {
+		init();
+		connect(source, 0, destination, 0);
+	}
+	AudioConnection(AudioStream &source, unsigned char sourceOutput,
+		AudioStream &destination, unsigned char destinationInput) {
+		init();
+		connect(source, sourceOutput, destination, destinationInput);
+	}
+	AudioConnection() { init(); }
+	~AudioConnection() { disconnect(); }
+	int disconnect(void);
+	int connect(void);
+	int connect(AudioStream &source, AudioStream &destination) {
+		return connect(source, 0, destination, 0);
+	}
+	int connect(AudioStream &source, unsigned char sourceOutput,
+		AudioStream &destination, unsigned char destinationInput);
+protected:
+	void init(void) {
+		src = NULL;
+		dst = NULL;
+		src_index = 0;
+		dest_index = 0;
+		next_dest = NULL;
+		isConnected = false;
+	}
+	AudioStream *src;
+	AudioStream *dst;
+	unsigned char src_index;
+	unsigned char dest_index;
+	AudioConnection *next_dest;
+	bool isConnected;
+	friend class AudioStream;
+};
+
+#define AudioMemory(num) ({ \
+	static audio_block_t data[num]; \
+	AudioStream::initialize_memory(data, num); \
+})
+
+#define AudioProcessorUsage() (0.0f)
+#define AudioProcessorUsageMax() (0.0f)
+#define AudioProcessorUsageMaxReset() do { } while (0)
+#define AudioMemoryUsage() (AudioStream::memory_used)
+#define AudioMemoryUsageMax() (AudioStream::memory_used_max)
+#define AudioMemoryUsageMaxReset() (AudioStream::memory_used_max = AudioStream::memory_used)
+
+class AudioStream
+{
+public:
+	AudioStream(unsigned char ninput, audio_block_t **iqueue) :
+		num_inputs(ninput), inputQueue(iqueue) {
+		active = false;
+		destination_list = NULL;
+		for (int i=0; i < num_inputs; i++) {
+			inputQueue[i] = NULL;
+		}
+		if (first_update == NULL) {
+			first_update = this;
+		} else {
+			AudioStream *p;
+			for (p=first_update; p->next_update; p = p->next_update) ;
+			p->next_update = this;
+		}
+		next_update = NULL;
+		cpu_cycles = 0;
+		cpu_cycles_max = 0;
+		numConnections = 0;
+	}
+	static void initialize_memory(audio_block_t *data, unsigned int num);
+	float processorUsage(void) { return 0.0f; }
+	float processorUsageMax(void) { return 0.0f; }
+	void processorUsageMaxReset(void) { cpu_cycles_max = cpu_cycles; }
+	bool isActive(void) { return active; }
+	uint16_t cpu_cycles;
+	uint16_t cpu_cycles_max;
+	static uint16_t cpu_cycles_total;
+	static uint16_t cpu_cycles_total_max;
+	static uint16_t memory_used;
+	static uint16_t memory_used_max;
+	// runs every active object once, like the software interrupt
+	static void update_all(void);
+protected:
+	bool active;
+	unsigned char num_inputs;
+	static audio_block_t * allocate(void);
+	static void release(audio_block_t * block);
+	void transmit(audio_block_t *block, unsigned char index = 0);
+	audio_block_t * receiveReadOnly(unsigned int index = 0);
+	audio_block_t * receiveWritable(unsigned int index = 0);
+	static bool update_setup(void) { return false; }
+	static void update_stop(void) { }
+	friend class AudioConnection;
+	uint8_t numConnections;
+private:
+	AudioConnection *destination_list;
+	audio_block_t **inputQueue;
+	virtual void update(void) = 0;
+	static AudioStream *first_update;
+	AudioStream *next_update;
+	static audio_block_t *memory_pool;
+	static unsigned int memory_pool_size;
+};
+
+#endif
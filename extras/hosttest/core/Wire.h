@@ -0,0 +1,77 @@
+// A fake I2C bus, for testing codec drivers on a PC
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Every transaction goes to the device given to Wire.attach(), which
+// models the chip.  A device returns false (NAK) to simulate bus errors.
+class I2CDevice
+{
+public:
+	virtual bool write(uint8_t address, const uint8_t *data, unsigned int len) = 0;
+	virtual bool read(uint8_t address, uint8_t *data, unsigned int len) = 0;
+};
+
+class TwoWire
+{
+public:
+	void begin(void) { }
+	void attach(I2CDevice *d) { device = d; }
+	void beginTransmission(int address) {
+		txaddr = address;
+		txlen = 0;
+	}
+	size_t write(uint8_t b) {
+		if (txlen >= sizeof(tx)) return 0;
+		tx[txlen++] = b;
+		return 1;
+	}
+	uint8_t endTransmission(bool stop = true) {
+		writes++;
+		if (!device || !device->write(txaddr, tx, txlen)) return 2;
+		return 0;
+	}
+	uint8_t requestFrom(int address, int len) {
+		reads++;
+		rxlen = rxpos = 0;
+		if (len > (int)sizeof(rx)) len = sizeof(rx);
+		if (!device || !device->read(address, rx, len)) return 0;
+		rxlen = len;
+		return len;
+	}
+	int available(void) { return rxlen - rxpos; }
+	int read(void) { return (rxpos < rxlen) ? rx[rxpos++] : -1; }
+	unsigned int writes = 0;	// transactions, including failed ones
+	unsigned int reads = 0;
+private:
+	I2CDevice *device = NULL;
+	uint8_t tx[32], rx[32];
+	unsigned int txlen = 0, rxlen = 0, rxpos = 0;
+	int txaddr = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
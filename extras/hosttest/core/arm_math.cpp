@@ -0,0 +1,258 @@
+// The parts of CMSIS arm_math used by the audio library, for PC based tests
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include <string.h>
+#include <math.h>
+#include "arm_math.h"
+
+static q15_t saturate16(q31_t n)
+{
+	if (n > 32767) return 32767;
+	if (n < -32768) return -32768;
+	return n;
+}
+
+static q31_t saturate32(q63_t n)
+{
+	if (n > 0x7FFFFFFF) return 0x7FFFFFFF;
+	if (n < -0x7FFFFFFF - 1) return -0x7FFFFFFF - 1;
+	return n;
+}
+
+arm_status arm_fir_init_q15(arm_fir_instance_q15 *S, uint16_t numTaps,
+	q15_t *pCoeffs, q15_t *pState, uint32_t blockSize)
+{
+	// the Cortex-M4 code handles 2 taps at a time
+	if (numTaps < 4 || (numTaps & 1)) return ARM_MATH_ARGUMENT_ERROR;
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1) * sizeof(q15_t));
+	return ARM_MATH_SUCCESS;
+}
+
+// The coefficients are in time reversed order.  The sum of products is
+// kept in 32 bits and wraps on overflow, like SMLAD.
+void arm_fir_fast_q15(const arm_fir_instance_q15 *S, q15_t *pSrc,
+	q15_t *pDst, uint32_t blockSize)
+{
+	q15_t *state = S->pState;
+	unsigned int taps = S->numTaps;
+
+	memcpy(state + taps - 1, pSrc, blockSize * sizeof(q15_t));
+	for (uint32_t i=0; i < blockSize; i++) {
+		uint32_t acc = 0;
+		for (unsigned int t=0; t < taps; t++) {
+			acc += (uint32_t)((q31_t)state[i + t] * S->pCoeffs[t]);
+		}
+		pDst[i] = saturate16((q31_t)acc >> 15);
+	}
+	memmove(state, state + blockSize, (taps - 1) * sizeof(q15_t));
+}
+
+arm_status arm_fir_interpolate_init_f32(arm_fir_interpolate_instance_f32 *S,
+	uint8_t L, uint16_t numTaps, float32_t *pCoeffs, float32_t *pState,
+	uint32_t blockSize)
+{
+	if (L == 0 || numTaps % L != 0) return ARM_MATH_LENGTH_ERROR;
+	S->L = L;
+	S->phaseLength = numTaps / L;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (blockSize + S->phaseLength - 1) * sizeof(float32_t));
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_fir_interpolate_f32(const arm_fir_interpolate_instance_f32 *S,
+	float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+	float32_t *state = S->pState;
+	unsigned int L = S->L, len = S->phaseLength;
+
+	memcpy(state + len - 1, pSrc, blockSize * sizeof(float32_t));
+	for (uint32_t i=0; i < blockSize; i++) {
+		for (unsigned int j=1; j <= L; j++) {
+			float32_t sum = 0.0f;
+			for (unsigned int t=0; t < len; t++) {
+				sum += state[i + t] * S->pCoeffs[L - j + t * L];
+			}
+			*pDst++ = sum;
+		}
+	}
+	memmove(state, state + blockSize, (len - 1) * sizeof(float32_t));
+}
+
+arm_status arm_fir_decimate_init_f32(arm_fir_decimate_instance_f32 *S,
+	uint16_t numTaps, uint8_t M, float32_t *pCoeffs, float32_t *pState,
+	uint32_t blockSize)
+{
+	if (M == 0 || blockSize % M != 0) return ARM_MATH_LENGTH_ERROR;
+	S->M = M;
+	S->numTaps = numTaps;
+	S->pCoeffs = pCoeffs;
+	S->pState = pState;
+	memset(pState, 0, (numTaps + blockSize - 1) * sizeof(float32_t));
+	return ARM_MATH_SUCCESS;
+}
+
+void arm_fir_decimate_f32(const arm_fir_decimate_instance_f32 *S,
+	float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+	float32_t *state = S->pState;
+	unsigned int M = S->M, taps = S->numTaps;
+
+	memcpy(state + taps - 1, pSrc, blockSize * sizeof(float32_t));
+	for (uint32_t i=0; i < blockSize / M; i++) {
+		float32_t sum = 0.0f;
+		for (unsigned int t=0; t < taps; t++) {
+			sum += state[i * M + t] * S->pCoeffs[t];
+		}
+		*pDst++ = sum;
+	}
+	memmove(state, state + blockSize, (taps - 1) * sizeof(float32_t));
+}
+
+arm_status arm_cfft_radix4_init_q15(arm_cfft_radix4_instance_q15 *S,
+	uint16_t fftLen, uint8_t ifftFlag, uint8_t bitReverseFlag)
+{
+	if (fftLen != 16 && fftLen != 64 && fftLen != 256 && fftLen != 1024) {
+		return ARM_MATH_ARGUMENT_ERROR;
+	}
+	S->fftLen = fftLen;
+	S->ifftFlag = ifftFlag;
+	S->bitReverseFlag = bitReverseFlag;
+	return ARM_MATH_SUCCESS;
+}
+
+// The CMSIS version halves the data at every radix 4 stage, so the
+// result is the transform divided by the length.
+void arm_cfft_radix4_q15(const arm_cfft_radix4_instance_q15 *S, q15_t *pSrc)
+{
+	static double re[1024], im[1024];
+	unsigned int n = S->fftLen, i, j, len;
+
+	// bit reversed order, for the in place transform below
+	for (i=0; i < n; i++) {
+		unsigned int r = 0;
+		for (unsigned int b = 1, k = i; b < n; b <<= 1, k >>= 1) {
+			r = (r << 1) | (k & 1);
+		}
+		re[r] = pSrc[i * 2];
+		im[r] = pSrc[i * 2 + 1];
+	}
+	for (len=2; len <= n; len <<= 1) {
+		double angle = (S->ifftFlag ? 2.0 : -2.0) * M_PI / len;
+		for (i=0; i < n; i += len) {
+			for (j=0; j < len / 2; j++) {
+				double wr = cos(angle * j), wi = sin(angle * j);
+				double *ar = re + i + j, *ai = im + i + j;
+				double *br = ar + len / 2, *bi = ai + len / 2;
+				double tr = *br * wr - *bi * wi;
+				double ti = *br * wi + *bi * wr;
+				*br = *ar - tr;
+				*bi = *ai - ti;
+				*ar += tr;
+				*ai += ti;
+			}
+		}
+	}
+	for (i=0; i < n; i++) {
+		pSrc[i * 2] = saturate16(lrint(re[i] / n));
+		pSrc[i * 2 + 1] = saturate16(lrint(im[i] / n));
+	}
+}
+
+// linear interpolation in a 512 entry table, like CMSIS
+#define SIN_TABLE_SIZE 512
+
+q15_t arm_sin_q15(q15_t x)
+{
+	static q15_t table[SIN_TABLE_SIZE + 1];
+	if (table[1] == 0) {
+		for (int i=0; i <= SIN_TABLE_SIZE; i++) {
+			table[i] = saturate16(lrint(sin(2.0 * M_PI * i / SIN_TABLE_SIZE) * 32768.0));
+		}
+	}
+	if (x < 0) x = 0;
+	int32_t index = (uint32_t)x >> 6;
+	q15_t fract = (x - (index << 6)) << 9;
+	q15_t a = table[index], b = table[index + 1];
+	q15_t n = ((q31_t)(0x8000 - fract) * a) >> 16;
+	n = (q15_t)((((q31_t)n << 16) + ((q31_t)fract * b)) >> 16);
+	return n << 1;
+}
+
+q31_t arm_sin_q31(q31_t x)
+{
+	static q31_t table[SIN_TABLE_SIZE + 1];
+	if (table[1] == 0) {
+		for (int i=0; i <= SIN_TABLE_SIZE; i++) {
+			table[i] = saturate32(llrint(sin(2.0 * M_PI * i / SIN_TABLE_SIZE) * 2147483648.0));
+		}
+	}
+	if (x < 0) x = 0;
+	int32_t index = (uint32_t)x >> 22;
+	q31_t fract = (x - (index << 22)) << 9;
+	q31_t a = table[index], b = table[index + 1];
+	q31_t n = ((q63_t)(0x80000000u - (uint32_t)fract) * a) >> 32;
+	n = (q31_t)((((q63_t)n << 32) + ((q63_t)fract * b)) >> 32);
+	return n << 1;
+}
+
+void arm_float_to_q31(float32_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+	while (blockSize--) {
+		*pDst++ = saturate32((q63_t)(*pSrc++ * 2147483648.0f));
+	}
+}
+
+void arm_q15_to_q31(q15_t *pSrc, q31_t *pDst, uint32_t blockSize)
+{
+	while (blockSize--) {
+		*pDst++ = (q31_t)((uint32_t)*pSrc++ << 16);
+	}
+}
+
+void arm_q31_to_q15(q31_t *pSrc, q15_t *pDst, uint32_t blockSize)
+{
+	while (blockSize--) {
+		*pDst++ = *pSrc++ >> 16;
+	}
+}
+
+void arm_shift_q31(q31_t *pSrc, int8_t shiftBits, q31_t *pDst, uint32_t blockSize)
+{
+	while (blockSize--) {
+		q31_t n = *pSrc++;
+		if (shiftBits >= 0) {
+			*pDst++ = saturate32((q63_t)n << shiftBits);
+		} else {
+			*pDst++ = n >> -shiftBits;
+		}
+	}
+}
+
+void arm_add_q31(q31_t *pSrcA, q31_t *pSrcB, q31_t *pDst, uint32_t blockSize)
+{
+	while (blockSize--) {
+		*pDst++ = saturate32((q63_t)*pSrcA++ + *pSrcB++);
+	}
+}
@@ -0,0 +1,110 @@
+// The parts of CMSIS arm_math used by the audio library, for PC based tests
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// The integer FIR filter and q31 helpers give the same results as the
+// CMSIS versions used on Teensy.  The FFT, sine and floating point FIR
+// functions compute the same thing, but may round differently.
+
+#ifndef _ARM_MATH_H
+#define _ARM_MATH_H
+
+#include <stdint.h>
+
+typedef int8_t q7_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+typedef int64_t q63_t;
+typedef float float32_t;
+
+typedef enum {
+	ARM_MATH_SUCCESS = 0,
+	ARM_MATH_ARGUMENT_ERROR = -1,
+	ARM_MATH_LENGTH_ERROR = -2,
+	ARM_MATH_SIZE_MISMATCH = -3,
+	ARM_MATH_NANINF = -4,
+	ARM_MATH_SINGULAR = -5,
+	ARM_MATH_TEST_FAILURE = -6
+} arm_status;
+
+typedef struct {
+	uint16_t numTaps;
+	q15_t *pState;
+	q15_t *pCoeffs;
+} arm_fir_instance_q15;
+
+typedef struct {
+	uint8_t L;
+	uint16_t phaseLength;
+	float32_t *pCoeffs;
+	float32_t *pState;
+} arm_fir_interpolate_instance_f32;
+
+typedef struct {
+	uint8_t M;
+	uint16_t numTaps;
+	float32_t *pCoeffs;
+	float32_t *pState;
+} arm_fir_decimate_instance_f32;
+
+typedef struct {
+	uint16_t fftLen;
+	uint8_t ifftFlag;
+	uint8_t bitReverseFlag;
+} arm_cfft_radix4_instance_q15;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+arm_status arm_fir_init_q15(arm_fir_instance_q15 *S, uint16_t numTaps,
+	q15_t *pCoeffs, q15_t *pState, uint32_t blockSize);
+void arm_fir_fast_q15(const arm_fir_instance_q15 *S, q15_t *pSrc,
+	q15_t *pDst, uint32_t blockSize);
+
+arm_status arm_fir_interpolate_init_f32(arm_fir_interpolate_instance_f32 *S,
+	uint8_t L, uint16_t numTaps, float32_t *pCoeffs, float32_t *pState,
+	uint32_t blockSize);
+void arm_fir_interpolate_f32(const arm_fir_interpolate_instance_f32 *S,
+	float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+arm_status arm_fir_decimate_init_f32(arm_fir_decimate_instance_f32 *S,
+	uint16_t numTaps, uint8_t M, float32_t *pCoeffs, float32_t *pState,
+	uint32_t blockSize);
+void arm_fir_decimate_f32(const arm_fir_decimate_instance_f32 *S,
+	float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+arm_status arm_cfft_radix4_init_q15(arm_cfft_radix4_instance_q15 *S,
+	uint16_t fftLen, uint8_t ifftFlag, uint8_t bitReverseFlag);
+void arm_cfft_radix4_q15(const arm_cfft_radix4_instance_q15 *S, q15_t *pSrc);
+
+q15_t arm_sin_q15(q15_t x);
+q31_t arm_sin_q31(q31_t x);
+
+void arm_float_to_q31(float32_t *pSrc, q31_t *pDst, uint32_t blockSize);
+void arm_q15_to_q31(q15_t *pSrc, q31_t *pDst, uint32_t blockSize);
+void arm_q31_to_q15(q31_t *pSrc, q15_t *pDst, uint32_t blockSize);
+void arm_shift_q31(q31_t *pSrc, int8_t shiftBits, q31_t *pDst, uint32_t blockSize);
+void arm_add_q31(q31_t *pSrcA, q31_t *pSrcB, q31_t *pDst, uint32_t blockSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,291 @@
+// Host test for the S/PDIF and ADAT encoders used by the digital outputs
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// usage:  digital
+//
+// 16 and 24 bit ramps are encoded by utility/spdif_encode.h and
+// utility/adat_encode.h, then decoded from the biphase-mark or NRZI line
+// signal.  The samples must match exactly, every cell must follow the
+// line code, and S/PDIF must have a B preamble every 192 frames.  The
+// S/PDIF stream is encoded in blocks, the way the outputs do it: one
+// block at a time, from the frame count the interrupt keeps for it.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "spdif_encode.h"
+#include "adat_encode.h"
+
+#define FRAMES  1000  // more than 5 blocks of 192 frames
+#define MAXBLOCK 256
+
+static int16_t left[FRAMES], left_lsb[FRAMES], right[FRAMES], right_lsb[FRAMES];
+static const int16_t zeros[MAXBLOCK];
+static uint32_t stream[FRAMES * 4];
+static unsigned int errors;
+
+static void fail(const char *name, unsigned int frame, const char *what)
+{
+	if (errors++ < 20) printf("FAIL %s, frame %u: %s\n", name, frame, what);
+}
+
+// 24 bit ramps, the left one rising and the right one falling.  With
+// bits24 = 0 the low 8 bits are zero, as sent for 16 bit audio.
+static void ramp(int bits24)
+{
+	for (int i=0; i < FRAMES; i++) {
+		uint32_t l = (i * (bits24 ? 40961u : 65u << 8)) & 0xFFFFFF;
+		uint32_t r = (0x800000 - i * (bits24 ? 25013u : 131u << 8)) & 0xFFFFFF;
+		left[i] = l >> 8;
+		left_lsb[i] = (l & 255) << 8;
+		right[i] = r >> 8;
+		right_lsb[i] = (r & 255) << 8;
+	}
+}
+
+static uint32_t sample24(const int16_t *msb, const int16_t *lsb, int i)
+{
+	return ((uint32_t)(uint16_t)msb[i] << 8) | ((uint16_t)lsb[i] >> 8);
+}
+
+// Decode one S/PDIF subframe, 64 cells in 2 words.  Returns the 24 bit
+// sample, or -1 if the line code is broken.  *line is the level of the
+// last cell before the subframe, and is updated.
+static int32_t spdif_decode(const uint32_t *src, int *line, uint32_t *preamble,
+	uint32_t *vucp)
+{
+	int cell[64], i, ones = 0;
+	uint32_t bits = 0;
+
+	for (i=0; i < 64; i++) cell[i] = (src[i / 32] >> (31 - i % 32)) & 1;
+	// the preamble is sent as is after a low line, or inverted
+	*preamble = 0;
+	for (i=0; i < 8; i++) *preamble = (*preamble << 1) | (cell[i] ^ *line);
+	// each bit begins with a transition, and a 1 has another in its middle
+	for (i=0; i < 28; i++) {
+		int a = cell[8 + i*2], b = cell[9 + i*2];
+		if (a == cell[7 + i*2]) return -1;
+		if (a != b) {
+			bits |= 1 << i;
+			ones++;
+		}
+	}
+	*line = cell[63];
+	if (ones & 1) return -1;  // parity is even
+	*vucp = bits >> 24;
+	return bits & 0xFFFFFF;
+}
+
+static void spdif_check(const char *name, unsigned int frames, uint32_t validity, int silent)
+{
+	int line = 0;
+	char msg[100];
+
+	for (unsigned int f=0; f < frames; f++) {
+		uint32_t expect[2], preamble, vucp;
+		expect[0] = silent ? 0 : sample24(left, left_lsb, f);
+		expect[1] = silent ? 0 : sample24(right, right_lsb, f);
+		for (int ch=0; ch < 2; ch++) {
+			int32_t s = spdif_decode(&stream[f * 4 + ch * 2], &line, &preamble, &vucp);
+			uint32_t p = ch ? SPDIF_PREAMBLE_W :
+				(f % 192 == 0) ? SPDIF_PREAMBLE_B : SPDIF_PREAMBLE_M;
+			if (s < 0) {
+				sprintf(msg, "channel %d is not biphase-mark coded", ch);
+				fail(name, f, msg);
+			} else if (preamble != p) {
+				sprintf(msg, "channel %d preamble %02X, %02X expected", ch, preamble, p);
+				fail(name, f, msg);
+			} else if ((uint32_t)s != expect[ch]) {
+				sprintf(msg, "channel %d sample %06X, %06X expected", ch, s, expect[ch]);
+				fail(name, f, msg);
+			} else if ((vucp & 7) != validity) {
+				sprintf(msg, "channel %d VUC bits %X, %X expected", ch, vucp & 7, validity);
+				fail(name, f, msg);
+			}
+		}
+	}
+}
+
+// Encode the ramps as the S/PDIF outputs do: update() encodes each block
+// from the frame count where the interrupt says it begins, which advances
+// by one block every interrupt, and sends silence if update() is late.
+static void spdif_blocks(const char *name, unsigned int block, uint32_t validity,
+	const char *late)
+{
+	uint16_t frame = 191, n;
+	char title[100];
+
+	for (unsigned int f=0; f < FRAMES; f += block) {
+		unsigned int count = (FRAMES - f < block) ? FRAMES - f : block;
+		n = frame;
+		if (late && late[f / block] == '.') {
+			spdif_encode_silence(&stream[f * 4], count, validity, &n);
+		} else {
+			spdif_encode_frames(&stream[f * 4], count, &left[f], &left_lsb[f],
+				&right[f], &right_lsb[f], validity, &n);
+		}
+		frame = (frame + block) % 192;
+		if (count == block && n != frame) fail(name, f, "frame count differs");
+	}
+	sprintf(title, "%s, blocks of %u", name, block);
+	if (!late) {
+		spdif_check(title, FRAMES, validity, 0);
+		return;
+	}
+	// check the blocks sent as silence separately
+	static uint32_t copy[FRAMES * 4];
+	memcpy(copy, stream, sizeof(stream));
+	for (unsigned int f=0; f < FRAMES; f += block) {
+		unsigned int count = (FRAMES - f < block) ? FRAMES - f : block;
+		if (late[f / block] == '.') {
+			uint16_t m = (191 + f) % 192;
+			spdif_encode_frames(&stream[f * 4], count, zeros, zeros, zeros, zeros,
+				validity, &m);
+			if (memcmp(&stream[f * 4], &copy[f * 4], count * 16) != 0) {
+				fail(title, f, "silence differs from encoded zeros");
+			}
+			m = (191 + f) % 192;
+			spdif_encode_frames(&stream[f * 4], count, &left[f], &left_lsb[f],
+				&right[f], &right_lsb[f], validity, &m);
+		}
+	}
+	spdif_check(title, FRAMES, validity, 0);
+}
+
+static void test_spdif(void)
+{
+	uint16_t frame;
+
+	for (int bits24=0; bits24 < 2; bits24++) {
+		const char *name = bits24 ? "S/PDIF 24 bit" : "S/PDIF 16 bit";
+		ramp(bits24);
+		// all at once, and in blocks of every supported size
+		frame = 191;
+		spdif_encode_frames(stream, FRAMES, left, left_lsb, right, right_lsb, 0, &frame);
+		spdif_check(name, FRAMES, 0, 0);
+		if (frame != (191 + FRAMES) % 192) fail(name, FRAMES, "wrong final frame count");
+		for (unsigned int block=16; block <= MAXBLOCK; block *= 2) {
+			spdif_blocks(name, block, 0, NULL);
+		}
+		spdif_blocks(name, 128, 1, NULL);
+		spdif_blocks(name, 128, 0, "x.xx..x.");
+		spdif_blocks(name, 32, 0, "xxx.xxxxx.xxxxxxxxxxxxxx..xxxxxx");
+	}
+	frame = 191;
+	spdif_encode_silence(stream, FRAMES, 0, &frame);
+	spdif_check("S/PDIF silence", FRAMES, 0, 1);
+	frame = 191;
+	spdif_encode_silence(stream, FRAMES, 1, &frame);
+	spdif_check("S/PDIF silence, invalid", FRAMES, 1, 1);
+}
+
+// Decode one ADAT frame, 256 bits in 8 words.  Returns 0 if the frame
+// structure is broken.  *line is the level before the frame, and is updated.
+static int adat_decode(const uint32_t *src, int *line, uint32_t *sample)
+{
+	int bit[256], i, ch, n, k = 0;
+
+	for (i=0; i < 256; i++) {
+		int cell = (src[i / 32] >> (31 - i % 32)) & 1;
+		bit[i] = cell ^ *line;  // a 1 toggles the line
+		*line = cell;
+	}
+	for (ch=0; ch < 8; ch++) {
+		sample[ch] = 0;
+		for (n=0; n < 6; n++) {
+			if (bit[k++] != 1) return 0;
+			for (i=0; i < 4; i++) sample[ch] = (sample[ch] << 1) | bit[k++];
+		}
+	}
+	if (bit[k++] != 1) return 0;
+	for (i=0; i < 10; i++) if (bit[k++] != 0) return 0;
+	if (bit[k++] != 1) return 0;
+	for (i=0; i < 4; i++) if (bit[k++] != 0) return 0;  // user bits
+	return 1;
+}
+
+static void test_adat(void)
+{
+	uint32_t sample[8], level, start, decoded[8];
+	int line;
+	char msg[100];
+
+	for (int bits24=0; bits24 < 2; bits24++) {
+		const char *name = bits24 ? "ADAT 24 bit" : "ADAT 16 bit";
+		ramp(bits24);
+		for (int invert=0; invert < 2; invert++) {
+			level = start = invert ? ~0U : 0;
+			for (int f=0; f < FRAMES / 2; f++) {
+				for (int ch=0; ch < 8; ch++) {
+					// 8 channels from the 2 ramps, some offset in time
+					int i = (f + ch * 97) % FRAMES;
+					sample[ch] = (ch & 1) ? sample24(right, right_lsb, i)
+						: sample24(left, left_lsb, i);
+				}
+				adat_encode_frame(&stream[f * 8], sample, &level);
+				if (level != ((stream[f * 8 + 7] & 1) ? ~0U : 0)) {
+					fail(name, f, "level is not the last line state");
+				}
+			}
+			line = start & 1;
+			for (int f=0; f < FRAMES / 2; f++) {
+				for (int ch=0; ch < 8; ch++) {
+					int i = (f + ch * 97) % FRAMES;
+					sample[ch] = (ch & 1) ? sample24(right, right_lsb, i)
+						: sample24(left, left_lsb, i);
+				}
+				if (!adat_decode(&stream[f * 8], &line, decoded)) {
+					fail(name, f, "frame is not NRZI coded");
+					continue;
+				}
+				for (int ch=0; ch < 8; ch++) {
+					if (decoded[ch] != sample[ch]) {
+						sprintf(msg, "channel %d sample %06X, %06X expected",
+							ch + 1, decoded[ch], sample[ch]);
+						fail(name, f, msg);
+					}
+				}
+			}
+		}
+	}
+	// the outputs repeat one silent frame, which needs it to end at the
+	// level where it began
+	for (int invert=0; invert < 2; invert++) {
+		memset(sample, 0, sizeof(sample));
+		level = start = invert ? ~0U : 0;
+		adat_encode_frame(stream, sample, &level);
+		line = start & 1;
+		if (level != start) fail("ADAT silence", 0, "the line level changes");
+		if (!adat_decode(stream, &line, decoded)) fail("ADAT silence", 0, "not NRZI coded");
+		for (int ch=0; ch < 8; ch++) {
+			if (decoded[ch] != 0) fail("ADAT silence", 0, "a sample is not zero");
+		}
+	}
+}
+
+int main(void)
+{
+	test_spdif();
+	test_adat();
+	printf("digital: S/PDIF and ADAT round trip, %u errors\n", errors);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,220 @@
+// Host test for the interleave / deinterleave kernels in memcpy_interleave.c
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// usage:  interleave [-b]
+//
+// Every channel count from 1 to 16 is run through the fast kernels and
+// the *_ref loops, at several lengths and shifts, with aligned and
+// misaligned buffers.  The results must be identical, and nothing
+// outside the buffers may be written.  With -b, the time for one 128
+// sample block is also printed for the optimized channel counts.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "memcpy_audio.h"
+
+#define MAXCH   16
+#define MAXLEN  256
+#define GUARD   8
+#define FILL    0x5A5A
+
+static int16_t chan16[2][MAXCH][MAXLEN + 2*GUARD] __attribute__ ((aligned (4)));
+static int16_t inter16[2][MAXCH*MAXLEN + 2*GUARD + 2] __attribute__ ((aligned (4)));
+static uint32_t inter32[2][MAXCH*MAXLEN + 2*GUARD];
+static unsigned int errors;
+static uint32_t seed = 1;
+
+static int16_t random16(void)
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+static void fill16(int16_t *p, unsigned int n)
+{
+	while (n--) *p++ = FILL;
+}
+
+static void fill32(uint32_t *p, unsigned int n)
+{
+	while (n--) *p++ = FILL * 65537u;
+}
+
+static void fail(const char *name, unsigned int ch, unsigned int len,
+	unsigned int shift, unsigned int offset)
+{
+	if (errors++ < 20) {
+		printf("FAIL %s, %u channels, len=%u, shift=%u, offset=%u\n",
+			name, ch, len, shift, offset);
+	}
+}
+
+// offset is in samples, so 1 makes every buffer misaligned for 32 bit access
+static void test(unsigned int ch, unsigned int len, unsigned int shift, unsigned int offset)
+{
+	const int16_t *src[MAXCH];
+	int16_t *dst[2][MAXCH];
+	unsigned int i, c, k, total = ch * len + 2*GUARD;
+
+	for (c=0; c < ch; c++) {
+		for (i=0; i < MAXLEN + 2*GUARD; i++) chan16[0][c][i] = random16();
+		src[c] = &chan16[0][c][GUARD + offset];
+	}
+
+	// channels to interleaved
+	for (k=0; k < 2; k++) {
+		fill16(inter16[k], sizeof(inter16[k]) / sizeof(int16_t));
+		fill32(inter32[k], sizeof(inter32[k]) / sizeof(uint32_t));
+	}
+	memcpy_tointerleave16(inter16[0] + GUARD + offset, src, ch, len);
+	memcpy_tointerleave16_ref(inter16[1] + GUARD + offset, src, ch, len);
+	if (memcmp(inter16[0], inter16[1], (total + offset) * sizeof(int16_t)) != 0) {
+		fail("memcpy_tointerleave16", ch, len, 0, offset);
+	}
+	memcpy_tointerleave32(inter32[0] + GUARD, src, ch, len, shift);
+	memcpy_tointerleave32_ref(inter32[1] + GUARD, src, ch, len, shift);
+	if (memcmp(inter32[0], inter32[1], total * sizeof(uint32_t)) != 0) {
+		fail("memcpy_tointerleave32", ch, len, shift, offset);
+	}
+	for (i=0; i < len; i++) {
+		for (c=0; c < ch; c++) {
+			if (inter16[1][GUARD + offset + i*ch + c] != src[c][i]) {
+				fail("memcpy_tointerleave16_ref", ch, len, 0, offset);
+				i = len;
+				break;
+			}
+		}
+	}
+
+	// interleaved to channels, using the data just made
+	{
+		static int16_t out[2][MAXCH][MAXLEN + 2*GUARD] __attribute__ ((aligned (4)));
+
+		for (k=0; k < 2; k++) {
+			for (c=0; c < ch; c++) {
+				fill16(out[k][c], MAXLEN + 2*GUARD);
+				dst[k][c] = &out[k][c][GUARD + offset];
+			}
+		}
+		memcpy_frominterleave16(dst[0], inter16[1] + GUARD + offset, ch, len);
+		memcpy_frominterleave16_ref(dst[1], inter16[1] + GUARD + offset, ch, len);
+		if (memcmp(out[0], out[1], ch * sizeof(out[0][0])) != 0) {
+			fail("memcpy_frominterleave16", ch, len, 0, offset);
+		}
+		for (c=0; c < ch; c++) {
+			if (memcmp(dst[1][c], src[c], len * sizeof(int16_t)) != 0) {
+				fail("memcpy_frominterleave16_ref", ch, len, 0, offset);
+				break;
+			}
+		}
+
+		for (k=0; k < 2; k++) {
+			for (c=0; c < ch; c++) {
+				fill16(out[k][c], MAXLEN + 2*GUARD);
+			}
+		}
+		memcpy_frominterleave32(dst[0], inter32[1] + GUARD, ch, len, shift);
+		memcpy_frominterleave32_ref(dst[1], inter32[1] + GUARD, ch, len, shift);
+		if (memcmp(out[0], out[1], ch * sizeof(out[0][0])) != 0) {
+			fail("memcpy_frominterleave32", ch, len, shift, offset);
+		}
+		// with shift 0 the 32 bit slots only keep the low 16 bits,
+		// otherwise the round trip must give back the original data
+		for (c=0; shift > 0 && c < ch; c++) {
+			if (memcmp(dst[1][c], src[c], len * sizeof(int16_t)) != 0) {
+				fail("memcpy_frominterleave32_ref", ch, len, shift, offset);
+				break;
+			}
+		}
+	}
+}
+
+static double seconds(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+// nanoseconds per 128 sample block, fast kernel and reference loop
+#define TIME(result, code) do { \
+	double t = seconds(); \
+	for (n=0; n < count; n++) code; \
+	result = (seconds() - t) * 1e9 / count; \
+} while (0)
+
+static void benchmark(unsigned int ch)
+{
+	const int16_t *src[MAXCH];
+	int16_t *dst[MAXCH];
+	const unsigned int len = 128, count = 200000;
+	double ns[8];
+	unsigned int c, n;
+
+	for (c=0; c < ch; c++) {
+		src[c] = chan16[0][c];
+		dst[c] = chan16[1][c];
+	}
+	TIME(ns[0], memcpy_tointerleave16(inter16[0], src, ch, len));
+	TIME(ns[1], memcpy_tointerleave16_ref(inter16[0], src, ch, len));
+	TIME(ns[2], memcpy_frominterleave16(dst, inter16[0], ch, len));
+	TIME(ns[3], memcpy_frominterleave16_ref(dst, inter16[0], ch, len));
+	TIME(ns[4], memcpy_tointerleave32(inter32[0], src, ch, len, 16));
+	TIME(ns[5], memcpy_tointerleave32_ref(inter32[0], src, ch, len, 16));
+	TIME(ns[6], memcpy_frominterleave32(dst, inter32[0], ch, len, 16));
+	TIME(ns[7], memcpy_frominterleave32_ref(dst, inter32[0], ch, len, 16));
+	printf("%2u channels, 16 bit:  to %7.1f ns (ref %7.1f)  from %7.1f ns (ref %7.1f)\n",
+		ch, ns[0], ns[1], ns[2], ns[3]);
+	printf("%2u channels, 32 bit:  to %7.1f ns (ref %7.1f)  from %7.1f ns (ref %7.1f)\n",
+		ch, ns[4], ns[5], ns[6], ns[7]);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned int lens[] = {0, 1, 2, 3, 4, 15, 16, 17, 64, 127, 128, 256};
+	static const unsigned int shifts[] = {0, 8, 16};
+	static const unsigned int fast[] = {2, 4, 6, 8, 16};
+	unsigned int ch, l, s, offset, tests=0;
+
+	for (ch=1; ch <= MAXCH; ch++) {
+		for (l=0; l < sizeof(lens)/sizeof(lens[0]); l++) {
+			for (s=0; s < sizeof(shifts)/sizeof(shifts[0]); s++) {
+				for (offset=0; offset < 2; offset++) {
+					test(ch, lens[l], shifts[s], offset);
+					tests++;
+				}
+			}
+		}
+	}
+	printf("interleave: %u tests, %u errors\n", tests, errors);
+	if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+		for (s=0; s < sizeof(fast)/sizeof(fast[0]); s++) {
+			benchmark(fast[s]);
+		}
+	}
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,135 @@
+// Host test for AudioAnalyzeLoudness, with the EBU Tech 3341 signals
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// usage:  loudness
+//
+// The stereo 1 kHz sine test signals of EBU Tech 3341 are played into
+// AudioAnalyzeLoudness.  Momentary and short-term loudness of a steady
+// tone, and the integrated loudness of each gated sequence, must be
+// within 0.1 LU of the expected value.
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include "Arduino.h"
+#include "AudioStream.h"
+#include "analyze_loudness.h"
+
+#define TOLERANCE 0.1f
+
+static unsigned int errors;
+
+static void fail(const char *format, ...)
+{
+	va_list args;
+
+	if (errors++ < 20) {
+		va_start(args, format);
+		printf("FAIL ");
+		vprintf(format, args);
+		printf("\n");
+		va_end(args);
+	}
+}
+
+// A 1 kHz sine, with its peak at a level in dBFS
+class SineInput : public AudioStream
+{
+public:
+	SineInput() : AudioStream(0, NULL) { }
+	void level(float dBFS) {
+		amplitude = 32768.0 * pow(10.0, dBFS / 20.0);
+	}
+	virtual void update(void) {
+		audio_block_t *block = allocate();
+		if (!block) return;
+		for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			block->data[i] = lrint(amplitude * sin(phase));
+			phase += 2.0 * M_PI * 1000.0 / AUDIO_SAMPLE_RATE_EXACT;
+			if (phase >= 2.0 * M_PI) phase -= 2.0 * M_PI;
+		}
+		transmit(block);
+		release(block);
+	}
+private:
+	double amplitude = 0, phase = 0;
+};
+
+SineInput sine;
+AudioAnalyzeLoudness loudness;
+AudioConnection left(sine, 0, loudness, 0);
+AudioConnection right(sine, 0, loudness, 1);
+
+static void check(const char *name, const char *what, float value, float expect)
+{
+	if (!(fabsf(value - expect) <= TOLERANCE)) {
+		fail("%s: %s %.2f LUFS, %.1f expected", name, what, value, expect);
+	}
+}
+
+// one part of a test signal, a level in dBFS for a number of seconds
+struct segment {
+	float dBFS;
+	float seconds;
+};
+
+// Play the segments, then check integrated loudness.  Momentary and
+// short-term are checked while the last segment has been steady for
+// at least 3 seconds, if steady is true.
+static void run(const char *name, const segment *seg, int count, float expect,
+	bool steady)
+{
+	unsigned int measured = 0;
+
+	loudness.reset();
+	for (int n=0; n < count; n++) {
+		sine.level(seg[n].dBFS);
+		double samples = seg[n].seconds * AUDIO_SAMPLE_RATE_EXACT;
+		for (double i=0; i < samples; i += AUDIO_BLOCK_SAMPLES) {
+			AudioStream::update_all();
+			if (!loudness.available()) continue;
+			if (!steady || n < count - 1 || i < 3.0 * AUDIO_SAMPLE_RATE_EXACT) continue;
+			check(name, "momentary", loudness.readMomentary(), seg[n].dBFS);
+			check(name, "short-term", loudness.readShortTerm(), seg[n].dBFS);
+			measured++;
+		}
+	}
+	if (steady && measured == 0) fail("%s: no momentary measurements", name);
+	check(name, "integrated", loudness.readIntegrated(), expect);
+}
+
+int main(void)
+{
+	static const segment test1[] = {{-23, 20}};
+	static const segment test2[] = {{-33, 20}};
+	static const segment test3[] = {{-36, 10}, {-23, 60}, {-36, 10}};
+	static const segment test4[] = {{-72, 10}, {-36, 10}, {-23, 60}, {-36, 10}, {-72, 10}};
+	static const segment test5[] = {{-26, 20}, {-20, 20.1}, {-26, 20}};
+
+	AudioMemory(10);
+	run("Tech 3341 #1", test1, 1, -23.0f, true);
+	run("Tech 3341 #2", test2, 1, -33.0f, true);
+	run("Tech 3341 #3", test3, 3, -23.0f, false);
+	run("Tech 3341 #4", test4, 5, -23.0f, false);
+	run("Tech 3341 #5", test5, 3, -23.0f, false);
+	printf("loudness: EBU Tech 3341 tests 1 to 5, %u errors\n", errors);
+	return errors ? 1 : 0;
+}
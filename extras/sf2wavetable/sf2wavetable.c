@@ -0,0 +1,920 @@
+// Convert SoundFont 2 presets into AudioSynthWavetable instrument data
+// Copyright 2021, Paul Stoffregen (paul@pjrc.com)
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+// compile with:  gcc -O2 -Wall -o sf2wavetable sf2wavetable.c -lm
+//
+// usage:  sf2wavetable [options] file.sf2
+//
+//   -l         list the presets in the file and exit
+//   -p preset  convert only this preset, as "program" or "bank:program",
+//              may be given more than once.  Default is every preset.
+//   -v vel     velocity used to pick one zone where layers overlap (100)
+//   -q dB      halve the sample rate of samples whose content above the
+//              new Nyquist frequency is at least this many dB below the
+//              signal (eg, 60), repeating while the budget allows
+//   -m rate    never downsample below this rate (default 11025)
+//   -o name    write name.h & name.cpp, default is the SoundFont's name
+//
+// All presets are written into one pair of files, so sample data used by
+// several presets, or by several zones of one preset, is stored once.
+// Samples with identical audio are also merged, even when the SoundFont
+// has separate headers for them.  A report of the flash used by each
+// instrument is printed when done.
+//
+// The sample data is trimmed to what AudioSynthWavetable can read.  Looped
+// samples keep only the audio up to their loop end, since playback never
+// leaves the loop.  One-shot samples get 128 zeros after their end, so
+// the last block played past MAX_PHASE reads silence.
+//
+// SoundFont 2.01 specification:
+// http://www.synthfont.com/sfspec24.pdf
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+
+// SoundFont generators used by AudioSynthWavetable
+#define GEN_START		0
+#define GEN_END			1
+#define GEN_STARTLOOP		2
+#define GEN_ENDLOOP		3
+#define GEN_START_COARSE	4
+#define GEN_MODLFO_PITCH	5
+#define GEN_VIBLFO_PITCH	6
+#define GEN_END_COARSE		12
+#define GEN_MODLFO_VOLUME	13
+#define GEN_MODLFO_DELAY	21
+#define GEN_MODLFO_FREQ		22
+#define GEN_VIBLFO_DELAY	23
+#define GEN_VIBLFO_FREQ		24
+#define GEN_VOLENV_DELAY	33
+#define GEN_VOLENV_ATTACK	34
+#define GEN_VOLENV_HOLD		35
+#define GEN_VOLENV_DECAY	36
+#define GEN_VOLENV_SUSTAIN	37
+#define GEN_VOLENV_RELEASE	38
+#define GEN_INSTRUMENT		41
+#define GEN_KEYRANGE		43
+#define GEN_VELRANGE		44
+#define GEN_STARTLOOP_COARSE	45
+#define GEN_ATTENUATION		48
+#define GEN_ENDLOOP_COARSE	50
+#define GEN_COARSE_TUNE		51
+#define GEN_FINE_TUNE		52
+#define GEN_SAMPLEID		53
+#define GEN_SAMPLE_MODES	54
+#define GEN_ROOTKEY		58
+#define GEN_COUNT		61
+
+#define ONESHOT_PADDING		128	// zeros after a sample which does not loop
+#define SAMPLE_DATA_SIZE	96	// sizeof(AudioSynthWavetable::sample_data) on ARM
+
+struct shdr {			// sample header
+	char name[21];
+	uint32_t start, end, startloop, endloop, rate;
+	uint8_t pitch;
+	int8_t correction;
+	uint16_t type;
+};
+
+struct zone {			// one region of a preset, after merging all levels
+	int gen[GEN_COUNT];
+	int keylo, keyhi, vello, velhi;
+};
+
+struct audio {			// sample data emitted, shared by every zone using it
+	int16_t *data;
+	uint32_t count;		// samples written, including padding
+	uint32_t length;	// samples played before MAX_PHASE
+	uint32_t loopstart, loopend;
+	uint32_t rate;
+	uint32_t hash;
+	int users;		// instruments referencing this audio
+	int last;		// last instrument to use it
+	char name[160];
+};
+
+struct region {			// one sample_data entry
+	struct zone z;
+	int audio;
+	int keyhi;
+};
+
+struct instrument {
+	char name[64];
+	int bank, program;
+	struct region *region;
+	int count;
+};
+
+// the parsed SoundFont
+const uint8_t *smpl;
+uint32_t smpl_count;
+const uint8_t *phdr, *pbag, *pgen, *inst, *ibag, *igen;
+uint32_t phdr_count, pbag_count, pgen_count, inst_count, ibag_count, igen_count;
+struct shdr *shdr;
+uint32_t shdr_count;
+
+struct audio *audio;
+int audio_count, audio_alloc;
+struct instrument *instrument;
+int instrument_count;
+
+double quality_db=0;		// -q
+int use_quality=0;
+uint32_t min_rate=11025;	// -m
+int velocity=100;		// -v
+uint32_t dedup_saved=0, trim_saved=0, downsample_saved=0;
+
+void parse_sf2(const uint8_t *p, uint32_t size);
+void convert_preset(int index);
+void write_files(const char *name);
+void report(void);
+void print_words(FILE *out, const int16_t *data, uint32_t count);
+void make_name(const char *in, char *out, size_t size);
+void * load_file(const char *filename, uint32_t *size);
+void die(const char *format, ...) __attribute__ ((format (printf, 1, 2), noreturn));
+
+static uint32_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t get32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// SoundFont files are a RIFF "sfbk" form with three lists: INFO (ignored),
+// sdta holding all 16 bit audio in one chunk, and pdta holding nine tables
+// of fixed size records, each ending with a terminal record.
+void find_chunks(const uint8_t *p, uint32_t size)
+{
+	const uint8_t *end = p + size;
+	while (p + 8 <= end) {
+		uint32_t len = get32(p + 4);
+		const uint8_t *data = p + 8;
+		if (len > (uint32_t)(end - data)) die("chunk \"%.4s\" is truncated", p);
+		if (memcmp(p, "LIST", 4) == 0 && len >= 4) {
+			find_chunks(data + 4, len - 4);
+		} else if (memcmp(p, "smpl", 4) == 0) {
+			smpl = data; smpl_count = len / 2;
+		} else if (memcmp(p, "phdr", 4) == 0) {
+			phdr = data; phdr_count = len / 38;
+		} else if (memcmp(p, "pbag", 4) == 0) {
+			pbag = data; pbag_count = len / 4;
+		} else if (memcmp(p, "pgen", 4) == 0) {
+			pgen = data; pgen_count = len / 4;
+		} else if (memcmp(p, "inst", 4) == 0) {
+			inst = data; inst_count = len / 22;
+		} else if (memcmp(p, "ibag", 4) == 0) {
+			ibag = data; ibag_count = len / 4;
+		} else if (memcmp(p, "igen", 4) == 0) {
+			igen = data; igen_count = len / 4;
+		} else if (memcmp(p, "shdr", 4) == 0) {
+			const uint8_t *h = data;
+			shdr_count = len / 46;
+			shdr = calloc(shdr_count, sizeof(struct shdr));
+			if (!shdr) die("out of memory");
+			for (uint32_t i=0; i < shdr_count; i++, h += 46) {
+				memcpy(shdr[i].name, h, 20);
+				shdr[i].start = get32(h + 20);
+				shdr[i].end = get32(h + 24);
+				shdr[i].startloop = get32(h + 28);
+				shdr[i].endloop = get32(h + 32);
+				shdr[i].rate = get32(h + 36);
+				shdr[i].pitch = h[40];
+				shdr[i].correction = (int8_t)h[41];
+				shdr[i].type = get16(h + 44);
+			}
+		}
+		p = data + len + (len & 1);
+	}
+}
+
+void parse_sf2(const uint8_t *p, uint32_t size)
+{
+	if (size < 12 || memcmp(p, "RIFF", 4) || memcmp(p + 8, "sfbk", 4)) {
+		die("not a SoundFont 2 file");
+	}
+	uint32_t len = get32(p + 4);
+	if (len > size - 8) len = size - 8;
+	find_chunks(p + 12, len - 4);
+	if (!smpl) die("no sample data (smpl chunk)");
+	if (!phdr || !pbag || !pgen || !inst || !ibag || !igen || !shdr) {
+		die("incomplete preset data (pdta list)");
+	}
+	if (phdr_count < 2 || inst_count < 2 || shdr_count < 2) die("no presets");
+	for (uint32_t i=0; i < phdr_count; i++) {
+		if (get16(phdr + i * 38 + 24) > pbag_count) die("corrupt preset headers");
+	}
+	for (uint32_t i=0; i < inst_count; i++) {
+		if (get16(inst + i * 22 + 20) > ibag_count) die("corrupt instrument headers");
+	}
+	for (uint32_t i=0; i < pbag_count; i++) {
+		if (get16(pbag + i * 4) > pgen_count) die("corrupt preset zones");
+	}
+	for (uint32_t i=0; i < ibag_count; i++) {
+		if (get16(ibag + i * 4) > igen_count) die("corrupt instrument zones");
+	}
+	// drop the terminal records
+	phdr_count--;
+	inst_count--;
+	shdr_count--;
+}
+
+static uint32_t bag_gen(const uint8_t *bag, uint32_t n) { return get16(bag + n * 4); }
+
+void zone_defaults(struct zone *z)
+{
+	memset(z, 0, sizeof(*z));
+	z->gen[GEN_MODLFO_DELAY] = -12000;
+	z->gen[GEN_VIBLFO_DELAY] = -12000;
+	z->gen[GEN_VOLENV_DELAY] = -12000;
+	z->gen[GEN_VOLENV_ATTACK] = -12000;
+	z->gen[GEN_VOLENV_HOLD] = -12000;
+	z->gen[GEN_VOLENV_DECAY] = -12000;
+	z->gen[GEN_VOLENV_RELEASE] = -12000;
+	z->gen[GEN_ROOTKEY] = -1;
+	z->gen[GEN_SAMPLEID] = -1;
+	z->gen[GEN_INSTRUMENT] = -1;
+	z->keylo = z->vello = 0;
+	z->keyhi = z->velhi = 127;
+}
+
+// Sample addresses, sample modes and the root key are instrument level
+// only, everything else a preset zone may offset.
+static int preset_gen(uint32_t oper)
+{
+	switch (oper) {
+	case GEN_START: case GEN_END: case GEN_STARTLOOP: case GEN_ENDLOOP:
+	case GEN_START_COARSE: case GEN_END_COARSE: case GEN_STARTLOOP_COARSE:
+	case GEN_ENDLOOP_COARSE: case GEN_SAMPLE_MODES: case GEN_ROOTKEY:
+	case GEN_INSTRUMENT: case GEN_SAMPLEID: case GEN_KEYRANGE: case GEN_VELRANGE:
+		return 0;
+	}
+	return oper < GEN_COUNT;
+}
+
+// Apply one bag's generators.  A local zone's generators replace those of
+// its global zone, at both levels.  Preset zones hold offsets, which are
+// later added to the values of the instrument zones they use, so only the
+// generators a preset may offset are taken from them.
+void apply_gens(struct zone *z, const uint8_t *gens, uint32_t first, uint32_t last, int preset)
+{
+	for (uint32_t i=first; i < last; i++) {
+		const uint8_t *g = gens + i * 4;
+		uint32_t oper = get16(g);
+		int amount = (int16_t)get16(g + 2);
+		if (oper == GEN_KEYRANGE || oper == GEN_VELRANGE) {
+			int lo = g[2], hi = g[3];
+			int *zlo = (oper == GEN_KEYRANGE) ? &z->keylo : &z->vello;
+			int *zhi = (oper == GEN_KEYRANGE) ? &z->keyhi : &z->velhi;
+			*zlo = lo;
+			*zhi = hi;
+		} else if (oper == GEN_INSTRUMENT || oper == GEN_SAMPLEID) {
+			z->gen[oper] = get16(g + 2);
+		} else if (preset ? preset_gen(oper) : oper < GEN_COUNT) {
+			z->gen[oper] = amount;
+		}
+	}
+}
+
+// Does a bag (zone) have any generator besides a key or velocity range?
+// The first zone without an instrument or sample ID is the global zone.
+int is_global(const uint8_t *bag, uint32_t n, const uint8_t *gens, uint32_t gen_count, int link)
+{
+	uint32_t first = bag_gen(bag, n), last = bag_gen(bag, n + 1);
+	if (last > gen_count) last = gen_count;
+	for (uint32_t i=first; i < last; i++) {
+		if (get16(gens + i * 4) == (uint32_t)link) return 0;
+	}
+	return 1;
+}
+
+static double timecents_to_ms(int tc)
+{
+	if (tc <= -12000) return 0.0;
+	if (tc > 8000) tc = 8000;
+	return 1000.0 * pow(2.0, tc / 1200.0);
+}
+
+static double abscents_to_hz(int cents)
+{
+	if (cents < -16000) cents = -16000;
+	if (cents > 4500) cents = 4500;
+	return 8.176 * pow(2.0, cents / 1200.0);
+}
+
+static uint32_t fnv1a(const int16_t *data, uint32_t count)
+{
+	const uint8_t *p = (const uint8_t *)data;
+	uint32_t hash = 2166136261u;
+	for (uint32_t i=0; i < count * 2; i++) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	return hash;
+}
+
+// Windowed sinc lowpass for halving the sample rate, cutoff just below
+// the new Nyquist frequency.  Returns the filtered signal in "out".
+#define HALFBAND_TAPS 31
+void lowpass(const double *in, double *out, uint32_t count)
+{
+	static double h[HALFBAND_TAPS * 2 + 1];
+	static int init=0;
+	if (!init) {
+		double sum = 0;
+		for (int i = -HALFBAND_TAPS; i <= HALFBAND_TAPS; i++) {
+			double x = i * 0.45;
+			double s = (i == 0) ? 0.45 : sin(M_PI * x) / (M_PI * i);
+			double w = 0.42 + 0.5 * cos(M_PI * i / (HALFBAND_TAPS + 1))
+				+ 0.08 * cos(2.0 * M_PI * i / (HALFBAND_TAPS + 1));
+			h[i + HALFBAND_TAPS] = s * w;
+			sum += s * w;
+		}
+		for (int i=0; i < HALFBAND_TAPS * 2 + 1; i++) h[i] /= sum;
+		init = 1;
+	}
+	for (uint32_t n=0; n < count; n++) {
+		double sum = 0;
+		for (int i = -HALFBAND_TAPS; i <= HALFBAND_TAPS; i++) {
+			int64_t k = (int64_t)n + i;
+			if (k >= 0 && k < count) sum += in[k] * h[i + HALFBAND_TAPS];
+		}
+		out[n] = sum;
+	}
+}
+
+// Halve the rate while the audio removed by the lowpass filter stays below
+// the quality budget.  Loop points must land on whole samples, or the loop
+// length (and so the pitch of sustained notes) would change.
+uint32_t downsample(double *buf, uint32_t *length, uint32_t *loopstart,
+	uint32_t *loopend, uint32_t rate, int loop)
+{
+	double *filtered = malloc(*length * sizeof(double));
+	if (!filtered) die("out of memory");
+	while (rate / 2 >= min_rate && *length > 2) {
+		if (loop && ((*loopstart & 1) || (*loopend & 1))) break;
+		lowpass(buf, filtered, *length);
+		double signal = 0, error = 0;
+		for (uint32_t i=0; i < *length; i++) {
+			double e = buf[i] - filtered[i];
+			signal += buf[i] * buf[i];
+			error += e * e;
+		}
+		if (signal <= 0) break;
+		if (error > 0 && 10.0 * log10(signal / error) < quality_db) break;
+		*length = (*length + 1) / 2;
+		for (uint32_t i=0; i < *length; i++) buf[i] = filtered[i * 2];
+		*loopstart /= 2;
+		*loopend /= 2;
+		rate /= 2;
+	}
+	free(filtered);
+	return rate;
+}
+
+// Extract the audio a zone plays, process it, and return its index in the
+// shared audio list, merging it with identical audio already converted.
+int add_audio(const struct zone *z, int inst)
+{
+	const struct shdr *h = shdr + z->gen[GEN_SAMPLEID];
+	int64_t start = (int64_t)h->start + z->gen[GEN_START] + 32768 * z->gen[GEN_START_COARSE];
+	int64_t end = (int64_t)h->end + z->gen[GEN_END] + 32768 * z->gen[GEN_END_COARSE];
+	int64_t ls = (int64_t)h->startloop + z->gen[GEN_STARTLOOP] + 32768 * z->gen[GEN_STARTLOOP_COARSE];
+	int64_t le = (int64_t)h->endloop + z->gen[GEN_ENDLOOP] + 32768 * z->gen[GEN_ENDLOOP_COARSE];
+	int loop = (z->gen[GEN_SAMPLE_MODES] & 1) != 0;
+
+	if (start < 0) start = 0;
+	if (end > smpl_count) end = smpl_count;
+	if (end <= start) die("sample \"%s\" has no audio", h->name);
+	if (ls < start) ls = start;
+	if (le > end) le = end;
+	if (loop && le - ls < 2) loop = 0;
+	uint32_t length = end - start;
+	uint32_t loopstart = ls - start, loopend = le - start;
+
+	// a looped sample is never read past its loop end
+	uint32_t trimmed = 0, downsampled = 0;
+	if (loop && loopend + 1 < length) {
+		trimmed = (length - loopend - 1) * 2;
+		length = loopend + 1;
+	}
+	double *buf = malloc((length + 1) * sizeof(double));
+	if (!buf) die("out of memory");
+	for (uint32_t i=0; i < length; i++) {
+		buf[i] = (int16_t)get16(smpl + (start + i) * 2);
+	}
+	uint32_t rate = h->rate;
+	if (use_quality) {
+		uint32_t before = length;
+		rate = downsample(buf, &length, &loopstart, &loopend, rate, loop);
+		downsampled = (before - length) * 2;
+	}
+
+	uint32_t count = length + (loop ? 0 : ONESHOT_PADDING);
+	int16_t *data = calloc(count + 1, sizeof(int16_t));	// +1 to fill the last word
+	if (!data) die("out of memory");
+	for (uint32_t i=0; i < length; i++) {
+		double d = floor(buf[i] + 0.5);
+		if (d > 32767.0) d = 32767.0;
+		if (d < -32768.0) d = -32768.0;
+		data[i] = (int16_t)d;
+	}
+	free(buf);
+	if (!loop) {
+		loopstart = 0;
+		loopend = length;
+	}
+
+	uint32_t hash = fnv1a(data, count);
+	for (int i=0; i < audio_count; i++) {
+		struct audio *a = audio + i;
+		if (a->hash == hash && a->count == count && a->length == length
+		  && a->rate == rate && a->loopstart == loopstart && a->loopend == loopend
+		  && memcmp(a->data, data, count * 2) == 0) {
+			free(data);
+			dedup_saved += ((count + 1) / 2) * 4;
+			if (a->last != inst) {
+				a->users++;
+				a->last = inst;
+			}
+			return i;
+		}
+	}
+	if (audio_count >= audio_alloc) {
+		audio_alloc = audio_alloc ? audio_alloc * 2 : 64;
+		audio = realloc(audio, audio_alloc * sizeof(struct audio));
+		if (!audio) die("out of memory");
+	}
+	trim_saved += trimmed;
+	downsample_saved += downsampled;
+	struct audio *a = audio + audio_count;
+	a->data = data;
+	a->count = count;
+	a->length = length;
+	a->loopstart = loopstart;
+	a->loopend = loopend;
+	a->rate = rate;
+	a->hash = hash;
+	a->users = 1;
+	a->last = inst;
+	char sname[64];
+	make_name(h->name, sname, sizeof(sname));
+	snprintf(a->name, sizeof(a->name), "sample_%d_%s_%s", audio_count,
+		instrument[inst].name, sname);
+	return audio_count++;
+}
+
+static int zone_covers(const struct zone *z, int key)
+{
+	return key >= z->keylo && key <= z->keyhi
+		&& velocity >= z->vello && velocity <= z->velhi;
+}
+
+// Flatten one preset into a list of zones with non-overlapping key ranges,
+// as AudioSynthWavetable selects its sample only by note number.
+void convert_preset(int index)
+{
+	const uint8_t *p = phdr + index * 38;
+	struct instrument *in = instrument + instrument_count;
+	struct zone *zones = NULL;
+	int zone_count = 0;
+
+	char pname[21];
+	memcpy(pname, p, 20);
+	pname[20] = 0;
+	make_name(pname, in->name, sizeof(in->name));
+	for (int i=0; i < instrument_count; i++) {
+		if (strcmp(instrument[i].name, in->name) == 0) {
+			size_t n = strlen(in->name);
+			snprintf(in->name + n, sizeof(in->name) - n, "_%d", instrument_count);
+			break;
+		}
+	}
+	in->program = get16(p + 20);
+	in->bank = get16(p + 22);
+
+	uint32_t pfirst = get16(p + 24), plast = get16(p + 38 + 24);
+	struct zone pglobal;
+	zone_defaults(&pglobal);
+	memset(pglobal.gen, 0, sizeof(pglobal.gen));
+	for (uint32_t pb=pfirst; pb < plast && pb + 1 < pbag_count; pb++) {
+		if (is_global(pbag, pb, pgen, pgen_count, GEN_INSTRUMENT)) {
+			if (pb == pfirst) {
+				apply_gens(&pglobal, pgen, bag_gen(pbag, pb), bag_gen(pbag, pb + 1), 1);
+			}
+			continue;
+		}
+		struct zone pz = pglobal;
+		apply_gens(&pz, pgen, bag_gen(pbag, pb), bag_gen(pbag, pb + 1), 1);
+		int ii = pz.gen[GEN_INSTRUMENT];
+		if (ii < 0 || (uint32_t)ii >= inst_count) continue;
+		const uint8_t *ih = inst + ii * 22;
+		uint32_t ifirst = get16(ih + 20), ilast = get16(ih + 22 + 20);
+
+		struct zone iglobal;
+		zone_defaults(&iglobal);
+		for (uint32_t ib=ifirst; ib < ilast && ib + 1 < ibag_count; ib++) {
+			if (is_global(ibag, ib, igen, igen_count, GEN_SAMPLEID)) {
+				if (ib == ifirst) {
+					apply_gens(&iglobal, igen, bag_gen(ibag, ib), bag_gen(ibag, ib + 1), 0);
+				}
+				continue;
+			}
+			struct zone z = iglobal;
+			apply_gens(&z, igen, bag_gen(ibag, ib), bag_gen(ibag, ib + 1), 0);
+			if (z.gen[GEN_SAMPLEID] < 0 || (uint32_t)z.gen[GEN_SAMPLEID] >= shdr_count) continue;
+			// ROM samples are not in the file, right channels duplicate the left
+			const struct shdr *h = shdr + z.gen[GEN_SAMPLEID];
+			if (h->type & 0x8000) continue;
+			if ((h->type & 0x7FFF) == 2) continue;
+			// add the preset's offsets and narrow its ranges
+			for (int g=0; g < GEN_COUNT; g++) {
+				if (preset_gen(g)) z.gen[g] += pz.gen[g];
+			}
+			if (pz.keylo > z.keylo) z.keylo = pz.keylo;
+			if (pz.keyhi < z.keyhi) z.keyhi = pz.keyhi;
+			if (pz.vello > z.vello) z.vello = pz.vello;
+			if (pz.velhi < z.velhi) z.velhi = pz.velhi;
+			if (z.keylo > z.keyhi || z.vello > z.velhi) continue;
+			zones = realloc(zones, (zone_count + 1) * sizeof(struct zone));
+			if (!zones) die("out of memory");
+			zones[zone_count++] = z;
+		}
+	}
+	if (zone_count == 0) {
+		fprintf(stderr, "skipping preset \"%s\", it has no usable zones\n", pname);
+		free(zones);
+		return;
+	}
+
+	// For each key, use the first zone covering it at the chosen velocity.
+	// Keys no zone covers use the nearest zone above, or below at the top.
+	int owner[128];
+	for (int key=0; key < 128; key++) {
+		owner[key] = -1;
+		for (int i=0; i < zone_count; i++) {
+			if (zone_covers(zones + i, key)) {
+				owner[key] = i;
+				break;
+			}
+		}
+		if (owner[key] < 0) {	// no zone at this velocity, ignore velocity
+			for (int i=0; i < zone_count; i++) {
+				if (key >= zones[i].keylo && key <= zones[i].keyhi) {
+					owner[key] = i;
+					break;
+				}
+			}
+		}
+	}
+	for (int key=126; key >= 0; key--) {
+		if (owner[key] < 0) owner[key] = owner[key + 1];
+	}
+	for (int key=1; key < 128; key++) {
+		if (owner[key] < 0) owner[key] = owner[key - 1];
+	}
+	if (owner[0] < 0) {
+		for (int key=0; key < 128; key++) owner[key] = 0;
+	}
+
+	in->region = NULL;
+	in->count = 0;
+	instrument_count++;	// add_audio() uses this instrument's name
+	for (int key=0; key < 128; key++) {
+		if (key < 127 && owner[key + 1] == owner[key]) continue;
+		if (in->count >= 255) die("preset \"%s\" needs more than 255 samples", pname);
+		in->region = realloc(in->region, (in->count + 1) * sizeof(struct region));
+		if (!in->region) die("out of memory");
+		struct region *r = in->region + in->count;
+		r->z = zones[owner[key]];
+		r->keyhi = key;
+		r->audio = add_audio(&r->z, instrument_count - 1);
+		in->count++;
+	}
+	free(zones);
+}
+
+void print_region(FILE *out, const struct region *r)
+{
+	const struct zone *z = &r->z;
+	const struct shdr *h = shdr + z->gen[GEN_SAMPLEID];
+	const struct audio *a = audio + r->audio;
+	int loop = a->count == a->length;
+	int bits = 1;
+	while ((1u << bits) < a->length) bits++;
+	int root = z->gen[GEN_ROOTKEY] >= 0 ? z->gen[GEN_ROOTKEY] : h->pitch;
+	if (root > 127) root = 60;
+	int cents = z->gen[GEN_COARSE_TUNE] * 100 + z->gen[GEN_FINE_TUNE] + h->correction;
+	double attenuation = z->gen[GEN_ATTENUATION] / 10.0;
+	if (attenuation < 0) attenuation = 0;
+	if (attenuation > 144) attenuation = 144;
+	double sustain = z->gen[GEN_VOLENV_SUSTAIN] / 10.0;
+	if (sustain < 0) sustain = 0;
+	if (sustain > 100) sustain = 100;
+	int vib_pitch = z->gen[GEN_VIBLFO_PITCH];
+	int mod_pitch = z->gen[GEN_MODLFO_PITCH];
+	double mod_volume = z->gen[GEN_MODLFO_VOLUME] / 10.0;
+
+	fprintf(out, "\t{\n");
+	fprintf(out, "\t\t(int16_t*)%s, // sample\n", a->name);
+	fprintf(out, "\t\t%s, // LOOP\n", loop ? "true" : "false");
+	fprintf(out, "\t\t%d, // LENGTH_BITS\n", bits);
+	fprintf(out, "\t\t(1 << (32 - %d)) * WAVETABLE_CENTS_SHIFT(%d) * %u.0 / "
+		"WAVETABLE_NOTE_TO_FREQUENCY(%d) / AUDIO_SAMPLE_RATE_EXACT + 0.5, "
+		"// PER_HERTZ_PHASE_INCREMENT\n", bits, cents, a->rate, root);
+	fprintf(out, "\t\t((uint32_t)%u - 1) << (32 - %d), // MAX_PHASE\n", a->length, bits);
+	fprintf(out, "\t\t((uint32_t)%u - 1) << (32 - %d), // LOOP_PHASE_END\n",
+		a->loopend + 1, bits);
+	fprintf(out, "\t\t(((uint32_t)%u - 1) << (32 - %d)) - (((uint32_t)%u - 1) << (32 - %d)), "
+		"// LOOP_PHASE_LENGTH\n", a->loopend + 1, bits, a->loopstart + 1, bits);
+	fprintf(out, "\t\tuint16_t(UINT16_MAX * WAVETABLE_DECIBEL_SHIFT(%.1f)), "
+		"// INITIAL_ATTENUATION_SCALAR\n", -attenuation);
+	static const struct { int gen; const char *name; } env[] = {
+		{GEN_VOLENV_DELAY, "DELAY_COUNT"}, {GEN_VOLENV_ATTACK, "ATTACK_COUNT"},
+		{GEN_VOLENV_HOLD, "HOLD_COUNT"}, {GEN_VOLENV_DECAY, "DECAY_COUNT"},
+		{GEN_VOLENV_RELEASE, "RELEASE_COUNT"}
+	};
+	for (int i=0; i < 5; i++) {
+		fprintf(out, "\t\tuint32_t(%.2f * AudioSynthWavetable::SAMPLES_PER_MSEC / "
+			"AudioSynthWavetable::ENVELOPE_PERIOD + 0.5), // %s\n",
+			timecents_to_ms(z->gen[env[i].gen]), env[i].name);
+	}
+	fprintf(out, "\t\tint32_t((1.0 - WAVETABLE_DECIBEL_SHIFT(%.1f)) * "
+		"AudioSynthWavetable::UNITY_GAIN), // SUSTAIN_MULT\n", -sustain);
+	fprintf(out, "\t\tuint32_t(%.2f * AudioSynthWavetable::SAMPLES_PER_MSEC / "
+		"(2 * AudioSynthWavetable::LFO_PERIOD)), // VIBRATO_DELAY\n",
+		timecents_to_ms(z->gen[GEN_VIBLFO_DELAY]));
+	fprintf(out, "\t\tuint32_t(%.1f * AudioSynthWavetable::LFO_PERIOD * "
+		"(UINT32_MAX / AUDIO_SAMPLE_RATE_EXACT)), // VIBRATO_INCREMENT\n",
+		abscents_to_hz(z->gen[GEN_VIBLFO_FREQ]));
+	fprintf(out, "\t\t(WAVETABLE_CENTS_SHIFT(%d) - 1.0) * 4, "
+		"// VIBRATO_PITCH_COEFFICIENT_INITIAL\n", vib_pitch);
+	fprintf(out, "\t\t(1.0 - WAVETABLE_CENTS_SHIFT(%d)) * 4, "
+		"// VIBRATO_COEFFICIENT_SECONDARY\n", -vib_pitch);
+	fprintf(out, "\t\tuint32_t(%.2f * AudioSynthWavetable::SAMPLES_PER_MSEC / "
+		"(2 * AudioSynthWavetable::LFO_PERIOD)), // MODULATION_DELAY\n",
+		timecents_to_ms(z->gen[GEN_MODLFO_DELAY]));
+	fprintf(out, "\t\tuint32_t(%.1f * AudioSynthWavetable::LFO_PERIOD * "
+		"(UINT32_MAX / AUDIO_SAMPLE_RATE_EXACT)), // MODULATION_INCREMENT\n",
+		abscents_to_hz(z->gen[GEN_MODLFO_FREQ]));
+	fprintf(out, "\t\t(WAVETABLE_CENTS_SHIFT(%d) - 1.0) * 4, "
+		"// MODULATION_PITCH_COEFFICIENT_INITIAL\n", mod_pitch);
+	fprintf(out, "\t\t(1.0 - WAVETABLE_CENTS_SHIFT(%d)) * 4, "
+		"// MODULATION_PITCH_COEFFICIENT_SECOND\n", -mod_pitch);
+	fprintf(out, "\t\tint32_t(UINT16_MAX * (WAVETABLE_DECIBEL_SHIFT(%.1f) - 1.0)) * 4, "
+		"// MODULATION_AMPLITUDE_INITIAL_GAIN\n", -mod_volume);
+	fprintf(out, "\t\tint32_t(UINT16_MAX * (1.0 - WAVETABLE_DECIBEL_SHIFT(%.1f))) * 4, "
+		"// MODULATION_AMPLITUDE_FINAL_GAIN\n", mod_volume);
+	fprintf(out, "\t},\n");
+}
+
+void write_files(const char *name)
+{
+	char filename[4096];
+	FILE *out;
+
+	snprintf(filename, sizeof(filename), "%s.h", name);
+	out = fopen(filename, "w");
+	if (!out) die("unable to write %s", filename);
+	fprintf(out, "// Audio data converted from SoundFont file, using sf2wavetable\n\n");
+	fprintf(out, "#pragma once\n#include <Audio.h>\n\n");
+	for (int i=0; i < instrument_count; i++) {
+		const struct instrument *in = instrument + i;
+		fprintf(out, "// bank %d, program %d\n", in->bank, in->program);
+		fprintf(out, "extern const AudioSynthWavetable::sample_data %s_samples[%d];\n",
+			in->name, in->count);
+		fprintf(out, "const uint8_t %s_ranges[] = {", in->name);
+		for (int r=0; r < in->count; r++) fprintf(out, "%d, ", in->region[r].keyhi);
+		fprintf(out, "};\n\n");
+		fprintf(out, "const AudioSynthWavetable::instrument_data %s = {%d, %s_ranges, %s_samples };\n\n",
+			in->name, in->count, in->name, in->name);
+	}
+	fprintf(out, "\n");
+	for (int i=0; i < audio_count; i++) {
+		fprintf(out, "extern const uint32_t %s[%u];\n\n", audio[i].name,
+			(audio[i].count + 1) / 2);
+	}
+	fclose(out);
+
+	snprintf(filename, sizeof(filename), "%s.cpp", name);
+	out = fopen(filename, "w");
+	if (!out) die("unable to write %s", filename);
+	const char *base = strrchr(name, '/');
+	fprintf(out, "#include \"%s.h\"\n", base ? base + 1 : name);
+	for (int i=0; i < instrument_count; i++) {
+		const struct instrument *in = instrument + i;
+		fprintf(out, "const AudioSynthWavetable::sample_data %s_samples[%d] = {\n",
+			in->name, in->count);
+		for (int r=0; r < in->count; r++) print_region(out, in->region + r);
+		fprintf(out, "};\n\n");
+	}
+	for (int i=0; i < audio_count; i++) {
+		const struct audio *a = audio + i;
+		fprintf(out, "const uint32_t %s[%u] = {\n", a->name, (a->count + 1) / 2);
+		print_words(out, a->data, a->count);
+		fprintf(out, "};\n\n");
+	}
+	fclose(out);
+}
+
+// Flash used by each instrument.  Sample data used by more than one
+// instrument is listed as shared, and counted once in the total.
+void report(void)
+{
+	uint32_t total=0, shared=0;
+
+	fprintf(stderr, "%-24s %7s %9s %9s %9s\n", "instrument", "samples",
+		"structs", "audio", "shared");
+	for (int i=0; i < instrument_count; i++) {
+		const struct instrument *in = instrument + i;
+		uint32_t structs = in->count * SAMPLE_DATA_SIZE + in->count;
+		uint32_t own=0, share=0;
+		char *seen = calloc(audio_count + 1, 1);
+		if (!seen) die("out of memory");
+		for (int r=0; r < in->count; r++) {
+			int n = in->region[r].audio;
+			if (seen[n]) continue;
+			seen[n] = 1;
+			uint32_t bytes = ((audio[n].count + 1) / 2) * 4;
+			if (audio[n].users > 1) share += bytes;
+			else own += bytes;
+		}
+		free(seen);
+		fprintf(stderr, "%-24s %7d %9u %9u %9u\n", in->name, in->count,
+			structs, own, share);
+		total += structs;
+	}
+	for (int i=0; i < audio_count; i++) {
+		uint32_t bytes = ((audio[i].count + 1) / 2) * 4;
+		total += bytes;
+		if (audio[i].users > 1) shared += bytes;
+	}
+	fprintf(stderr, "total flash: %u bytes, %d unique samples", total, audio_count);
+	if (shared) fprintf(stderr, ", %u bytes shared between instruments", shared);
+	fprintf(stderr, "\n");
+	fprintf(stderr, "saved: %u bytes by merging identical samples, "
+		"%u after loop ends", dedup_saved, trim_saved);
+	if (use_quality) fprintf(stderr, ", %u by downsampling", downsample_saved);
+	fprintf(stderr, "\n");
+}
+
+void list_presets(void)
+{
+	for (uint32_t i=0; i < phdr_count; i++) {
+		const uint8_t *p = phdr + i * 38;
+		printf("%3u:%-3u  %.20s\n", get16(p + 22), get16(p + 20), p);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char *outname = NULL, *sf2 = NULL;
+	int list = 0, *select = NULL, select_count = 0;
+	char name[4096];
+
+	for (int i=1; i < argc; i++) {
+		const char *arg = argv[i];
+		if (strcmp(arg, "-l") == 0) {
+			list = 1;
+		} else if (strcmp(arg, "-p") == 0 && i + 1 < argc) {
+			const char *s = argv[++i], *colon = strchr(s, ':');
+			select = realloc(select, (select_count + 1) * sizeof(int));
+			if (!select) die("out of memory");
+			if (colon) {
+				select[select_count++] = (atoi(s) << 8) | atoi(colon + 1);
+			} else {
+				select[select_count++] = atoi(s);
+			}
+		} else if (strcmp(arg, "-v") == 0 && i + 1 < argc) {
+			velocity = atoi(argv[++i]);
+			if (velocity < 1 || velocity > 127) die("velocity must be 1 to 127");
+		} else if (strcmp(arg, "-q") == 0 && i + 1 < argc) {
+			quality_db = atof(argv[++i]);
+			use_quality = 1;
+		} else if (strcmp(arg, "-m") == 0 && i + 1 < argc) {
+			min_rate = atoi(argv[++i]);
+		} else if (strcmp(arg, "-o") == 0 && i + 1 < argc) {
+			outname = argv[++i];
+		} else if (arg[0] == '-') {
+			die("unknown option %s", arg);
+		} else {
+			sf2 = arg;
+		}
+	}
+	if (!sf2) die("usage: sf2wavetable [-l] [-p preset] [-v vel] [-q dB] [-m rate] [-o name] file.sf2");
+
+	uint32_t size;
+	const uint8_t *file = load_file(sf2, &size);
+	parse_sf2(file, size);
+	if (list) {
+		list_presets();
+		return 0;
+	}
+
+	instrument = calloc(phdr_count, sizeof(struct instrument));
+	if (!instrument) die("out of memory");
+	for (uint32_t i=0; i < phdr_count; i++) {
+		const uint8_t *p = phdr + i * 38;
+		int program = get16(p + 20), bank = get16(p + 22);
+		if (select_count) {
+			int found = 0;
+			for (int s=0; s < select_count; s++) {
+				if (select[s] == ((bank << 8) | program)) found = 1;
+			}
+			if (!found) continue;
+		}
+		convert_preset(i);
+	}
+	if (instrument_count == 0) die("no presets converted");
+
+	if (!outname) {
+		const char *base = strrchr(sf2, '/');
+		make_name(base ? base + 1 : sf2, name, sizeof(name));
+		char *dot = strstr(name, "_sf2");
+		if (dot && dot[4] == 0) *dot = 0;
+		outname = name;
+	}
+	write_files(outname);
+	report();
+	return 0;
+}
+
+void print_words(FILE *out, const int16_t *data, uint32_t count)
+{
+	uint32_t words = (count + 1) / 2;
+	for (uint32_t i=0; i < words; i++) {
+		uint32_t lo = (uint16_t)data[i * 2];
+		uint32_t hi = (i * 2 + 1 < count) ? (uint16_t)data[i * 2 + 1] : 0;
+		fprintf(out, "0x%08x,", lo | (hi << 16));
+		if ((i % 8) == 7 || i == words - 1) fprintf(out, "\n");
+	}
+}
+
+// lowercase C identifier from a SoundFont or file name
+void make_name(const char *in, char *out, size_t size)
+{
+	size_t n = 0;
+	while (*in == ' ') in++;
+	if (isdigit((unsigned char)*in) && n + 1 < size) out[n++] = '_';
+	for (; *in && n + 1 < size; in++) {
+		int c = (unsigned char)*in;
+		if (isalnum(c)) {
+			out[n++] = tolower(c);
+		} else if (n > 0 && out[n - 1] != '_') {
+			out[n++] = '_';
+		}
+	}
+	while (n > 0 && out[n - 1] == '_') n--;
+	if (n == 0 && size > 6) {
+		strcpy(out, "preset");
+		return;
+	}
+	out[n] = 0;
+}
+
+void * load_file(const char *filename, uint32_t *size)
+{
+	FILE *fp = fopen(filename, "rb");
+	if (!fp) die("unable to read %s", filename);
+	fseek(fp, 0, SEEK_END);
+	long len = ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+	if (len <= 0) die("%s is empty", filename);
+	uint8_t *data = malloc(len);
+	if (!data) die("out of memory");
+	if (fread(data, 1, len, fp) != (size_t)len) die("error reading %s", filename);
+	fclose(fp);
+	*size = len;
+	return data;
+}
+
+void die(const char *format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	fprintf(stderr, "sf2wavetable: ");
+	vfprintf(stderr, format, args);
+	fprintf(stderr, "\n");
+	exit(1);
+}
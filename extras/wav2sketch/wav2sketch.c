@@ -19,8 +19,21 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 // THE SOFTWARE.
 
-// compile with:  gcc -O2 -Wall -o wav2sketch wav2sketch.c
-//                i686-w64-mingw32-gcc -s -O2 -Wall wav2sketch.c -o wav2sketch.exe
+// compile with:  gcc -O2 -Wall -o wav2sketch wav2sketch.c -lm -lpthread
+//                i686-w64-mingw32-gcc -s -O2 -Wall wav2sketch.c -o wav2sketch.exe -lm -lpthread
+//
+// usage:  wav2sketch [options] [file.wav ...]
+//
+//   -16        use 16 bit PCM, instead of u-law
+//   -e dB      choose the encoding for each sample: u-law when its signal to
+//              error ratio is at least this many dB (eg, 38), otherwise PCM
+//   -r rate    resample every file to 44100, 22050 or 11025 Hz
+//   -t dB      trim leading and trailing silence quieter than dB (eg, -60)
+//   -n dB      normalize each sample's peak to dB (eg, -1)
+//   -b name    pack all samples into one array, written to name.cpp & name.h
+//   -j num     convert num files in parallel, default is one per CPU core
+//
+// Without file names, every .wav file in the current directory is converted.
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -28,150 +41,527 @@
 #include <stdarg.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#include <unistd.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <dirent.h>
 
+struct sample {
+	const char *filename;
+	char name[64];
+	uint32_t inrate;	// sample rate of the WAV file
+	uint32_t rate;		// sample rate of the output
+	float *audio;		// mono, scaled to 16 bit range
+	uint32_t length;
+	int pcm;		// 16 bit PCM, otherwise u-law
+	double snr;		// u-law signal to error ratio, in dB
+	uint32_t *data;		// header word, then encoded audio
+	uint32_t words;
+};
+
 uint8_t ulaw_encode(int16_t audio);
-void print_byte(FILE *out, uint8_t b);
-void filename2samplename(void);
+int16_t ulaw_decode(uint8_t code);
+void print_words(FILE *out, const uint32_t *data, uint32_t count);
+void filename2samplename(const char *filename, char *samplename, size_t size);
 uint32_t padding(uint32_t length, uint32_t block);
-uint8_t read_uint8(FILE *in);
-int16_t read_int16(FILE *in);
-uint32_t read_uint32(FILE *in);
-void die(const char *format, ...) __attribute__ ((format (printf, 1, 2)));
+void * load_file(const char *filename, uint32_t *size);
+void die(const char *format, ...) __attribute__ ((format (printf, 1, 2), noreturn));
 
 // WAV file format:
 // http://www-mmsp.ece.mcgill.ca/Documents/AudioFormats/WAVE/WAVE.html
 
-const char *filename="";
-char samplename[64];
-unsigned int bcount, wcount;
-unsigned int total_length=0;
 int pcm_mode=0;
+double error_budget=0;		// -e
+uint32_t target_rate=0;		// -r
+double trim_db=0;		// -t
+double normalize_db=0;		// -n
+int use_budget=0, use_trim=0, use_normalize=0;
+const char *blobname=NULL;	// -b
+
+struct sample *samples=NULL;
+int nsamples=0;
+int next_sample=0;
+pthread_mutex_t job_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t get16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+static uint32_t get32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
 
-void wav2c(FILE *in, FILE *out, FILE *outh)
+// Read a WAV file, mixing all channels to mono.  PCM of 8, 16, 24 or 32 bits
+// and 32 bit float are accepted, at any sample rate.
+void load_wav(struct sample *s)
 {
-	uint32_t header[4];
-	int16_t format, channels, bits;
-	uint32_t rate;
-	uint32_t i, length, padlength=0, arraylen;
-	uint32_t chunkSize;
-	int32_t audio=0;
-
-	// read the WAV file's header
-	for (i=0; i < 4; i++) {
-		header[i] = read_uint32(in);
-	}
-	while (header[3] != 0x20746D66) {
-		// skip past unknown sections until "fmt "
-		chunkSize = read_uint32(in);
-		for (i=0; i < chunkSize; i++) {
-			read_uint8(in);
+	const char *filename = s->filename;
+	uint8_t *file, *p, *end, *fmt=NULL, *data=NULL;
+	uint32_t size, chunkSize, length=0, fmtsize=0, i, c;
+	uint32_t format, channels, bits, frame;
+
+	file = load_file(filename, &size);
+	if (size < 12) die("file %s is too short to be a WAV file", filename);
+	p = file + 12;
+	end = file + size;
+	while (p + 8 <= end) {
+		chunkSize = get32(p + 4);
+		if (chunkSize > (uint32_t)(end - p - 8)) chunkSize = end - p - 8;
+		if (memcmp(p, "fmt ", 4) == 0) {
+			fmt = p + 8;
+			fmtsize = chunkSize;
+		} else if (memcmp(p, "data", 4) == 0) {
+			data = p + 8;
+			length = chunkSize;
+			break;
 		}
-		header[3] = read_uint32(in);
+		p += 8 + chunkSize + (chunkSize & 1);
 	}
-	chunkSize = read_uint32(in);
-
-	// read the audio format parameters
-	format = read_int16(in);
-	channels = read_int16(in);
-	rate = read_uint32(in);
-	read_uint32(in); // ignore byterate
-	read_int16(in);  // ignore blockalign
-	bits = read_int16(in);
-	//printf("format: %d, channels: %d, rate: %d, bits %d\n", format, channels, rate, bits);
-	if (format != 1)
+	if (!fmt || fmtsize < 16) die("file %s has no format header", filename);
+	if (!data) die("file %s has no audio data", filename);
+	format = get16(fmt);
+	channels = get16(fmt + 2);
+	s->inrate = get32(fmt + 4);
+	bits = get16(fmt + 14);
+	if (format == 0xFFFE && fmtsize >= 26) format = get16(fmt + 24);
+	if (format != 1 && format != 3)
 		die("file %s is compressed, only uncompressed supported", filename);
-	if (rate != 44100 && rate != 22050 && rate != 11025 /*&& rate != 8000*/ )
-		die("sample rate %d in %s is unsupported\n"
-		  "Only 44100, 22050, 11025 work", rate, filename);
-	if (channels != 1 && channels != 2)
-		die("file %s has %d channels, but only 1 & 2 are supported", filename, channels);
-	if (bits != 16)
-		die("file %s has %d bit format, but only 16 is supported", filename, bits);
-
-	// skip past any extra data on the WAVE header (hopefully it doesn't matter?)
-	for (chunkSize -= 16; chunkSize > 0; chunkSize--) {
-		read_uint8(in);
+	if (format == 3 && bits != 32)
+		die("file %s has %d bit floating point, only 32 is supported", filename, bits);
+	if (bits != 8 && bits != 16 && bits != 24 && bits != 32)
+		die("file %s has %d bit format, which is unsupported", filename, bits);
+	if (channels < 1)
+		die("file %s has no audio channels", filename);
+	frame = channels * bits / 8;
+	if (length % frame)
+		die("file %s data length is not a multiple of %d", filename, frame);
+	length /= frame;
+	s->length = length;
+	s->audio = malloc((length ? length : 1) * sizeof(float));
+	if (!s->audio) die("unable to allocate memory");
+	for (i=0; i < length; i++) {
+		const uint8_t *in = data + i * frame;
+		double sum=0;
+		int32_t isum=0;
+		for (c=0; c < channels; c++) {
+			if (format == 3) {
+				union { uint32_t u; float f; } u32;
+				u32.u = get32(in);
+				sum += u32.f * 32768.0;
+			} else if (bits == 8) {
+				sum += ((int)in[0] - 128) * 256;
+			} else if (bits == 16) {
+				isum += (int16_t)get16(in);
+			} else if (bits == 24) {
+				sum += (int32_t)(get32(in - 1) & 0xFFFFFF00) / 65536.0;
+			} else {
+				sum += (int32_t)get32(in) / 65536.0;
+			}
+			in += bits / 8;
+		}
+		if (format == 1 && bits == 16) {
+			// integer average, same as earlier versions
+			s->audio[i] = isum / (int32_t)channels;
+		} else {
+			s->audio[i] = sum / channels;
+		}
 	}
+	free(file);
+}
 
-	// read the data header, skip non-audio data
-	while (1) {
-		header[0] = read_uint32(in);
-		length = read_uint32(in);
-		if (header[0] == 0x61746164) break; // beginning of actual audio data
-		// skip over non-audio data
-		for (i=0; i < length; i++) {
-			read_uint8(in);
+// Remove leading and trailing audio quieter than the threshold.
+void trim(struct sample *s)
+{
+	float threshold = 32768.0 * pow(10.0, trim_db / 20.0);
+	uint32_t first=0, last=s->length;
+
+	while (first < last && fabsf(s->audio[first]) < threshold) first++;
+	while (last > first && fabsf(s->audio[last - 1]) < threshold) last--;
+	memmove(s->audio, s->audio + first, (last - first) * sizeof(float));
+	s->length = last - first;
+}
+
+double bessel_i0(double x)
+{
+	double sum=1.0, term=1.0;
+	int k;
+
+	for (k=1; k < 50; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12) break;
+	}
+	return sum;
+}
+
+#define SRC_ZEROS	32	// sinc zero crossings each side
+#define SRC_PHASES	512	// kernel table steps per input sample
+#define SRC_BETA	9.0	// Kaiser window, about 90 dB stopband
+
+// Band limited resampling, using a Kaiser windowed sinc kernel.  The cutoff
+// is just below the lower of the two Nyquist frequencies.
+void resample(struct sample *s)
+{
+	double ratio = (double)s->rate / (double)s->inrate;
+	double fc = 0.5 * (ratio < 1.0 ? ratio : 1.0) * 0.96;
+	double halfwidth = SRC_ZEROS / (2.0 * fc);
+	uint32_t tablelen = (uint32_t)(halfwidth * SRC_PHASES) + 2;
+	uint32_t outlen = (uint32_t)floor(s->length * ratio);
+	float *table, *out;
+	uint32_t i, n;
+
+	table = malloc(tablelen * sizeof(float));
+	out = malloc((outlen ? outlen : 1) * sizeof(float));
+	if (!table || !out) die("unable to allocate memory");
+	for (i=0; i < tablelen; i++) {
+		double t = (double)i / SRC_PHASES;
+		double x = 2.0 * fc * t;
+		double sinc = (i == 0) ? 1.0 : sin(M_PI * x) / (M_PI * x);
+		double w = t / halfwidth;
+		w = (w < 1.0) ? bessel_i0(SRC_BETA * sqrt(1.0 - w * w)) / bessel_i0(SRC_BETA) : 0.0;
+		table[i] = 2.0 * fc * sinc * w;
+	}
+	for (n=0; n < outlen; n++) {
+		double t = n / ratio;
+		int32_t k = (int32_t)ceil(t - halfwidth);
+		int32_t kend = (int32_t)floor(t + halfwidth);
+		double sum=0;
+		if (k < 0) k = 0;
+		if (kend > (int32_t)s->length - 1) kend = s->length - 1;
+		for (; k <= kend; k++) {
+			double d = fabs(t - k) * SRC_PHASES;
+			uint32_t idx = (uint32_t)d;
+			double frac = d - idx;
+			if (idx + 1 >= tablelen) continue;
+			sum += s->audio[k] * (table[idx] + (table[idx + 1] - table[idx]) * frac);
 		}
+		out[n] = sum;
 	}
+	free(table);
+	free(s->audio);
+	s->audio = out;
+	s->length = outlen;
+	s->inrate = s->rate;
+}
+
+void normalize(struct sample *s)
+{
+	float peak=0, gain;
+	uint32_t i;
 
-	// the length must be a multiple of the data size
-	if (channels == 2) {
-		if (length % 4) die("file %s data length is not a multiple of 4", filename);
-		length = length / 4;
+	for (i=0; i < s->length; i++) {
+		if (fabsf(s->audio[i]) > peak) peak = fabsf(s->audio[i]);
 	}
-	if (channels == 1) {
-		if (length % 1) die("file %s data length is not a multiple of 2", filename);
-		length = length / 2;
+	if (peak <= 0) return;
+	gain = 32767.0 * pow(10.0, normalize_db / 20.0) / peak;
+	for (i=0; i < s->length; i++) s->audio[i] *= gain;
+}
+
+// Pack the audio in the AudioPlayMemory format: a header word with the
+// format and length, then u-law bytes or 16 bit samples, padded to a
+// multiple of 2.9 ms.
+void encode(struct sample *s)
+{
+	int16_t *pcm;
+	uint32_t i, length=s->length, padlength=0, format=0;
+	double signal=0, error=0;
+	uint8_t *bytes;
+
+	pcm = malloc((length ? length : 1) * sizeof(int16_t));
+	if (!pcm) die("unable to allocate memory");
+	for (i=0; i < length; i++) {
+		long n = lrintf(s->audio[i]);
+		if (n > 32767) n = 32767;
+		else if (n < -32768) n = -32768;
+		pcm[i] = n;
+		double e = n - ulaw_decode(ulaw_encode(n));
+		signal += (double)n * n;
+		error += e * e;
+	}
+	s->snr = (error > 0) ? 10.0 * log10(signal / error) : 999.0;
+	if (pcm_mode) {
+		s->pcm = 1;
+	} else if (use_budget) {
+		s->pcm = (s->snr < error_budget);
+	} else {
+		s->pcm = 0;
 	}
-	if (length > 0xFFFFFF) die("file %s data length is too long", filename);
-	bcount = 0;
 
 	// AudioPlayMemory requires padding to 2.9 ms boundary (128 samples @ 44100)
-	if (rate == 44100) {
+	if (s->rate == 44100) {
 		padlength = padding(length, 128);
 		format = 1;
-	} else if (rate == 22050) {
+	} else if (s->rate == 22050) {
 		padlength = padding(length, 64);
 		format = 2;
-	} else if (rate == 11025) {
+	} else if (s->rate == 11025) {
 		padlength = padding(length, 32);
 		format = 3;
 	}
-	if (pcm_mode) {
-		arraylen = ((length + padlength) * 2 + 3) / 4 + 1;
+	if (s->pcm) {
+		s->words = ((length + padlength) * 2 + 3) / 4 + 1;
 		format |= 0x80;
 	} else {
-		arraylen = (length + padlength + 3) / 4 + 1;
+		s->words = (length + padlength + 3) / 4 + 1;
+	}
+	s->data = calloc(s->words, sizeof(uint32_t));
+	if (!s->data) die("unable to allocate memory");
+	s->data[0] = length | (format << 24);
+	bytes = (uint8_t *)(s->data + 1);
+	for (i=0; i < length; i++) {
+		if (s->pcm) {
+			bytes[i * 2] = pcm[i];
+			bytes[i * 2 + 1] = (uint16_t)pcm[i] >> 8;
+		} else {
+			bytes[i] = ulaw_encode(pcm[i]);
+		}
+	}
+	// the packed bytes were stored lsb first, fix the word order on
+	// big endian hosts
+	for (i=1; i < s->words; i++) {
+		const uint8_t *b = (const uint8_t *)(s->data + i);
+		s->data[i] = b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+	}
+	free(pcm);
+}
+
+void convert(struct sample *s)
+{
+	load_wav(s);
+	if (use_trim) trim(s);
+	if (target_rate && target_rate != s->inrate) {
+		s->rate = target_rate;
+		resample(s);
+	} else {
+		s->rate = s->inrate;
+	}
+	if (s->rate != 44100 && s->rate != 22050 && s->rate != 11025 /*&& rate != 8000*/ )
+		die("sample rate %d in %s is unsupported\n"
+		  "Only 44100, 22050, 11025 work, or use -r to resample",
+		  s->inrate, s->filename);
+	if (use_normalize) normalize(s);
+	if (s->length > 0xFFFFFF) die("file %s data length is too long", s->filename);
+	encode(s);
+	free(s->audio);
+	s->audio = NULL;
+}
+
+void * worker(void *arg)
+{
+	int n;
+
+	(void)arg;
+	while (1) {
+		pthread_mutex_lock(&job_lock);
+		n = next_sample++;
+		pthread_mutex_unlock(&job_lock);
+		if (n >= nsamples) break;
+		convert(&samples[n]);
+	}
+	return NULL;
+}
+
+void add_file(const char *filename)
+{
+	int len = strlen(filename);
+
+	if (len < 5 || strcasecmp(filename + len - 4, ".wav") != 0) {
+		die("%s is not a .wav file", filename);
 	}
-	total_length += arraylen;
+	samples = realloc(samples, (nsamples + 1) * sizeof(struct sample));
+	if (!samples) die("unable to allocate memory");
+	memset(&samples[nsamples], 0, sizeof(struct sample));
+	samples[nsamples].filename = strdup(filename);
+	filename2samplename(filename, samples[nsamples].name,
+		sizeof(samples[nsamples].name));
+	nsamples++;
+}
+
+int compare_samples(const void *a, const void *b)
+{
+	return strcmp(((const struct sample *)a)->filename,
+		((const struct sample *)b)->filename);
+}
+
+void print_comment(FILE *out, const char *prefix, const struct sample *s)
+{
+	fprintf(out, "// %s from %s, using %d Hz, %s encoding\n", prefix, s->filename,
+	  s->rate, (s->pcm ? "16 bit PCM" : "u-law"));
+}
+
+const char *title = "// Audio data converted from WAV file by wav2sketch\n\n";
 
+// one AudioSample<name>.cpp and .h for each WAV file
+void write_files(const struct sample *s)
+{
+	FILE *outc, *outh;
+	char buf[128];
+
+	snprintf(buf, sizeof(buf), "AudioSample%s.cpp", s->name);
+	outc = fopen(buf, "w");
+	if (outc == NULL) die("unable to write %s", buf);
+	snprintf(buf, sizeof(buf), "AudioSample%s.h", s->name);
+	outh = fopen(buf, "w");
+	if (outh == NULL) die("unable to write %s\n", buf);
+	fprintf(outh, "%s", title);
+	fprintf(outc, "%s", title);
+	fprintf(outc, "#include <Arduino.h>\n");
+	fprintf(outc, "#include \"%s\"\n\n", buf);
 	// output a minimal header, just the length, #bits and sample rate
-	fprintf(outh, "extern const unsigned int AudioSample%s[%d];\n", samplename, arraylen);	
-	fprintf(out, "// Converted from %s, using %d Hz, %s encoding\n", filename, rate,
-	  (pcm_mode ? "16 bit PCM" : "u-law"));
-	fprintf(out, "PROGMEM const unsigned int AudioSample%s[%d] = {\n", samplename, arraylen);
-	fprintf(out, "0x%08X,", length | (format << 24));
-	wcount = 1;
-
-	// finally, read the audio data
-	while (length > 0) {
-		if (channels == 1) {
-			audio = read_int16(in);
-		} else {
-			audio = read_int16(in);
-			audio += read_int16(in);
-			audio /= 2;
+	fprintf(outh, "extern const unsigned int AudioSample%s[%d];\n", s->name, s->words);
+	print_comment(outc, "Converted", s);
+	fprintf(outc, "PROGMEM const unsigned int AudioSample%s[%d] = {\n", s->name, s->words);
+	print_words(outc, s->data, s->words);
+	fprintf(outc, "};\n");
+	fclose(outc);
+	fclose(outh);
+}
+
+// All samples packed in one array, with an index.  Each sample's name is
+// defined as a pointer into the array, so AudioPlayMemory's play() is
+// used the same way as with separate files.
+void write_blob(const char *name)
+{
+	FILE *outc, *outh;
+	char buf[128], arrayname[64];
+	uint32_t total=0, offset=0;
+	int i, j;
+
+	for (i=0; i < nsamples; i++) {
+		for (j=0; j < i; j++) {
+			if (strcmp(samples[i].name, samples[j].name) == 0) {
+				die("%s and %s would both be named AudioSample%s",
+					samples[j].filename, samples[i].filename, samples[i].name);
+			}
 		}
-		if (pcm_mode) {
-			print_byte(out, audio);
-			print_byte(out, audio >> 8);
+		total += samples[i].words;
+	}
+	snprintf(buf, sizeof(buf), "%s.wav", name);
+	filename2samplename(buf, arrayname, sizeof(arrayname));
+	snprintf(buf, sizeof(buf), "%s.h", name);
+	outh = fopen(buf, "w");
+	if (outh == NULL) die("unable to write %s", buf);
+	fprintf(outh, "%s", title);
+	fprintf(outh, "extern const unsigned int AudioSample%s[%u];\n", arrayname, total);
+	fprintf(outh, "extern const unsigned int * const AudioSample%sIndex[%d];\n",
+		arrayname, nsamples);
+	fprintf(outh, "#define AudioSample%sCount %d\n\n", arrayname, nsamples);
+	for (i=0; i < nsamples; i++) {
+		fprintf(outh, "#define AudioSample%s (AudioSample%s + %u)\n",
+			samples[i].name, arrayname, offset);
+		offset += samples[i].words;
+	}
+	fclose(outh);
+
+	snprintf(buf, sizeof(buf), "%s.cpp", name);
+	outc = fopen(buf, "w");
+	if (outc == NULL) die("unable to write %s", buf);
+	fprintf(outc, "%s", title);
+	fprintf(outc, "#include <Arduino.h>\n");
+	fprintf(outc, "#include \"%s.h\"\n\n", name);
+	fprintf(outc, "PROGMEM const unsigned int AudioSample%s[%u] = {\n", arrayname, total);
+	for (i=0; i < nsamples; i++) {
+		snprintf(buf, sizeof(buf), "AudioSample%s, converted", samples[i].name);
+		print_comment(outc, buf, &samples[i]);
+		print_words(outc, samples[i].data, samples[i].words);
+	}
+	fprintf(outc, "};\n\n");
+	fprintf(outc, "const unsigned int * const AudioSample%sIndex[%d] = {\n",
+		arrayname, nsamples);
+	for (i=0; i < nsamples; i++) {
+		fprintf(outc, "\tAudioSample%s,\n", samples[i].name);
+	}
+	fprintf(outc, "};\n");
+	fclose(outc);
+}
+
+int main(int argc, char **argv)
+{
+	DIR *dir;
+	struct dirent *f;
+	struct stat s;
+	pthread_t *threads;
+	int i, len, jobs=0, files=0;
+	uint32_t total_length=0;
+
+	// By default, audio is u-law encoded to reduce the memory requirement
+	// in half.  However, u-law does add distortion.  If "-16" is specified
+	// on the command line, the original 16 bit PCM samples are used.
+	for (i=1; i < argc; i++) {
+		if (strcmp(argv[i], "-16") == 0) {
+			pcm_mode = 1;
+		} else if (argv[i][0] == '-' && argv[i][1] && !argv[i][2]) {
+			if (i + 1 >= argc) die("option %s needs a value", argv[i]);
+			const char *val = argv[++i];
+			switch (argv[i - 1][1]) {
+			  case 'e': error_budget = atof(val); use_budget = 1; break;
+			  case 't': trim_db = atof(val); use_trim = 1; break;
+			  case 'n': normalize_db = atof(val); use_normalize = 1; break;
+			  case 'b': blobname = val; break;
+			  case 'j': jobs = atoi(val); break;
+			  case 'r':
+				target_rate = atoi(val);
+				if (target_rate != 44100 && target_rate != 22050 && target_rate != 11025)
+					die("-r must be 44100, 22050 or 11025");
+				break;
+			  default: die("unknown option %s", argv[i - 1]);
+			}
 		} else {
-			print_byte(out, ulaw_encode(audio));
+			add_file(argv[i]);
+			files++;
+		}
+	}
+	if (files == 0) {
+		dir = opendir(".");
+		if (!dir) die("unable to open directory");
+		while (1) {
+			f = readdir(dir);
+			if (!f) break;
+			if (stat(f->d_name, &s) < 0) continue; // skip if unable to stat
+			if (S_ISDIR(s.st_mode)) continue;  // skip directories
+			if (!S_ISREG(s.st_mode)) continue; // skip special files
+			len = strlen(f->d_name);
+			if (len < 5) continue;
+			if (strcasecmp(f->d_name + len - 4, ".wav") != 0) continue;
+			add_file(f->d_name);
 		}
-		length--;
+		closedir(dir);
 	}
-	while (padlength > 0) {
-		print_byte(out, 0);
-		padlength--;
+	if (nsamples == 0) die("no WAV files to convert");
+	qsort(samples, nsamples, sizeof(struct sample), compare_samples);
+
+	// convert all the files in parallel, then write them in order
+#ifdef _SC_NPROCESSORS_ONLN
+	if (jobs <= 0) jobs = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (jobs <= 0) jobs = 4;
+	if (jobs > nsamples) jobs = nsamples;
+	threads = malloc(jobs * sizeof(pthread_t));
+	if (!threads) die("unable to allocate memory");
+	for (i=0; i < jobs; i++) {
+		if (pthread_create(&threads[i], NULL, worker, NULL) != 0) {
+			die("unable to start thread");
+		}
 	}
-	while (bcount > 0) {
-		print_byte(out, 0);
+	for (i=0; i < jobs; i++) {
+		pthread_join(threads[i], NULL);
 	}
-	if (wcount > 0) fprintf(out, "\n");
-	fprintf(out, "};\n");
+	free(threads);
+
+	for (i=0; i < nsamples; i++) {
+		struct sample *p = &samples[i];
+		printf("converting: %s  -->  AudioSample%s\n", p->filename, p->name);
+		if (use_budget || target_rate || use_trim || use_normalize || blobname) {
+			printf("  %u samples at %u Hz, %s (u-law %.1f dB), %u bytes\n",
+				p->length, p->rate, p->pcm ? "16 bit PCM" : "u-law",
+				p->snr, p->words * 4);
+		}
+		if (!blobname) write_files(p);
+		total_length += p->words;
+	}
+	if (blobname) write_blob(blobname);
+	printf("Total data size %d bytes\n", total_length * 4);
+	return 0;
 }
 
 
@@ -199,6 +589,18 @@ uint8_t ulaw_encode(int16_t audio)
 	else               return neg | 0x00 | ((mag >> 3) & 0x0F);   // 0000 0000 1wxy z000
 }
 
+// inverse of ulaw_encode, the center of each step
+int16_t ulaw_decode(uint8_t code)
+{
+	int exponent = (code >> 4) & 7;
+	int mantissa = code & 15;
+	int32_t mag;
+
+	mag = ((16 + mantissa) << (exponent + 3)) + (1 << (exponent + 2)) - 128;
+	if (mag > 32767) mag = 32767;
+	return (code & 0x80) ? -mag : mag;
+}
+
 
 
 // compute the extra padding needed
@@ -211,35 +613,35 @@ uint32_t padding(uint32_t length, uint32_t block)
 	return block - extra;
 }
 
-// pack the output bytes into 32 bit words, lsb first, and
-// format the data nicely with commas and newlines
-void print_byte(FILE *out, uint8_t b)
+// format the data nicely with commas and newlines, 8 words per line
+void print_words(FILE *out, const uint32_t *data, uint32_t count)
 {
-	static uint32_t buf32=0;
+	uint32_t i, wcount=0;
 
-	buf32 |= (b << (8 * bcount++));
-	if (bcount >= 4) {
-		fprintf(out, "0x%08X,", buf32);
-		buf32 = 0;
-		bcount = 0;
+	for (i=0; i < count; i++) {
+		fprintf(out, "0x%08X,", data[i]);
 		if (++wcount >= 8) {
 			fprintf(out, "\n");
 			wcount = 0;
 		}
 	}
+	if (wcount > 0) fprintf(out, "\n");
 }
 
 // convert the WAV filename into a C-compatible name
-void filename2samplename(void)
+void filename2samplename(const char *filename, char *samplename, size_t size)
 {
+	const char *slash;
 	int len, i, n;
 	char c;
 
+	slash = strrchr(filename, '/');
+	if (slash) filename = slash + 1;
 	len = strlen(filename) - 4;
-	if (len >= sizeof(samplename)-1) len = sizeof(samplename)-1;
-	for (i=0, n=0; n < len; i++) {
+	if (len >= (int)size-1) len = size-1;
+	for (i=0, n=0; n < len && filename[i]; i++) {
 		c = filename[i];
-		if (isalpha(c) || c == '_' || (isdigit(c) && n > 0)) {
+		if (isalpha((unsigned char)c) || c == '_' || (isdigit((unsigned char)c) && n > 0)) {
 			samplename[n] = (n == 0) ? toupper(c) : tolower(c);
 			n++;
 		}
@@ -247,102 +649,24 @@ void filename2samplename(void)
 	samplename[n] = 0;
 }
 
-
-const char *title = "// Audio data converted from WAV file by wav2sketch\n\n";
-
-int main(int argc, char **argv)
-{
-	DIR *dir;
-	struct dirent *f;
-	struct stat s;
-	FILE *fp, *outc=NULL, *outh=NULL;
-	char buf[128];
-	int i, len;
-
-	// By default, audio is u-law encoded to reduce the memory requirement
-	// in half.  However, u-law does add distortion.  If "-16" is specified
-	// on the command line, the original 16 bit PCM samples are used.
-	for (i=1; i < argc; i++) {
-		if (strcmp(argv[i], "-16") == 0) pcm_mode = 1;
-	}
-	dir = opendir(".");
-	if (!dir) die("unable to open directory");
-	while (1) {
-		f = readdir(dir);
-		if (!f) break;
-		//if ((f->d_type & DT_DIR)) continue; // skip directories
-		//if (!(f->d_type & DT_REG)) continue; // skip special files
-		if (stat(f->d_name, &s) < 0) continue; // skip if unable to stat
-		if (S_ISDIR(s.st_mode)) continue;  // skip directories
-		if (!S_ISREG(s.st_mode)) continue; // skip special files
-		filename = f->d_name;
-		len = strlen(filename);
-		if (len < 5) continue;
-		if (strcasecmp(filename + len - 4, ".wav") != 0) continue;
-		fp = fopen(filename, "rb");
-		if (!fp) die("unable to read file %s", filename);
-		filename2samplename();
-		printf("converting: %s  -->  AudioSample%s\n", filename, samplename);
-		snprintf(buf, sizeof(buf), "AudioSample%s.cpp", samplename);
-		outc = fopen(buf, "w");
-		if (outc == NULL) die("unable to write %s", buf);
-		snprintf(buf, sizeof(buf), "AudioSample%s.h", samplename);
-		outh = fopen(buf, "w");
-		if (outh == NULL) die("unable to write %s\n", buf);
-		fprintf(outh, "%s", title);
-		fprintf(outc, "%s", title);
-		fprintf(outc, "#include <Arduino.h>\n");
-		fprintf(outc, "#include \"%s\"\n\n", buf);
-		wav2c(fp, outc, outh);
-		//wav2c(fp, stdout, stdout);
-		fclose(outc);
-		fclose(outh);
-		fclose(fp);
-	}
-	printf("Total data size %d bytes\n", total_length * 4);
-	return 0;
-}
-
-uint8_t read_uint8(FILE *in)
-{
-	int c1;
-
-	c1 = fgetc(in);
-	if (c1 == EOF) die("error, end of data while reading from %s\n", filename);
-	c1 &= 255;
-	return c1;
-}
-
-int16_t read_int16(FILE *in)
-{
-	int c1, c2;
-
-	c1 = fgetc(in);
-	if (c1 == EOF) die("error, end of data while reading from %s\n", filename);
-	c2 = fgetc(in);
-	if (c2 == EOF) die("error, end of data while reading from %s\n", filename);
-	c1 &= 255;
-	c2 &= 255;
-	return (c2 << 8) | c1;
-}
-
-uint32_t read_uint32(FILE *in)
+void * load_file(const char *filename, uint32_t *size)
 {
-	int c1, c2, c3, c4;
-
-	c1 = fgetc(in);
-	if (c1 == EOF) die("error, end of data while reading from %s\n", filename);
-	c2 = fgetc(in);
-	if (c2 == EOF) die("error, end of data while reading from %s\n", filename);
-	c3 = fgetc(in);
-	if (c3 == EOF) die("error, end of data while reading from %s\n", filename);
-	c4 = fgetc(in);
-	if (c4 == EOF) die("error, end of data while reading from %s\n", filename);
-	c1 &= 255;
-	c2 &= 255;
-	c3 &= 255;
-	c4 &= 255;
-	return (c4 << 24) | (c3 << 16) | (c2 << 8) | c1;
+	FILE *fp;
+	long len;
+	void *buf;
+
+	fp = fopen(filename, "rb");
+	if (!fp) die("unable to read file %s", filename);
+	if (fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) < 0)
+		die("unable to read file %s", filename);
+	rewind(fp);
+	buf = malloc(len ? len : 1);
+	if (!buf) die("unable to allocate memory");
+	if (fread(buf, 1, len, fp) != (size_t)len)
+		die("error, end of data while reading from %s", filename);
+	fclose(fp);
+	*size = len;
+	return buf;
 }
 
 void die(const char *format, ...)
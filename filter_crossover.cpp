@@ -0,0 +1,185 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(KINETISL)
+
+#include <Arduino.h>
+#include "filter_crossover.h"
+#include "biquad.h"
+#include "utility/dspinst.h"
+
+// Linkwitz-Riley filters are a Butterworth filter applied twice.  LR4
+// is two identical 2nd order sections, LR8 is the two sections of a 4th
+// order Butterworth, twice.  The lowpass and highpass of each crossover
+// point sum to an allpass with the Butterworth's Q, so every band below
+// a crossover point also passes through that allpass, to keep all the
+// bands in phase.  All bands are computed together for each sample, so
+// the input is read only once.
+
+static const float butterworth2_q[2] = {0.70710678f, 0.70710678f};
+static const float butterworth4_q[2] = {0.54119610f, 1.30656296f};
+
+#define DELAY_MASK (CROSSOVER_DELAY_SIZE - 1)
+
+void AudioFilterCrossover::compute(struct crossover_coefs &c, int n, int s)
+{
+	const float fmin = 20.0f, fmax = AUDIO_SAMPLE_RATE_EXACT * 0.45f;
+	const float *q = (s == 4) ? butterworth4_q : butterworth2_q;
+	int i, k;
+
+	for (i=0; i < n; i++) {
+		float lower = (i > 0) ? c.freq[i-1] : fmin;
+		if (c.freq[i] < lower) c.freq[i] = lower;
+		if (c.freq[i] > fmax) c.freq[i] = fmax;
+		for (k=0; k < s; k++) {
+			getCoefficients<float>(c.lowpass[i][k], BiquadType::LOW_PASS, 0.0,
+				c.freq[i], AUDIO_SAMPLE_RATE_EXACT, q[k & 1]);
+			getCoefficients<float>(c.highpass[i][k], BiquadType::HIGH_PASS, 0.0,
+				c.freq[i], AUDIO_SAMPLE_RATE_EXACT, q[k & 1]);
+		}
+		for (k=0; k < s/2; k++) {
+			getCoefficients<float>(c.allpass[i][k], BiquadType::ALL_PASS, 0.0,
+				c.freq[i], AUDIO_SAMPLE_RATE_EXACT, q[k]);
+		}
+	}
+}
+
+static float bessel_i0(float x)
+{
+	float sum = 1.0f, term = 1.0f;
+	for (int k=1; k < 20; k++) {
+		term *= x * 0.5f / (float)k;
+		sum += term * term;
+	}
+	return sum;
+}
+
+// Fractional delays use a 16 tap Kaiser windowed sinc, accurate within
+// -60 dB up to 16 kHz.  To center it on the delay, every band is delayed
+// by CROSSOVER_LATENCY more samples, so the bands stay aligned.
+void AudioFilterCrossover::setdelay(struct band_param &p, float milliseconds)
+{
+	const float beta = 7.0f;
+	float d = milliseconds * (AUDIO_SAMPLE_RATE_EXACT / 1000.0f);
+	if (d < 0.0f) d = 0.0f;
+	if (d > (float)(CROSSOVER_DELAY_SIZE - CROSSOVER_INTERP_TAPS)) {
+		d = CROSSOVER_DELAY_SIZE - CROSSOVER_INTERP_TAPS;
+	}
+	int i = (int)d;
+	float t = d - (float)i;
+	if (t < 0.0001f || t > 0.9999f) {
+		p.offset = (int)(d + 0.5f) + CROSSOVER_LATENCY;
+		p.taps = 1;
+		p.weight[0] = 1.0f;
+		return;
+	}
+	float sum = 0.0f;
+	for (int k=0; k < CROSSOVER_INTERP_TAPS; k++) {
+		float x = (float)k - ((float)CROSSOVER_LATENCY + t);
+		float r = x * (2.0f / CROSSOVER_INTERP_TAPS);
+		float w = sinf((float)M_PI * x) / ((float)M_PI * x);
+		w *= bessel_i0(beta * sqrtf(fmaxf(0.0f, 1.0f - r * r))) / bessel_i0(beta);
+		p.weight[k] = w;
+		sum += w;
+	}
+	for (int k=0; k < CROSSOVER_INTERP_TAPS; k++) {
+		p.weight[k] /= sum;
+	}
+	p.offset = i;
+	p.taps = CROSSOVER_INTERP_TAPS;
+}
+
+// Direct form 2 transposed, one sample
+static inline float biquad(const float *coef, float *state, float x)
+{
+	float y = coef[0] * x + state[0];
+	state[0] = coef[1] * x + coef[3] * y + state[1];
+	state[1] = coef[2] * x + coef[4] * y;
+	return y;
+}
+
+void AudioFilterCrossover::update(void)
+{
+	audio_block_t *in, *out[CROSSOVER_MAX_BANDS];
+	float y[CROSSOVER_MAX_BANDS];
+	int b, i, j, k;
+
+	in = receiveReadOnly();
+	if (!in) return;
+
+	const int n = splits;
+	const int s = sections;
+	const int a = s / 2;
+	const struct crossover_coefs &c = coefs;
+	for (b=0; b <= n; b++) {
+		out[b] = allocate();
+	}
+	uint32_t head = delay_head;
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		float rest = (float)in->data[i] * (1.0f / 32768.0f);
+		for (b=0; b < n; b++) {
+			float (*st)[2] = state[b];
+			float low = rest;
+			for (k=0; k < s; k++) {
+				low = biquad(c.lowpass[b][k], st[k], low);
+			}
+			for (k=0; k < s; k++) {
+				rest = biquad(c.highpass[b][k], st[4 + k], rest);
+			}
+			for (j=b+1; j < n; j++) {
+				for (k=0; k < a; k++) {
+					low = biquad(c.allpass[j][k], st[8 + (j-b-1)*2 + k], low);
+				}
+			}
+			y[b] = low;
+		}
+		y[n] = rest;
+		for (b=0; b <= n; b++) {
+			const struct band_param &p = bandparam[b];
+			float *dl = delayline[b];
+			dl[head] = y[b];
+			uint32_t r = head - p.offset;
+			float v = p.weight[0] * dl[r & DELAY_MASK];
+			for (k=1; k < p.taps; k++) {
+				v += p.weight[k] * dl[(r - k) & DELAY_MASK];
+			}
+			if (out[b]) {
+				out[b]->data[i] = saturate16((int32_t)(v * p.gain * 32768.0f));
+			}
+		}
+		head = (head + 1) & DELAY_MASK;
+	}
+	delay_head = head;
+	release(in);
+	for (b=0; b <= n; b++) {
+		if (out[b]) {
+			transmit(out[b], b);
+			release(out[b]);
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,131 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef filter_crossover_h_
+#define filter_crossover_h_
+
+#if !defined(KINETISL)
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+#define CROSSOVER_MAX_BANDS	4
+#define CROSSOVER_DELAY_SIZE	512	// must be a power of 2, max delay is 16 less
+#define CROSSOVER_INTERP_TAPS	16	// fractional delay interpolation
+#define CROSSOVER_LATENCY	7	// samples, added to every band
+
+class AudioFilterCrossover : public AudioStream
+{
+public:
+	AudioFilterCrossover(void) : AudioStream(1, inputQueueArray) {
+		splits = 1;
+		sections = 2;
+		coefs.freq[0] = 1000.0f;
+		coefs.freq[1] = coefs.freq[2] = 0.0f;
+		compute(coefs, 1, 2);
+		for (int i=0; i < CROSSOVER_MAX_BANDS; i++) {
+			setdelay(bandparam[i], 0.0f);
+			bandparam[i].gain = 1.0f;
+		}
+	}
+	// Split into 2, 3 or 4 bands at these frequencies, in increasing order.
+	void frequency(float freq1) {
+		setfrequency(1, freq1, 0.0f, 0.0f);
+	}
+	void frequency(float freq1, float freq2) {
+		setfrequency(2, freq1, freq2, 0.0f);
+	}
+	void frequency(float freq1, float freq2, float freq3) {
+		setfrequency(3, freq1, freq2, freq3);
+	}
+	// Linkwitz-Riley order, 4 (24 dB/octave) or 8 (48 dB/octave).
+	void order(int n) {
+		int s = (n >= 8) ? 4 : 2;
+		struct crossover_coefs c = coefs;
+		compute(c, splits, s);
+		__disable_irq();
+		coefs = c;
+		sections = s;
+		memset(state, 0, sizeof(state));
+		__enable_irq();
+	}
+	// Gain for one band.  Negative inverts polarity.
+	void gain(unsigned int band, float level) {
+		if (band >= CROSSOVER_MAX_BANDS) return;
+		bandparam[band].gain = level;
+	}
+	// Delay one band, with sub-sample resolution, for time alignment.
+	void delay(unsigned int band, float milliseconds) {
+		if (band >= CROSSOVER_MAX_BANDS) return;
+		struct band_param p = bandparam[band];
+		setdelay(p, milliseconds);
+		__disable_irq();
+		bandparam[band] = p;
+		__enable_irq();
+	}
+	virtual void update(void);
+private:
+	struct crossover_coefs {
+		float freq[CROSSOVER_MAX_BANDS-1];
+		// biquad.h order: b0, b1, b2, -a1, -a2
+		float lowpass[CROSSOVER_MAX_BANDS-1][4][5];
+		float highpass[CROSSOVER_MAX_BANDS-1][4][5];
+		float allpass[CROSSOVER_MAX_BANDS-1][2][5];
+	};
+	struct band_param {
+		float gain;
+		uint16_t offset;	// newest sample used
+		uint8_t taps;		// 1 for whole samples, or CROSSOVER_INTERP_TAPS
+		float weight[CROSSOVER_INTERP_TAPS];
+	};
+	void setfrequency(int n, float f1, float f2, float f3) {
+		struct crossover_coefs c;
+		c.freq[0] = f1;
+		c.freq[1] = f2;
+		c.freq[2] = f3;
+		compute(c, n, sections);
+		__disable_irq();
+		coefs = c;
+		splits = n;
+		memset(state, 0, sizeof(state));
+		__enable_irq();
+	}
+	static void compute(struct crossover_coefs &c, int n, int s);
+	static void setdelay(struct band_param &p, float milliseconds);
+	audio_block_t *inputQueueArray[1];
+	uint8_t splits;			// number of bands - 1
+	uint8_t sections;		// biquads per lowpass or highpass
+	struct crossover_coefs coefs;
+	struct band_param bandparam[CROSSOVER_MAX_BANDS];
+	// filter state: [band][lowpass, highpass, allpass x2 per higher split][2]
+	float state[CROSSOVER_MAX_BANDS][4 + 4 + 2*(CROSSOVER_MAX_BANDS-2)][2] = {};
+	float delayline[CROSSOVER_MAX_BANDS][CROSSOVER_DELAY_SIZE] = {};
+	uint16_t delay_head = 0;
+};
+
+#endif
+
+#endif
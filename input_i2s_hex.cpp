@@ -27,6 +27,7 @@
 #include <Arduino.h>
 #include "input_i2s_hex.h"
 #include "output_i2s.h"
+#include "memcpy_audio.h"
 
 DMAMEM __attribute__((aligned(32))) static uint32_t i2s_rx_buffer[AUDIO_BLOCK_SAMPLES*3];
 audio_block_t * AudioInputI2SHex::block_ch1 = NULL;
@@ -122,14 +123,8 @@ void AudioInputI2SHex::isr(void)
 			dest4 = &(block_ch4->data[offset]);
 			dest5 = &(block_ch5->data[offset]);
 			dest6 = &(block_ch6->data[offset]);
-			for (int i=0; i < AUDIO_BLOCK_SAMPLES/2; i++) {
-				*dest1++ = *src++;
-				*dest3++ = *src++;
-				*dest5++ = *src++;
-				*dest2++ = *src++;
-				*dest4++ = *src++;
-				*dest6++ = *src++;
-			}
+			int16_t *dest[6] = {dest1, dest3, dest5, dest2, dest4, dest6};
+			memcpy_frominterleave16(dest, src, 6, AUDIO_BLOCK_SAMPLES/2);
 		}
 	}
 	//digitalWriteFast(3, LOW);
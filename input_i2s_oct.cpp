@@ -27,6 +27,7 @@
 #include <Arduino.h>
 #include "input_i2s_oct.h"
 #include "output_i2s.h"
+#include "memcpy_audio.h"
 
 DMAMEM __attribute__((aligned(32))) static uint32_t i2s_rx_buffer[AUDIO_BLOCK_SAMPLES*4];
 audio_block_t * AudioInputI2SOct::block_ch1 = NULL;
@@ -114,16 +115,8 @@ void AudioInputI2SOct::isr(void)
 			dest6 = &(block_ch6->data[offset]);
 			dest7 = &(block_ch7->data[offset]);
 			dest8 = &(block_ch8->data[offset]);
-			for (int i=0; i < AUDIO_BLOCK_SAMPLES/2; i++) {
-				*dest1++ = *src++;
-				*dest3++ = *src++;
-				*dest5++ = *src++;
-				*dest7++ = *src++;
-				*dest2++ = *src++;
-				*dest4++ = *src++;
-				*dest6++ = *src++;
-				*dest8++ = *src++;
-			}
+			int16_t *dest[8] = {dest1, dest3, dest5, dest7, dest2, dest4, dest6, dest8};
+			memcpy_frominterleave16(dest, src, 8, AUDIO_BLOCK_SAMPLES/2);
 		}
 	}
 	//digitalWriteFast(3, LOW);
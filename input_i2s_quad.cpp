@@ -28,6 +28,7 @@
 #include "input_i2s_quad.h"
 #include "output_i2s_quad.h"
 #include "output_i2s.h"
+#include "memcpy_audio.h"
 
 DMAMEM __attribute__((aligned(32))) static uint32_t i2s_rx_buffer[AUDIO_BLOCK_SAMPLES*2];
 audio_block_t * AudioInputI2SQuad::block_ch1 = NULL;
@@ -156,12 +157,8 @@ void AudioInputI2SQuad::isr(void)
 			dest2 = &(block_ch2->data[offset]);
 			dest3 = &(block_ch3->data[offset]);
 			dest4 = &(block_ch4->data[offset]);
-			for (int i=0; i < AUDIO_BLOCK_SAMPLES/2; i++) {
-				*dest1++ = *src++;
-				*dest3++ = *src++;
-				*dest2++ = *src++;
-				*dest4++ = *src++;
-			}
+			int16_t *dest[4] = {dest1, dest3, dest2, dest4};
+			memcpy_frominterleave16(dest, src, 4, AUDIO_BLOCK_SAMPLES/2);
 		}
 	}
 	//digitalWriteFast(3, LOW);
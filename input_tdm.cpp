@@ -27,6 +27,7 @@
 #include <Arduino.h>
 #include "input_tdm.h"
 #include "output_tdm.h"
+#include "memcpy_audio.h"
 #if defined(KINETISK) || defined(__IMXRT1062__)
 #include "utility/imxrt_hw.h"
 
@@ -93,20 +94,6 @@ void AudioInputTDM::begin(void)
 #endif	
 }
 
-// TODO: needs optimization...
-static void memcpy_tdm_rx(uint32_t *dest1, uint32_t *dest2, const uint32_t *src)
-{
-	uint32_t i, in1, in2;
-
-	for (i=0; i < AUDIO_BLOCK_SAMPLES/2; i++) {
-		in1 = *src;
-		in2 = *(src+8);
-		src += 16;
-		*dest1++ = ((in1 >> 16) & 0x0000FFFF) | ((in2 <<  0) & 0xFFFF0000);
-		*dest2++ = ((in1 >>  0) & 0x0000FFFF) | ((in2 << 16) & 0xFFFF0000);	
-	}
-}
-
 void AudioInputTDM::isr(void)
 {
 	uint32_t daddr;
@@ -129,12 +116,14 @@ void AudioInputTDM::isr(void)
 		#if IMXRT_CACHE_ENABLED >=1
 		arm_dcache_delete((void*)src, sizeof(tdm_rx_buffer) / 2);
 		#endif
+		// each 32 bit word holds 2 channels, the odd channel in the
+		// low 16 bits, so swap each pair to get 16 bit slot order
+		int16_t *dest[16];
 		for (i=0; i < 16; i += 2) {
-			uint32_t *dest1 = (uint32_t *)(block_incoming[i]->data);
-			uint32_t *dest2 = (uint32_t *)(block_incoming[i+1]->data);
-			memcpy_tdm_rx(dest1, dest2, src);
-			src++;
+			dest[i] = block_incoming[i+1]->data;
+			dest[i+1] = block_incoming[i]->data;
 		}
+		memcpy_frominterleave16(dest, (const int16_t *)src, 16, AUDIO_BLOCK_SAMPLES);
 	}
 	if (update_responsibility) update_all();
 }
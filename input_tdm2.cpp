@@ -28,6 +28,7 @@
 #include <Arduino.h>
 #include "input_tdm2.h"
 #include "output_tdm2.h"
+#include "memcpy_audio.h"
 #include "utility/imxrt_hw.h"
 
 DMAMEM __attribute__((aligned(32)))
@@ -71,20 +72,6 @@ void AudioInputTDM2::begin(void)
 	I2S2_TCSR |= I2S_TCSR_TE | I2S_TCSR_BCE;
 }
 
-// TODO: needs optimization...
-static void memcpy_tdm_rx(uint32_t *dest1, uint32_t *dest2, const uint32_t *src)
-{
-	uint32_t i, in1, in2;
-
-	for (i=0; i < AUDIO_BLOCK_SAMPLES/2; i++) {
-		in1 = *src;
-		in2 = *(src+8);
-		src += 16;
-		*dest1++ = ((in1 >> 16) & 0x0000FFFF) | ((in2 <<  0) & 0xFFFF0000);
-		*dest2++ = ((in1 >>  0) & 0x0000FFFF) | ((in2 << 16) & 0xFFFF0000);	
-	}
-}
-
 void AudioInputTDM2::isr(void)
 {
 	uint32_t daddr;
@@ -107,12 +94,14 @@ void AudioInputTDM2::isr(void)
 		#if IMXRT_CACHE_ENABLED >=1
 		arm_dcache_delete((void*)src, sizeof(tdm_rx_buffer) / 2);
 		#endif
+		// each 32 bit word holds 2 channels, the odd channel in the
+		// low 16 bits, so swap each pair to get 16 bit slot order
+		int16_t *dest[16];
 		for (i=0; i < 16; i += 2) {
-			uint32_t *dest1 = (uint32_t *)(block_incoming[i]->data);
-			uint32_t *dest2 = (uint32_t *)(block_incoming[i+1]->data);
-			memcpy_tdm_rx(dest1, dest2, src);
-			src++;
+			dest[i] = block_incoming[i+1]->data;
+			dest[i+1] = block_incoming[i]->data;
 		}
+		memcpy_frominterleave16(dest, (const int16_t *)src, 16, AUDIO_BLOCK_SAMPLES);
 	}
 	if (update_responsibility) update_all();
 }
@@ -38,6 +38,31 @@ void memcpy_tointerleaveL(int16_t *dst, const int16_t *srcL);
 void memcpy_tointerleaveR(int16_t *dst, const int16_t *srcR);
 void memcpy_tointerleaveQuad(int16_t *dst, const int16_t *src1, const int16_t *src2,
 	const int16_t *src3, const int16_t *src4);
+
+// Interleave "channels" buffers of "len" samples each into dst, or the
+// reverse.  The 16 bit versions use 16 bit slots.  The 32 bit versions
+// use 32 bit slots with each sample shifted left by "shift": 16 gives
+// left justified 32 bit data, 8 gives 24 bit data in a 32 bit slot.
+// 2, 4, 6, 8 and 16 channels use optimized code, and the 16 bit versions
+// are fastest when len is even and all buffers are 32 bit aligned.
+void memcpy_tointerleave16(int16_t *dst, const int16_t * const *src,
+	unsigned int channels, unsigned int len);
+void memcpy_frominterleave16(int16_t * const *dst, const int16_t *src,
+	unsigned int channels, unsigned int len);
+void memcpy_tointerleave32(uint32_t *dst, const int16_t * const *src,
+	unsigned int channels, unsigned int len, unsigned int shift);
+void memcpy_frominterleave32(int16_t * const *dst, const uint32_t *src,
+	unsigned int channels, unsigned int len, unsigned int shift);
+
+// Simple reference versions of the above, any channel count or alignment
+void memcpy_tointerleave16_ref(int16_t *dst, const int16_t * const *src,
+	unsigned int channels, unsigned int len);
+void memcpy_frominterleave16_ref(int16_t * const *dst, const int16_t *src,
+	unsigned int channels, unsigned int len);
+void memcpy_tointerleave32_ref(uint32_t *dst, const int16_t * const *src,
+	unsigned int channels, unsigned int len, unsigned int shift);
+void memcpy_frominterleave32_ref(int16_t * const *dst, const uint32_t *src,
+	unsigned int channels, unsigned int len, unsigned int shift);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,239 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <stdint.h>
+#include "memcpy_audio.h"
+
+// Generic N channel interleave & deinterleave, shared by the multichannel
+// I2S and TDM drivers.  The common channel counts (2, 4, 6, 8, 16) are
+// handled by a kernel which moves 2 samples per 32 bit load & store, with
+// the channel count a compile time constant so the compiler can fully
+// unroll the inner loop.  Anything else falls back to the simple loops,
+// which also serve as the reference for what the fast kernels must do.
+
+#define INTERLEAVE_INLINE static inline __attribute__((always_inline, unused))
+
+static int interleave_aligned(const void *p, const int16_t * const *list, unsigned int channels)
+{
+	uintptr_t bits = (uintptr_t)p;
+	unsigned int i;
+
+	for (i=0; i < channels; i++) {
+		bits |= (uintptr_t)list[i];
+	}
+	return (bits & 3) == 0;
+}
+
+INTERLEAVE_INLINE void tointerleave16_packed(int16_t *dst, const int16_t * const *src,
+	const unsigned int channels, unsigned int len)
+{
+	const uint32_t *in[16];
+	uint32_t *out = (uint32_t *)dst;
+	const uint32_t *end = out + channels * (len / 2);
+	unsigned int c;
+
+	for (c=0; c < channels; c++) {
+		in[c] = (const uint32_t *)src[c];
+	}
+	do {
+		// each 32 bit read holds 2 consecutive samples from 1 channel,
+		// each 32 bit write holds 1 sample from 2 adjacent channels
+		for (c=0; c < channels; c += 2) {
+			uint32_t a = *in[c]++;
+			uint32_t b = *in[c+1]++;
+			out[c/2] = (b << 16) | (a & 0xFFFF);
+			out[c/2 + channels/2] = (b & 0xFFFF0000) | (a >> 16);
+		}
+		out += channels;
+	} while (out < end);
+}
+
+INTERLEAVE_INLINE void frominterleave16_packed(int16_t * const *dst, const int16_t *src,
+	const unsigned int channels, unsigned int len)
+{
+	uint32_t *out[16];
+	const uint32_t *in = (const uint32_t *)src;
+	const uint32_t *end = in + channels * (len / 2);
+	unsigned int c;
+
+	for (c=0; c < channels; c++) {
+		out[c] = (uint32_t *)dst[c];
+	}
+	do {
+		for (c=0; c < channels; c += 2) {
+			uint32_t a = in[c/2];
+			uint32_t b = in[c/2 + channels/2];
+			*out[c]++ = (b << 16) | (a & 0xFFFF);
+			*out[c+1]++ = (b & 0xFFFF0000) | (a >> 16);
+		}
+		in += channels;
+	} while (in < end);
+}
+
+INTERLEAVE_INLINE void tointerleave32_const(uint32_t *dst, const int16_t * const *src,
+	const unsigned int channels, unsigned int len, unsigned int shift)
+{
+	const int16_t *in[16];
+	const uint32_t *end = dst + channels * len;
+	unsigned int c;
+
+	for (c=0; c < channels; c++) {
+		in[c] = src[c];
+	}
+	do {
+		for (c=0; c < channels; c++) {
+			*dst++ = (uint32_t)(int32_t)(*in[c]++) << shift;
+		}
+	} while (dst < end);
+}
+
+INTERLEAVE_INLINE void frominterleave32_const(int16_t * const *dst, const uint32_t *src,
+	const unsigned int channels, unsigned int len, unsigned int shift)
+{
+	int16_t *out[16];
+	const uint32_t *end = src + channels * len;
+	unsigned int c;
+
+	for (c=0; c < channels; c++) {
+		out[c] = dst[c];
+	}
+	do {
+		for (c=0; c < channels; c++) {
+			*out[c]++ = (int16_t)(*src++ >> shift);
+		}
+	} while (src < end);
+}
+
+
+void memcpy_tointerleave16_ref(int16_t *dst, const int16_t * const *src,
+	unsigned int channels, unsigned int len)
+{
+	unsigned int i, c;
+
+	for (i=0; i < len; i++) {
+		for (c=0; c < channels; c++) {
+			*dst++ = src[c][i];
+		}
+	}
+}
+
+void memcpy_frominterleave16_ref(int16_t * const *dst, const int16_t *src,
+	unsigned int channels, unsigned int len)
+{
+	unsigned int i, c;
+
+	for (i=0; i < len; i++) {
+		for (c=0; c < channels; c++) {
+			dst[c][i] = *src++;
+		}
+	}
+}
+
+void memcpy_tointerleave32_ref(uint32_t *dst, const int16_t * const *src,
+	unsigned int channels, unsigned int len, unsigned int shift)
+{
+	unsigned int i, c;
+
+	for (i=0; i < len; i++) {
+		for (c=0; c < channels; c++) {
+			*dst++ = (uint32_t)(int32_t)src[c][i] << shift;
+		}
+	}
+}
+
+void memcpy_frominterleave32_ref(int16_t * const *dst, const uint32_t *src,
+	unsigned int channels, unsigned int len, unsigned int shift)
+{
+	unsigned int i, c;
+
+	for (i=0; i < len; i++) {
+		for (c=0; c < channels; c++) {
+			dst[c][i] = (int16_t)(*src++ >> shift);
+		}
+	}
+}
+
+
+void memcpy_tointerleave16(int16_t *dst, const int16_t * const *src,
+	unsigned int channels, unsigned int len)
+{
+	if (len >= 2 && (len & 1) == 0 && interleave_aligned(dst, src, channels)) {
+		switch (channels) {
+		  case 2:  tointerleave16_packed(dst, src, 2, len);  return;
+		  case 4:  tointerleave16_packed(dst, src, 4, len);  return;
+		  case 6:  tointerleave16_packed(dst, src, 6, len);  return;
+		  case 8:  tointerleave16_packed(dst, src, 8, len);  return;
+		  case 16: tointerleave16_packed(dst, src, 16, len); return;
+		}
+	}
+	memcpy_tointerleave16_ref(dst, src, channels, len);
+}
+
+void memcpy_frominterleave16(int16_t * const *dst, const int16_t *src,
+	unsigned int channels, unsigned int len)
+{
+	if (len >= 2 && (len & 1) == 0
+	  && interleave_aligned(src, (const int16_t * const *)dst, channels)) {
+		switch (channels) {
+		  case 2:  frominterleave16_packed(dst, src, 2, len);  return;
+		  case 4:  frominterleave16_packed(dst, src, 4, len);  return;
+		  case 6:  frominterleave16_packed(dst, src, 6, len);  return;
+		  case 8:  frominterleave16_packed(dst, src, 8, len);  return;
+		  case 16: frominterleave16_packed(dst, src, 16, len); return;
+		}
+	}
+	memcpy_frominterleave16_ref(dst, src, channels, len);
+}
+
+void memcpy_tointerleave32(uint32_t *dst, const int16_t * const *src,
+	unsigned int channels, unsigned int len, unsigned int shift)
+{
+	if (len > 0) {
+		switch (channels) {
+		  case 2:  tointerleave32_const(dst, src, 2, len, shift);  return;
+		  case 4:  tointerleave32_const(dst, src, 4, len, shift);  return;
+		  case 6:  tointerleave32_const(dst, src, 6, len, shift);  return;
+		  case 8:  tointerleave32_const(dst, src, 8, len, shift);  return;
+		  case 16: tointerleave32_const(dst, src, 16, len, shift); return;
+		}
+	}
+	memcpy_tointerleave32_ref(dst, src, channels, len, shift);
+}
+
+void memcpy_frominterleave32(int16_t * const *dst, const uint32_t *src,
+	unsigned int channels, unsigned int len, unsigned int shift)
+{
+	if (len > 0) {
+		switch (channels) {
+		  case 2:  frominterleave32_const(dst, src, 2, len, shift);  return;
+		  case 4:  frominterleave32_const(dst, src, 4, len, shift);  return;
+		  case 6:  frominterleave32_const(dst, src, 6, len, shift);  return;
+		  case 8:  frominterleave32_const(dst, src, 8, len, shift);  return;
+		  case 16: frominterleave32_const(dst, src, 16, len, shift); return;
+		}
+	}
+	memcpy_frominterleave32_ref(dst, src, channels, len, shift);
+}
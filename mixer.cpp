@@ -111,7 +111,11 @@ void AudioMixer4::update(void)
 	unsigned int channel;
 
 	for (channel=0; channel < 4; channel++) {
-		if (!out) {
+		if (multiplier[channel] == 0) {
+			// channel is off, discard its input without computing
+			in = receiveReadOnly(channel);
+			if (in) release(in);
+		} else if (!out) {
 			out = receiveWritable(channel);
 			if (out) {
 				int32_t mult = multiplier[channel];
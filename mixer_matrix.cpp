@@ -0,0 +1,130 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+#include "mixer_matrix.h"
+#include "utility/dspinst.h"
+
+// commit() runs in the sketch and may be interrupted by update() at any
+// point, but update() is never interrupted by commit().  So a sequence
+// number is enough: update() only copies the published gains when the
+// number is even (no commit in progress) and has changed since last time.
+// A commit interrupted part way is simply applied one block later.
+
+void AudioMixerMatrix::commit(bool crossfade)
+{
+	uint32_t seq = sequence + 1;
+
+	sequence = seq;		// odd, published gains are changing
+	asm volatile("" ::: "memory");
+	memcpy(published, staged, sizeof(published));
+	fade = crossfade;
+	asm volatile("" ::: "memory");
+	sequence = seq + 1;	// even, published gains are complete
+}
+
+void AudioMixerMatrix::revert(void)
+{
+	memcpy(staged, published, sizeof(staged));
+}
+
+void AudioMixerMatrix::update(void)
+{
+	audio_block_t *in[MATRIX_INPUTS];
+	audio_block_t *out;
+	int32_t sum[AUDIO_BLOCK_SAMPLES];
+	uint32_t seq, i, ch, n;
+
+	seq = sequence;
+	if (seq != applied && !(seq & 1)) {
+		memcpy(target, published, sizeof(target));
+		if (fade) {
+			// ramp from the gains heard now, even part way through a ramp
+			for (ch=0; ch < MATRIX_OUTPUTS; ch++) {
+				for (n=0; n < MATRIX_INPUTS; n++) {
+					inc[ch][n] = (target[ch][n] - active[ch][n]) / MATRIX_RAMP_SAMPLES;
+				}
+			}
+			ramp = MATRIX_RAMP_SAMPLES;
+		} else {
+			memcpy(active, target, sizeof(active));
+			ramp = 0;
+		}
+		applied = seq;
+	}
+	// the part of this block which is ramping
+	const uint32_t len = (ramp < AUDIO_BLOCK_SAMPLES) ? ramp : AUDIO_BLOCK_SAMPLES;
+	for (ch=0; ch < MATRIX_INPUTS; ch++) {
+		in[ch] = receiveReadOnly(ch);
+	}
+	for (ch=0; ch < MATRIX_OUTPUTS; ch++) {
+		bool any = false;
+		for (n=0; n < MATRIX_INPUTS; n++) {
+			int32_t g = active[ch][n];
+			const int32_t g1 = target[ch][n];
+			if (!in[n] || (g == 0 && g1 == 0)) continue;
+			const int16_t *data = in[n]->data;
+			if (!any) {
+				memset(sum, 0, sizeof(sum));
+				any = true;
+			}
+			i = 0;
+			if (g != g1) {
+				// linear ramp from the old to the new gain
+				const int32_t step = inc[ch][n];
+				for (; i < len; i++) {
+					g += step;
+					sum[i] += signed_multiply_32x16b(g, data[i]);
+				}
+				if (len == ramp) g = g1;
+			}
+			for (; i < AUDIO_BLOCK_SAMPLES; i++) {
+				sum[i] += signed_multiply_32x16b(g, data[i]);
+			}
+		}
+		if (!any) continue;
+		out = allocate();
+		if (!out) continue;
+		for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+			out->data[i] = signed_saturate_rshift(sum[i], 16, 0);
+		}
+		transmit(out, ch);
+		release(out);
+	}
+	// every gain moves on, including those with no input this time
+	if (len > 0) {
+		ramp -= len;
+		for (ch=0; ch < MATRIX_OUTPUTS; ch++) {
+			for (n=0; n < MATRIX_INPUTS; n++) {
+				if (ramp == 0) active[ch][n] = target[ch][n];
+				else active[ch][n] += inc[ch][n] * (int32_t)len;
+			}
+		}
+	}
+	for (ch=0; ch < MATRIX_INPUTS; ch++) {
+		if (in[ch]) release(in[ch]);
+	}
+}
@@ -0,0 +1,89 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef mixer_matrix_h_
+#define mixer_matrix_h_
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+#define MATRIX_INPUTS  8
+#define MATRIX_OUTPUTS 8
+#define MATRIX_RAMP_SAMPLES 128	// crossfades take 2.9 ms
+
+// Route any input to any output with its own gain.  Changes are staged,
+// then committed together.  The audio update applies a commit at the start
+// of a block, never part way through, so interrupts are not disabled and
+// dozens of routes can change at exactly the same moment.
+class AudioMixerMatrix : public AudioStream
+{
+public:
+	AudioMixerMatrix(void) : AudioStream(MATRIX_INPUTS, inputQueueArray) {
+		memset(staged, 0, sizeof(staged));
+		memset(published, 0, sizeof(published));
+		memset(active, 0, sizeof(active));
+		memset(target, 0, sizeof(target));
+		memset(inc, 0, sizeof(inc));
+	}
+	// Staged changes, heard only after commit()
+	void gain(unsigned int input, unsigned int output, float level) {
+		if (input >= MATRIX_INPUTS || output >= MATRIX_OUTPUTS) return;
+		if (level > 64.0f) level = 64.0f;
+		else if (level < -64.0f) level = -64.0f;
+		staged[output][input] = level * 65536.0f;
+	}
+	void connect(unsigned int input, unsigned int output) {
+		gain(input, output, 1.0f);
+	}
+	void disconnect(unsigned int input, unsigned int output) {
+		gain(input, output, 0.0f);
+	}
+	void disconnectAll(void) {
+		memset(staged, 0, sizeof(staged));
+	}
+	// Discard staged changes, returning to the last commit.
+	void revert(void);
+	// Apply all staged changes at the next block.  With crossfade, every
+	// changed gain ramps from its old to its new value over 128 samples,
+	// at any block size.
+	void commit(bool crossfade = true);
+	// True while the last commit is waiting for the next block.
+	bool pending(void) { return sequence != applied; }
+	virtual void update(void);
+private:
+	int32_t staged[MATRIX_OUTPUTS][MATRIX_INPUTS];		// user only
+	int32_t published[MATRIX_OUTPUTS][MATRIX_INPUTS];	// last commit
+	int32_t active[MATRIX_OUTPUTS][MATRIX_INPUTS];		// update only
+	int32_t target[MATRIX_OUTPUTS][MATRIX_INPUTS];		// end of the ramp
+	int32_t inc[MATRIX_OUTPUTS][MATRIX_INPUTS];		// per sample
+	unsigned int ramp = 0;		// samples left until active reaches target
+	volatile uint32_t sequence = 0;		// odd while commit() is writing
+	volatile uint32_t applied = 0;
+	volatile bool fade = true;
+	audio_block_t *inputQueueArray[MATRIX_INPUTS];
+};
+
+#endif
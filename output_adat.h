@@ -31,44 +31,24 @@
 class AudioOutputADAT : public AudioStream
 {
 public:
-	AudioOutputADAT(void) : AudioStream(8, inputQueueArray) { begin(); }
+	AudioOutputADAT(void) : AudioStream(16, inputQueueArray) { begin(); }
 	virtual void update(void);
 	void begin(void);
 	static void mute_PCM(const bool mute);
 protected:
-	AudioOutputADAT(int dummy): AudioStream(8, inputQueueArray) {}
+	AudioOutputADAT(int dummy): AudioStream(16, inputQueueArray) {}
 	static void config_ADAT(void);
-	static audio_block_t *block_ch1_1st;
-	static audio_block_t *block_ch2_1st;
-	static audio_block_t *block_ch3_1st;
-	static audio_block_t *block_ch4_1st;
-	static audio_block_t *block_ch5_1st;
-	static audio_block_t *block_ch6_1st;
-	static audio_block_t *block_ch7_1st;
-	static audio_block_t *block_ch8_1st;
 	static bool update_responsibility;
 	static DMAChannel dma;
 	static void isr(void);
 	static void setI2SFreq(int freq);
 private:
 	//static uint32_t vucp;
-	static audio_block_t *block_ch1_2nd;
-	static audio_block_t *block_ch2_2nd;
-	static audio_block_t *block_ch3_2nd;
-	static audio_block_t *block_ch4_2nd;
-	static audio_block_t *block_ch5_2nd;
-	static audio_block_t *block_ch6_2nd;
-	static audio_block_t *block_ch7_2nd;
-	static audio_block_t *block_ch8_2nd;
-	static uint16_t ch1_offset;
-	static uint16_t ch2_offset;
-	static uint16_t ch3_offset;
-	static uint16_t ch4_offset;
-	static uint16_t ch5_offset;
-	static uint16_t ch6_offset;
-	static uint16_t ch7_offset;
-	static uint16_t ch8_offset;
-	audio_block_t *inputQueueArray[8];
+	static void encode_silence(uint32_t *dest, uint32_t level);
+	static volatile uint8_t next_half;   // the half of the buffer sent next
+	static volatile uint8_t next_ready;  // next_half holds the next block
+	static volatile uint16_t block_count; // DMA interrupts, to detect a late update()
+	audio_block_t *inputQueueArray[16];
 };
 
 
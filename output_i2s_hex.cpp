@@ -131,20 +131,8 @@ void AudioOutputI2SHex::isr(void)
 	src4 = (block_ch4_1st) ? block_ch4_1st->data + ch4_offset : zeros;
 	src5 = (block_ch5_1st) ? block_ch5_1st->data + ch5_offset : zeros;
 	src6 = (block_ch6_1st) ? block_ch6_1st->data + ch6_offset : zeros;
-#if 0
-	// TODO: optimized 6 channel copy...
-	memcpy_tointerleaveQuad(dest, src1, src2, src3, src4);
-#else
-	int16_t *p=dest;
-	for (int i=0; i < AUDIO_BLOCK_SAMPLES/2; i++) {
-		*p++ = *src1++;
-		*p++ = *src3++;
-		*p++ = *src5++;
-		*p++ = *src2++;
-		*p++ = *src4++;
-		*p++ = *src6++;
-	}
-#endif
+	const int16_t *src[6] = {src1, src3, src5, src2, src4, src6};
+	memcpy_tointerleave16(dest, src, 6, AUDIO_BLOCK_SAMPLES/2);
 	arm_dcache_flush_delete(dest, sizeof(i2s_tx_buffer) / 2);
 
 	if (block_ch1_1st) {
@@ -131,22 +131,8 @@ void AudioOutputI2SOct::isr(void)
 	src6 = (block_ch6_1st) ? block_ch6_1st->data + ch6_offset : zeros;
 	src7 = (block_ch7_1st) ? block_ch7_1st->data + ch7_offset : zeros;
 	src8 = (block_ch8_1st) ? block_ch8_1st->data + ch8_offset : zeros;
-#if 0
-	// TODO: optimized 8 channel copy...
-	memcpy_tointerleaveQuad(dest, src1, src2, src3, src4);
-#else
-	int16_t *p=dest;
-	for (int i=0; i < AUDIO_BLOCK_SAMPLES/2; i++) {
-		*p++ = *src1++;
-		*p++ = *src3++;
-		*p++ = *src5++;
-		*p++ = *src7++;
-		*p++ = *src2++;
-		*p++ = *src4++;
-		*p++ = *src6++;
-		*p++ = *src8++;
-	}
-#endif
+	const int16_t *src[8] = {src1, src3, src5, src7, src2, src4, src6, src8};
+	memcpy_tointerleave16(dest, src, 8, AUDIO_BLOCK_SAMPLES/2);
 	arm_dcache_flush_delete(dest, sizeof(i2s_tx_buffer) / 2);
 
 	if (block_ch1_1st) {
@@ -26,41 +26,37 @@
 #include <Arduino.h>
 #include "output_spdif.h"
 #include "utility/imxrt_hw.h"
+#include "utility/spdif_encode.h"
 
-audio_block_t * AudioOutputSPDIF::block_left_1st = NULL;
-audio_block_t * AudioOutputSPDIF::block_right_1st = NULL;
-audio_block_t * AudioOutputSPDIF::block_left_2nd = NULL;
-audio_block_t * AudioOutputSPDIF::block_right_2nd = NULL;
-uint16_t  AudioOutputSPDIF::block_left_offset = 0;
-uint16_t  AudioOutputSPDIF::block_right_offset = 0;
 bool AudioOutputSPDIF::update_responsibility = false;
 DMAChannel AudioOutputSPDIF::dma(false);
-extern uint16_t spdif_bmclookup[256];
+// one block in each half, which update() encodes directly
 DMAMEM __attribute__((aligned(32)))
-static uint32_t SPDIF_tx_buffer[AUDIO_BLOCK_SAMPLES * 4]; //2 KB
+static uint32_t SPDIF_tx_buffer[2][AUDIO_BLOCK_SAMPLES * 4]; //4 KB
 
 #if defined(KINETISK) || defined(__IMXRT1062__)
 
-#define PREAMBLE_B  (0xE8) //11101000
-#define PREAMBLE_M  (0xE2) //11100010
-#define PREAMBLE_W  (0xE4) //11100100
-
-#define VUCP_VALID   ((0xCC) << 24)
-#define VUCP_INVALID ((0xD4) << 24)// To mute PCM, set VUCP = invalid.
-
-uint32_t  AudioOutputSPDIF::vucp = VUCP_VALID;
+static const int16_t zerodata[AUDIO_BLOCK_SAMPLES] = {0};
 
+uint32_t  AudioOutputSPDIF::validity = 0;
+volatile uint16_t  AudioOutputSPDIF::frame = 0;
+volatile uint8_t  AudioOutputSPDIF::next_half = 0;
+volatile uint8_t  AudioOutputSPDIF::next_ready = 0;
+volatile uint16_t  AudioOutputSPDIF::block_count = 0;
 
 FLASHMEM
 void AudioOutputSPDIF::begin(void)
 {
 
-	memset(SPDIF_tx_buffer,0,sizeof SPDIF_tx_buffer); // ensure we start with silence
+	// start with silence in both halves, the first frame with the B preamble
+	uint16_t n = 191;
+	spdif_encode_silence(SPDIF_tx_buffer[0], AUDIO_BLOCK_SAMPLES, validity, &n);
+	frame = n;
+	spdif_encode_silence(SPDIF_tx_buffer[1], AUDIO_BLOCK_SAMPLES, validity, &n);
+	next_half = 0;
+	next_ready = 1;
 	dma.begin(true); // Allocate the DMA channel first
 
-	block_left_1st = NULL;
-	block_right_1st = NULL;
-
 	// TODO: should we set & clear the I2S_TCSR_SR bit here?
 	config_SPDIF();
 #if defined(KINETISK)
@@ -118,187 +114,94 @@ void AudioOutputSPDIF::begin(void)
 
  http://www.hardwarebook.info/S/PDIF
 
- 1. To make it easier and a bit faster, the parity-bit is always the same.
-	- With a alternating parity we had to adjust the next subframe. Instead, use a bit from the aux-info as parity.
+ The DMA sends one block from each half of the transmit buffer, with an
+ interrupt as it begins each half.  update() biphase-mark encodes the next
+ block (utility/spdif_encode.h) directly into the other half, so the
+ interrupt copies no data.  Only if update() did not fill a half in time
+ does the interrupt encode silence into the next one.
 
- 2. The buffer is filled with an offset of 1 byte, so the last parity (which is always 0 now (see 1.) ) is written as first byte.
-	-> A bit easier and faster to construct both subframes.
+ The interrupt counts the frames, so each block's B preambles fall every
+ 192 frames of the stream, wherever in it update() encodes the block.
+
+ Inputs 2 and 3 optionally extend the left and right samples to 24 bits:
+ the upper byte of each sample supplies audio bits 0-7.
 
 */
 
 void AudioOutputSPDIF::isr(void)
 {
-	static uint16_t frame = 0;
-	const int16_t *src;
-	int32_t *end, *dest;
-	audio_block_t *block;
-	uint32_t saddr, offset;
-	uint16_t sample, lo, hi, aux;
+	uint32_t saddr, half;
+	uint16_t n;
 
-#if defined(KINETISK) || defined(__IMXRT1062__)
 	saddr = (uint32_t)(dma.TCD->SADDR);
-#endif
 	dma.clearInterrupt();
-	if (saddr < (uint32_t)SPDIF_tx_buffer + sizeof(SPDIF_tx_buffer) / 2) {
-		// DMA is transmitting the first half of the buffer
-		// so we must fill the second half
-		dest = (int32_t *)&SPDIF_tx_buffer[AUDIO_BLOCK_SAMPLES * 4/2];
-		end = (int32_t *)&SPDIF_tx_buffer[AUDIO_BLOCK_SAMPLES * 4];
-		if (AudioOutputSPDIF::update_responsibility) AudioStream::update_all();
-	} else {
-		// DMA is transmitting the second half of the buffer
-		// so we must fill the first half
-		dest = (int32_t *)SPDIF_tx_buffer;
-		end = (int32_t *)&SPDIF_tx_buffer[AUDIO_BLOCK_SAMPLES * 4/2];
-	}
-
-
-	block = AudioOutputSPDIF::block_left_1st;
-	if (block) {
-		offset = AudioOutputSPDIF::block_left_offset;
-		src = &block->data[offset];
-		do {
-
-			sample = *src++;
-
-			//Subframe Channel 1
-			hi  = spdif_bmclookup[(uint8_t)(sample >> 8)];
-			lo  = spdif_bmclookup[(uint8_t) sample];
-			lo ^= (~((int16_t)hi) >> 16);
-			// 16 Bit sample:
-			*(dest+1) = ((uint32_t)lo << 16) | hi;
-			// 4 Bit Auxillary-audio-databits, the first used as parity
-			aux = (0xB333 ^ (((uint32_t)((int16_t)lo)) >> 17));
-
-			if (++frame > 191) {
-				// VUCP-Bits ("Valid, Subcode, Channelstatus, Parity) = 0 (0xcc) | Preamble (depends on Framno.) | Auxillary
-				*(dest+0) =  vucp | (PREAMBLE_B << 16 ) | aux; //special preamble for one of 192 frames
-				frame = 0;
-			} else {
-				*(dest+0) = vucp | (PREAMBLE_M << 16 ) | aux;
-			}
-			dest += 4;
-
-		} while (dest < end);
-		offset += AUDIO_BLOCK_SAMPLES/2;
-		if (offset < AUDIO_BLOCK_SAMPLES) {
-			AudioOutputSPDIF::block_left_offset = offset;
-		} else {
-			AudioOutputSPDIF::block_left_offset = 0;
-			AudioStream::release(block);
-			AudioOutputSPDIF::block_left_1st = AudioOutputSPDIF::block_left_2nd;
-			AudioOutputSPDIF::block_left_2nd = NULL;
-		}
-	} else {
-		do {
-			if ( ++frame > 191 ) {
-				*(dest+0) = vucp | 0x00e8cccc;
-				frame = 0;
-			} else {
-				*(dest+0) = vucp | 0x00e2cccc;
-			}
-			*(dest+1) = 0xccccccccUL;
-
-			dest +=4;
-		} while (dest < end);
-	}
-
-
-	dest -= AUDIO_BLOCK_SAMPLES * 4/2 - 4/2;
-	block = AudioOutputSPDIF::block_right_1st;
-	if (block) {
-		offset = AudioOutputSPDIF::block_right_offset;
-		src = &block->data[offset];
-
-		do {
-			sample = *src++;
-
-			//Subframe Channel 2
-			hi  = spdif_bmclookup[(uint8_t)(sample >> 8)];
-			lo  = spdif_bmclookup[(uint8_t)sample];
-			lo ^= (~((int16_t)hi) >> 16);
-
-			*(dest+1) = ( ((uint32_t)lo << 16) | hi );
-
-			aux = (0xB333 ^ (((uint32_t)((int16_t)lo)) >> 17));
-			*(dest+0)  =  vucp | (PREAMBLE_W << 16 ) | aux;
-
-			dest += 4;
-		} while (dest < end);
-
-		offset += AUDIO_BLOCK_SAMPLES/2;
-		if (offset < AUDIO_BLOCK_SAMPLES) {
-			AudioOutputSPDIF::block_right_offset = offset;
-		} else {
-			AudioOutputSPDIF::block_right_offset = 0;
-			AudioStream::release(block);
-			AudioOutputSPDIF::block_right_1st = AudioOutputSPDIF::block_right_2nd;
-			AudioOutputSPDIF::block_right_2nd = NULL;
-		}
+	// the DMA has begun transmitting one half of the buffer,
+	// so the other half is transmitted next
+	half = (saddr < (uint32_t)SPDIF_tx_buffer[1]) ? 1 : 0;
+	n = (AudioOutputSPDIF::frame + AUDIO_BLOCK_SAMPLES) % 192;
+	AudioOutputSPDIF::frame = n;
+	AudioOutputSPDIF::next_half = half;
+	AudioOutputSPDIF::block_count++;
+	if (AudioOutputSPDIF::next_ready) {
+		AudioOutputSPDIF::next_ready = 0;
 	} else {
-		do {
-			*dest 	= vucp | 0x00e4ccccUL;
-			*(dest+1) = 0xccccccccUL;
-			dest += 4 ;
-		} while (dest < end);
-	}
-
+		// update() has fallen behind, or is not running, so the
+		// DMA is repeating an old block.  Send silence after it.
+		uint32_t *dest = SPDIF_tx_buffer[half];
+		spdif_encode_silence(dest, AUDIO_BLOCK_SAMPLES, AudioOutputSPDIF::validity, &n);
 	#if IMXRT_CACHE_ENABLED >= 2
-	dest -= AUDIO_BLOCK_SAMPLES * 4/2 + 4/2;
-	arm_dcache_flush_delete(dest, sizeof(SPDIF_tx_buffer) / 2 );
-	#endif	
-	
+		arm_dcache_flush_delete(dest, sizeof(SPDIF_tx_buffer) / 2 );
+	#endif
+		AudioOutputSPDIF::next_ready = 1;
+	}
+	if (AudioOutputSPDIF::update_responsibility) AudioStream::update_all();
 }
 
 void AudioOutputSPDIF::mute_PCM(const bool mute)
 {
-	vucp = mute?VUCP_INVALID:VUCP_VALID;
+	validity = mute ? 1 : 0;
 }
 
 void AudioOutputSPDIF::update(void)
 {
-
-	audio_block_t *block;
-	block = receiveReadOnly(0); // input 0 = left channel
-	if (block) {
-
-		__disable_irq();
-		if (block_left_1st == NULL) {
-			block_left_1st = block;
-			block_left_offset = 0;
-			__enable_irq();
-		} else if (block_left_2nd == NULL) {
-			block_left_2nd = block;
-			__enable_irq();
-		} else {
-			audio_block_t *tmp = block_left_1st;
-			block_left_1st = block_left_2nd;
-			block_left_2nd = block;
-			block_left_offset = 0;
-			__enable_irq();
-			release(tmp);
-		}
-	}
-	block = receiveReadOnly(1); // input 1 = right channel
-	if (block) {
-		__disable_irq();
-		if (block_right_1st == NULL) {
-			block_right_1st = block;
-			block_right_offset = 0;
-			__enable_irq();
-		} else if (block_right_2nd == NULL) {
-			block_right_2nd = block;
-			__enable_irq();
-		} else {
-			audio_block_t *tmp = block_right_1st;
-			block_right_1st = block_right_2nd;
-			block_right_2nd = block;
-			block_right_offset = 0;
-			__enable_irq();
-			release(tmp);
-		}
+	audio_block_t *left, *right, *left_lsb, *right_lsb;
+	uint32_t *dest, half;
+	uint16_t n, count;
+
+	left = receiveReadOnly(0); // input 0 = left channel
+	right = receiveReadOnly(1); // input 1 = right channel
+	left_lsb = receiveReadOnly(2); // input 2 = left channel, bits 0-7 of 24
+	right_lsb = receiveReadOnly(3); // input 3 = right channel, bits 0-7 of 24
+
+	// the half to fill, and the frame count where it begins, which
+	// only the interrupt changes
+	__disable_irq();
+	half = next_half;
+	n = frame;
+	count = block_count;
+	__enable_irq();
+
+	dest = SPDIF_tx_buffer[half];
+	if (left || right || left_lsb || right_lsb) {
+		spdif_encode_frames(dest, AUDIO_BLOCK_SAMPLES,
+			left ? left->data : zerodata, left_lsb ? left_lsb->data : zerodata,
+			right ? right->data : zerodata, right_lsb ? right_lsb->data : zerodata,
+			validity, &n);
+		if (left) release(left);
+		if (right) release(right);
+		if (left_lsb) release(left_lsb);
+		if (right_lsb) release(right_lsb);
+	} else {
+		spdif_encode_silence(dest, AUDIO_BLOCK_SAMPLES, validity, &n);
 	}
+	#if IMXRT_CACHE_ENABLED >= 2
+	arm_dcache_flush_delete(dest, sizeof(SPDIF_tx_buffer) / 2 );
+	#endif
 
+	__disable_irq();
+	// if the DMA has already begun this half, it is too late
+	if (block_count == count) next_ready = 1;
+	__enable_irq();
 }
 
 #if defined(KINETISK)
@@ -454,6 +357,10 @@ void AudioOutputSPDIF::update(void)
 	if (block) release(block);
 	block = receiveReadOnly(1); // input 1 = right channel
 	if (block) release(block);
+	block = receiveReadOnly(2); // input 2 = left channel, bits 0-7 of 24
+	if (block) release(block);
+	block = receiveReadOnly(3); // input 3 = right channel, bits 0-7 of 24
+	if (block) release(block);
 }
 
 #endif
@@ -31,7 +31,7 @@
 class AudioOutputSPDIF : public AudioStream
 {
 public:
-	AudioOutputSPDIF(void) : AudioStream(2, inputQueueArray) { begin(); }
+	AudioOutputSPDIF(void) : AudioStream(4, inputQueueArray) { begin(); }
 	virtual void update(void);
 	void begin(void);
 	//friend class AudioInputSPDIF;
@@ -39,18 +39,16 @@ public:
 protected:
 	//AudioOutputSPDIF(int dummy): AudioStream(2, inputQueueArray) {}
 	static void config_SPDIF(void);
-	static audio_block_t *block_left_1st;
-	static audio_block_t *block_right_1st;
 	static bool update_responsibility;
 	static DMAChannel dma;
 	static void isr(void);
 private:
-	static uint32_t vucp;
-	static audio_block_t *block_left_2nd;
-	static audio_block_t *block_right_2nd;
-	static uint16_t block_left_offset;
-	static uint16_t block_right_offset;
-	audio_block_t *inputQueueArray[2];
+	static uint32_t validity;
+	static volatile uint16_t frame;  // frames since the last B preamble, before next_half
+	static volatile uint8_t next_half;   // the half of the buffer sent next
+	static volatile uint8_t next_ready;  // next_half holds the next block
+	static volatile uint16_t block_count; // DMA interrupts, to detect a late update()
+	audio_block_t *inputQueueArray[4];
 };
 
 
@@ -30,12 +30,17 @@
 
 #include "output_tdm.h"
 #include "memcpy_audio.h"
+#include "utility/dspinst.h"
 #include "utility/imxrt_hw.h"
 
 audio_block_t * AudioOutputTDM::block_input[16] = {
 	nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
 	nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
 };
+int32_t AudioOutputTDM::multiplier[16] = {
+	65536, 65536, 65536, 65536, 65536, 65536, 65536, 65536,
+	65536, 65536, 65536, 65536, 65536, 65536, 65536, 65536
+};
 bool AudioOutputTDM::update_responsibility = false;
 DMAChannel AudioOutputTDM::dma(false);
 DMAMEM __attribute__((aligned(32)))
@@ -105,26 +110,32 @@ void AudioOutputTDM::begin(void)
 #endif
 }
 
-// TODO: needs optimization...
-static void memcpy_tdm_tx(uint32_t *dest, const uint32_t *src1, const uint32_t *src2)
+// interleave 2 channels into their 32 bit TDM slot, scaling & saturating
+// each channel, so the output gain costs no extra pass over the data
+static void memcpy_tdm_tx_gain(uint32_t *dest, const uint32_t *src1, const uint32_t *src2,
+	int32_t mult1, int32_t mult2)
 {
-	uint32_t i, in1, in2, out1, out2;
+	uint32_t i, in1, in2;
+	int32_t a0, a1, b0, b1;
 
 	for (i=0; i < AUDIO_BLOCK_SAMPLES/4; i++) {
-
 		in1 = *src1++;
 		in2 = *src2++;
-		out1 = (in1 << 16) | (in2 & 0xFFFF);
-		out2 = (in1 & 0xFFFF0000) | (in2 >> 16);
-		*dest = out1;
-		*(dest + 8) = out2;
+		a0 = signed_saturate_rshift(signed_multiply_32x16b(mult1, in1), 16, 0);
+		a1 = signed_saturate_rshift(signed_multiply_32x16t(mult1, in1), 16, 0);
+		b0 = signed_saturate_rshift(signed_multiply_32x16b(mult2, in2), 16, 0);
+		b1 = signed_saturate_rshift(signed_multiply_32x16t(mult2, in2), 16, 0);
+		*dest = pack_16b_16b(a0, b0);
+		*(dest + 8) = pack_16b_16b(a1, b1);
 
 		in1 = *src1++;
 		in2 = *src2++;
-		out1 = (in1 << 16) | (in2 & 0xFFFF);
-		out2 = (in1 & 0xFFFF0000) | (in2 >> 16);
-		*(dest + 16)= out1;
-		*(dest + 24) = out2;
+		a0 = signed_saturate_rshift(signed_multiply_32x16b(mult1, in1), 16, 0);
+		a1 = signed_saturate_rshift(signed_multiply_32x16t(mult1, in1), 16, 0);
+		b0 = signed_saturate_rshift(signed_multiply_32x16b(mult2, in2), 16, 0);
+		b1 = signed_saturate_rshift(signed_multiply_32x16t(mult2, in2), 16, 0);
+		*(dest + 16) = pack_16b_16b(a0, b0);
+		*(dest + 24) = pack_16b_16b(a1, b1);
 
 		dest += 32;
 	}
@@ -155,11 +166,27 @@ void AudioOutputTDM::isr(void)
 	uint32_t *dc = dest;
 	#endif
 	
-	for (i=0; i < 16; i += 2) {
-		src1 = block_input[i] ? (uint32_t *)(block_input[i]->data) : zeros;
-		src2 = block_input[i+1] ? (uint32_t *)(block_input[i+1]->data) : zeros;
-		memcpy_tdm_tx(dest, src1, src2);
-		dest++;
+	for (i=0; i < 16; i++) {
+		if (multiplier[i] != 65536) break;
+	}
+	if (i == 16) {
+		// all unity gain: each 32 bit word holds 2 channels, the odd
+		// channel in the low 16 bits, so swap each pair for slot order
+		const int16_t *src[16];
+		for (i=0; i < 16; i += 2) {
+			src[i] = block_input[i+1] ? block_input[i+1]->data : (const int16_t *)zeros;
+			src[i+1] = block_input[i] ? block_input[i]->data : (const int16_t *)zeros;
+		}
+		memcpy_tointerleave16((int16_t *)dest, src, 16, AUDIO_BLOCK_SAMPLES);
+	} else {
+		for (i=0; i < 16; i += 2) {
+			int32_t mult1 = multiplier[i];
+			int32_t mult2 = multiplier[i+1];
+			src1 = (block_input[i] && mult1 != 0) ? (uint32_t *)(block_input[i]->data) : zeros;
+			src2 = (block_input[i+1] && mult2 != 0) ? (uint32_t *)(block_input[i+1]->data) : zeros;
+			memcpy_tdm_tx_gain(dest, src1, src2, mult1, mult2);
+			dest++;
+		}
 	}
 
 	#if IMXRT_CACHE_ENABLED >= 2
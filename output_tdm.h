@@ -37,10 +37,19 @@ public:
 	AudioOutputTDM(void) : AudioStream(16, inputQueueArray) { begin(); }
 	virtual void update(void);
 	void begin(void);
+	// Gain is applied while the DMA buffer is filled, so an amplifier
+	// or mixer in front of each channel is not needed to set levels.
+	void gain(unsigned int channel, float level) {
+		if (channel >= 16) return;
+		if (level > 32767.0f) level = 32767.0f;
+		else if (level < -32767.0f) level = -32767.0f;
+		multiplier[channel] = level * 65536.0f;
+	}
 	friend class AudioInputTDM;
 protected:
 	static void config_tdm(void);
 	static audio_block_t *block_input[16];
+	static int32_t multiplier[16];
 	static bool update_responsibility;
 	static DMAChannel dma;
 	static void isr(void);
@@ -70,6 +70,19 @@ void AudioPlayMemory::update(void)
 	in = next;
 	s0 = prior;
 
+#if AUDIO_BLOCK_SAMPLES > 128
+	// the data is only padded to a multiple of 128 samples, so the
+	// last block is read from a copy, with silence after the end
+	uint32_t last[AUDIO_BLOCK_SAMPLES/2];
+	uint32_t words = (playing & 0x80) ? (length + 1) / 2 : (length + 3) / 4;
+	uint32_t needed = AUDIO_BLOCK_SAMPLES >> (((playing & 0x80) ? 0 : 1) + (playing & 3));
+	if (words < needed) {
+		memcpy(last, in, words * 4);
+		memset(last + words, 0, (needed - words) * 4);
+		in = last;
+	}
+#endif
+
 	switch (playing) {
 	  case 0x01: // u-law encoded, 44100 Hz
 		for (i=0; i < AUDIO_BLOCK_SAMPLES; i += 4) {
@@ -39,6 +39,13 @@ int AudioRecordQueue::available(void)
 	return max_buffers + h - t;
 }
 
+void AudioRecordQueue::setMaxBuffers(uint8_t n)
+{
+	if (n < 1) n = 1;
+	if (n > max_buffers - 1) n = max_buffers - 1;
+	max_queued = n;
+}
+
 void AudioRecordQueue::clear(void)
 {
 	uint32_t t;
@@ -86,14 +93,17 @@ void AudioRecordQueue::update(void)
 		release(block);
 		return;
 	}
-	h = head + 1;
-	if (h >= max_buffers) h = 0;
-	if (h == tail) {
+	if (available() >= max_queued) {
 		release(block);
-	} else {
-		queue[h] = block;
-		head = h;
+		dropped++;
+		return;
 	}
+	h = head + 1;
+	if (h >= max_buffers) h = 0;
+	queue[h] = block;
+	head = h;
+	uint32_t n = memoryUsage();
+	if (n > usage_max) usage_max = n;
 }
 
 
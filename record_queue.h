@@ -40,7 +40,8 @@ private:
 #endif
 public:
 	AudioRecordQueue(void) : AudioStream(1, inputQueueArray),
-		userblock(NULL), head(0), tail(0), enabled(0) { }
+		userblock(NULL), head(0), tail(0), enabled(0),
+		max_queued(max_buffers - 1), usage_max(0), dropped(0) { }
 	void begin(void) {
 		clear();
 		enabled = 1;
@@ -52,12 +53,22 @@ public:
 	void end(void) {
 		enabled = 0;
 	}
+	void setMaxBuffers(uint8_t n);
+	int memoryUsage(void) {
+		return available() + (userblock ? 1 : 0);
+	}
+	int memoryUsageMax(void) { return usage_max; }
+	void memoryUsageMaxReset(void) { usage_max = memoryUsage(); }
+	uint32_t droppedBlocks(void) { return dropped; }
 	virtual void update(void);
 private:
 	audio_block_t *inputQueueArray[1];
 	audio_block_t * volatile queue[max_buffers];
 	audio_block_t *userblock;
 	volatile uint8_t head, tail, enabled;
+	volatile uint8_t max_queued;  // limit on blocks waiting in the queue
+	volatile uint8_t usage_max;   // most blocks held at once
+	volatile uint32_t dropped;    // blocks discarded because queue was full
 };
 
 #endif
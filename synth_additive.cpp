@@ -0,0 +1,126 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if !defined(KINETISL)
+
+#include <Arduino.h>
+#include "synth_additive.h"
+#include "utility/dspinst.h"
+
+// Each partial is a unit phasor, rotated by the partial's frequency every
+// sample, which needs only 4 multiplies and no table or phase wrapping.
+// Amplitude changes ramp linearly over 128 samples at any block size, and
+// frequency changes take effect at the next block without any phase
+// discontinuity.  Rounding makes the phasor's length drift very slowly, so
+// it is corrected once per block.  Silent partials, and partials above
+// half the sample rate, are skipped.
+
+#define SILENT (1.0f / 65536.0f)
+
+void AudioSynthAdditive::setpartial(unsigned int index)
+{
+	float f = freq[index];
+	float a = level[index];
+	float cw = 1.0f, sw = 0.0f;
+
+	if (f > 0.0f && f < AUDIO_SAMPLE_RATE_EXACT * 0.5f) {
+		float w = f * (float)(2.0 * M_PI / AUDIO_SAMPLE_RATE_EXACT);
+		cw = cosf(w);
+		sw = sinf(w);
+	} else {
+		a = 0.0f;
+	}
+	__disable_irq();
+	partials[index].cosw = cw;
+	partials[index].sinw = sw;
+	partials[index].target = a;
+	partials[index].inc = (a - partials[index].amp) * (1.0f / ADDITIVE_RAMP_SAMPLES);
+	partials[index].ramp = ADDITIVE_RAMP_SAMPLES;
+	if (a > 0.0f && index >= count) count = index + 1;
+	__enable_irq();
+}
+
+void AudioSynthAdditive::update(void)
+{
+	audio_block_t *block;
+	float sum[AUDIO_BLOCK_SAMPLES];
+	unsigned int i, n, num=0;
+
+	const unsigned int end = count;
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) sum[i] = 0.0f;
+	unsigned int last = 0;
+	for (n=0; n < end; n++) {
+		struct partial_state *p = &partials[n];
+		float amp = p->amp;
+		const float target = p->target;
+		if (amp < SILENT && target < SILENT) {
+			p->amp = target;
+			p->ramp = 0;
+			continue;
+		}
+		last = n + 1;
+		num++;
+		float c = p->c, s = p->s;
+		const float cw = p->cosw, sw = p->sinw;
+		const float inc = p->inc;
+		const unsigned int ramp = (p->ramp < AUDIO_BLOCK_SAMPLES) ? p->ramp : AUDIO_BLOCK_SAMPLES;
+		for (i=0; i < ramp; i++) {
+			float t = c * cw - s * sw;
+			s = s * cw + c * sw;
+			c = t;
+			amp += inc;
+			sum[i] += amp * s;
+		}
+		if (ramp > 0) {
+			p->ramp -= ramp;
+			if (p->ramp == 0) amp = target;
+		}
+		for (; i < AUDIO_BLOCK_SAMPLES; i++) {
+			float t = c * cw - s * sw;
+			s = s * cw + c * sw;
+			c = t;
+			sum[i] += amp * s;
+		}
+		float g = 1.5f - 0.5f * (c * c + s * s);
+		p->c = c * g;
+		p->s = s * g;
+		p->amp = amp;
+	}
+	count = last;
+	active = num;
+	if (num == 0) return;
+
+	block = allocate();
+	if (!block) return;
+	const float scale = magnitude * 32767.0f;
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		block->data[i] = saturate16((int32_t)(sum[i] * scale));
+	}
+	transmit(block);
+	release(block);
+}
+
+#endif
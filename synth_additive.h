@@ -0,0 +1,107 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef synth_additive_h_
+#define synth_additive_h_
+
+#if !defined(KINETISL)
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+#define ADDITIVE_MAX_PARTIALS 256
+#define ADDITIVE_RAMP_SAMPLES 128	// amplitude changes take 2.9 ms
+
+class AudioSynthAdditive : public AudioStream
+{
+public:
+	AudioSynthAdditive() : AudioStream(0, NULL) {
+		for (int i=0; i < ADDITIVE_MAX_PARTIALS; i++) {
+			partials[i].c = 1.0f;
+			partials[i].s = 0.0f;
+			partials[i].cosw = 1.0f;
+			partials[i].sinw = 0.0f;
+			partials[i].amp = 0.0f;
+			partials[i].target = 0.0f;
+			partials[i].inc = 0.0f;
+			partials[i].ramp = 0;
+			level[i] = 0.0f;
+			freq[i] = 0.0f;
+		}
+	}
+	// Set the frequency (Hz) and amplitude (0 to 1.0) of one partial.
+	void partial(unsigned int index, float frequency, float amplitude) {
+		if (index >= ADDITIVE_MAX_PARTIALS) return;
+		level[index] = (amplitude > 0.0f) ? amplitude : 0.0f;
+		freq[index] = frequency;
+		setpartial(index);
+	}
+	void frequency(unsigned int index, float frequency) {
+		if (index >= ADDITIVE_MAX_PARTIALS) return;
+		freq[index] = frequency;
+		setpartial(index);
+	}
+	void amplitude(unsigned int index, float amplitude) {
+		if (index >= ADDITIVE_MAX_PARTIALS) return;
+		level[index] = (amplitude > 0.0f) ? amplitude : 0.0f;
+		setpartial(index);
+	}
+	// Set partials 0 to count-1 to harmonics of the fundamental.
+	void harmonics(float fundamental, const float *levels, unsigned int count) {
+		if (count > ADDITIVE_MAX_PARTIALS) count = ADDITIVE_MAX_PARTIALS;
+		for (unsigned int i=0; i < count; i++) {
+			partial(i, fundamental * (float)(i + 1), levels[i]);
+		}
+	}
+	// Overall output level, applied after all partials are summed.
+	void amplitude(float n) {
+		if (n < 0.0f) n = 0.0f;
+		magnitude = n;
+	}
+	// Number of partials computed during the most recent update.
+	unsigned int activePartials(void) { return active; }
+	virtual void update(void);
+private:
+	struct partial_state {
+		float c, s;		// unit phasor, the output is s
+		float cosw, sinw;	// rotation per sample
+		float amp;		// amplitude now
+		float target;		// amplitude at the end of the ramp
+		float inc;		// amplitude change per sample
+		unsigned int ramp;	// samples left until amp reaches target
+	};
+	void setpartial(unsigned int index);
+	struct partial_state partials[ADDITIVE_MAX_PARTIALS];
+	float level[ADDITIVE_MAX_PARTIALS];
+	float freq[ADDITIVE_MAX_PARTIALS];
+	float magnitude = 1.0f;
+	uint16_t count = 0;		// partials above this are all unused
+	volatile uint16_t active = 0;
+};
+
+#endif
+
+#endif
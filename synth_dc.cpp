@@ -33,6 +33,10 @@ void AudioSynthWaveformDc::update(void)
 	uint32_t *p, *end, val;
 	int32_t count, t1, t2, t3, t4;
 
+	if (state == 0 && magnitude == 0) {
+		// steady zero output, transmit nothing (silence)
+		return;
+	}
 	block = allocate();
 	if (!block) return;
 	p = (uint32_t *)(block->data);
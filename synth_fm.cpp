@@ -0,0 +1,454 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <Arduino.h>
+#include "synth_fm.h"
+
+// data_waveforms.c
+extern "C" {
+extern const int16_t AudioWaveformSine[257];
+}
+
+#define STAGE_IDLE	0
+#define STAGE_ATTACK	1
+#define STAGE_DECAY	2
+#define STAGE_SUSTAIN	3
+#define STAGE_RELEASE	4
+
+// One entry per algorithm, operators numbered 1 to 6 as in the charts.
+// mod[n] lists which operators modulate operator n+1.
+struct fm_algorithm {
+	uint8_t mod[FM_OPERATORS];
+	uint8_t carriers;
+	uint8_t fb_from;
+	uint8_t fb_to;
+};
+
+#define OP(n) (1 << ((n) - 1))
+
+static const struct fm_algorithm algorithms[FM_ALGORITHMS] = {
+	{{OP(2), 0, OP(4), OP(5), OP(6), 0}, OP(1)|OP(3), 6, 6},		// 1
+	{{OP(2), 0, OP(4), OP(5), OP(6), 0}, OP(1)|OP(3), 2, 2},		// 2
+	{{OP(2), OP(3), 0, OP(5), OP(6), 0}, OP(1)|OP(4), 6, 6},		// 3
+	{{OP(2), OP(3), 0, OP(5), OP(6), 0}, OP(1)|OP(4), 4, 6},		// 4
+	{{OP(2), 0, OP(4), 0, OP(6), 0}, OP(1)|OP(3)|OP(5), 6, 6},		// 5
+	{{OP(2), 0, OP(4), 0, OP(6), 0}, OP(1)|OP(3)|OP(5), 5, 6},		// 6
+	{{OP(2), 0, OP(4)|OP(5), 0, OP(6), 0}, OP(1)|OP(3), 6, 6},		// 7
+	{{OP(2), 0, OP(4)|OP(5), 0, OP(6), 0}, OP(1)|OP(3), 4, 4},		// 8
+	{{OP(2), 0, OP(4)|OP(5), 0, OP(6), 0}, OP(1)|OP(3), 2, 2},		// 9
+	{{OP(2), OP(3), 0, OP(5)|OP(6), 0, 0}, OP(1)|OP(4), 3, 3},		// 10
+	{{OP(2), OP(3), 0, OP(5)|OP(6), 0, 0}, OP(1)|OP(4), 6, 6},		// 11
+	{{OP(2), 0, OP(4)|OP(5)|OP(6), 0, 0, 0}, OP(1)|OP(3), 2, 2},		// 12
+	{{OP(2), 0, OP(4)|OP(5)|OP(6), 0, 0, 0}, OP(1)|OP(3), 6, 6},		// 13
+	{{OP(2), 0, OP(4), OP(5)|OP(6), 0, 0}, OP(1)|OP(3), 6, 6},		// 14
+	{{OP(2), 0, OP(4), OP(5)|OP(6), 0, 0}, OP(1)|OP(3), 2, 2},		// 15
+	{{OP(2)|OP(3)|OP(5), 0, OP(4), 0, OP(6), 0}, OP(1), 6, 6},		// 16
+	{{OP(2)|OP(3)|OP(5), 0, OP(4), 0, OP(6), 0}, OP(1), 2, 2},		// 17
+	{{OP(2)|OP(3)|OP(4), 0, 0, OP(5), OP(6), 0}, OP(1), 3, 3},		// 18
+	{{OP(2), OP(3), 0, OP(6), OP(6), 0}, OP(1)|OP(4)|OP(5), 6, 6},		// 19
+	{{OP(3), OP(3), 0, OP(5)|OP(6), 0, 0}, OP(1)|OP(2)|OP(4), 3, 3},	// 20
+	{{OP(3), OP(3), 0, OP(6), OP(6), 0}, OP(1)|OP(2)|OP(4)|OP(5), 3, 3},	// 21
+	{{OP(2), 0, OP(6), OP(6), OP(6), 0}, OP(1)|OP(3)|OP(4)|OP(5), 6, 6},	// 22
+	{{0, OP(3), 0, OP(6), OP(6), 0}, OP(1)|OP(2)|OP(4)|OP(5), 6, 6},	// 23
+	{{0, 0, OP(6), OP(6), OP(6), 0}, 0x1F, 6, 6},				// 24
+	{{0, 0, 0, OP(6), OP(6), 0}, 0x1F, 6, 6},				// 25
+	{{0, OP(3), 0, OP(5)|OP(6), 0, 0}, OP(1)|OP(2)|OP(4), 6, 6},		// 26
+	{{0, OP(3), 0, OP(5)|OP(6), 0, 0}, OP(1)|OP(2)|OP(4), 3, 3},		// 27
+	{{OP(2), 0, OP(4), OP(5), 0, 0}, OP(1)|OP(3)|OP(6), 5, 5},		// 28
+	{{0, 0, OP(4), 0, OP(6), 0}, OP(1)|OP(2)|OP(3)|OP(5), 6, 6},		// 29
+	{{0, 0, OP(4), OP(5), 0, 0}, OP(1)|OP(2)|OP(3)|OP(6), 5, 5},		// 30
+	{{0, 0, 0, 0, OP(6), 0}, 0x1F, 6, 6},					// 31
+	{{0, 0, 0, 0, 0, 0}, 0x3F, 6, 6},					// 32
+};
+
+void AudioSynthFMBase::init_algorithm(unsigned int n)
+{
+	if (n < 1) n = 1;
+	else if (n > FM_ALGORITHMS) n = FM_ALGORITHMS;
+	const struct fm_algorithm *a = &algorithms[n - 1];
+	for (int to=0; to < FM_OPERATORS; to++) {
+		for (int from=0; from < FM_OPERATORS; from++) {
+			matrix[to][from] = (a->mod[to] & (1 << from)) ? 1.0f : 0.0f;
+		}
+	}
+	carriers = a->carriers;
+	fb_from = a->fb_from - 1;
+	fb_to = a->fb_to - 1;
+	matrix[fb_to][fb_from] = fb_amount;
+	rebuild();
+}
+
+// Compile the modulation matrix into per-operator source lists, and find
+// which operators actually reach the output so the others are skipped.
+void AudioSynthFMBase::rebuild(void)
+{
+	uint32_t needed = carriers;
+	bool changed;
+	do {
+		changed = false;
+		for (int to=0; to < FM_OPERATORS; to++) {
+			if (!(needed & (1 << to))) continue;
+			for (int from=0; from < FM_OPERATORS; from++) {
+				if (matrix[to][from] != 0.0f && !(needed & (1 << from))) {
+					needed |= (1 << from);
+					changed = true;
+				}
+			}
+		}
+	} while (changed);
+	nrun = 0;
+	for (int to=FM_OPERATORS-1; to >= 0; to--) {
+		nsrc[to] = 0;
+		if (!(needed & (1 << to))) continue;
+		order[nrun++] = to;
+		for (int from=0; from < FM_OPERATORS; from++) {
+			if (matrix[to][from] == 0.0f) continue;
+			src[to][nsrc[to]] = from;
+			depth[to][nsrc[to]] = matrix[to][from] * 65536.0f;
+			nsrc[to]++;
+		}
+	}
+}
+
+void AudioSynthFMBase::algorithm(unsigned int n)
+{
+	__disable_irq();
+	init_algorithm(n);
+	__enable_irq();
+}
+
+void AudioSynthFMBase::connect(unsigned int from, unsigned int to, float depth)
+{
+	if (from >= FM_OPERATORS || to >= FM_OPERATORS) return;
+	if (depth < -8.0f) depth = -8.0f;
+	else if (depth > 8.0f) depth = 8.0f;
+	__disable_irq();
+	matrix[to][from] = depth;
+	rebuild();
+	__enable_irq();
+}
+
+void AudioSynthFMBase::carrier(unsigned int op, bool enable)
+{
+	if (op >= FM_OPERATORS) return;
+	__disable_irq();
+	if (enable) {
+		carriers |= (1 << op);
+	} else {
+		carriers &= ~(1 << op);
+	}
+	rebuild();
+	__enable_irq();
+}
+
+void AudioSynthFMBase::feedback(float amount)
+{
+	if (amount < 0.0f) amount = 0.0f;
+	else if (amount > 1.0f) amount = 1.0f;
+	__disable_irq();
+	fb_amount = amount;
+	matrix[fb_to][fb_from] = amount;
+	rebuild();
+	__enable_irq();
+}
+
+void AudioSynthFMBase::voice_init(struct fm_voice *v)
+{
+	for (int i=0; i < FM_OPERATORS; i++) {
+		v->phase[i] = 0;
+		v->amp[i] = 0;
+		v->gain[i] = 0;
+		v->ampinc[i] = 0;
+		v->last[i] = 0;
+		v->fb[i] = 0;
+		v->env[i] = 0.0f;
+		v->stage[i] = STAGE_IDLE;
+	}
+	v->tick = 0;
+	v->note = 0;
+	v->freq = 0.0f;
+	v->velocity = 0.0f;
+	v->age = 0;
+}
+
+void AudioSynthFMBase::voice_on(struct fm_voice *v, float freq, float velocity)
+{
+	if (velocity < 0.0f) velocity = 0.0f;
+	else if (velocity > 1.0f) velocity = 1.0f;
+	bool restart = !voice_active(v);
+	v->freq = (freq > 0.0f) ? freq : 0.0f;
+	v->velocity = velocity;
+	for (int i=0; i < FM_OPERATORS; i++) {
+		// an idle voice restarts its phases so every note begins alike,
+		// a sounding voice attacks from where it is to avoid a click
+		if (restart) {
+			v->phase[i] = 0;
+			v->last[i] = 0;
+			v->fb[i] = 0;
+		}
+		v->stage[i] = STAGE_ATTACK;
+	}
+	v->tick = 0;	// the attack begins with the next sample
+}
+
+void AudioSynthFMBase::voice_off(struct fm_voice *v)
+{
+	for (int i=0; i < FM_OPERATORS; i++) {
+		if (v->stage[i] != STAGE_IDLE) v->stage[i] = STAGE_RELEASE;
+	}
+}
+
+bool AudioSynthFMBase::voice_active(const struct fm_voice *v)
+{
+	for (int i=0; i < FM_OPERATORS; i++) {
+		if ((carriers & (1 << i)) && v->stage[i] != STAGE_IDLE) return true;
+	}
+	return false;
+}
+
+// Loudest carrier envelope, and whether any carrier is still held.
+float AudioSynthFMBase::voice_level(const struct fm_voice *v, bool *held)
+{
+	float level = 0.0f;
+	*held = false;
+	for (int i=0; i < FM_OPERATORS; i++) {
+		if (!(carriers & (1 << i))) continue;
+		if (v->stage[i] != STAGE_RELEASE && v->stage[i] != STAGE_IDLE) *held = true;
+		if (v->env[i] > level) level = v->env[i];
+	}
+	return level;
+}
+
+// Advance the envelopes by one control period, and ramp every operator's
+// gain linearly to its new level across the period.
+void AudioSynthFMBase::advance(struct fm_voice *v)
+{
+	for (uint32_t k=0; k < FM_OPERATORS; k++) {
+		float e = v->env[k];
+		switch (v->stage[k]) {
+		  case STAGE_ATTACK:
+			e += attack_step[k];
+			if (e >= 1.0f) {
+				e = 1.0f;
+				v->stage[k] = STAGE_DECAY;
+			}
+			break;
+		  case STAGE_DECAY:
+			e -= decay_step[k];
+			if (e <= sustain_level[k]) {
+				e = sustain_level[k];
+				v->stage[k] = STAGE_SUSTAIN;
+			}
+			break;
+		  case STAGE_SUSTAIN:
+			e = sustain_level[k];
+			break;
+		  case STAGE_RELEASE:
+			e -= release_step[k];
+			if (e <= 0.0f) {
+				e = 0.0f;
+				v->stage[k] = STAGE_IDLE;
+			}
+			break;
+		  default:
+			e = 0.0f;
+		}
+		v->env[k] = e;
+		int32_t target = e * levels[k] * v->velocity * 65536.0f;
+		v->gain[k] = v->amp[k];
+		v->ampinc[k] = (target - v->amp[k]) / (int32_t)FM_CONTROL_SAMPLES;
+		v->amp[k] = target;
+	}
+	v->tick = FM_CONTROL_SAMPLES;
+}
+
+// Add one voice into sum[].  Envelopes advance every FM_CONTROL_SAMPLES,
+// so they sound the same at any block size.  All operators of the
+// algorithm are evaluated together for each sample, so feedback paths
+// are only one sample long.  A voice which has just become idle still
+// finishes ramping down to silence.
+bool AudioSynthFMBase::render(struct fm_voice *v, int32_t *sum)
+{
+	uint32_t inc[FM_OPERATORS];
+	int32_t out[FM_OPERATORS];
+	uint32_t i, n, k, end, index, scale, ph;
+	int32_t val1, val2;
+
+	if (!voice_active(v) && v->tick == 0) return false;
+	for (k=0; k < FM_OPERATORS; k++) {
+		float hz = v->freq * ratios[k] + detunes[k];
+		if (hz < 0.0f) hz = 0.0f;
+		else if (hz > AUDIO_SAMPLE_RATE_EXACT / 2.0f) hz = 0.0f;
+		inc[k] = hz * (4294967296.0f / AUDIO_SAMPLE_RATE_EXACT);
+		out[k] = 0;
+	}
+
+	for (i=0; i < AUDIO_BLOCK_SAMPLES; ) {
+		if (v->tick == 0) advance(v);
+		end = i + v->tick;
+		if (end > AUDIO_BLOCK_SAMPLES) end = AUDIO_BLOCK_SAMPLES;
+		v->tick -= end - i;
+		for (; i < end; i++) {
+			int32_t total = 0;
+			for (n=0; n < nrun; n++) {
+				k = order[n];
+				// sum phase modulation, wrapping modulo one cycle
+				uint32_t mod = 0;
+				for (uint32_t s=0; s < nsrc[k]; s++) {
+					uint32_t j = src[k][s];
+					int32_t x = (j > k) ? out[j] : v->fb[j];
+					mod += (uint32_t)x * (uint32_t)depth[k][s];
+				}
+				ph = v->phase[k] + (mod << 1);
+				index = ph >> 24;
+				val1 = AudioWaveformSine[index];
+				val2 = AudioWaveformSine[index+1];
+				scale = (ph >> 8) & 0xFFFF;
+				val2 *= scale;
+				val1 *= 0x10000 - scale;
+				out[k] = (((val1 + val2) >> 16) * v->gain[k]) >> 16;
+				if (carriers & (1 << k)) total += out[k];
+				v->gain[k] += v->ampinc[k];
+				v->phase[k] += inc[k];
+			}
+			for (n=0; n < nrun; n++) {
+				k = order[n];
+				v->fb[k] = (out[k] + v->last[k]) >> 1;
+				v->last[k] = out[k];
+			}
+			sum[i] += total;
+		}
+	}
+	return true;
+}
+
+void AudioSynthFMBase::transmit_sum(const int32_t *sum)
+{
+	audio_block_t *block;
+
+	block = allocate();
+	if (!block) return;
+	for (uint32_t i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
+		int32_t val = ((int64_t)sum[i] * magnitude) >> 16;
+		if (val > 32767) val = 32767;
+		else if (val < -32768) val = -32768;
+		block->data[i] = val;
+	}
+	transmit(block);
+	release(block);
+}
+
+void AudioSynthFM::noteOn(float frequency, float velocity)
+{
+	__disable_irq();
+	voice_on(&voice, frequency, velocity);
+	__enable_irq();
+}
+
+void AudioSynthFM::noteOff(void)
+{
+	__disable_irq();
+	voice_off(&voice);
+	__enable_irq();
+}
+
+void AudioSynthFM::update(void)
+{
+	int32_t sum[AUDIO_BLOCK_SAMPLES];
+
+	memset(sum, 0, sizeof(sum));
+	if (!render(&voice, sum)) return;
+	transmit_sum(sum);
+}
+
+void AudioSynthFMPoly::noteOn(uint8_t note, float velocity)
+{
+	float freq = 440.0f * powf(2.0f, ((float)note - 69.0f) / 12.0f);
+	struct fm_voice *v = NULL;
+	struct fm_voice *oldest = NULL;
+	struct fm_voice *quietest = NULL;
+	float quiet = 2.0f;
+
+	__disable_irq();
+	for (int i=0; i < FM_POLY_VOICES; i++) {
+		struct fm_voice *p = &voices[i];
+		bool busy = voice_active(p);
+		if (busy && p->note == note) {
+			v = p;		// same note again, retrigger it
+			break;
+		}
+		if (!busy) {
+			if (!v) v = p;
+			continue;
+		}
+		// steal the quietest released voice before a held one
+		bool held;
+		float loudness = voice_level(p, &held);
+		if (!held && loudness < quiet) {
+			quiet = loudness;
+			quietest = p;
+		}
+		if (!oldest || (int32_t)(p->age - oldest->age) < 0) oldest = p;
+	}
+	if (!v) v = quietest ? quietest : oldest;
+	v->note = note;
+	v->age = counter++;
+	voice_on(v, freq, velocity);
+	__enable_irq();
+}
+
+void AudioSynthFMPoly::noteOff(uint8_t note)
+{
+	__disable_irq();
+	for (int i=0; i < FM_POLY_VOICES; i++) {
+		struct fm_voice *p = &voices[i];
+		if (p->note == note && voice_active(p)) voice_off(p);
+	}
+	__enable_irq();
+}
+
+void AudioSynthFMPoly::allNotesOff(void)
+{
+	__disable_irq();
+	for (int i=0; i < FM_POLY_VOICES; i++) {
+		voice_off(&voices[i]);
+	}
+	__enable_irq();
+}
+
+void AudioSynthFMPoly::update(void)
+{
+	int32_t sum[AUDIO_BLOCK_SAMPLES];
+	uint32_t count = 0;
+
+	memset(sum, 0, sizeof(sum));
+	for (int i=0; i < FM_POLY_VOICES; i++) {
+		if (render(&voices[i], sum)) count++;
+	}
+	active = count;
+	if (count == 0) return;
+	transmit_sum(sum);
+}
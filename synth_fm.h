@@ -0,0 +1,185 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef synth_fm_h_
+#define synth_fm_h_
+
+#include "Arduino.h"
+#include "AudioStream.h"
+
+#define FM_OPERATORS   6
+#define FM_ALGORITHMS  32
+#define FM_POLY_VOICES 8
+#define FM_CONTROL_SAMPLES 128	// envelopes update every 2.9 ms
+
+// Operators are numbered 0 to 5.  The algorithm() numbering follows the
+// familiar 32 six-operator charts, where chart operator 1 is operator 0
+// here.  Each operator may be modulated by any other: higher numbered
+// sources are used from the same sample, while equal or lower numbered
+// sources (feedback) use the average of their previous two outputs.
+
+class AudioSynthFMBase : public AudioStream
+{
+public:
+	AudioSynthFMBase() : AudioStream(0, NULL) {
+		for (int i=0; i < FM_OPERATORS; i++) {
+			ratios[i] = 1.0f;
+			detunes[i] = 0.0f;
+			levels[i] = 1.0f;
+			attack_step[i] = 1.0f;
+			decay_step[i] = 0.0f;
+			sustain_level[i] = 1.0f;
+			release_step[i] = msec2step(50.0f);
+		}
+		init_algorithm(1);
+	}
+	// Select one of the 32 standard routings, 1 to 32.
+	void algorithm(unsigned int n);
+	// Custom routing: "from" phase modulates "to".  A depth of 1.0 with
+	// a full level modulator shifts the phase by one cycle.  Zero removes.
+	void connect(unsigned int from, unsigned int to, float depth);
+	void carrier(unsigned int op, bool enable);
+	// Feedback amount for the algorithm's feedback path, 0 to 1.0.
+	// Values around 0.1 to 0.3 add harmonics, 1.0 is nearly noise.
+	void feedback(float amount);
+	// Operator frequency is note frequency * ratio + detune (Hz).
+	void ratio(unsigned int op, float n) {
+		if (op >= FM_OPERATORS) return;
+		ratios[op] = (n > 0.0f) ? n : 0.0f;
+	}
+	void detune(unsigned int op, float hz) {
+		if (op >= FM_OPERATORS) return;
+		detunes[op] = hz;
+	}
+	// Output level for carriers, modulation index for modulators.
+	void level(unsigned int op, float n) {
+		if (op >= FM_OPERATORS) return;
+		if (n < 0.0f) n = 0.0f;
+		else if (n > 1.0f) n = 1.0f;
+		levels[op] = n;
+	}
+	void envelope(unsigned int op, float attack, float decay,
+	  float sustain, float release) {
+		if (op >= FM_OPERATORS) return;
+		if (sustain < 0.0f) sustain = 0.0f;
+		else if (sustain > 1.0f) sustain = 1.0f;
+		attack_step[op] = msec2step(attack);
+		decay_step[op] = msec2step(decay);
+		sustain_level[op] = sustain;
+		release_step[op] = msec2step(release);
+	}
+	void amplitude(float n) {
+		if (n < 0.0f) n = 0.0f;
+		else if (n > 4.0f) n = 4.0f;
+		magnitude = n * 65536.0f;
+	}
+protected:
+	struct fm_voice {
+		uint32_t phase[FM_OPERATORS];
+		int32_t amp[FM_OPERATORS];	// gain at the end of the control period
+		int32_t gain[FM_OPERATORS];	// gain now
+		int32_t ampinc[FM_OPERATORS];	// gain change per sample
+		int32_t last[FM_OPERATORS];	// previous output
+		int32_t fb[FM_OPERATORS];	// average of previous two outputs
+		float env[FM_OPERATORS];
+		uint8_t stage[FM_OPERATORS];
+		uint8_t tick;			// samples left in the control period
+		uint8_t note;
+		float freq;
+		float velocity;
+		uint32_t age;
+	};
+	void voice_init(struct fm_voice *v);
+	void voice_on(struct fm_voice *v, float freq, float velocity);
+	void voice_off(struct fm_voice *v);
+	bool voice_active(const struct fm_voice *v);
+	float voice_level(const struct fm_voice *v, bool *held);
+	void advance(struct fm_voice *v);
+	bool render(struct fm_voice *v, int32_t *sum);
+	void transmit_sum(const int32_t *sum);
+private:
+	static float msec2step(float milliseconds) {
+		float periods = milliseconds * (AUDIO_SAMPLE_RATE_EXACT / 1000.0f
+			/ (float)FM_CONTROL_SAMPLES);
+		return (periods > 1.0f) ? 1.0f / periods : 1.0f;
+	}
+	void init_algorithm(unsigned int n);
+	void rebuild(void);
+	float ratios[FM_OPERATORS];
+	float detunes[FM_OPERATORS];
+	float levels[FM_OPERATORS];
+	float attack_step[FM_OPERATORS];
+	float decay_step[FM_OPERATORS];
+	float sustain_level[FM_OPERATORS];
+	float release_step[FM_OPERATORS];
+	float matrix[FM_OPERATORS][FM_OPERATORS];	// [to][from]
+	float fb_amount = 0.0f;
+	int32_t magnitude = 65536;
+	// compiled from matrix: sources of each operator, in running order
+	uint8_t nsrc[FM_OPERATORS];
+	uint8_t src[FM_OPERATORS][FM_OPERATORS];
+	int32_t depth[FM_OPERATORS][FM_OPERATORS];
+	uint8_t order[FM_OPERATORS];
+	uint8_t nrun;
+	uint8_t carriers;
+	uint8_t fb_from, fb_to;
+};
+
+class AudioSynthFM : public AudioSynthFMBase
+{
+public:
+	AudioSynthFM() { voice_init(&voice); }
+	void noteOn(float frequency, float velocity = 1.0f);
+	void noteOff(void);
+	void frequency(float freq) {
+		if (freq < 0.0f) freq = 0.0f;
+		voice.freq = freq;
+	}
+	bool isActive(void) { return voice_active(&voice); }
+	virtual void update(void);
+private:
+	struct fm_voice voice;
+};
+
+class AudioSynthFMPoly : public AudioSynthFMBase
+{
+public:
+	AudioSynthFMPoly() {
+		for (int i=0; i < FM_POLY_VOICES; i++) voice_init(&voices[i]);
+	}
+	// MIDI note number, velocity 0 to 1.0
+	void noteOn(uint8_t note, float velocity = 1.0f);
+	void noteOff(uint8_t note);
+	void allNotesOff(void);
+	unsigned int activeVoices(void) { return active; }
+	virtual void update(void);
+private:
+	struct fm_voice voices[FM_POLY_VOICES];
+	uint32_t counter = 0;
+	volatile uint8_t active = 0;
+};
+
+#endif
@@ -56,6 +56,7 @@ void AudioSynthKarplusStrong::update(void)
 			buffer[i] = signed_multiply_32x16b(magnitude, lo);
 		}
 		seed = lo;
+		prior = buffer[bufferLen - 1];
 		state = 2;
 	}
 
@@ -65,12 +66,9 @@ void AudioSynthKarplusStrong::update(void)
 		return;
 	}
 
-	int16_t prior;
-	if (bufferIndex > 0) {
-		prior = buffer[bufferIndex - 1];
-	} else {
-		prior = buffer[bufferLen - 1];
-	}
+	// the buffer already holds the filtered output, so the input
+	// before this block's first sample is kept from the last update
+	int16_t prior = this->prior;
 	int16_t *data = block->data;
 	for (int i=0; i < AUDIO_BLOCK_SAMPLES; i++) {
 		int16_t in = buffer[bufferIndex];
@@ -82,6 +80,7 @@ void AudioSynthKarplusStrong::update(void)
 		prior = in;
 		if (++bufferIndex >= bufferLen) bufferIndex = 0;
 	}
+	this->prior = prior;
 
 	transmit(block);
 	release(block);
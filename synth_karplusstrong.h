@@ -59,6 +59,7 @@ private:
 	uint16_t bufferLen;
 	uint16_t bufferIndex;
 	int32_t  magnitude; // current output
+	int16_t  prior;     // buffer input before the current one
 	static uint32_t seed;  // must start at 1
 	int16_t buffer[536]; // TODO: dynamically use audio memory blocks
 };
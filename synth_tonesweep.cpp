@@ -72,6 +72,7 @@ if(0) {
   }
   tone_tmp = tone_tmp / t_time / AUDIO_SAMPLE_RATE_EXACT;
   tone_incr = (tone_tmp * 0x100000000LL);
+  tone_step = (tone_freq << 14) / (int) AUDIO_SAMPLE_RATE_EXACT;
   sweep_busy = 1;
   return(true);
 }
@@ -96,29 +97,30 @@ void AudioSynthToneSweep::update(void)
   block = allocate();
   if(block) {
     bp = block->data;
-    uint32_t tmp  = tone_freq >> 32; 
-    uint64_t tone_tmp = (tone_freq << 14) / (int) AUDIO_SAMPLE_RATE_EXACT;
     uint64_t incr     = (tone_incr << 14) / (int) AUDIO_SAMPLE_RATE_EXACT;
-    // Generate the sweep
+    // Generate the sweep.  The phase step and the end of the sweep
+    // follow tone_freq every sample, not once per block, so the
+    // sweep is the same at any block size.
     for(i = 0;i < AUDIO_BLOCK_SAMPLES;i++) {
       *bp++ = (short)(( (short)(arm_sin_q31((uint32_t)((tone_phase >> 15)&0x7fffffff))>>16) *tone_amp) >> 15);
 
-      tone_phase +=  tone_tmp;
-      tone_tmp   +=  incr ;
+      tone_phase +=  tone_step;
 
       if(tone_sign > 0) {
-        if(tmp > tone_hi) {
+        if((tone_freq >> 32) > tone_hi) {
           sweep_busy = 0;
           break;
         }
         tone_freq += tone_incr;
+        tone_step += incr;
       } else {
-        if(tmp < tone_hi || tone_freq < tone_incr) {
+        if((tone_freq >> 32) < tone_hi || tone_freq < tone_incr) {
           sweep_busy = 0;
 
           break;
         }
         tone_freq -= tone_incr;        
+        tone_step -= incr;
       }
     }
     while(i < AUDIO_BLOCK_SAMPLES) {
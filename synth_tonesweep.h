@@ -55,6 +55,7 @@ private:
   uint64_t tone_freq;
   uint64_t tone_phase;
   uint64_t tone_incr;
+  uint64_t tone_step;
   int tone_sign;
   unsigned char sweep_busy;
 };
@@ -235,6 +235,14 @@ void AudioSynthWaveformModulated::update(void)
 	moddata = receiveReadOnly(0);
 	shapedata = receiveReadOnly(1);
 
+	if (magnitude == 0 && !moddata) {
+		// silent and unmodulated, only the phase needs to advance
+		if (shapedata) release(shapedata);
+		phasedata[AUDIO_BLOCK_SAMPLES-1] = phase_accumulator + inc * (AUDIO_BLOCK_SAMPLES-1);
+		phase_accumulator += inc * AUDIO_BLOCK_SAMPLES;
+		return;
+	}
+
 	// Pre-compute the phase angle for every output sample of this update
 	ph = phase_accumulator;
 	priorphase = phasedata[AUDIO_BLOCK_SAMPLES-1];
@@ -136,6 +136,7 @@ void AudioSynthWavetable::setState(int note, int amp, float freq) {
 	}
 	setFrequency(freq);
 	vib_count = mod_count = tone_phase = env_incr = env_mult = 0;
+	lfo_remaining = 0;
 	vib_phase = mod_phase = TRIANGLE_INITIAL_PHASE;
 	env_count = current_sample->DELAY_COUNT;
 	// linear scalar for amp with UINT16_MAX being no attenuation
@@ -207,6 +208,10 @@ void AudioSynthWavetable::update(void) {
 	int32_t mod_pitch_offset_init = this->mod_pitch_offset_init;
 	int32_t mod_pitch_offset_scnd = this->mod_pitch_offset_scnd;
 
+	uint32_t lfo_remaining = this->lfo_remaining;
+	int32_t tone_incr_offset = this->lfo_incr_offset;
+	int32_t mod_amp = this->lfo_amp;
+
 	audio_block_t* block;
 	block = allocate();
 	if (block == NULL) return;
@@ -221,9 +226,10 @@ void AudioSynthWavetable::update(void) {
 	end = p + AUDIO_BLOCK_SAMPLES / 2;
 
 	// Main loop to handle interpolation, vibrato (vibrato LFO and modulation LFO), and tremolo (modulation LFO only)
-	// Virbrato and modulation offsets/multipliers are updated depending on the LFO_SMOOTHNESS, with max smoothness (7) being one
-	// update per loop interation, and minimum smoothness (1) being once per loop. Hence there is a configurable trade-off
-	// between performance and the smoothness of LFO changes to pitch/amplitude as well as the vibrato/modulation delay granularity
+	// Vibrato and modulation offsets/multipliers are updated every LFO_PERIOD samples, which is 128 / (1 << (LFO_SMOOTHNESS-1)),
+	// at any block size; lfo_remaining carries the count from one block to the next. Max smoothness (7) updates every 2 samples,
+	// and minimum smoothness (1) every 128 samples. Hence there is a configurable trade-off between performance and the
+	// smoothness of LFO changes to pitch/amplitude as well as the vibrato/modulation delay granularity
 
 	// also note that the vibrato/tremolo for the two LFO are defined in the SoundFont spec to be a cents (vibrato) or centibel (tremolo)
 	// diviation oscillating with a triangle wave at a given frequency; the following implementation gets the critical points of those
@@ -233,43 +239,50 @@ void AudioSynthWavetable::update(void) {
 		// TODO: more elegant support of non-looping samples
 		if (s->LOOP == false && tone_phase >= s->MAX_PHASE) break;
 
-		// variable to accumulate LFO pitch offsets; stays 0 if still in vibrato/modulation delay
-		int32_t tone_incr_offset = 0; 
-		if (vib_count++ > s->VIBRATO_DELAY) {
-			vib_phase += s->VIBRATO_INCREMENT;
-			// convert uint32_t phase value to int32_t triangle wave value
-			// TRIANGLE_INITIAL_PHASE (0xC0000000) and 0x40000000 -> 0, 0 -> INT32_MAX/2, 0x80000000 -> INT32_MIN/2
-			int32_t vib_scale = vib_phase & 0x80000000 ? 0x40000000 + vib_phase : 0x3FFFFFFF - vib_phase;
-			// select a vibrato pitch offset based on sign of scale; note that the values "init" and "scnd" values
-			// produced by the decoder script will either both be negative, or both be positive; this allows the 
-			// scalar to either start with either a downward (negative offset) or upward (positive) pitch oscillation
-			int32_t vib_pitch_offset = vib_scale >= 0 ? vib_pitch_offset_init : vib_pitch_offset_scnd;
-			// scale the offset and accumulate into offset
-			// note the offset value is already preshifted by << 2 to account for this func shifting >> 32
-			tone_incr_offset = multiply_accumulate_32x32_rshift32_rounded(tone_incr_offset, vib_scale, vib_pitch_offset);
-		}
-
-		// variable to hold an adjusted amplitude attenuation value; stays at tone_amp if modulation in delay
-		int32_t mod_amp = tone_amp;
-		if (mod_count++ > s->MODULATION_DELAY) {
-			// pitch LFO component is same as above, but we'll also use the scale value for tremolo below
-			mod_phase += s->MODULATION_INCREMENT;
-			int32_t mod_scale = mod_phase & 0x80000000 ? 0x40000000 + mod_phase : 0x3FFFFFFF - mod_phase;
-
-			int32_t mod_pitch_offset = mod_scale >= 0 ? mod_pitch_offset_init : mod_pitch_offset_scnd;
-			tone_incr_offset = multiply_accumulate_32x32_rshift32_rounded(tone_incr_offset, mod_scale, mod_pitch_offset);
-
-			// similar to pitch, sign of init and scnd are either both + or - to allow correct triangle direction
-			int32_t mod_amp_offset = (mod_scale >= 0 ? s->MODULATION_AMPLITUDE_INITIAL_GAIN : s->MODULATION_AMPLITUDE_SECOND_GAIN);
-			// here we scale the amp offset which, similar to the pitch offset, is already pre-shifted by << 2
-			mod_scale = multiply_32x32_rshift32(mod_scale, mod_amp_offset);
-			// the resulting scalar is then used to scale mod_map (possibly resulting in a negative) and add that back into mod_amp
-			mod_amp = signed_multiply_accumulate_32x16b(mod_amp, mod_scale, mod_amp);
+		// the LFOs move once every LFO_PERIOD samples, which may span several blocks
+		if (lfo_remaining == 0) {
+			// variable to accumulate LFO pitch offsets; stays 0 if still in vibrato/modulation delay
+			tone_incr_offset = 0;
+			if (vib_count++ > s->VIBRATO_DELAY) {
+				vib_phase += s->VIBRATO_INCREMENT;
+				// convert uint32_t phase value to int32_t triangle wave value
+				// TRIANGLE_INITIAL_PHASE (0xC0000000) and 0x40000000 -> 0, 0 -> INT32_MAX/2, 0x80000000 -> INT32_MIN/2
+				int32_t vib_scale = vib_phase & 0x80000000 ? 0x40000000 + vib_phase : 0x3FFFFFFF - vib_phase;
+				// select a vibrato pitch offset based on sign of scale; note that the values "init" and "scnd" values
+				// produced by the decoder script will either both be negative, or both be positive; this allows the 
+				// scalar to either start with either a downward (negative offset) or upward (positive) pitch oscillation
+				int32_t vib_pitch_offset = vib_scale >= 0 ? vib_pitch_offset_init : vib_pitch_offset_scnd;
+				// scale the offset and accumulate into offset
+				// note the offset value is already preshifted by << 2 to account for this func shifting >> 32
+				tone_incr_offset = multiply_accumulate_32x32_rshift32_rounded(tone_incr_offset, vib_scale, vib_pitch_offset);
+			}
+
+			// variable to hold an adjusted amplitude attenuation value; stays at tone_amp if modulation in delay
+			mod_amp = tone_amp;
+			if (mod_count++ > s->MODULATION_DELAY) {
+				// pitch LFO component is same as above, but we'll also use the scale value for tremolo below
+				mod_phase += s->MODULATION_INCREMENT;
+				int32_t mod_scale = mod_phase & 0x80000000 ? 0x40000000 + mod_phase : 0x3FFFFFFF - mod_phase;
+
+				int32_t mod_pitch_offset = mod_scale >= 0 ? mod_pitch_offset_init : mod_pitch_offset_scnd;
+				tone_incr_offset = multiply_accumulate_32x32_rshift32_rounded(tone_incr_offset, mod_scale, mod_pitch_offset);
+
+				// similar to pitch, sign of init and scnd are either both + or - to allow correct triangle direction
+				int32_t mod_amp_offset = (mod_scale >= 0 ? s->MODULATION_AMPLITUDE_INITIAL_GAIN : s->MODULATION_AMPLITUDE_SECOND_GAIN);
+				// here we scale the amp offset which, similar to the pitch offset, is already pre-shifted by << 2
+				mod_scale = multiply_32x32_rshift32(mod_scale, mod_amp_offset);
+				// the resulting scalar is then used to scale mod_map (possibly resulting in a negative) and add that back into mod_amp
+				mod_amp = signed_multiply_accumulate_32x16b(mod_amp, mod_scale, mod_amp);
+			}
+			lfo_remaining = LFO_PERIOD;
 		}
 
-		// producing 2 output values per iteration; repeat more depending on the LFO_SMOOTHNESS
+		// producing 2 output values per iteration, until the LFO period or the block ends
 		// this segment linearly interpolates, calculates how far we step through the sample data, and scales amplitude
-		for (int i = LFO_PERIOD / 2; i; --i, ++p) {
+		uint32_t *lfo_end = p + lfo_remaining / 2;
+		if (lfo_end > end) lfo_end = end;
+		lfo_remaining -= (lfo_end - p) * 2;
+		for (; p < lfo_end; ++p) {
 			// INDEX_BITS representing the higher order bits we use to index into the sample data
 			index = tone_phase >> (32 - s->INDEX_BITS);
 			// recast as uint32_t to load in packed variable; initially int16_t* since we may need to read accross a word boundry
@@ -426,8 +439,12 @@ void AudioSynthWavetable::update(void) {
 			this->vib_phase = vib_phase;
 			this->mod_count = mod_count;
 			this->mod_phase = mod_phase;
+			this->lfo_remaining = lfo_remaining;
+			this->lfo_incr_offset = tone_incr_offset;
+			this->lfo_amp = mod_amp;
 		}
 		else {
+			this->lfo_remaining = 0;
 			this->vib_count = this->mod_count = 0;
 			this->vib_phase = this->mod_phase = TRIANGLE_INITIAL_PHASE;
 		}
@@ -74,7 +74,8 @@ public:
 	static const int32_t UNITY_GAIN = INT32_MAX;
 	static constexpr float SAMPLES_PER_MSEC = (AUDIO_SAMPLE_RATE_EXACT/1000.0f);
 	static const int32_t LFO_SMOOTHNESS = 3;
-	static constexpr float LFO_PERIOD = (AUDIO_BLOCK_SAMPLES/(1 << (LFO_SMOOTHNESS-1)));
+	// LFOs update every 32 samples at any block size
+	static constexpr float LFO_PERIOD = (128/(1 << (LFO_SMOOTHNESS-1)));
 	static const int32_t ENVELOPE_PERIOD = 8;
 
 	struct instrument_data {
@@ -199,5 +200,10 @@ private:
 	volatile uint32_t mod_phase = TRIANGLE_INITIAL_PHASE;
 	volatile int32_t mod_pitch_offset_init = 0;
 	volatile int32_t mod_pitch_offset_scnd = 0;
+
+	//LFO output, held for LFO_PERIOD samples
+	volatile uint16_t lfo_remaining = 0;
+	volatile int32_t lfo_incr_offset = 0;
+	volatile int32_t lfo_amp = 0;
 };
 
@@ -29,22 +29,40 @@
 
 #include <stdint.h>
 
+// Every function has a Cortex-M4/M7 (ARM_ARCH_7EM) version using the DSP
+// instructions, and a portable C version giving identical results, used
+// on Teensy LC and when compiling for other processors.  On PC (SSE2) and
+// 64 bit ARM (NEON) hosts, some of the packed 16 bit functions use SIMD.
+// A host build may define __ARM_ARCH_7EM__ to test the same code paths in
+// the audio objects, so the assembly is only used by an ARM compiler.
+#if defined(__ARM_ARCH_7EM__) && defined(__arm__)
+#define DSPINST_ARM_7EM
+#else
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DSPINST_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DSPINST_NEON
+#endif
+#endif
+
 // computes limit((val >> rshift), 2**bits)
 static inline int32_t signed_saturate_rshift(int32_t val, int bits, int rshift) __attribute__((always_inline, unused));
 static inline int32_t signed_saturate_rshift(int32_t val, int bits, int rshift)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("ssat %0, %1, %2, asr %3" : "=r" (out) : "I" (bits), "r" (val), "I" (rshift));
 	return out;
-#elif defined(KINETISL)
+#else
 	int32_t out, max;
 	out = val >> rshift;
-	max = 1 << (bits - 1);
+	max = (int32_t)(((uint32_t)1 << (bits - 1)) - 1);
 	if (out >= 0) {
-		if (out > max - 1) out = max - 1;
+		if (out > max) out = max;
 	} else {
-		if (out < -max) out = -max;
+		if (out < -max - 1) out = -max - 1;
 	}
 	return out;
 #endif
@@ -54,7 +72,7 @@ static inline int32_t signed_saturate_rshift(int32_t val, int bits, int rshift)
 static inline int16_t saturate16(int32_t val) __attribute__((always_inline, unused));
 static inline int16_t saturate16(int32_t val)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int16_t out;
 	int32_t tmp;
 	asm volatile("ssat %0, %1, %2" : "=r" (tmp) : "I" (16), "r" (val) );
@@ -71,11 +89,11 @@ static inline int16_t saturate16(int32_t val)
 static inline int32_t signed_multiply_32x16b(int32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t signed_multiply_32x16b(int32_t a, uint32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smulwb %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else
 	return ((int64_t)a * (int16_t)(b & 0xFFFF)) >> 16;
 #endif
 }
@@ -84,11 +102,11 @@ static inline int32_t signed_multiply_32x16b(int32_t a, uint32_t b)
 static inline int32_t signed_multiply_32x16t(int32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t signed_multiply_32x16t(int32_t a, uint32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smulwt %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else
 	return ((int64_t)a * (int16_t)(b >> 16)) >> 16;
 #endif
 }
@@ -97,51 +115,55 @@ static inline int32_t signed_multiply_32x16t(int32_t a, uint32_t b)
 static inline int32_t multiply_32x32_rshift32(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_32x32_rshift32(int32_t a, int32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smmul %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else
 	return ((int64_t)a * (int64_t)b) >> 32;
 #endif
 }
 
-// computes (((int64_t)a[31:0] * (int64_t)b[31:0] + 0x8000000) >> 32)
+// computes (((int64_t)a[31:0] * (int64_t)b[31:0] + 0x80000000) >> 32)
 static inline int32_t multiply_32x32_rshift32_rounded(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_32x32_rshift32_rounded(int32_t a, int32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smmulr %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
-	return (((int64_t)a * (int64_t)b) + 0x8000000) >> 32;
+#else
+	return (((int64_t)a * (int64_t)b) + 0x80000000) >> 32;
 #endif
 }
 
-// computes sum + (((int64_t)a[31:0] * (int64_t)b[31:0] + 0x8000000) >> 32)
+// computes (((int64_t)sum[31:0] << 32) + (int64_t)a[31:0] * (int64_t)b[31:0] + 0x80000000) >> 32
 static inline int32_t multiply_accumulate_32x32_rshift32_rounded(int32_t sum, int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_accumulate_32x32_rshift32_rounded(int32_t sum, int32_t a, int32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smmlar %0, %2, %3, %1" : "=r" (out) : "r" (sum), "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
-	return sum + ((((int64_t)a * (int64_t)b) + 0x8000000) >> 32);
+#else
+	return (((uint64_t)(uint32_t)sum << 32) + (uint64_t)((int64_t)a * (int64_t)b)
+		+ 0x80000000) >> 32;
 #endif
 }
 
-// computes sum - (((int64_t)a[31:0] * (int64_t)b[31:0] + 0x8000000) >> 32)
+// computes (((int64_t)sum[31:0] << 32) - (int64_t)a[31:0] * (int64_t)b[31:0] + 0x80000000) >> 32
 static inline int32_t multiply_subtract_32x32_rshift32_rounded(int32_t sum, int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_subtract_32x32_rshift32_rounded(int32_t sum, int32_t a, int32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smmlsr %0, %2, %3, %1" : "=r" (out) : "r" (sum), "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
-	return sum - ((((int64_t)a * (int64_t)b) + 0x8000000) >> 32);
+#else
+	// not the same as sum - multiply_32x32_rshift32_rounded(a, b) when
+	// the low 32 bits of the product are exactly 0x80000000
+	return (((uint64_t)(uint32_t)sum << 32) - (uint64_t)((int64_t)a * (int64_t)b)
+		+ 0x80000000) >> 32;
 #endif
 }
 
@@ -150,11 +172,11 @@ static inline int32_t multiply_subtract_32x32_rshift32_rounded(int32_t sum, int3
 static inline uint32_t pack_16t_16t(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline uint32_t pack_16t_16t(int32_t a, int32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("pkhtb %0, %1, %2, asr #16" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else
 	return (a & 0xFFFF0000) | ((uint32_t)b >> 16);
 #endif
 }
@@ -163,11 +185,11 @@ static inline uint32_t pack_16t_16t(int32_t a, int32_t b)
 static inline uint32_t pack_16t_16b(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline uint32_t pack_16t_16b(int32_t a, int32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("pkhtb %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
-#elif defined(KINETISL)
+#else
 	return (a & 0xFFFF0000) | (b & 0x0000FFFF);
 #endif
 }
@@ -176,12 +198,12 @@ static inline uint32_t pack_16t_16b(int32_t a, int32_t b)
 static inline uint32_t pack_16b_16b(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline uint32_t pack_16b_16b(int32_t a, int32_t b)
 {
-#if defined (__ARM_ARCH_7EM__)
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("pkhbt %0, %1, %2, lsl #16" : "=r" (out) : "r" (b), "r" (a));
 	return out;
-#elif defined(KINETISL)
-	return (a << 16) | (b & 0x0000FFFF);
+#else
+	return ((uint32_t)a << 16) | (b & 0x0000FFFF);
 #endif
 }
 
@@ -195,144 +217,254 @@ static inline uint32_t pack_16x16(int32_t a, int32_t b)
 	return out;
 }
 */
-#if defined (__ARM_ARCH_7EM__)
+
 // computes (((a[31:16] + b[31:16]) << 16) | (a[15:0 + b[15:0]))  (saturates)
 static inline uint32_t signed_add_16_and_16(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline uint32_t signed_add_16_and_16(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("qadd16 %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#elif defined(DSPINST_SSE2)
+	return _mm_cvtsi128_si32(_mm_adds_epi16(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b)));
+#elif defined(DSPINST_NEON)
+	return vget_lane_u32(vreinterpret_u32_s16(vqadd_s16(
+		vreinterpret_s16_u32(vdup_n_u32(a)), vreinterpret_s16_u32(vdup_n_u32(b)))), 0);
+#else
+	int32_t top = ((int32_t)a >> 16) + ((int32_t)b >> 16);
+	int32_t bottom = (int16_t)a + (int16_t)b;
+	return pack_16b_16b(saturate16(top), saturate16(bottom));
+#endif
 }
 
 // computes (((a[31:16] - b[31:16]) << 16) | (a[15:0 - b[15:0]))  (saturates)
 static inline int32_t signed_subtract_16_and_16(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline int32_t signed_subtract_16_and_16(int32_t a, int32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("qsub16 %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#elif defined(DSPINST_SSE2)
+	return _mm_cvtsi128_si32(_mm_subs_epi16(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b)));
+#elif defined(DSPINST_NEON)
+	return vget_lane_s32(vreinterpret_s32_s16(vqsub_s16(
+		vreinterpret_s16_s32(vdup_n_s32(a)), vreinterpret_s16_s32(vdup_n_s32(b)))), 0);
+#else
+	int32_t top = (a >> 16) - (b >> 16);
+	int32_t bottom = (int16_t)a - (int16_t)b;
+	return pack_16b_16b(saturate16(top), saturate16(bottom));
+#endif
 }
 
 // computes out = (((a[31:16]+b[31:16])/2) <<16) | ((a[15:0]+b[15:0])/2)
 static inline int32_t signed_halving_add_16_and_16(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline int32_t signed_halving_add_16_and_16(int32_t a, int32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("shadd16 %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#elif defined(DSPINST_NEON)
+	return vget_lane_s32(vreinterpret_s32_s16(vhadd_s16(
+		vreinterpret_s16_s32(vdup_n_s32(a)), vreinterpret_s16_s32(vdup_n_s32(b)))), 0);
+#else
+	// the halving rounds down, (-3)/2 = -2
+	return pack_16b_16b(((a >> 16) + (b >> 16)) >> 1, ((int16_t)a + (int16_t)b) >> 1);
+#endif
 }
 
 // computes out = (((a[31:16]-b[31:16])/2) <<16) | ((a[15:0]-b[15:0])/2)
 static inline int32_t signed_halving_subtract_16_and_16(int32_t a, int32_t b) __attribute__((always_inline, unused));
 static inline int32_t signed_halving_subtract_16_and_16(int32_t a, int32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("shsub16 %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#elif defined(DSPINST_NEON)
+	return vget_lane_s32(vreinterpret_s32_s16(vhsub_s16(
+		vreinterpret_s16_s32(vdup_n_s32(a)), vreinterpret_s16_s32(vdup_n_s32(b)))), 0);
+#else
+	return pack_16b_16b(((a >> 16) - (b >> 16)) >> 1, ((int16_t)a - (int16_t)b) >> 1);
+#endif
 }
 
 // computes (sum + ((a[31:0] * b[15:0]) >> 16))
 static inline int32_t signed_multiply_accumulate_32x16b(int32_t sum, int32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t signed_multiply_accumulate_32x16b(int32_t sum, int32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smlawb %0, %2, %3, %1" : "=r" (out) : "r" (sum), "r" (a), "r" (b));
 	return out;
+#else
+	return (uint32_t)sum + (uint32_t)signed_multiply_32x16b(a, b);
+#endif
 }
 
 // computes (sum + ((a[31:0] * b[31:16]) >> 16))
 static inline int32_t signed_multiply_accumulate_32x16t(int32_t sum, int32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t signed_multiply_accumulate_32x16t(int32_t sum, int32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smlawt %0, %2, %3, %1" : "=r" (out) : "r" (sum), "r" (a), "r" (b));
 	return out;
+#else
+	return (uint32_t)sum + (uint32_t)signed_multiply_32x16t(a, b);
+#endif
 }
 
 // computes logical and, forces compiler to allocate register and use single cycle instruction
 static inline uint32_t logical_and(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline uint32_t logical_and(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	asm volatile("and %0, %1" : "+r" (a) : "r" (b));
 	return a;
+#else
+	return a & b;
+#endif
 }
 
 // computes ((a[15:0] * b[15:0]) + (a[31:16] * b[31:16]))
 static inline int32_t multiply_16tx16t_add_16bx16b(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_16tx16t_add_16bx16b(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smuad %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#elif defined(DSPINST_SSE2)
+	return _mm_cvtsi128_si32(_mm_madd_epi16(_mm_cvtsi32_si128(a), _mm_cvtsi32_si128(b)));
+#else
+	// only -32768 * -32768 twice overflows, giving 0x80000000 like smuad
+	return (uint32_t)((int16_t)a * (int16_t)b)
+		+ (uint32_t)(((int32_t)a >> 16) * ((int32_t)b >> 16));
+#endif
 }
 
 // computes ((a[15:0] * b[31:16]) + (a[31:16] * b[15:0]))
 static inline int32_t multiply_16tx16b_add_16bx16t(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_16tx16b_add_16bx16t(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smuadx %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#elif defined(DSPINST_SSE2)
+	return _mm_cvtsi128_si32(_mm_madd_epi16(_mm_cvtsi32_si128(a),
+		_mm_shufflelo_epi16(_mm_cvtsi32_si128(b), _MM_SHUFFLE(2, 3, 0, 1))));
+#else
+	return (uint32_t)((int16_t)a * ((int32_t)b >> 16))
+		+ (uint32_t)(((int32_t)a >> 16) * (int16_t)b);
+#endif
 }
 
 // // computes sum += ((a[15:0] * b[15:0]) + (a[31:16] * b[31:16]))
 static inline int64_t multiply_accumulate_16tx16t_add_16bx16b(int64_t sum, uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	asm volatile("smlald %Q0, %R0, %1, %2" : "+r" (sum) : "r" (a), "r" (b));
 	return sum;
+#else
+	return sum + (int32_t)((int16_t)a * (int16_t)b)
+		+ (int32_t)(((int32_t)a >> 16) * ((int32_t)b >> 16));
+#endif
 }
 
 // // computes sum += ((a[15:0] * b[31:16]) + (a[31:16] * b[15:0]))
 static inline int64_t multiply_accumulate_16tx16b_add_16bx16t(int64_t sum, uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	asm volatile("smlaldx %Q0, %R0, %1, %2" : "+r" (sum) : "r" (a), "r" (b));
 	return sum;
+#else
+	return sum + (int32_t)((int16_t)a * ((int32_t)b >> 16))
+		+ (int32_t)(((int32_t)a >> 16) * (int16_t)b);
+#endif
 }
 
 // computes ((a[15:0] * b[15:0])
 static inline int32_t multiply_16bx16b(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_16bx16b(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smulbb %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#else
+	return (int16_t)a * (int16_t)b;
+#endif
 }
 
 // computes ((a[15:0] * b[31:16])
 static inline int32_t multiply_16bx16t(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_16bx16t(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smulbt %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#else
+	return (int16_t)a * (int16_t)(b >> 16);
+#endif
 }
 
 // computes ((a[31:16] * b[15:0])
 static inline int32_t multiply_16tx16b(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_16tx16b(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smultb %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#else
+	return (int16_t)(a >> 16) * (int16_t)b;
+#endif
 }
 
 // computes ((a[31:16] * b[31:16])
 static inline int32_t multiply_16tx16t(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t multiply_16tx16t(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("smultt %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#else
+	return (int16_t)(a >> 16) * (int16_t)(b >> 16);
+#endif
 }
 
+#if !defined(DSPINST_ARM_7EM)
+// Without the DSP instructions there is no Q flag, so it is kept here.  Only
+// substract_32_saturate() sets it.  Each file including this has its own copy.
+static uint32_t dspinst_q_flag __attribute__((unused)) = 0;
+#endif
+
 // computes (a - b), result saturated to 32 bit integer range
 static inline int32_t substract_32_saturate(uint32_t a, uint32_t b) __attribute__((always_inline, unused));
 static inline int32_t substract_32_saturate(uint32_t a, uint32_t b)
 {
+#if defined(DSPINST_ARM_7EM)
 	int32_t out;
 	asm volatile("qsub %0, %1, %2" : "=r" (out) : "r" (a), "r" (b));
 	return out;
+#else
+	int64_t diff = (int64_t)(int32_t)a - (int32_t)b;
+	if (diff > 2147483647) {
+		dspinst_q_flag = 1;
+		return 2147483647;
+	}
+	if (diff < -2147483647 - 1) {
+		dspinst_q_flag = 1;
+		return -2147483647 - 1;
+	}
+	return diff;
+#endif
 }
 
 // Multiply two S.31 fractional integers, and return the 32 most significant
@@ -341,6 +473,7 @@ static inline int32_t substract_32_saturate(uint32_t a, uint32_t b)
 
 static inline int32_t FRACMUL_SHL(int32_t x, int32_t y, int z)
 {
+#if defined(DSPINST_ARM_7EM)
     int32_t t, t2;
     asm ("smull    %[t], %[t2], %[a], %[b]\n\t"
          "mov      %[t2], %[t2], asl %[c]\n\t"
@@ -349,26 +482,35 @@ static inline int32_t FRACMUL_SHL(int32_t x, int32_t y, int z)
          : [a] "r" (x), [b] "r" (y),
            [c] "Mr" ((z) + 1), [d] "Mr" (31 - (z)));
     return t;
-}
-
+#else
+    return (uint64_t)((int64_t)x * y) >> (31 - z);
 #endif
+}
 
 //get Q from PSR
 static inline uint32_t get_q_psr(void) __attribute__((always_inline, unused));
 static inline uint32_t get_q_psr(void)
 {
+#if defined(DSPINST_ARM_7EM)
   uint32_t out;
   asm ("mrs %0, APSR" : "=r" (out));
   return (out & 0x8000000)>>27;
+#else
+  return dspinst_q_flag;
+#endif
 }
 
 //clear Q BIT in PSR
 static inline void clr_q_psr(void) __attribute__((always_inline, unused));
 static inline void clr_q_psr(void)
 {
+#if defined(DSPINST_ARM_7EM)
   uint32_t t;
   asm ("mov %[t],#0\n"
        "msr APSR_nzcvq,%0\n" : [t] "=&r" (t)::"cc");
+#else
+  dspinst_q_flag = 0;
+#endif
 }
 
 
@@ -0,0 +1,122 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef register_shadow_h_
+#define register_shadow_h_
+
+#include <stdint.h>
+#include <string.h>
+
+// A copy in RAM of a codec's control registers, so reads and unchanged
+// writes need no I2C communication.  Writes may also be deferred, where
+// they only update the copy and are queued to be sent later.  Writing
+// a register which is already queued updates its value without adding
+// it again, so a fast sweep of volume sends only the latest setting.
+// Queued registers are sent in the order they were first written.
+// N is the number of registers, at most 256.
+
+template <unsigned int N>
+class RegisterShadow
+{
+public:
+	RegisterShadow(void) { clear(); }
+	// forget everything, for example after the codec is reset
+	void clear(void) {
+		memset(valid, 0, sizeof(valid));
+		memset(dirty, 0, sizeof(dirty));
+		head = 0;
+		count = 0;
+	}
+	bool cached(unsigned int i) const {
+		return valid[i >> 5] & (1u << (i & 31));
+	}
+	bool pending(unsigned int i) const {
+		return dirty[i >> 5] & (1u << (i & 31));
+	}
+	unsigned int pending(void) const {
+		return count;
+	}
+	uint16_t get(unsigned int i) const {
+		return value[i];
+	}
+	// the register is known to hold val, so a write of val may be skipped
+	bool same(unsigned int i, uint16_t val) const {
+		return cached(i) && value[i] == val;
+	}
+	// val was read from or written to the codec
+	void set(unsigned int i, uint16_t val) {
+		value[i] = val;
+		valid[i >> 5] |= (1u << (i & 31));
+	}
+	void invalidate(unsigned int i) {
+		valid[i >> 5] &= ~(1u << (i & 31));
+	}
+	// val should be written to the codec later
+	void defer(unsigned int i, uint16_t val) {
+		set(i, val);
+		if (pending(i)) return;
+		dirty[i >> 5] |= (1u << (i & 31));
+		queue[(head + count) % N] = i;
+		count++;
+	}
+	// the oldest queued register, or -1 if none
+	int next(void) {
+		if (count == 0) return -1;
+		unsigned int i = queue[head];
+		head = (head + 1) % N;
+		count--;
+		dirty[i >> 5] &= ~(1u << (i & 31));
+		return i;
+	}
+	// put back the register from next() which could not be sent, so it
+	// is still sent before the ones queued after it
+	void retry(unsigned int i) {
+		head = (head + N - 1) % N;
+		queue[head] = i;
+		dirty[i >> 5] |= (1u << (i & 31));
+		count++;
+	}
+	// send a queued register after all the others, for registers which
+	// are also changed by writing another register
+	void requeue(unsigned int i) {
+		unsigned int n, j=0;
+		if (!pending(i)) return;
+		for (n=0; n < count; n++) {
+			unsigned int q = queue[(head + n) % N];
+			if (q != i) queue[(head + j++) % N] = q;
+		}
+		queue[(head + j) % N] = i;
+	}
+private:
+	uint16_t value[N];
+	uint32_t valid[(N + 31) / 32];
+	uint32_t dirty[(N + 31) / 32];
+	uint8_t queue[N];
+	uint16_t head;
+	uint16_t count;
+};
+
+#endif
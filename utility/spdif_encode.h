@@ -0,0 +1,139 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef spdif_encode_h_
+#define spdif_encode_h_
+
+#include <stdint.h>
+
+// Biphase-mark encoding of S/PDIF subframes, shared by the I2S based
+// S/PDIF outputs.  Each 32 bit subframe is 64 cells in 2 words, sent MSB
+// first: an 8 cell preamble, 24 audio bits (LSB first) and the validity,
+// user, channel status and parity bits.  Every subframe begins and ends
+// with the line low, so subframes can be encoded independently of each
+// other and copied or repeated freely.
+
+#define SPDIF_PREAMBLE_B  (0xE8) //11101000, left channel, 1st of 192 frames
+#define SPDIF_PREAMBLE_M  (0xE2) //11100010, left channel
+#define SPDIF_PREAMBLE_W  (0xE4) //11100100, right channel
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern const uint16_t spdif_bmclookup[256];
+#ifdef __cplusplus
+}
+#endif
+
+// sample is 24 bits in the low bits, validity is 1 to mark the audio unusable
+static inline void spdif_encode_subframe(uint32_t *dest, uint32_t preamble,
+	uint32_t sample, uint32_t validity) __attribute__((always_inline, unused));
+static inline void spdif_encode_subframe(uint32_t *dest, uint32_t preamble,
+	uint32_t sample, uint32_t validity)
+{
+	uint32_t b0, b1, b2, vucp, inv;
+
+	// every code in the lookup table ends low, and must begin with
+	// the opposite level of the cell before it, so a code is inverted
+	// when its first cell matches the level it follows.  The preamble
+	// always ends low.
+	b0 = spdif_bmclookup[sample & 255];
+	inv = ((b0 >> 15) ^ 1);
+	b0 ^= (0 - inv) & 0xFFFF;
+	b1 = spdif_bmclookup[(sample >> 8) & 255];
+	inv = ((b1 >> 15) ^ inv ^ 1) & 1;
+	b1 ^= (0 - inv) & 0xFFFF;
+	b2 = spdif_bmclookup[(sample >> 16) & 255];
+	inv = ((b2 >> 15) ^ inv ^ 1) & 1;
+	b2 ^= (0 - inv) & 0xFFFF;
+	// the level after the audio bits is their parity, so even parity
+	// over the whole subframe needs P = level ^ V, which also leaves
+	// the line low for the next preamble
+	vucp = spdif_bmclookup[validity | ((inv ^ validity) << 3)] >> 8;
+	inv = ((vucp >> 7) ^ inv ^ 1) & 1;
+	vucp ^= (0 - inv) & 0xFF;
+	dest[0] = (preamble << 24) | (b0 << 8) | (b1 >> 8);
+	dest[1] = (b1 << 24) | (b2 << 8) | vucp;
+}
+
+// Encode stereo frames, 4 words each, from 16 bit samples.  left_lsb and
+// right_lsb carry bits 0-7 of 24 bit samples in their upper byte.  All
+// pointers must be valid, use a buffer of zeros for absent data.  frame
+// counts frames since the last B preamble.
+static inline void spdif_encode_frames(uint32_t *dest, uint32_t count,
+	const int16_t *left, const int16_t *left_lsb,
+	const int16_t *right, const int16_t *right_lsb,
+	uint32_t validity, uint16_t *frame) __attribute__((unused));
+static inline void spdif_encode_frames(uint32_t *dest, uint32_t count,
+	const int16_t *left, const int16_t *left_lsb,
+	const int16_t *right, const int16_t *right_lsb,
+	uint32_t validity, uint16_t *frame)
+{
+	uint32_t n = *frame, preamble, sample;
+
+	do {
+		if (++n > 191) {
+			preamble = SPDIF_PREAMBLE_B;
+			n = 0;
+		} else {
+			preamble = SPDIF_PREAMBLE_M;
+		}
+		sample = ((uint32_t)(uint16_t)*left++ << 8) | ((uint16_t)*left_lsb++ >> 8);
+		spdif_encode_subframe(dest, preamble, sample, validity);
+		sample = ((uint32_t)(uint16_t)*right++ << 8) | ((uint16_t)*right_lsb++ >> 8);
+		spdif_encode_subframe(dest + 2, SPDIF_PREAMBLE_W, sample, validity);
+		dest += 4;
+	} while (--count > 0);
+	*frame = n;
+}
+
+// Encode silent stereo frames.  Only the preamble differs between them,
+// so the subframes are encoded once and repeated.
+static inline void spdif_encode_silence(uint32_t *dest, uint32_t count,
+	uint32_t validity, uint16_t *frame) __attribute__((unused));
+static inline void spdif_encode_silence(uint32_t *dest, uint32_t count,
+	uint32_t validity, uint16_t *frame)
+{
+	uint32_t n = *frame, left[2], right[2];
+
+	spdif_encode_subframe(left, SPDIF_PREAMBLE_M, 0, validity);
+	spdif_encode_subframe(right, SPDIF_PREAMBLE_W, 0, validity);
+	do {
+		if (++n > 191) {
+			dest[0] = (left[0] & 0x00FFFFFF) | (SPDIF_PREAMBLE_B << 24);
+			n = 0;
+		} else {
+			dest[0] = left[0];
+		}
+		dest[1] = left[1];
+		dest[2] = right[0];
+		dest[3] = right[1];
+		dest += 4;
+	} while (--count > 0);
+	*frame = n;
+}
+
+#endif
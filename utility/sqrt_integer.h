@@ -35,6 +35,8 @@ extern const uint16_t sqrt_integer_guess_table[];
 inline uint32_t sqrt_uint32(uint32_t in) __attribute__((always_inline,unused));
 inline uint32_t sqrt_uint32(uint32_t in)
 {
+	// zero would divide by zero, which only gives 0 on ARM
+	if (in == 0) return 0;
 	uint32_t n = sqrt_integer_guess_table[__builtin_clz(in)];
 	n = ((in / n) + n) / 2;
 	n = ((in / n) + n) / 2;
@@ -45,6 +47,8 @@ inline uint32_t sqrt_uint32(uint32_t in)
 inline uint32_t sqrt_uint32_approx(uint32_t in) __attribute__((always_inline,unused));
 inline uint32_t sqrt_uint32_approx(uint32_t in)
 {
+	// zero would divide by zero, which only gives 0 on ARM
+	if (in == 0) return 0;
 	uint32_t n = sqrt_integer_guess_table[__builtin_clz(in)];
 	n = ((in / n) + n) / 2;
 	n = ((in / n) + n) / 2;
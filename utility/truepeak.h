@@ -0,0 +1,43 @@
+/* Audio Library for Teensy 3.X
+ * Copyright (c) 2021, Paul Stoffregen, paul@pjrc.com
+ *
+ * Development of this audio library was funded by PJRC.COM, LLC by sales of
+ * Teensy and Audio Adaptor boards.  Please support PJRC's efforts to develop
+ * open source software by purchasing Teensy or other PJRC products.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice, development funding notice, and this permission
+ * notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef truepeak_h_
+#define truepeak_h_
+
+#include <stdint.h>
+
+// 4x oversampling filter from ITU-R BS.1770-4 Annex 2, scaled by 8192.
+// The other two phases are these in reverse order.  Phase 0 lands on
+// the sample 6 behind the newest, phase 3 on the sample 5 behind.
+static const int16_t truepeak_phase0[12] = {
+	14, 90, -161, 272, -487, 1125, 7964, -838, 390, -218, 122, -68
+};
+static const int16_t truepeak_phase1[12] = {
+	-239, 240, -424, 730, -1364, 3810, 6388, -1641, 832, -477, 271, -155
+};
+#define TRUEPEAK_GAIN_BOUND 16572  // sum of |truepeak_phase1|, the largest
+
+#endif